@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "benchmark/benchmark.h"
+#include "ecsact/runtime/meta.hh"
+#include "ecsact/runtime/dynamic.h"
+#include "ecsact/interpret/eval.hh"
+#include "schema_gen.hh"
+
+namespace ecsact::bench {
+
+/**
+ * Schema sizes shared by the benchmarks. Arguments are packages, components,
+ * fields and systems in that order.
+ */
+inline auto schema_sizes(benchmark::internal::Benchmark* b) -> void {
+	b->ArgNames({"pkgs", "comps", "fields", "systems"});
+	b->Args({1, 8, 4, 4});
+	b->Args({8, 32, 8, 16});
+	b->Args({32, 64, 16, 32});
+	b->Args({128, 64, 16, 32});
+}
+
+inline auto schema_params_from(const benchmark::State& state) //
+	-> schema_params {
+	return schema_params{
+		.packages = static_cast<int>(state.range(0)),
+		.components = static_cast<int>(state.range(1)),
+		.fields = static_cast<int>(state.range(2)),
+		.systems = static_cast<int>(state.range(3)),
+	};
+}
+
+inline auto destroy_all_packages() -> void {
+	for(auto package_id : ecsact::meta::get_package_ids()) {
+		ecsact_destroy_package(package_id);
+	}
+}
+
+/**
+ * Evaluates @p schema into the resolver runtime. Throws if the generated schema
+ * did not evaluate cleanly since the numbers would be meaningless.
+ */
+inline auto eval_schema(const generated_schema& schema) -> void {
+	auto sources = schema.eval_sources();
+	auto errors = ecsact::eval_files(sources);
+	if(!errors.empty()) {
+		throw std::logic_error{
+			"generated schema failed to evaluate: " + errors[0].error_message
+		};
+	}
+}
+
+} // namespace ecsact::bench
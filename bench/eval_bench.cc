@@ -0,0 +1,167 @@
+#include <cstdint>
+#include <vector>
+#include "benchmark/benchmark.h"
+#include "ecsact/parse.h"
+#include "ecsact/interpret/eval.h"
+#include "ecsact/interpret/eval.hh"
+#include "ecsact/interpret/detail/read_util.hh"
+#include "ecsact/interpret/detail/eval_parse.hh"
+#include "bench_util.hh"
+
+using ecsact::parse_eval_error;
+using ecsact::bench::destroy_all_packages;
+using ecsact::bench::generate_schema;
+using ecsact::bench::schema_params_from;
+using ecsact::bench::schema_sizes;
+using ecsact::detail::buffer_input;
+using ecsact::detail::eval_parse_state;
+
+using file_states_t = std::vector<eval_parse_state<buffer_input>>;
+
+static auto make_file_states( //
+	const std::vector<ecsact::eval_source>& sources
+) -> file_states_t {
+	auto file_states = file_states_t{};
+	file_states.reserve(sources.size());
+	for(auto& source : sources) {
+		auto& file_state = file_states.emplace_back();
+		file_state.file_path = source.file_path;
+		file_state.reader.stream.buffer = source.source;
+	}
+	return file_states;
+}
+
+static auto parse_headers(
+	file_states_t&                 file_states,
+	std::vector<parse_eval_error>& errors
+) -> void {
+	ecsact::detail::parse_package_statements(file_states, errors);
+	ecsact::detail::parse_imports(file_states, errors);
+	ecsact::detail::check_unknown_imports(file_states, errors);
+	ecsact::detail::check_cyclic_imports(file_states, errors);
+}
+
+static void BM_eval_parse_package_statements(benchmark::State& state) {
+	auto schema = generate_schema(schema_params_from(state));
+	auto sources = schema.eval_sources();
+	auto errors = std::vector<parse_eval_error>{};
+
+	for(auto _ : state) {
+		state.PauseTiming();
+		auto file_states = make_file_states(sources);
+		errors.clear();
+		state.ResumeTiming();
+
+		ecsact::detail::parse_package_statements(file_states, errors);
+		benchmark::DoNotOptimize(errors.data());
+	}
+}
+
+static void BM_eval_parse_imports(benchmark::State& state) {
+	auto schema = generate_schema(schema_params_from(state));
+	auto sources = schema.eval_sources();
+	auto errors = std::vector<parse_eval_error>{};
+
+	for(auto _ : state) {
+		state.PauseTiming();
+		auto file_states = make_file_states(sources);
+		errors.clear();
+		ecsact::detail::parse_package_statements(file_states, errors);
+		state.ResumeTiming();
+
+		ecsact::detail::parse_imports(file_states, errors);
+		benchmark::DoNotOptimize(errors.data());
+	}
+}
+
+static void BM_eval_sort_imports(benchmark::State& state) {
+	auto schema = generate_schema(schema_params_from(state));
+	auto sources = schema.eval_sources();
+	auto errors = std::vector<parse_eval_error>{};
+
+	for(auto _ : state) {
+		state.PauseTiming();
+		auto file_states = make_file_states(sources);
+		errors.clear();
+		ecsact::detail::parse_package_statements(file_states, errors);
+		ecsact::detail::parse_imports(file_states, errors);
+		state.ResumeTiming();
+
+		ecsact::detail::check_unknown_imports(file_states, errors);
+		ecsact::detail::check_cyclic_imports(file_states, errors);
+		auto order = ecsact::detail::get_sorted_states(file_states);
+		benchmark::DoNotOptimize(order.data());
+	}
+}
+
+static void BM_eval_declarations(benchmark::State& state) {
+	auto schema = generate_schema(schema_params_from(state));
+	auto sources = schema.eval_sources();
+	auto errors = std::vector<parse_eval_error>{};
+
+	for(auto _ : state) {
+		state.PauseTiming();
+		auto file_states = make_file_states(sources);
+		errors.clear();
+		parse_headers(file_states, errors);
+		auto order = ecsact::detail::get_sorted_states(file_states);
+		state.ResumeTiming();
+
+		ecsact::detail::eval_package_statements(file_states, errors);
+		for(auto index : order) {
+			auto source_index = static_cast<int32_t>(index);
+			ecsact::detail::eval_imports(source_index, file_states[index], errors);
+			ecsact::detail::parse_eval_declarations(
+				source_index,
+				file_states[index],
+				errors
+			);
+		}
+
+		state.PauseTiming();
+		if(!errors.empty()) {
+			state.SkipWithError(errors[0].error_message.c_str());
+			break;
+		}
+		destroy_all_packages();
+		state.ResumeTiming();
+	}
+}
+
+static void BM_eval_files(benchmark::State& state) {
+	auto schema = generate_schema(schema_params_from(state));
+	auto sources = schema.eval_sources();
+	auto options = ecsact::eval_files_options{
+		.jobs = static_cast<int>(state.range(4)),
+		.pipeline_depth = static_cast<int>(state.range(5)),
+	};
+
+	for(auto _ : state) {
+		auto errors = ecsact::eval_files(sources, options);
+
+		state.PauseTiming();
+		if(!errors.empty()) {
+			state.SkipWithError(errors[0].error_message.c_str());
+			break;
+		}
+		destroy_all_packages();
+		state.ResumeTiming();
+	}
+
+	state.SetBytesProcessed(state.iterations() * schema.total_bytes());
+}
+
+BENCHMARK(BM_eval_parse_package_statements)->Apply(schema_sizes);
+BENCHMARK(BM_eval_parse_imports)->Apply(schema_sizes);
+BENCHMARK(BM_eval_sort_imports)->Apply(schema_sizes);
+BENCHMARK(BM_eval_declarations)->Apply(schema_sizes);
+
+BENCHMARK(BM_eval_files)
+	->ArgNames({"pkgs", "comps", "fields", "systems", "jobs", "depth"})
+	->Args({8, 32, 8, 16, 1, 0})
+	->Args({32, 64, 16, 32, 1, 0})
+	->Args({32, 64, 16, 32, 0, 0})
+	->Args({32, 64, 16, 32, 0, 4})
+	->Args({128, 64, 16, 32, 1, 0})
+	->Args({128, 64, 16, 32, 0, 0})
+	->Args({128, 64, 16, 32, 0, 4});
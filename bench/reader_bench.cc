@@ -0,0 +1,86 @@
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include "benchmark/benchmark.h"
+#include "ecsact/parse.h"
+#include "ecsact/interpret/eval.h"
+#include "ecsact/interpret/detail/read_util.hh"
+#include "ecsact/interpret/detail/eval_parse.hh"
+#include "bench_util.hh"
+
+using ecsact::bench::generate_package_source;
+using ecsact::bench::schema_params_from;
+using ecsact::bench::schema_sizes;
+using ecsact::detail::buffer_input;
+using ecsact::detail::statement_ending_chars;
+using ecsact::detail::statement_reader;
+
+template<typename InputStream>
+static auto read_all_statements(statement_reader<InputStream>& reader) //
+	-> int64_t {
+	auto count = int64_t{};
+	while(reader.can_read_next()) {
+		reader.read_next();
+		if(ecsact_is_error_parse_status_code(reader.status.code)) {
+			break;
+		}
+		reader.pump_status_code();
+		count += 1;
+	}
+	return count;
+}
+
+static void BM_statement_reader_buffered(benchmark::State& state) {
+	auto params = schema_params_from(state);
+	auto source = generate_package_source(params, params.packages - 1);
+
+	auto statement_count = int64_t{};
+	for(auto _ : state) {
+		auto reader = statement_reader<buffer_input>{};
+		reader.stream.buffer = source;
+		statement_count = read_all_statements(reader);
+		benchmark::DoNotOptimize(statement_count);
+	}
+
+	state.SetBytesProcessed(state.iterations() * source.size());
+	state.SetItemsProcessed(state.iterations() * statement_count);
+}
+
+static void BM_statement_reader_stream(benchmark::State& state) {
+	auto params = schema_params_from(state);
+	auto source = generate_package_source(params, params.packages - 1);
+
+	auto statement_count = int64_t{};
+	for(auto _ : state) {
+		auto reader = statement_reader<std::istringstream>{};
+		reader.stream.str(source);
+		statement_count = read_all_statements(reader);
+		benchmark::DoNotOptimize(statement_count);
+	}
+
+	state.SetBytesProcessed(state.iterations() * source.size());
+	state.SetItemsProcessed(state.iterations() * statement_count);
+}
+
+static void BM_statement_boundaries(benchmark::State& state) {
+	auto params = schema_params_from(state);
+	auto source = generate_package_source(params, params.packages - 1);
+
+	auto boundary_count = int64_t{};
+	for(auto _ : state) {
+		auto input = buffer_input{};
+		input.buffer = source;
+		boundary_count = 0;
+		while(input) {
+			benchmark::DoNotOptimize(input.get_until(statement_ending_chars));
+			boundary_count += 1;
+		}
+	}
+
+	state.SetBytesProcessed(state.iterations() * source.size());
+	state.SetItemsProcessed(state.iterations() * boundary_count);
+}
+
+BENCHMARK(BM_statement_reader_buffered)->Apply(schema_sizes);
+BENCHMARK(BM_statement_reader_stream)->Apply(schema_sizes);
+BENCHMARK(BM_statement_boundaries)->Apply(schema_sizes);
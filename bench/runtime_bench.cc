@@ -0,0 +1,158 @@
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "benchmark/benchmark.h"
+#include "ecsact/runtime/meta.hh"
+#include "ecsact/runtime/dynamic.h"
+#include "parse-resolver-runtime/export.h"
+#include "parse-resolver-runtime/lookup.h"
+#include "bench_util.hh"
+
+using ecsact::bench::component_name;
+using ecsact::bench::destroy_all_packages;
+using ecsact::bench::eval_schema;
+using ecsact::bench::generate_schema;
+using ecsact::bench::package_name;
+using ecsact::bench::schema_params_from;
+using ecsact::bench::schema_sizes;
+
+/**
+ * Resolves every component of the main package by plain name and every
+ * component of its import by fully qualified name. This is the lookup the
+ * evaluator does for each component reference.
+ */
+static void BM_lookup_component(benchmark::State& state) {
+	auto params = schema_params_from(state);
+	eval_schema(generate_schema(params));
+	auto scope_package_id = ecsact_meta_main_package();
+
+	auto names = std::vector<std::string>{};
+	for(int c = 0; params.components > c; ++c) {
+		names.push_back(component_name(c));
+		if(params.packages > 1) {
+			names.push_back(
+				package_name(params.packages - 2) + "." + component_name(c)
+			);
+		}
+	}
+
+	for(auto _ : state) {
+		for(auto& name : names) {
+			auto id = ecsact_lookup_component(
+				scope_package_id,
+				name.data(),
+				static_cast<int32_t>(name.size())
+			);
+			benchmark::DoNotOptimize(id);
+		}
+	}
+
+	state.SetItemsProcessed(state.iterations() * names.size());
+	destroy_all_packages();
+}
+
+static void BM_meta_field_offset(benchmark::State& state) {
+	auto params = schema_params_from(state);
+	eval_schema(generate_schema(params));
+
+	auto package_id = ecsact_meta_main_package();
+	auto fields = std::vector<std::pair<ecsact_composite_id, ecsact_field_id>>{};
+	for(auto comp_id : ecsact::meta::get_component_ids(package_id)) {
+		auto compo_id = ecsact_id_cast<ecsact_composite_id>(comp_id);
+		for(auto field_id : ecsact::meta::get_field_ids(compo_id)) {
+			fields.emplace_back(compo_id, field_id);
+		}
+	}
+
+	for(auto _ : state) {
+		for(auto [compo_id, field_id] : fields) {
+			auto offset = ecsact_meta_field_offset(compo_id, field_id);
+			benchmark::DoNotOptimize(offset);
+		}
+	}
+
+	state.SetItemsProcessed(state.iterations() * fields.size());
+	destroy_all_packages();
+}
+
+/**
+ * Reads the ID, name, type and offset of every field of the main package one
+ * call at a time, the way generators walk the model
+ */
+static void BM_meta_fields(benchmark::State& state) {
+	auto params = schema_params_from(state);
+	eval_schema(generate_schema(params));
+	auto package_id = ecsact_meta_main_package();
+
+	auto field_count = std::size_t{};
+	for(auto _ : state) {
+		field_count = 0;
+		for(auto comp_id : ecsact::meta::get_component_ids(package_id)) {
+			auto compo_id = ecsact_id_cast<ecsact_composite_id>(comp_id);
+			for(auto field_id : ecsact::meta::get_field_ids(compo_id)) {
+				auto name = ecsact_meta_field_name(compo_id, field_id);
+				auto type = ecsact_meta_field_type(compo_id, field_id);
+				auto offset = ecsact_meta_field_offset(compo_id, field_id);
+				benchmark::DoNotOptimize(name);
+				benchmark::DoNotOptimize(type);
+				benchmark::DoNotOptimize(offset);
+				field_count += 1;
+			}
+		}
+	}
+
+	state.SetItemsProcessed(state.iterations() * field_count);
+	destroy_all_packages();
+}
+
+/**
+ * Same as BM_meta_fields with a single bulk export
+ */
+static void BM_export_package_fields(benchmark::State& state) {
+	auto params = schema_params_from(state);
+	eval_schema(generate_schema(params));
+	auto package_id = ecsact_meta_main_package();
+
+	auto field_count = int32_t{};
+	ecsact_export_package_fields(package_id, 0, {}, &field_count);
+
+	auto composite_ids = std::vector<ecsact_composite_id>(field_count);
+	auto field_ids = std::vector<ecsact_field_id>(field_count);
+	auto names = std::vector<const char*>(field_count);
+	auto types = std::vector<ecsact_field_type>(field_count);
+	auto offsets = std::vector<int32_t>(field_count);
+	auto rows = ecsact_field_rows{
+		.composite_ids = composite_ids.data(),
+		.field_ids = field_ids.data(),
+		.names = names.data(),
+		.types = types.data(),
+		.offsets = offsets.data(),
+	};
+
+	for(auto _ : state) {
+		ecsact_export_package_fields(package_id, field_count, rows, nullptr);
+		benchmark::DoNotOptimize(offsets.data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * field_count);
+	destroy_all_packages();
+}
+
+static void BM_destroy_package(benchmark::State& state) {
+	auto schema = generate_schema(schema_params_from(state));
+
+	for(auto _ : state) {
+		state.PauseTiming();
+		eval_schema(schema);
+		state.ResumeTiming();
+
+		destroy_all_packages();
+	}
+}
+
+BENCHMARK(BM_lookup_component)->Apply(schema_sizes);
+BENCHMARK(BM_meta_field_offset)->Apply(schema_sizes);
+BENCHMARK(BM_meta_fields)->Apply(schema_sizes);
+BENCHMARK(BM_export_package_fields)->Apply(schema_sizes);
+BENCHMARK(BM_destroy_package)->Apply(schema_sizes);
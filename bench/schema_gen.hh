@@ -0,0 +1,131 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <vector>
+#include "ecsact/interpret/eval.hh"
+
+namespace ecsact::bench {
+
+/**
+ * Shape of a synthetic schema, used by the benchmarks and the scaling tests.
+ * Each package imports up to `imports` of the packages before it and every
+ * system reads one component from each import by its fully qualified name.
+ * With `nested_systems` each package also gets a `Root` system holding that
+ * many nested systems.
+ */
+struct schema_params {
+	int packages = 1;
+	int imports = 1;
+	int components = 1;
+	int fields = 1;
+	int systems = 1;
+	int nested_systems = 0;
+};
+
+struct generated_schema {
+	std::vector<std::filesystem::path> file_paths;
+	std::vector<std::string>           sources;
+
+	/**
+	 * Views into `sources` suitable for the in memory `eval_files`. Invalidated
+	 * if `sources` is modified.
+	 */
+	auto eval_sources() const -> std::vector<eval_source> {
+		auto result = std::vector<eval_source>{};
+		result.reserve(sources.size());
+		for(std::size_t i = 0; sources.size() > i; ++i) {
+			result.push_back(eval_source{
+				.file_path = file_paths[i],
+				.source = sources[i],
+			});
+		}
+		return result;
+	}
+
+	auto total_bytes() const -> std::size_t {
+		auto total = std::size_t{};
+		for(auto& source : sources) {
+			total += source.size();
+		}
+		return total;
+	}
+};
+
+inline auto package_name(int package_index) -> std::string {
+	return "bench.pkg" + std::to_string(package_index);
+}
+
+inline auto component_name(int component_index) -> std::string {
+	return "Comp" + std::to_string(component_index);
+}
+
+inline auto generate_package_source( //
+	const schema_params& params,
+	int                  package_index
+) -> std::string {
+	constexpr auto field_types = std::array{"i32", "f32", "u8", "i16", "entity"};
+
+	auto source = std::string{};
+	if(package_index == params.packages - 1) {
+		source += "main ";
+	}
+	source += "package " + package_name(package_index) + ";\n";
+
+	auto import_count = std::min(params.imports, package_index);
+	for(int i = 1; import_count >= i; ++i) {
+		source += "import " + package_name(package_index - i) + ";\n";
+	}
+
+	for(int c = 0; params.components > c; ++c) {
+		source += "component " + component_name(c) + " {\n";
+		for(int f = 0; params.fields > f; ++f) {
+			source += "\t";
+			source += field_types[f % field_types.size()];
+			source += " f" + std::to_string(f) + ";\n";
+		}
+		source += "}\n";
+	}
+
+	for(int s = 0; params.systems > s; ++s) {
+		source += "system Sys" + std::to_string(s) + " {\n";
+		if(params.components > 0) {
+			source += "\treadwrite " + component_name(s % params.components) + ";\n";
+			for(int i = 1; import_count >= i; ++i) {
+				source += "\treadonly " + package_name(package_index - i) + "." +
+					component_name((s + 1) % params.components) + ";\n";
+			}
+		}
+		source += "}\n";
+	}
+
+	if(params.nested_systems > 0 && params.components > 0) {
+		source += "system Root {\n";
+		source += "\treadwrite " + component_name(0) + ";\n";
+		for(int n = 0; params.nested_systems > n; ++n) {
+			source += "\tsystem Nested" + std::to_string(n) + " {\n";
+			source += "\t\treadwrite " + component_name(n % params.components);
+			source += ";\n\t}\n";
+		}
+		source += "}\n";
+	}
+
+	return source;
+}
+
+inline auto generate_schema(const schema_params& params) -> generated_schema {
+	auto schema = generated_schema{};
+	schema.file_paths.reserve(params.packages);
+	schema.sources.reserve(params.packages);
+	for(int p = 0; params.packages > p; ++p) {
+		schema.file_paths.emplace_back("bench_pkg" + std::to_string(p) + ".ecsact");
+		schema.sources.push_back(generate_package_source(params, p));
+	}
+	return schema;
+}
+
+} // namespace ecsact::bench
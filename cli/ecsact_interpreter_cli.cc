@@ -1,20 +1,42 @@
 #include <type_traits>
 #include <iostream>
+#include <iterator>
+#include <algorithm>
 #include <array>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <iomanip>
+#include <mutex>
 #include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
 #include "magic_enum.hpp"
 #include "ecsact/runtime/meta.hh"
 #include "ecsact/runtime/dynamic.h"
 #include "ecsact/parse.h"
 #include "ecsact/interpret/eval.h"
+#include "ecsact/interpret/eval.hh"
+#include "ecsact/interpret/eval_session.hh"
 #include "ecsact/interpret/detail/eval_parse.hh"
+#include "ecsact/interpret/detail/parallel.hh"
+#include "ecsact/interpret/detail/read_util.hh"
+#include "parse-resolver-runtime/context.h"
+#include "parse-resolver-runtime/fingerprint.h"
+#include "parse-resolver-runtime/memory.h"
+#include "parse-resolver-runtime/views.hh"
 
 #define COLOR_GREY "\033[90m"
 #define COLOR_RED "\033[31m"
 #define COLOR_CYAN "\u001b[36m"
 #define COLOR_RESET "\033[0m"
 
-bool is_repl_cmd(const std::string& source, std::string cmd_str) {
+bool is_repl_cmd(std::string_view source, std::string cmd_str) {
 	if(source == cmd_str) {
 		return true;
 	}
@@ -28,10 +50,625 @@ bool is_repl_cmd(const std::string& source, std::string cmd_str) {
 	return false;
 }
 
-int main() {
-	// Let's go !!blazingly fast!!
-	std::ios_base::sync_with_stdio(false);
+constexpr auto usage = R"(Usage: ecsact_interpreter [options] [files...]
+
+Without any files an interactive REPL reads statements from stdin. The REPL
+also accepts .reset to clear the runtime, .memory to report the runtime
+memory usage per table and package, and .exit. Otherwise
+every given file is evaluated together and every error is reported. A file
+of - is read from stdin.
+
+Options:
+  --jobs N        Threads used to read and parse files. Defaults to the
+                  hardware concurrency.
+  --max-errors N  Stop after N errors
+  --stats         Print evaluation statistics once done
+  --root NAME     Only evaluate package NAME and the packages it imports.
+                  May be given more than once.
+  --main-root     Only evaluate the main package and the packages it
+                  imports. May be combined with --root.
+  --serve         Keep the files evaluated and answer requests, see below
+  --poll-ms N     How often --serve checks the files for changes. Defaults
+                  to 200.
+  --help          Print this message
+
+Exit codes:
+  0  Every file evaluated without errors
+  1  Some file failed to evaluate
+  2  Invalid arguments or a file could not be read
+
+With --serve the files are evaluated once and kept in memory. Files that
+changed since, and the files importing them, are evaluated again whenever
+the files are checked. Requests are read from stdin, one per line:
+
+  errors        Errors of the last evaluation
+  packages      Name, fingerprint and file of every package
+  package NAME  Declarations of package NAME
+  eval          Evaluate changed files right away, even those whose write
+                time is unchanged
+  exit          Stop serving
+
+Every response starts with a line of "ok" or "error MESSAGE" and ends with
+a line holding a single ".". Evaluations are reported the same way with a
+first line of "ready", "changed" or "ok" for the eval request, followed by
+the number of files evaluated and the number of errors, then the errors.
+)";
+
+struct batch_options {
+	std::vector<std::filesystem::path> files;
+	int                                jobs = 0;
+	int                                max_errors = 0;
+	std::vector<std::string>           root_packages;
+	bool                               main_package_root = false;
+	bool                               stats = false;
+	bool                               serve = false;
+	int                                poll_ms = 200;
+};
+
+static auto parse_int_arg(std::string_view arg, int& out) -> bool {
+	auto result = std::from_chars(arg.data(), arg.data() + arg.size(), out);
+	return result.ec == std::errc{} && result.ptr == arg.data() + arg.size();
+}
+
+/**
+ * Whether @p arg is the option @p name, on its own or as `name=value`
+ */
+static auto is_option(std::string_view arg, std::string_view name) -> bool {
+	if(!arg.starts_with(name)) {
+		return false;
+	}
+	return arg.size() == name.size() || arg[name.size()] == '=';
+}
+
+/**
+ * @returns nullopt when the arguments are invalid, after reporting why
+ */
+static auto parse_batch_options( //
+	std::vector<std::string_view> args
+) -> std::optional<batch_options> {
+	auto options = batch_options{};
+
+	for(std::size_t i = 0; args.size() > i; ++i) {
+		auto arg = args[i];
+		// Only called once `is_option` matched `name`
+		auto int_option = [&](std::string_view name, int& out) -> bool {
+			if(arg.size() > name.size()) {
+				return parse_int_arg(arg.substr(name.size() + 1), out);
+			}
+			if(i + 1 >= args.size()) {
+				return false;
+			}
+			return parse_int_arg(args[++i], out);
+		};
+
+		if(arg == "--stats") {
+			options.stats = true;
+		} else if(arg == "--main-root") {
+			options.main_package_root = true;
+		} else if(is_option(arg, "--root")) {
+			auto name = arg.substr(std::string_view{"--root"}.size());
+			if(!name.empty()) {
+				name.remove_prefix(1);
+			} else if(i + 1 < args.size()) {
+				name = args[++i];
+			}
+			if(name.empty()) {
+				std::cerr << "Invalid --root value\n";
+				return std::nullopt;
+			}
+			options.root_packages.emplace_back(name);
+		} else if(arg == "--serve") {
+			options.serve = true;
+		} else if(is_option(arg, "--poll-ms")) {
+			if(!int_option("--poll-ms", options.poll_ms) || options.poll_ms < 1) {
+				std::cerr << "Invalid --poll-ms value\n";
+				return std::nullopt;
+			}
+		} else if(is_option(arg, "--jobs")) {
+			if(!int_option("--jobs", options.jobs)) {
+				std::cerr << "Invalid --jobs value\n";
+				return std::nullopt;
+			}
+		} else if(is_option(arg, "--max-errors")) {
+			if(!int_option("--max-errors", options.max_errors)) {
+				std::cerr << "Invalid --max-errors value\n";
+				return std::nullopt;
+			}
+		} else if(arg.starts_with("--") || (arg.starts_with("-") && arg != "-")) {
+			std::cerr << "Unknown option " << arg << "\n" << usage;
+			return std::nullopt;
+		} else if(arg == "-" && std::ranges::count(options.files, "-") > 0) {
+			std::cerr << "stdin (-) may only be given once\n";
+			return std::nullopt;
+		} else {
+			options.files.emplace_back(arg);
+		}
+	}
+
+	return options;
+}
+
+static void print_stats(std::ostream& out, const ecsact::eval_stats& stats) {
+	auto ms = [](std::chrono::nanoseconds time) {
+		return std::chrono::duration<double, std::milli>(time).count();
+	};
+
+	auto& times = stats.phase_times;
+	auto& objects = stats.objects_created;
+	out //
+		<< "read files:               " << ms(times.read_files) << "ms\n"
+		<< "select roots:             " << ms(times.select_roots) << "ms\n"
+		<< "parse package statements: " << ms(times.parse_package_statements)
+		<< "ms\n"
+		<< "parse imports:            " << ms(times.parse_imports) << "ms\n"
+		<< "check imports:            " << ms(times.check_imports) << "ms\n"
+		<< "eval package statements:  " << ms(times.eval_package_statements)
+		<< "ms\n"
+		<< "eval declarations:        " << ms(times.eval_declarations) << "ms\n"
+		<< "total:                    " << ms(times.total) << "ms\n"
+		<< "bytes read:               " << stats.bytes_read << "\n"
+		<< "symbol lookups:           " << stats.symbol_lookups << " ("
+		<< stats.symbol_lookup_misses << " misses)\n"
+		<< "packages:                 " << objects.packages << "\n"
+		<< "components:               " << objects.components << "\n"
+		<< "transients:               " << objects.transients << "\n"
+		<< "systems:                  " << objects.systems << "\n"
+		<< "actions:                  " << objects.actions << "\n"
+		<< "enums:                    " << objects.enums << "\n"
+		<< "fields:                   " << objects.fields << "\n";
+
+	for(auto [type, count] : stats.statements_parsed) {
+		out << "  " << magic_enum::enum_name(type) << ": " << count << "\n";
+	}
+}
+
+static void print_memory_usage(
+	std::ostream&                      out,
+	const ecsact_runtime_memory_usage& usage
+) {
+	for(auto i = 0; ECSACT_MEMORY_TABLE_COUNT > i; ++i) {
+		auto table = static_cast<ecsact_runtime_memory_table>(i);
+		auto entry = usage.tables[i];
+		out //
+			<< "  " << std::left << std::setw(18)
+			<< ecsact_runtime_memory_table_name(table) << std::right
+			<< std::setw(10) << entry.count << std::setw(12) << entry.bytes
+			<< " bytes\n";
+	}
+	out << "  " << std::left << std::setw(28) << "total" << std::right
+			<< std::setw(12) << usage.total_bytes << " bytes\n";
+}
+
+/**
+ * Prints the memory used by the whole runtime followed by each package
+ */
+static void print_memory_report(std::ostream& out) {
+	auto usage = ecsact_runtime_memory_usage{};
+	ecsact_get_runtime_memory_usage(&usage);
+	out << "runtime\n";
+	print_memory_usage(out, usage);
+
+	for(auto package_id : ecsact::meta::get_package_ids()) {
+		ecsact_get_package_memory_usage(package_id, &usage);
+		out << "package " << ecsact::meta::package_name(package_id) << "\n";
+		print_memory_usage(out, usage);
+	}
+}
+
+/**
+ * Writes @p err as `file:line:character: error: message`. The file is left
+ * out when @p file_path is empty.
+ */
+static void write_error(
+	std::ostream&                   out,
+	const std::filesystem::path&    file_path,
+	const ecsact::parse_eval_error& err
+) {
+	if(!file_path.empty()) {
+		out << file_path.string() << ":";
+	}
+	out //
+		<< err.line << ":" << err.character << ": error: " << err.error_message
+		<< "\n";
+}
+
+/**
+ * Evaluates every file of @p options in one go. Output is buffered and written
+ * once everything is done.
+ */
+static auto run_batch(const batch_options& options) -> int {
+	using ecsact::detail::read_file_contents;
+	using ecsact::detail::read_source_files;
+	using ecsact::detail::record_read_time;
+	using ecsact::detail::resolve_job_count;
+
+	auto unreadable = false;
+	for(auto& file : options.files) {
+		if(file != "-" && !std::filesystem::is_regular_file(file)) {
+			std::cerr << file.string() << ": cannot read file\n";
+			unreadable = true;
+		}
+	}
+	if(unreadable) {
+		return 2;
+	}
+
+	auto reads_stdin = std::ranges::any_of(options.files, [](auto& file) {
+		return file == "-";
+	});
+
+	auto read_start = std::chrono::steady_clock::now();
+	auto stdin_contents = std::string{};
+	if(reads_stdin) {
+		stdin_contents.assign(
+			std::istreambuf_iterator<char>{std::cin},
+			std::istreambuf_iterator<char>{}
+		);
+	}
+	auto stdin_read_time = std::chrono::steady_clock::now() - read_start;
+
+	auto jobs = resolve_job_count(options.jobs);
+	auto files_read =
+		read_source_files(options.files, jobs, [&](const auto& file_path) {
+			return file_path == "-" ? stdin_contents : read_file_contents(file_path);
+		});
+	files_read.read_time += stdin_read_time;
+
+	auto& sources = files_read.sources;
+	for(auto& source : sources) {
+		if(source.file_path == "-") {
+			source.file_path = "<stdin>";
+		}
+	}
+
+	auto err_out = std::ostringstream{};
+	auto stats = ecsact::eval_stats{};
+	auto errors = ecsact::eval_files(
+		sources,
+		{
+			.jobs = jobs,
+			.max_errors = options.max_errors,
+			.root_packages = options.root_packages,
+			.main_package_root = options.main_package_root,
+			.stats = options.stats ? &stats : nullptr,
+		}
+	);
+
+	for(auto& err : errors) {
+		auto file_path = std::filesystem::path{};
+		if(err.source_index >= 0) {
+			file_path = sources[err.source_index].file_path;
+		}
+		write_error(err_out, file_path, err);
+	}
+	std::cerr << err_out.str();
+
+	if(options.stats) {
+		record_read_time(&stats, files_read.read_time);
+		auto stats_out = std::ostringstream{};
+		print_stats(stats_out, stats);
+		std::cout << stats_out.str();
+	}
+
+	return errors.empty() ? 0 : 1;
+}
+
+/**
+ * Reads request lines from stdin on its own thread so the server can keep
+ * checking files while it waits. Stops reading at the end of input or once
+ * an exit request was read.
+ */
+class request_reader {
+	std::mutex              _mutex;
+	std::condition_variable _cv;
+	std::deque<std::string> _lines;
+	bool                    _closed = false;
+	std::thread             _thread;
+
+	void read() {
+		auto line = std::string{};
+		auto open = true;
+		while(open && std::getline(std::cin, line)) {
+			if(line.ends_with('\r')) {
+				line.pop_back();
+			}
+			open = line != "exit";
+
+			auto lk = std::scoped_lock{_mutex};
+			_lines.push_back(std::move(line));
+			_cv.notify_one();
+		}
+
+		auto lk = std::scoped_lock{_mutex};
+		_closed = true;
+		_cv.notify_one();
+	}
+
+public:
+	request_reader() : _thread([this] { read(); }) {
+	}
+
+	request_reader(const request_reader&) = delete;
+
+	~request_reader() {
+		_thread.join();
+	}
+
+	/**
+	 * Waits up to @p timeout for the next line
+	 * @returns nullopt if there was none in time or the input is closed
+	 */
+	auto next(std::chrono::milliseconds timeout) -> std::optional<std::string> {
+		auto lk = std::unique_lock{_mutex};
+		_cv.wait_for(lk, timeout, [&] { return _closed || !_lines.empty(); });
+		if(_lines.empty()) {
+			return std::nullopt;
+		}
+
+		auto line = std::move(_lines.front());
+		_lines.pop_front();
+		return line;
+	}
+
+	auto closed() -> bool {
+		auto lk = std::scoped_lock{_mutex};
+		return _closed && _lines.empty();
+	}
+};
+
+/**
+ * Files being served along with what was last seen of them
+ */
+struct serve_state {
+	using file_time = std::filesystem::file_time_type;
+
+	ecsact::eval_session                  session;
+	std::vector<std::filesystem::path>    files;
+	std::vector<std::optional<file_time>> write_times;
+	std::vector<std::string>              errors;
+	int                                   jobs = 1;
+	int                                   max_errors = 0;
+	std::vector<std::string>              root_packages;
+	bool                                  main_package_root = false;
+};
+
+/**
+ * Updates the write time of every served file
+ * @returns true if any of them changed or could no longer be read
+ */
+static auto check_write_times(serve_state& state) -> bool {
+	auto changed = false;
+	for(std::size_t i = 0; state.files.size() > i; ++i) {
+		auto ec = std::error_code{};
+		auto write_time = std::optional<serve_state::file_time>{};
+		if(std::filesystem::is_regular_file(state.files[i], ec)) {
+			write_time = std::filesystem::last_write_time(state.files[i], ec);
+			if(ec) {
+				write_time = std::nullopt;
+			}
+		}
+
+		if(write_time != state.write_times[i]) {
+			state.write_times[i] = write_time;
+			changed = true;
+		}
+	}
+
+	return changed;
+}
+
+/**
+ * Evaluates the served files whose content changed, and their importers,
+ * again. Files that can't be read are left out so their packages are
+ * destroyed until they are back.
+ * @returns number of files evaluated
+ */
+static auto reevaluate(serve_state& state) -> std::size_t {
+	state.errors.clear();
+
+	auto files = std::vector<std::filesystem::path>{};
+	files.reserve(state.files.size());
+	for(std::size_t i = 0; state.files.size() > i; ++i) {
+		if(state.write_times[i]) {
+			files.push_back(state.files[i]);
+		} else {
+			state.errors.push_back(state.files[i].string() + ": cannot read file");
+		}
+	}
+
+	auto errors = state.session.eval_files(
+		files,
+		{
+			.jobs = state.jobs,
+			.max_errors = state.max_errors,
+			.root_packages = state.root_packages,
+			.main_package_root = state.main_package_root,
+		}
+	);
+
+	for(auto& err : errors) {
+		auto err_out = std::ostringstream{};
+		auto file_path = std::filesystem::path{};
+		if(err.source_index >= 0) {
+			file_path = files[err.source_index];
+		}
+		write_error(err_out, file_path, err);
+
+		auto line = err_out.str();
+		line.pop_back();
+		state.errors.push_back(std::move(line));
+	}
+
+	return state.session.last_evaluated_count();
+}
+
+static void write_evaluation(
+	std::ostream&      out,
+	std::string_view   header,
+	const serve_state& state,
+	std::size_t        evaluated_count
+) {
+	out << header << " " << evaluated_count << " " << state.errors.size() << "\n";
+	for(auto& err : state.errors) {
+		out << err << "\n";
+	}
+	out << ".\n";
+}
+
+static void write_fingerprint(std::ostream& out, ecsact_package_id pkg_id) {
+	auto flags = out.flags();
+	out //
+		<< std::hex << std::setw(16) << std::setfill('0')
+		<< ecsact_package_fingerprint(pkg_id) << std::setfill(' ');
+	out.flags(flags);
+}
+
+static auto find_package(std::string_view name)
+	-> std::optional<ecsact_package_id> {
+	for(auto pkg_id : ecsact::interpret::views::package_ids()) {
+		if(ecsact::interpret::views::package_name(pkg_id) == name) {
+			return pkg_id;
+		}
+	}
+
+	return std::nullopt;
+}
+
+static void write_packages(std::ostream& out) {
+	out << "ok\n";
+	for(auto pkg_id : ecsact::interpret::views::package_ids()) {
+		out << ecsact::interpret::views::package_name(pkg_id) << " ";
+		write_fingerprint(out, pkg_id);
+		out << " " << ecsact_meta_package_file_path(pkg_id) << "\n";
+	}
+	out << ".\n";
+}
+
+static void write_package(std::ostream& out, std::string_view name) {
+	namespace views = ecsact::interpret::views;
+
+	auto pkg_id = find_package(name);
+	if(!pkg_id) {
+		out << "error unknown package " << name << "\n.\n";
+		return;
+	}
+
+	out << "ok\n";
+	out << "file " << ecsact_meta_package_file_path(*pkg_id) << "\n";
+	out << "fingerprint ";
+	write_fingerprint(out, *pkg_id);
+	out << "\n";
+
+	for(auto dep_id : views::dependencies(*pkg_id)) {
+		out << "dependency " << views::package_name(dep_id) << "\n";
+	}
+	for(auto id : views::enum_ids(*pkg_id)) {
+		out << "enum " << ecsact_meta_enum_name(id) << "\n";
+	}
+	for(auto id : views::component_ids(*pkg_id)) {
+		out << "component " << ecsact_meta_component_name(id) << "\n";
+	}
+	for(auto id : views::transient_ids(*pkg_id)) {
+		out << "transient " << ecsact_meta_transient_name(id) << "\n";
+	}
+	for(auto id : views::action_ids(*pkg_id)) {
+		out << "action " << ecsact_meta_action_name(id) << "\n";
+	}
+	for(auto id : views::system_ids(*pkg_id)) {
+		auto decl_id = ecsact_id_cast<ecsact_decl_id>(id);
+		out << "system " << ecsact_meta_decl_full_name(decl_id) << "\n";
+	}
+	out << ".\n";
+}
+
+/**
+ * Writes the response to @p request
+ * @returns false once the server should stop
+ */
+static auto handle_request(
+	serve_state&     state,
+	std::string_view request,
+	std::ostream&    out
+) -> bool {
+	auto space_idx = request.find(' ');
+	auto name = request.substr(0, space_idx);
+	auto arg = space_idx == std::string_view::npos
+		? std::string_view{}
+		: request.substr(space_idx + 1);
+
+	if(name == "exit") {
+		out << "ok\n.\n";
+		return false;
+	} else if(name == "errors") {
+		out << "ok\n";
+		for(auto& err : state.errors) {
+			out << err << "\n";
+		}
+		out << ".\n";
+	} else if(name == "packages") {
+		write_packages(out);
+	} else if(name == "package") {
+		write_package(out, arg);
+	} else if(name == "eval") {
+		check_write_times(state);
+		write_evaluation(out, "ok", state, reevaluate(state));
+	} else {
+		out << "error unknown request " << name << "\n.\n";
+	}
+
+	return true;
+}
+
+/**
+ * Serves the files of @p options until stdin closes or an exit request
+ */
+static auto run_serve(const batch_options& options) -> int {
+	auto state = serve_state{
+		.files = options.files,
+		.write_times = {},
+		.errors = {},
+		.jobs = ecsact::detail::resolve_job_count(options.jobs),
+		.max_errors = options.max_errors,
+		.root_packages = options.root_packages,
+		.main_package_root = options.main_package_root,
+	};
+	state.write_times.resize(state.files.size());
+	check_write_times(state);
+
+	auto out = std::ostringstream{};
+	write_evaluation(out, "ready", state, reevaluate(state));
+	std::cout << out.str() << std::flush;
+
+	auto poll_interval = std::chrono::milliseconds{options.poll_ms};
+	auto requests = request_reader{};
+	for(;;) {
+		auto request = requests.next(poll_interval);
+		if(!request && requests.closed()) {
+			break;
+		}
+
+		out.str({});
+		if(check_write_times(state)) {
+			write_evaluation(out, "changed", state, reevaluate(state));
+		}
 
+		auto serving = true;
+		if(request && !request->empty()) {
+			serving = handle_request(state, *request, out);
+		}
+
+		if(out.tellp() > 0) {
+			std::cout << out.str() << std::flush;
+		}
+		if(!serving) {
+			break;
+		}
+	}
+
+	return 0;
+}
+
+static auto run_repl() -> int {
 	ecsact::detail::statement_reader<std::istream&> reader{std::cin};
 	std::optional<ecsact_package_id>                current_package{};
 
@@ -62,13 +699,15 @@ int main() {
 			if(is_repl_cmd(repl_maybe, ".exit")) {
 				return 0;
 			} else if(is_repl_cmd(repl_maybe, ".reset")) {
-				for(auto pkg_id : ecsact::meta::get_package_ids()) {
-					ecsact_destroy_package(pkg_id);
-				}
-				ecsact_eval_reset();
+				ecsact_reset_runtime();
+				current_package = std::nullopt;
 				reader.reset();
 				std::cout << COLOR_GREY " [ reset ]\n" COLOR_RESET;
 				continue;
+			} else if(is_repl_cmd(repl_maybe, ".memory")) {
+				print_memory_report(std::cout);
+				reader.reset();
+				continue;
 			}
 		}
 
@@ -148,7 +787,7 @@ int main() {
 						eval_err.relevant_content.data,
 						eval_err.relevant_content.length
 					);
-					int offset = eval_err.relevant_content.data - last_source.c_str();
+					int offset = eval_err.relevant_content.data - last_source.data();
 					if(offset < last_source.size()) {
 						std::cerr //
 							<< std::string(offset + 3, ' ') << COLOR_RED "^" COLOR_RESET
@@ -189,3 +828,40 @@ int main() {
 
 	return 0;
 }
+
+int main(int argc, char* argv[]) {
+	// Let's go !!blazingly fast!!
+	std::ios_base::sync_with_stdio(false);
+
+	auto args = std::vector<std::string_view>(argv + 1, argv + argc);
+	if(args.empty()) {
+		return run_repl();
+	}
+
+	for(auto arg : args) {
+		if(arg == "--help" || arg == "-h") {
+			std::cout << usage;
+			return 0;
+		}
+	}
+
+	auto options = parse_batch_options(args);
+	if(!options) {
+		return 2;
+	}
+
+	if(options->files.empty()) {
+		std::cerr << "No files given\n" << usage;
+		return 2;
+	}
+
+	if(options->serve) {
+		if(std::ranges::count(options->files, "-") > 0) {
+			std::cerr << "stdin (-) can't be served\n";
+			return 2;
+		}
+		return run_serve(*options);
+	}
+
+	return run_batch(*options);
+}
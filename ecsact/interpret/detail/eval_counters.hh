@@ -0,0 +1,101 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include "magic_enum.hpp"
+#include "ecsact/parse/statements.h"
+#include "ecsact/interpret/eval.hh"
+
+namespace ecsact::detail {
+
+/**
+ * Counters gathered while evaluating. Each file keeps its own copy so phases
+ * running on several threads never share one.
+ */
+struct eval_counters {
+	std::array<int64_t, magic_enum::enum_count<ecsact_statement_type>()>
+		statements = {};
+
+	int64_t symbol_lookups = 0;
+	int64_t symbol_lookup_misses = 0;
+
+	auto count_statement(ecsact_statement_type type) -> void {
+		if(auto index = magic_enum::enum_index(type)) {
+			statements[*index] += 1;
+		}
+	}
+
+	auto count_lookup(bool found) -> void {
+		symbol_lookups += 1;
+		if(!found) {
+			symbol_lookup_misses += 1;
+		}
+	}
+
+	/**
+	 * Adds these counters to @p stats
+	 */
+	auto add_to(eval_stats& stats) const -> void {
+		for(std::size_t i = 0; statements.size() > i; ++i) {
+			if(statements[i] > 0) {
+				auto type = magic_enum::enum_value<ecsact_statement_type>(i);
+				stats.statements_parsed[type] += statements[i];
+			}
+		}
+		stats.symbol_lookups += symbol_lookups;
+		stats.symbol_lookup_misses += symbol_lookup_misses;
+	}
+};
+
+/**
+ * Counters that name lookups in the evaluator are recorded to. Only set while
+ * declarations are evaluated on this thread.
+ */
+inline thread_local eval_counters* current_eval_counters = nullptr;
+
+/**
+ * Makes @p counters the `current_eval_counters` for the lifetime of this
+ * object.
+ */
+class scoped_eval_counters {
+	eval_counters* _previous;
+
+public:
+	explicit scoped_eval_counters(eval_counters& counters)
+		: _previous(current_eval_counters) {
+		current_eval_counters = &counters;
+	}
+
+	scoped_eval_counters(const scoped_eval_counters&) = delete;
+
+	~scoped_eval_counters() {
+		current_eval_counters = _previous;
+	}
+};
+
+/**
+ * Adds the time between construction and destruction to @p out. Does nothing
+ * if @p out is null.
+ */
+class scoped_phase_timer {
+	using clock = std::chrono::steady_clock;
+
+	std::chrono::nanoseconds* _out;
+	clock::time_point         _start;
+
+public:
+	explicit scoped_phase_timer(std::chrono::nanoseconds* out)
+		: _out(out), _start(out ? clock::now() : clock::time_point{}) {
+	}
+
+	scoped_phase_timer(const scoped_phase_timer&) = delete;
+
+	~scoped_phase_timer() {
+		if(_out) {
+			*_out += clock::now() - _start;
+		}
+	}
+};
+
+} // namespace ecsact::detail
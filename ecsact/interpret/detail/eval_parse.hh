@@ -1,26 +1,37 @@
 #pragma once
 
 #include <filesystem>
+#include <algorithm>
 #include <array>
+#include <unordered_map>
 #include <unordered_set>
 #include <cassert>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
 #include <iostream> //  TODO(ZAUCY): Remove this
-#include "magic_enum.hpp"
 #include "ecsact/runtime/dynamic.h"
 #include "ecsact/runtime/meta.hh"
 #include "ecsact/interpret/parse_eval_error.hh"
+#include "parse-resolver-runtime/views.hh"
 
 #include "./file_eval_error.hh"
-#include "./fixed_stack.hh"
 #include "./stack_util.hh"
 #include "./string_util.hh"
 #include "./read_util.hh"
-
-template<>
-struct magic_enum::customize::enum_range<ecsact_eval_error_code> {
-	static constexpr int min = 0;
-	static constexpr int max = 2000;
-};
+#include "./small_stack.hh"
+#include "./source_arena.hh"
+#include "./statement_tape.hh"
+#include "./parallel.hh"
+#include "./eval_counters.hh"
+#include "./trace.hh"
 
 namespace ecsact::detail {
 
@@ -28,63 +39,59 @@ constexpr std::array statement_ending_chars{';', '{', '}', '\n'};
 
 template<typename InputStream>
 struct statement_reader {
-	InputStream                       stream;
-	fixed_stack<ecsact_statement, 16> statements;
-	fixed_stack<std::string, 16>      sources;
-	std::vector<std::string>          next_statement_sources;
-	ecsact_statement*                 current_context = nullptr;
-	ecsact_parse_status               status = {};
-	int                               current_line = 0;
-	int                               current_character = 0;
+	/**
+	 * Buffered readers hand out views into the input buffer. Stream readers copy
+	 * each statement source into `arena` instead.
+	 */
+	static constexpr bool buffered = is_buffer_input_v<InputStream>;
+
+	using source_type = std::string_view;
+
+	InputStream                         stream;
+	small_stack<ecsact_statement, 16>   statements;
+	small_stack<source_type, 16>        sources;
+	std::optional<source_type>          rewound_source;
+	ecsact_statement*                   current_context = nullptr;
+	ecsact_parse_status                 status = {};
+	int                                 current_line = 0;
+	int                                 current_character = 0;
+	source_arena                        arena;
+	small_stack<source_arena::mark, 16> source_marks;
+	source_arena::mark                  rewound_source_mark;
 
 	void reset() {
 		current_line = 0;
 		current_character = 0;
 		status = {};
 		current_context = nullptr;
-		next_statement_sources.clear();
+		rewound_source = std::nullopt;
 		statements.clear();
 		sources.clear();
+		source_marks.clear();
+		arena.clear();
 	}
 
 	bool can_read_next() {
-		return !next_statement_sources.empty() || (stream && !stream.eof());
+		return rewound_source.has_value() || (stream && !stream.eof());
+	}
+
+	auto position() const -> source_position {
+		return {.line = current_line, .character = current_character};
 	}
 
 	void read_next() {
-		auto  previous_statement = try_top(statements);
 		auto& next_statement = statements.emplace();
 		auto& next_source = sources.emplace();
 
-		if(status.code == ECSACT_PARSE_STATUS_ASSUMED_STATEMENT_END) {
-			next_source.reserve(1024);
-			ecsact::detail::stream_get_until(
-				stream,
-				next_source,
-				statement_ending_chars
-			);
-			if(!next_statement_sources.empty()) {
-				next_source = next_statement_sources.back() + next_source;
-				next_statement_sources.pop_back();
-			}
-			next_source.shrink_to_fit();
-		} else if(next_statement_sources.empty()) {
-			next_source.reserve(1024);
-			ecsact::detail::stream_get_until(
-				stream,
-				next_source,
-				statement_ending_chars
-			);
-			next_source.shrink_to_fit();
-		} else {
-			next_source = next_statement_sources.back();
-			next_statement_sources.pop_back();
-		}
+		auto single_read = read_next_source(next_source);
 
 		auto read_data = next_source.data();
 		auto read_size = next_source.size();
 
-		current_context = previous_statement ? &previous_statement->get() : nullptr;
+		// Looked up after the push since growing the stack moves its statements
+		current_context = statements.size() > 1
+			? &statements.data()[statements.size() - 2]
+			: nullptr;
 		[[maybe_unused]] auto parse_read_amount = ecsact_parse_statement(
 			read_data,
 			read_size,
@@ -93,8 +100,15 @@ struct statement_reader {
 			&status
 		);
 
+		// Newlines end statements so a source made of a single read can only have
+		// one as its last character. Rewound sources may span several reads.
 		int last_nl_index = -1;
-		current_line += count_char(next_source, '\n', last_nl_index);
+		if(!single_read) {
+			current_line += count_char(next_source, '\n', last_nl_index);
+		} else if(!next_source.empty() && next_source.back() == '\n') {
+			current_line += 1;
+			last_nl_index = static_cast<int>(next_source.size() - 1);
+		}
 		if(last_nl_index != -1) {
 			current_character = next_source.size() - last_nl_index;
 		} else {
@@ -110,29 +124,38 @@ struct statement_reader {
 		if(status.code == ECSACT_PARSE_STATUS_OK) {
 			// We've reached the end of the current statement. Pop it off the stack.
 			statements.pop();
-			sources.pop();
+			pop_source();
 			current_context = nullptr;
 		} else if(status.code == ECSACT_PARSE_STATUS_ASSUMED_STATEMENT_END) {
 			// A valid statement was parsed without a statement end being reached. It
 			// is expected to not call `pump_status_code` if reading more is required,
 			// but this is a "successful" parse. Treated the same as status OK.
 			statements.pop();
-			sources.pop();
+			pop_source();
 			current_context = nullptr;
 		} else if(status.code == ECSACT_PARSE_STATUS_BLOCK_END) {
 			// We've reached the end of the current statement and the current block.
 			// Pop the current and pop the block.
 			statements.pop();
-			sources.pop();
+			pop_source();
 			statements.pop();
-			sources.pop();
+			pop_source();
 			current_context = nullptr;
 		}
 	}
 
+	/**
+	 * Pops the last statement and reads the same source again on the next
+	 * `read_next`. Only one source may be rewound at a time.
+	 */
 	void pop_rewind() {
-		auto& last_source = sources.top();
-		next_statement_sources.push_back(last_source);
+		assert(!rewound_source);
+		rewound_source = sources.top();
+		if constexpr(!buffered) {
+			// The source stays in the arena until it is read again
+			rewound_source_mark = source_marks.top();
+			source_marks.pop();
+		}
 		statements.pop();
 		sources.pop();
 		current_context = nullptr;
@@ -140,11 +163,123 @@ struct statement_reader {
 
 	void pop_discard() {
 		statements.pop();
-		sources.pop();
+		pop_source();
 		current_context = nullptr;
 	}
+
+private:
+	void pop_source() {
+		sources.pop();
+		if constexpr(!buffered) {
+			arena.rewind(source_marks.top());
+			source_marks.pop();
+		}
+	}
+
+	/**
+	 * @returns whether @p next_source is exactly what a single read up to the
+	 *          next statement ending character returned
+	 */
+	bool read_next_source(std::string_view& next_source) {
+		const bool assumed_end =
+			status.code == ECSACT_PARSE_STATUS_ASSUMED_STATEMENT_END;
+		const bool single_read = !rewound_source;
+
+		if constexpr(buffered) {
+			if(!rewound_source || assumed_end) {
+				next_source = stream.get_until(statement_ending_chars);
+			}
+
+			if(rewound_source && assumed_end) {
+				// A rewound source is always the last thing read from the buffer so
+				// joining it with the next read is just widening the view.
+				assert(
+					rewound_source->data() + rewound_source->size() == next_source.data()
+				);
+				next_source = std::string_view{
+					rewound_source->data(),
+					rewound_source->size() + next_source.size(),
+				};
+			} else if(rewound_source) {
+				next_source = *rewound_source;
+			}
+		} else {
+			if(rewound_source && !assumed_end) {
+				next_source = *rewound_source;
+				source_marks.push(rewound_source_mark);
+			} else {
+				if(rewound_source) {
+					// Nothing was written after the rewound source so the next read can
+					// continue right where it ends.
+					arena.resume_source(rewound_source_mark, rewound_source->size());
+				} else {
+					arena.begin_source();
+				}
+				ecsact::detail::stream_get_until(
+					stream,
+					arena,
+					statement_ending_chars
+				);
+				next_source = arena.source();
+				source_marks.push(arena.source_mark());
+			}
+		}
+
+		rewound_source = std::nullopt;
+		return single_read;
+	}
 };
 
+/**
+ * How many errors an evaluation may report before it stops. See
+ * `eval_files_options::max_errors` and
+ * `eval_files_options::stop_at_first_failing_file`.
+ */
+struct error_budget {
+	std::size_t max_errors = 0;
+	bool        first_failing_file_only = false;
+
+	/**
+	 * Whether @p errors already used up the budget and nothing more should be
+	 * evaluated
+	 */
+	auto exhausted(const std::vector<parse_eval_error>& errors) const -> bool {
+		return max_errors > 0 && errors.size() >= max_errors;
+	}
+
+	/**
+	 * Same as `exhausted` once a whole file is done
+	 */
+	auto exhausted_after_file( //
+		const std::vector<parse_eval_error>& errors
+	) const -> bool {
+		return exhausted(errors) || (first_failing_file_only && !errors.empty());
+	}
+
+	/**
+	 * Drops the errors of @p errors that don't fit the budget
+	 */
+	void trim(std::vector<parse_eval_error>& errors) const {
+		if(first_failing_file_only && !errors.empty()) {
+			auto first_source_index = errors.front().source_index;
+			std::erase_if(errors, [&](const parse_eval_error& err) {
+				return err.source_index != first_source_index;
+			});
+		}
+		if(max_errors > 0 && errors.size() > max_errors) {
+			errors.resize(max_errors);
+		}
+	}
+};
+
+inline auto error_budget_of(const eval_files_options& options)
+	-> error_budget {
+	return error_budget{
+		.max_errors = static_cast<std::size_t>(std::max(options.max_errors, 0)),
+		.first_failing_file_only = options.stop_at_first_failing_file,
+	};
+}
+
 template<typename InputStream>
 struct eval_parse_state {
 	std::filesystem::path            file_path;
@@ -153,181 +288,444 @@ struct eval_parse_state {
 	bool                             main_package = false;
 	std::string                      package_name;
 	std::vector<std::string>         imports;
+
+	/**
+	 * Offset of each import name in the tape source
+	 */
+	std::vector<int32_t> import_offsets;
+	eval_counters        counters;
+
+	/**
+	 * Reader position once the import statements were read. Errors evaluating
+	 * imports are reported here.
+	 */
+	source_position imports_end;
+
+	/**
+	 * Statements read so far. `reader` is only ever used to read more of the
+	 * tape, every phase reads statements from here.
+	 */
+	statement_tape tape;
+
+	/**
+	 * Index of the first tape statement no phase has handled yet
+	 */
+	std::size_t tape_cursor = 0;
 };
 
+/**
+ * Reads one more statement from the reader of @p state onto its tape. Returns
+ * false if the reader has nothing left. Only buffered readers may fill a tape
+ * since statements view their source.
+ */
 template<typename InputStream>
-parse_eval_error to_parse_eval_error(
-	int32_t                              source_index,
-	const statement_reader<InputStream>& reader
-) {
-	std::string error_message;
+bool read_tape_statement(eval_parse_state<InputStream>& state) {
+	static_assert(statement_reader<InputStream>::buffered);
 
-	switch(reader.status.code) {
-		case ECSACT_PARSE_STATUS_SYNTAX_ERROR:
-			error_message = "Failed to parse statement. Syntax error.";
-			break;
-		case ECSACT_PARSE_STATUS_UNEXPECTED_EOF:
-			error_message = "Failed to parse statement. Unexpected EOF.";
-			break;
-		default:
-			error_message = "Unknown parse error.";
-			break;
+	auto& reader = state.reader;
+	if(!reader.can_read_next()) {
+		return false;
+	}
+
+	auto source = reader.stream.buffer;
+	auto depth = static_cast<int32_t>(reader.statements.size());
+	reader.read_next();
+
+	auto statement_source = reader.sources.top();
+	state.tape.source = source;
+	state.tape.statements.push_back(tape_statement{
+		.statement = reader.statements.top(),
+		.status = reader.status,
+		.position = reader.position(),
+		.source_offset =
+			static_cast<int32_t>(statement_source.data() - source.data()),
+		.source_length = static_cast<int32_t>(statement_source.size()),
+		.depth = depth,
+	});
+
+	// Statements that failed to parse stay on the stack as the context of the
+	// next statement.
+	if(!ecsact_is_error_parse_status_code(reader.status.code)) {
+		reader.pump_status_code();
+	}
+
+	return true;
+}
+
+/**
+ * Reads everything left in the reader of @p state onto its tape. Returns the
+ * tape size.
+ */
+template<typename InputStream>
+auto read_tape(eval_parse_state<InputStream>& state) -> std::size_t {
+	while(read_tape_statement(state)) {
+	}
+	return state.tape.statements.size();
+}
+
+/**
+ * Tape statement at the cursor of @p state, read first if it isn't on the tape
+ * yet. Null once the source has nothing left. Only valid until the tape grows.
+ */
+template<typename InputStream>
+auto next_tape_statement(eval_parse_state<InputStream>& state)
+	-> const tape_statement* {
+	if(state.tape_cursor == state.tape.statements.size()) {
+		if(!read_tape_statement(state)) {
+			return nullptr;
+		}
 	}
 
+	return &state.tape.statements[state.tape_cursor];
+}
+
+/**
+ * Forgets what the phases got from the tape of @p state so far. The statements
+ * stay on the tape, so the phases handle them again without parsing them again.
+ */
+template<typename InputStream>
+void rewind_tape(eval_parse_state<InputStream>& state) {
+	state.main_package = false;
+	state.package_name.clear();
+	state.imports.clear();
+	state.import_offsets.clear();
+	state.counters = {};
+	state.tape_cursor = 0;
+}
+
+inline parse_eval_error to_parse_eval_error(
+	int32_t             source_index,
+	source_position     position,
+	ecsact_parse_status status
+) {
 	return parse_eval_error{
+		.parse_status = status.code,
 		.source_index = source_index,
-		.line = reader.current_line,
-		.character = reader.current_character,
-		.error_message = error_message,
+		.line = position.line,
+		.character = position.character,
 	};
 }
 
-template<typename InputStream>
-parse_eval_error to_parse_eval_error(
-	int32_t                              source_index,
-	const statement_reader<InputStream>& reader,
-	ecsact_eval_error                    eval_err
+/**
+ * The relevant content of @p eval_err is only kept if it is part of @p source
+ */
+inline parse_eval_error to_parse_eval_error(
+	int32_t           source_index,
+	source_position   position,
+	ecsact_eval_error eval_err,
+	std::string_view  source
 ) {
-	std::string relevant_content(
-		eval_err.relevant_content.data,
-		eval_err.relevant_content.length
-	);
-	std::string err_code_str;
-	switch(eval_err.code) {
-		default:
-			err_code_str = magic_enum::enum_name(eval_err.code);
-			if(!err_code_str.empty()) {
-				err_code_str = magic_enum::enum_name(eval_err.code).substr(16);
-			} else {
-				assert(false && "Magic Enum failed to get error name");
-			}
-			break;
-	}
+	auto err = parse_eval_error{
+		.eval_error = eval_err.code,
+		.source_index = source_index,
+		.line = position.line,
+		.character = position.character,
+	};
 
-	std::string error_message = err_code_str + " (" +
-		std::to_string(magic_enum::enum_integer(eval_err.code)) + ")";
-	if(!relevant_content.empty()) {
-		error_message += " near: " + relevant_content;
+	auto content = eval_err.relevant_content;
+	auto less = std::less<const char*>{};
+	auto source_end = source.data() + source.size();
+	if(content.data && !less(content.data, source.data()) &&
+		 !less(source_end, content.data + content.length)) {
+		err.content_offset = static_cast<int>(content.data - source.data());
+		err.content_length = content.length;
 	}
 
+	return err;
+}
+
+/**
+ * Error about the import at @p import_index of @p state
+ */
+template<typename InputStream>
+parse_eval_error to_import_error(
+	int32_t                              source_index,
+	const eval_parse_state<InputStream>& state,
+	std::size_t                          import_index,
+	ecsact_eval_error_code               code
+) {
 	return parse_eval_error{
-		.eval_error = eval_err.code,
+		.eval_error = code,
 		.source_index = source_index,
-		.line = reader.current_line,
-		.character = reader.current_character,
-		.error_message = error_message,
+		.line = state.imports_end.line,
+		.character = state.imports_end.character,
+		.content_offset = state.import_offsets[import_index],
+		.content_length = static_cast<int>(state.imports[import_index].size()),
 	};
 }
 
 template<typename InputStream>
-void parse_package_statements(
-	std::vector<eval_parse_state<InputStream>>& file_states,
-	std::vector<parse_eval_error>&              out_errors
+void parse_package_statement(
+	int32_t                        source_index,
+	eval_parse_state<InputStream>& state,
+	std::vector<parse_eval_error>& out_errors
 ) {
-	auto source_index = 0;
-	for(auto& state : file_states) {
-		while(state.reader.can_read_next()) {
-			state.reader.read_next();
+	while(auto entry = next_tape_statement(state)) {
+		if(ecsact_is_error_parse_status_code(entry->status.code)) {
+			out_errors.push_back(
+				to_parse_eval_error(source_index, entry->position, entry->status)
+			);
+			break;
+		}
 
-			if(ecsact_is_error_parse_status_code(state.reader.status.code)) {
-				out_errors.push_back(to_parse_eval_error(source_index, state.reader));
-				break;
-			}
+		auto& statement = entry->statement;
+		state.tape_cursor += 1;
 
-			auto& statement = state.reader.statements.top();
+		if(statement.type == ECSACT_STATEMENT_NONE) {
+			continue;
+		}
 
-			if(statement.type == ECSACT_STATEMENT_NONE) {
-				state.reader.pump_status_code();
-				continue;
-			}
+		if(statement.type != ECSACT_STATEMENT_PACKAGE) {
+			out_errors.push_back(parse_eval_error{
+				.eval_error = ECSACT_EVAL_ERR_EXPECTED_PACKAGE_STATEMENT,
+				.source_index = source_index,
+				.line = entry->position.line,
+				.character = entry->position.character,
+			});
+		} else {
+			state.counters.count_statement(statement.type);
+			state.main_package = statement.data.package_statement.main;
+			state.package_name = std::string(
+				statement.data.package_statement.package_name.data,
+				statement.data.package_statement.package_name.length
+			);
+		}
 
-			if(statement.type != ECSACT_STATEMENT_PACKAGE) {
-				out_errors.push_back(parse_eval_error{
-					.eval_error = ECSACT_EVAL_ERR_EXPECTED_PACKAGE_STATEMENT,
-					.source_index = source_index,
-					.line = state.reader.current_line,
-					.character = state.reader.current_character,
-					.error_message = "Must have package statement as first statement in "
-													 "file.",
-				});
-			} else {
-				state.main_package = statement.data.package_statement.main;
-				state.package_name = std::string(
-					statement.data.package_statement.package_name.data,
-					statement.data.package_statement.package_name.length
-				);
+		break;
+	}
+}
+
+template<typename InputStream>
+void parse_file_imports(
+	int32_t                        source_index,
+	eval_parse_state<InputStream>& state,
+	std::vector<parse_eval_error>& out_errors,
+	const error_budget&            budget = {}
+) {
+	while(auto entry = next_tape_statement(state)) {
+		if(ecsact_is_error_parse_status_code(entry->status.code)) {
+			out_errors.push_back(
+				to_parse_eval_error(source_index, entry->position, entry->status)
+			);
+			state.tape_cursor += 1;
+			if(budget.exhausted(out_errors)) {
+				break;
 			}
+			continue;
+		}
 
-			state.reader.pump_status_code();
+		auto& statement = entry->statement;
+		if(statement.type == ECSACT_STATEMENT_NONE) {
+			state.tape_cursor += 1;
+			continue;
+		}
+
+		// The first declaration is left at the cursor for the declarations phase
+		if(statement.type != ECSACT_STATEMENT_IMPORT) {
 			break;
 		}
 
-		source_index += 1;
+		auto& import_name = statement.data.import_statement.import_package_name;
+		state.counters.count_statement(statement.type);
+		state.imports.push_back(std::string(import_name.data, import_name.length));
+		state.import_offsets.push_back(
+			static_cast<int32_t>(import_name.data - state.tape.source.data())
+		);
+		state.tape_cursor += 1;
 	}
+
+	state.imports_end = state.reader.position();
+}
+
+/**
+ * Runs @p fn(source_index, state, errors) for every file state. With more than
+ * one job the files are processed concurrently, so @p fn must not touch any
+ * shared state (e.g. the resolver runtime.) Errors are always appended to
+ * @p out_errors in `source_index` order regardless of completion order. Only
+ * sequential runs stop early once @p budget is exhausted.
+ */
+template<typename InputStream, typename Fn>
+void for_each_file_state(
+	std::vector<eval_parse_state<InputStream>>& file_states,
+	std::vector<parse_eval_error>&              out_errors,
+	int                                         jobs,
+	const error_budget&                         budget,
+	Fn&&                                        fn
+) {
+	if(jobs <= 1 || file_states.size() <= 1) {
+		for(size_t index = 0; file_states.size() > index; ++index) {
+			fn(static_cast<int32_t>(index), file_states[index], out_errors);
+			if(budget.exhausted_after_file(out_errors)) {
+				break;
+			}
+		}
+		return;
+	}
+
+	auto file_errors =
+		std::vector<std::vector<parse_eval_error>>(file_states.size());
+
+	parallel_for(file_states.size(), jobs, [&](size_t index) {
+		fn(static_cast<int32_t>(index), file_states[index], file_errors[index]);
+	});
+
+	for(auto& errors : file_errors) {
+		out_errors.insert(
+			out_errors.end(),
+			std::make_move_iterator(errors.begin()),
+			std::make_move_iterator(errors.end())
+		);
+	}
+}
+
+template<typename InputStream>
+void parse_package_statements(
+	std::vector<eval_parse_state<InputStream>>& file_states,
+	std::vector<parse_eval_error>&              out_errors,
+	int                                         jobs = 1,
+	const error_budget&                         budget = {}
+) {
+	for_each_file_state(
+		file_states,
+		out_errors,
+		jobs,
+		budget,
+		[](auto source_index, auto& state, auto& errors) {
+			parse_package_statement(source_index, state, errors);
+		}
+	);
 }
 
 template<typename InputStream>
 void parse_imports(
 	std::vector<eval_parse_state<InputStream>>& file_states,
-	std::vector<parse_eval_error>&              out_errors
+	std::vector<parse_eval_error>&              out_errors,
+	int                                         jobs = 1,
+	const error_budget&                         budget = {}
 ) {
-	auto source_index = 0;
-	for(auto& state : file_states) {
-		while(state.reader.can_read_next()) {
-			state.reader.read_next();
+	for_each_file_state(
+		file_states,
+		out_errors,
+		jobs,
+		budget,
+		[&](auto source_index, auto& state, auto& errors) {
+			parse_file_imports(source_index, state, errors, budget);
+		}
+	);
+}
 
-			if(ecsact_is_error_parse_status_code(state.reader.status.code)) {
-				out_errors.push_back(to_parse_eval_error(source_index, state.reader));
-			} else {
-				ecsact_statement& statement = state.reader.statements.top();
-				if(statement.type == ECSACT_STATEMENT_NONE) {
-					state.reader.pump_status_code();
-					continue;
-				}
-				if(statement.type != ECSACT_STATEMENT_IMPORT) {
-					state.reader.pop_rewind();
-					break;
-				}
-				state.imports.push_back(std::string(
-					statement.data.import_statement.import_package_name.data,
-					statement.data.import_statement.import_package_name.length
-				));
+/**
+ * Maps each package name to the index of the first file state declaring it.
+ */
+template<typename InputStream>
+auto index_package_names( //
+	const std::vector<eval_parse_state<InputStream>>& file_states
+) -> std::unordered_map<std::string_view, std::size_t> {
+	auto index = std::unordered_map<std::string_view, std::size_t>{};
+	index.reserve(file_states.size());
+	for(std::size_t i = 0; file_states.size() > i; ++i) {
+		index.try_emplace(file_states[i].package_name, i);
+	}
+	return index;
+}
+
+/**
+ * Import edges between file states by index. Imports of unknown packages and
+ * of a file's own package are left out.
+ */
+struct import_graph {
+	/** `imports[i]` are the states that state `i` imports */
+	std::vector<std::vector<std::size_t>> imports;
+	/** `importers[i]` are the states that import state `i` */
+	std::vector<std::vector<std::size_t>> importers;
+};
+
+template<typename InputStream>
+auto make_import_graph(
+	const std::vector<eval_parse_state<InputStream>>&         file_states,
+	const std::unordered_map<std::string_view, std::size_t>& package_index
+) -> import_graph {
+	auto graph = import_graph{};
+	graph.imports.resize(file_states.size());
+	graph.importers.resize(file_states.size());
 
-				state.reader.pump_status_code();
+	for(std::size_t i = 0; file_states.size() > i; ++i) {
+		for(auto& import_name : file_states[i].imports) {
+			auto itr = package_index.find(import_name);
+			if(itr == package_index.end() || itr->second == i) {
+				continue;
 			}
+
+			graph.imports[i].push_back(itr->second);
+			graph.importers[itr->second].push_back(i);
 		}
+	}
 
-		source_index += 1;
+	return graph;
+}
+
+/**
+ * Kahn's algorithm over @p graph. Every state comes after the states it
+ * imports. States in, or depending on, an import cycle are not in the result.
+ */
+inline auto topological_order(const import_graph& graph)
+	-> std::vector<std::size_t> {
+	auto pending_imports = std::vector<std::size_t>{};
+	pending_imports.reserve(graph.imports.size());
+	for(auto& imports : graph.imports) {
+		pending_imports.push_back(imports.size());
+	}
+
+	// The result doubles as the queue. Everything before `next` is done.
+	auto order = std::vector<std::size_t>{};
+	order.reserve(graph.imports.size());
+	for(std::size_t i = 0; pending_imports.size() > i; ++i) {
+		if(pending_imports[i] == 0) {
+			order.push_back(i);
+		}
+	}
+
+	for(std::size_t next = 0; order.size() > next; ++next) {
+		for(auto importer : graph.importers[order[next]]) {
+			pending_imports[importer] -= 1;
+			if(pending_imports[importer] == 0) {
+				order.push_back(importer);
+			}
+		}
 	}
+
+	return order;
 }
 
+/**
+ * Reports imports that are not one of @p file_states packages or one of the
+ * already evaluated @p external_packages.
+ */
 template<typename InputStream>
 void check_unknown_imports(
 	std::vector<eval_parse_state<InputStream>>& file_states,
-	std::vector<parse_eval_error>&              out_errors
+	std::vector<parse_eval_error>&              out_errors,
+	const std::unordered_set<std::string_view>& external_packages = {}
 ) {
+	auto package_index = index_package_names(file_states);
+
 	auto source_index = 0;
 	for(auto& state : file_states) {
-		for(auto& import_name : state.imports) {
-			bool found_import = false;
-			for(auto& other_state : file_states) {
-				if(state.package_name == other_state.package_name) {
-					continue;
-				}
+		for(std::size_t i = 0; state.imports.size() > i; ++i) {
+			auto& import_name = state.imports[i];
 
-				if(import_name == other_state.package_name) {
-					found_import = true;
-					break;
-				}
-			}
+			// Importing your own package is treated the same as an unknown import
+			bool found_import = import_name != state.package_name &&
+				(package_index.contains(import_name) ||
+				 external_packages.contains(import_name));
 
 			if(!found_import) {
-				out_errors.push_back({
-					.source_index = source_index,
-					.line = state.reader.current_line,
-					.character = state.reader.current_character,
-					.error_message = "Unknown import package '" + import_name + "'",
-				});
+				out_errors.push_back(to_import_error(
+					source_index,
+					state,
+					i,
+					ECSACT_EVAL_ERR_UNKNOWN_IMPORT
+				));
 			}
 		}
 
@@ -340,6 +738,71 @@ void check_cyclic_imports(
 	std::vector<eval_parse_state<InputStream>>& file_states,
 	std::vector<parse_eval_error>&              out_errors
 ) {
+	auto package_index = index_package_names(file_states);
+	auto graph = make_import_graph(file_states, package_index);
+	auto order = topological_order(graph);
+	if(order.size() == file_states.size()) {
+		return;
+	}
+
+	auto in_cycle = std::vector<bool>(file_states.size(), true);
+	for(auto i : order) {
+		in_cycle[i] = false;
+	}
+
+	// What is left also has states that only import a cycle without being part
+	// of one. Peel those off from the importer side so only the states actually
+	// making up cycles are reported.
+	auto pending_importers = std::vector<std::size_t>(file_states.size(), 0);
+	auto peel = std::vector<std::size_t>{};
+	for(std::size_t i = 0; file_states.size() > i; ++i) {
+		if(!in_cycle[i]) {
+			continue;
+		}
+		for(auto importer : graph.importers[i]) {
+			if(in_cycle[importer]) {
+				pending_importers[i] += 1;
+			}
+		}
+		if(pending_importers[i] == 0) {
+			peel.push_back(i);
+		}
+	}
+
+	while(!peel.empty()) {
+		auto i = peel.back();
+		peel.pop_back();
+		in_cycle[i] = false;
+		for(auto imported : graph.imports[i]) {
+			if(in_cycle[imported]) {
+				pending_importers[imported] -= 1;
+				if(pending_importers[imported] == 0) {
+					peel.push_back(imported);
+				}
+			}
+		}
+	}
+
+	for(std::size_t i = 0; file_states.size() > i; ++i) {
+		if(!in_cycle[i]) {
+			continue;
+		}
+
+		auto& state = file_states[i];
+		for(std::size_t j = 0; state.imports.size() > j; ++j) {
+			auto itr = package_index.find(state.imports[j]);
+			if(itr == package_index.end() || !in_cycle[itr->second]) {
+				continue;
+			}
+
+			out_errors.push_back(to_import_error(
+				static_cast<int32_t>(i),
+				state,
+				j,
+				ECSACT_EVAL_ERR_CYCLIC_IMPORT
+			));
+		}
+	}
 }
 
 template<typename InputStream>
@@ -371,7 +834,8 @@ void eval_imports(
 	eval_parse_state<InputStream>& file_state,
 	std::vector<parse_eval_error>& out_errors
 ) {
-	for(auto& import_name : file_state.imports) {
+	for(std::size_t i = 0; file_state.imports.size() > i; ++i) {
+		auto&            import_name = file_state.imports[i];
 		ecsact_statement faux_import_statement{
 			.type = ECSACT_STATEMENT_IMPORT,
 			.data{.import_statement{
@@ -387,114 +851,457 @@ void eval_imports(
 
 		if(eval_err.code != ECSACT_EVAL_OK) {
 			out_errors.push_back(
-				to_parse_eval_error(source_index, file_state.reader, eval_err)
+				to_import_error(source_index, file_state, i, eval_err.code)
 			);
 		}
 	}
 }
 
-template<typename InputStream>
-void skip_until_current_block_end(statement_reader<InputStream>& reader) {
-	assert(reader.status.code == ECSACT_PARSE_STATUS_BLOCK_BEGIN);
-	int block_depth = 1;
-	while(block_depth > 0) {
-		if(!reader.can_read_next()) {
-			break;
-		}
-
-		reader.read_next();
-		if(reader.status.code == ECSACT_PARSE_STATUS_BLOCK_BEGIN) {
-			block_depth += 1;
-		} else if(reader.status.code == ECSACT_PARSE_STATUS_BLOCK_END) {
-			block_depth -= 1;
-		}
-
-		reader.pump_status_code();
-	}
-}
-
+/**
+ * Evaluates the tape statements of @p file_state from its cursor on, reading
+ * whatever is not on the tape yet. Statements inside a block that failed to
+ * evaluate are skipped. Stops as soon as @p budget is exhausted.
+ */
 template<typename InputStream>
 void parse_eval_declarations(
 	int32_t                        source_index,
 	eval_parse_state<InputStream>& file_state,
-	std::vector<parse_eval_error>& out_errors
+	std::vector<parse_eval_error>& out_errors,
+	const error_budget&            budget = {}
 ) {
-	while(file_state.reader.can_read_next()) {
-		file_state.reader.read_next();
+	auto span = scoped_trace_span{
+		"file",
+		"parse_eval_declarations",
+		file_state.file_path,
+	};
 
-		if(ecsact_is_error_parse_status_code(file_state.reader.status.code)) {
-			out_errors.push_back(to_parse_eval_error(source_index, file_state.reader)
+	auto& tape = file_state.tape;
+
+	// Context of the current statement followed by the statement itself
+	auto statements = small_stack<ecsact_statement, 16>{};
+
+	while(auto entry = next_tape_statement(file_state)) {
+		statements.resize(static_cast<std::size_t>(entry->depth));
+		statements.push(entry->statement);
+		auto code = entry->status.code;
+
+		if(ecsact_is_error_parse_status_code(code)) {
+			out_errors.push_back(
+				to_parse_eval_error(source_index, entry->position, entry->status)
 			);
+			if(budget.exhausted(out_errors)) {
+				return;
+			}
+			file_state.tape_cursor += 1;
 			continue;
 		}
 
+		auto& statement = statements.top();
+		if(statement.type != ECSACT_STATEMENT_NONE) {
+			file_state.counters.count_statement(statement.type);
+		}
+
 		auto eval_err = ecsact_eval_statement(
 			*file_state.package_id,
-			static_cast<int32_t>(file_state.reader.statements.size()),
-			file_state.reader.statements.data()
+			static_cast<int32_t>(statements.size()),
+			statements.data()
 		);
 
-		if(eval_err.code == ECSACT_EVAL_OK) {
+		if(eval_err.code == ECSACT_EVAL_OK && statements.size() > 1) {
 			ecsact::detail::check_file_eval_error(
 				eval_err,
 				*file_state.package_id,
-				file_state.reader.status,
-				*file_state.reader.current_context,
+				entry->status,
+				statements.data()[statements.size() - 2],
 				""
 			);
 		}
 
 		if(eval_err.code == ECSACT_EVAL_OK) {
-			file_state.reader.pump_status_code();
-		} else {
-			out_errors.push_back(
-				to_parse_eval_error(source_index, file_state.reader, eval_err)
-			);
+			file_state.tape_cursor += 1;
+			continue;
+		}
 
-			if(file_state.reader.status.code == ECSACT_PARSE_STATUS_BLOCK_BEGIN) {
-				skip_until_current_block_end(file_state.reader);
-			} else {
-				file_state.reader.pump_status_code();
-			}
+		out_errors.push_back(to_parse_eval_error(
+			source_index,
+			entry->position,
+			eval_err,
+			tape.source
+		));
+		if(budget.exhausted(out_errors)) {
+			return;
+		}
+
+		if(code == ECSACT_PARSE_STATUS_BLOCK_BEGIN) {
+			read_tape(file_state);
+			file_state.tape_cursor = tape.skip_block(file_state.tape_cursor);
+		} else {
+			file_state.tape_cursor += 1;
 		}
 	}
 }
 
+/**
+ * Indices of @p file_states ordered so each state comes after the states it
+ * imports. Expects `check_unknown_imports` and `check_cyclic_imports` to have
+ * passed.
+ */
 template<typename InputStream>
 inline auto get_sorted_states(
 	std::vector<eval_parse_state<InputStream>>& file_states
-) -> std::vector<std::reference_wrapper<eval_parse_state<InputStream>>> {
-	auto result =
-		std::vector<std::reference_wrapper<eval_parse_state<InputStream>>>{};
-	result.reserve(file_states.size());
+) -> std::vector<std::size_t> {
+	auto package_index = index_package_names(file_states);
+	auto graph = make_import_graph(file_states, package_index);
+	auto result = topological_order(graph);
 
-	auto resolved_packages = std::unordered_set<std::string>{};
-	resolved_packages.reserve(file_states.size());
+	assert(result.size() == file_states.size());
+	return result;
+}
 
-	while(resolved_packages.size() != file_states.size()) {
-		for(auto& state : file_states) {
-			if(resolved_packages.contains(state.package_name)) {
-				continue;
+/**
+ * Adds the objects the resolver runtime holds for each evaluated package in
+ * @p file_states to @p out_counts
+ */
+template<typename InputStream>
+void count_created_objects(
+	const std::vector<eval_parse_state<InputStream>>& file_states,
+	eval_object_counts&                               out_counts
+) {
+	auto count_fields = [&](auto id) {
+		out_counts.fields +=
+			ecsact_meta_count_fields(ecsact_id_cast<ecsact_composite_id>(id));
+	};
+
+	for(auto& state : file_states) {
+		if(!state.package_id) {
+			continue;
+		}
+
+		auto package_id = *state.package_id;
+		out_counts.packages += 1;
+		out_counts.components += ecsact_meta_count_components(package_id);
+		out_counts.transients += ecsact_meta_count_transients(package_id);
+		out_counts.systems += ecsact_meta_count_systems(package_id);
+		out_counts.actions += ecsact_meta_count_actions(package_id);
+		out_counts.enums += ecsact_meta_count_enums(package_id);
+
+		for(auto id : ecsact::interpret::views::component_ids(package_id)) {
+			count_fields(id);
+		}
+		for(auto id : ecsact::interpret::views::transient_ids(package_id)) {
+			count_fields(id);
+		}
+		for(auto id : ecsact::interpret::views::action_ids(package_id)) {
+			count_fields(id);
+		}
+	}
+}
+
+template<typename InputStream>
+void eval_file_states_phases(
+	std::vector<eval_parse_state<InputStream>>& file_states,
+	std::vector<parse_eval_error>&              out_errors,
+	int                                         jobs,
+	const std::unordered_set<std::string_view>& external_packages,
+	eval_phase_times*                           times,
+	int                                         pipeline_depth,
+	const error_budget&                         budget
+) {
+	auto phase_time = [&](std::chrono::nanoseconds eval_phase_times::*phase) {
+		return scoped_phase_timer{times ? &(times->*phase) : nullptr};
+	};
+
+	{
+		auto timer = phase_time(&eval_phase_times::parse_package_statements);
+		auto span = scoped_trace_span{"phase", "parse_package_statements"};
+		parse_package_statements(file_states, out_errors, jobs, budget);
+	}
+	if(!out_errors.empty()) {
+		return;
+	}
+
+	{
+		auto timer = phase_time(&eval_phase_times::parse_imports);
+		auto span = scoped_trace_span{"phase", "parse_imports"};
+		parse_imports(file_states, out_errors, jobs, budget);
+	}
+	if(!out_errors.empty()) {
+		return;
+	}
+
+	{
+		auto timer = phase_time(&eval_phase_times::check_imports);
+		auto span = scoped_trace_span{"phase", "check_imports"};
+		check_unknown_imports(file_states, out_errors, external_packages);
+		if(out_errors.empty()) {
+			check_cyclic_imports(file_states, out_errors);
+		}
+	}
+	if(!out_errors.empty()) {
+		return;
+	}
+
+	{
+		auto timer = phase_time(&eval_phase_times::eval_package_statements);
+		auto span = scoped_trace_span{"phase", "eval_package_statements"};
+		eval_package_statements(file_states, out_errors);
+	}
+	if(!out_errors.empty()) {
+		return;
+	}
+
+	auto timer = phase_time(&eval_phase_times::eval_declarations);
+	auto span = scoped_trace_span{"phase", "eval_declarations"};
+	auto order = get_sorted_states(file_states);
+
+	// The calling thread evaluates so one less job is left for reading ahead
+	auto producer_jobs = pipeline_depth > 0 ? std::max(1, jobs - 1) : 0;
+	pipeline_for<std::size_t>(
+		order.size(),
+		producer_jobs,
+		pipeline_depth,
+		[&](std::size_t i) { return read_tape(file_states[order[i]]); },
+		[&](std::size_t i, std::size_t) {
+			auto  source_index = static_cast<int32_t>(order[i]);
+			auto& file_state = file_states[order[i]];
+
+			eval_imports(source_index, file_state, out_errors);
+			if(!out_errors.empty()) {
+				return false;
 			}
 
-			bool imports_resolved = true;
-			for(auto import_name : state.imports) {
-				if(!resolved_packages.contains(import_name)) {
-					imports_resolved = false;
-					break;
-				}
+			auto counters_scope = scoped_eval_counters{file_state.counters};
+			parse_eval_declarations(source_index, file_state, out_errors, budget);
+			return out_errors.empty();
+		}
+	);
+}
+
+/**
+ * Runs every evaluation phase over @p file_states, stopping at the first phase
+ * that reports an error. Imports may also refer to @p external_packages which
+ * must already be evaluated in the resolver runtime.
+ *
+ * When @p stats is set the phase times, counters and created objects are added
+ * to it. See `eval_files_options::pipeline_depth` for @p pipeline_depth.
+ * Errors past @p budget are dropped.
+ */
+template<typename InputStream>
+void eval_file_states(
+	std::vector<eval_parse_state<InputStream>>& file_states,
+	std::vector<parse_eval_error>&              out_errors,
+	int                                         jobs,
+	const std::unordered_set<std::string_view>& external_packages = {},
+	eval_stats*                                 stats = nullptr,
+	int                                         pipeline_depth = 0,
+	const error_budget&                         budget = {}
+) {
+	eval_file_states_phases(
+		file_states,
+		out_errors,
+		jobs,
+		external_packages,
+		stats ? &stats->phase_times : nullptr,
+		pipeline_depth,
+		budget
+	);
+	budget.trim(out_errors);
+
+	if(stats) {
+		for(auto& state : file_states) {
+			state.counters.add_to(*stats);
+		}
+		count_created_objects(file_states, stats->objects_created);
+	}
+}
+
+/**
+ * Whether @p options limit evaluation to the files reachable from some roots
+ */
+inline auto has_roots(const eval_files_options& options) -> bool {
+	return !options.root_packages.empty() || options.main_package_root;
+}
+
+/**
+ * Sources picked by `select_root_sources`
+ */
+struct root_selection {
+	/**
+	 * Indices, in order, of the picked sources
+	 */
+	std::vector<std::size_t> indices;
+
+	/**
+	 * State of each picked source. Their tapes still hold the statements read
+	 * while picking, so evaluating the states doesn't parse those again.
+	 */
+	std::vector<eval_parse_state<buffer_input>> states;
+};
+
+/**
+ * Picks the @p sources declaring one of the root packages of @p options, the
+ * main package when `main_package_root` is set, or a package they
+ * transitively import. Only package and import statements are parsed, and
+ * import statements only of files that turn out to be reachable. Files whose
+ * package statement can't be parsed are always picked so the evaluation of
+ * the picked files reports their errors. Other parse errors are left for
+ * that evaluation too. Roots no file declares are added to @p out_errors.
+ */
+inline auto select_root_sources(
+	std::span<const eval_source>   sources,
+	const eval_files_options&      options,
+	std::vector<parse_eval_error>& out_errors
+) -> root_selection {
+	auto jobs = resolve_job_count(options.jobs);
+	auto states = std::vector<eval_parse_state<buffer_input>>(sources.size());
+	for(std::size_t i = 0; sources.size() > i; ++i) {
+		states[i].file_path = sources[i].file_path;
+		states[i].reader.stream.buffer = sources[i].source;
+	}
+
+	auto header_errors = std::vector<parse_eval_error>{};
+	parse_package_statements(states, header_errors, jobs);
+
+	auto package_files =
+		std::unordered_map<std::string_view, std::vector<std::size_t>>{};
+	auto selected = std::vector<bool>(states.size(), false);
+	auto frontier = std::vector<std::size_t>{};
+
+	auto select = [&](std::size_t index) {
+		if(!selected[index]) {
+			selected[index] = true;
+			frontier.push_back(index);
+		}
+	};
+
+	auto select_package = [&](std::string_view package_name) -> bool {
+		auto itr = package_files.find(package_name);
+		if(itr == package_files.end()) {
+			return false;
+		}
+		for(auto index : itr->second) {
+			select(index);
+		}
+		return true;
+	};
+
+	auto found_main = false;
+	for(std::size_t i = 0; states.size() > i; ++i) {
+		auto& state = states[i];
+		if(state.package_name.empty()) {
+			select(i);
+			continue;
+		}
+
+		package_files[state.package_name].push_back(i);
+		if(options.main_package_root && state.main_package) {
+			found_main = true;
+			select(i);
+		}
+	}
+
+	// Roots are not part of any source so the content of an unknown root error
+	// is the root name itself. Only a message formatted here can show it, see
+	// `eval_files_options::format_messages`.
+	for(auto& root : options.root_packages) {
+		if(!select_package(root)) {
+			auto& err = out_errors.emplace_back(parse_eval_error{
+				.eval_error = ECSACT_EVAL_ERR_UNKNOWN_ROOT_PACKAGE,
+				.content_offset = 0,
+				.content_length = static_cast<int>(root.size()),
+			});
+			if(options.format_messages) {
+				err.error_message = format_error_message(err, root);
 			}
+		}
+	}
+	if(options.main_package_root && !found_main) {
+		auto& err = out_errors.emplace_back(parse_eval_error{
+			.eval_error = ECSACT_EVAL_ERR_NO_MAIN_PACKAGE,
+		});
+		if(options.format_messages) {
+			err.error_message = format_error_message(err, {});
+		}
+	}
 
-			if(imports_resolved) {
-				resolved_packages.insert(state.package_name);
-				result.push_back(std::ref(state));
-				break;
+	// Each pass reads the imports of the files first reached by the pass before
+	while(!frontier.empty()) {
+		auto reached = std::exchange(frontier, {});
+		parallel_for(reached.size(), jobs, [&](std::size_t i) {
+			auto index = reached[i];
+			auto errors = std::vector<parse_eval_error>{};
+			parse_file_imports(static_cast<int32_t>(index), states[index], errors);
+		});
+
+		// Unknown imports are reported when the selected files are evaluated
+		for(auto index : reached) {
+			for(auto& import_name : states[index].imports) {
+				select_package(import_name);
 			}
 		}
 	}
 
-	assert(result.capacity() == result.size());
+	auto result = root_selection{};
+	for(std::size_t i = 0; selected.size() > i; ++i) {
+		if(selected[i]) {
+			rewind_tape(states[i]);
+			result.indices.push_back(i);
+			result.states.push_back(std::move(states[i]));
+		}
+	}
 	return result;
 }
 
+/**
+ * Evaluates only the @p sources picked by the roots of @p options (see
+ * `select_root_sources`) with
+ * @p eval(picked_sources, options_without_roots, selection). @p eval should
+ * evaluate the states of the selection instead of starting over. Source
+ * indices of the returned errors refer to @p sources again and the selection
+ * time is added to the stats.
+ */
+template<typename EvalFn>
+auto eval_root_sources(
+	std::span<const eval_source> sources,
+	eval_files_options           options,
+	EvalFn&&                     eval
+) -> std::vector<parse_eval_error> {
+	auto trace = scoped_trace_file{options.trace_path};
+
+	auto select_time = std::chrono::nanoseconds{};
+	auto errors = std::vector<parse_eval_error>{};
+	auto selection = root_selection{};
+	{
+		auto timer = scoped_phase_timer{options.stats ? &select_time : nullptr};
+		auto span = scoped_trace_span{"phase", "select_roots"};
+		selection = select_root_sources(sources, options, errors);
+	}
+
+	if(errors.empty()) {
+		auto selected = std::vector<eval_source>{};
+		selected.reserve(selection.indices.size());
+		for(auto index : selection.indices) {
+			selected.push_back(sources[index]);
+		}
+
+		options.root_packages.clear();
+		options.main_package_root = false;
+		errors = eval(std::span<const eval_source>{selected}, options, selection);
+		for(auto& err : errors) {
+			if(err.source_index >= 0) {
+				auto index = selection.indices[err.source_index];
+				err.source_index = static_cast<int>(index);
+			}
+		}
+	} else if(options.stats) {
+		*options.stats = {};
+	}
+
+	if(options.stats) {
+		options.stats->phase_times.select_roots = select_time;
+		options.stats->phase_times.total += select_time;
+	}
+	return errors;
+}
+
 } // namespace ecsact::detail
@@ -3,8 +3,6 @@
 #include <string>
 #include "ecsact/interpret/eval.h"
 
-#include "./fixed_stack.hh"
-
 namespace ecsact::detail {
 
 void check_file_eval_error(
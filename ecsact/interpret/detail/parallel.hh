@@ -0,0 +1,194 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace ecsact::detail {
+
+/**
+ * Resolves a user provided job count. Values less than 1 mean 'use the
+ * hardware concurrency'.
+ */
+inline auto resolve_job_count(int jobs) -> int {
+	if(jobs > 0) {
+		return jobs;
+	}
+
+	return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+/**
+ * Calls @p fn for each index in [0, @p count) on up to @p jobs threads. Indices
+ * are handed out in order, but may complete in any order. The first exception
+ * thrown by @p fn is rethrown on the calling thread once all threads finish.
+ */
+template<typename Fn>
+void parallel_for(std::size_t count, int jobs, Fn&& fn) {
+	auto thread_count = std::min(count, static_cast<std::size_t>(jobs));
+	if(thread_count <= 1) {
+		for(std::size_t index = 0; count > index; ++index) {
+			fn(index);
+		}
+		return;
+	}
+
+	auto next_index = std::atomic_size_t{0};
+	auto first_exception = std::exception_ptr{};
+	auto exception_mutex = std::mutex{};
+
+	auto worker = [&] {
+		for(;;) {
+			auto index = next_index.fetch_add(1, std::memory_order_relaxed);
+			if(index >= count) {
+				break;
+			}
+
+			try {
+				fn(index);
+			} catch(...) {
+				auto lk = std::scoped_lock{exception_mutex};
+				if(!first_exception) {
+					first_exception = std::current_exception();
+				}
+			}
+		}
+	};
+
+	auto threads = std::vector<std::thread>{};
+	threads.reserve(thread_count - 1);
+	for(std::size_t i = 1; thread_count > i; ++i) {
+		threads.emplace_back(worker);
+	}
+
+	// The calling thread does work too instead of idling until the others join
+	worker();
+
+	for(auto& thread : threads) {
+		thread.join();
+	}
+
+	if(first_exception) {
+		std::rethrow_exception(first_exception);
+	}
+}
+
+/**
+ * Calls @p produce(index) for each index in [0, @p count) on up to @p jobs
+ * producer threads and hands each result to @p consume(index, result) on the
+ * calling thread in index order. No more than @p depth results are produced
+ * ahead of the one being consumed. When @p consume returns false nothing else
+ * is consumed and producers stop picking up new indices.
+ *
+ * With @p jobs or @p depth less than 1 each index is produced and consumed in
+ * turn on the calling thread. The first exception thrown by either callback is
+ * rethrown on the calling thread once all producers finish.
+ */
+template<typename T, typename Produce, typename Consume>
+void pipeline_for(
+	std::size_t count,
+	int         jobs,
+	int         depth,
+	Produce&&   produce,
+	Consume&&   consume
+) {
+	auto thread_count = std::min(count, static_cast<std::size_t>(jobs));
+	if(thread_count < 1 || depth < 1) {
+		for(std::size_t index = 0; count > index; ++index) {
+			if(!consume(index, produce(index))) {
+				break;
+			}
+		}
+		return;
+	}
+
+	auto results = std::vector<std::optional<T>>(count);
+	auto next_index = std::size_t{0};
+	auto consumed_count = std::size_t{0};
+	auto stopped = false;
+	auto first_exception = std::exception_ptr{};
+	auto mutex = std::mutex{};
+	auto cv = std::condition_variable{};
+
+	auto stop = [&](std::exception_ptr exception) {
+		auto lk = std::scoped_lock{mutex};
+		if(!first_exception) {
+			first_exception = exception;
+		}
+		stopped = true;
+		cv.notify_all();
+	};
+
+	auto producer = [&] {
+		for(;;) {
+			auto index = std::size_t{};
+			{
+				auto lk = std::unique_lock{mutex};
+				cv.wait(lk, [&] {
+					return stopped || next_index >= count ||
+						next_index < consumed_count + static_cast<std::size_t>(depth);
+				});
+				if(stopped || next_index >= count) {
+					break;
+				}
+				index = next_index++;
+			}
+
+			try {
+				auto result = produce(index);
+				auto lk = std::scoped_lock{mutex};
+				results[index] = std::move(result);
+				cv.notify_all();
+			} catch(...) {
+				stop(std::current_exception());
+				break;
+			}
+		}
+	};
+
+	auto threads = std::vector<std::thread>{};
+	threads.reserve(thread_count);
+	for(std::size_t i = 0; thread_count > i; ++i) {
+		threads.emplace_back(producer);
+	}
+
+	try {
+		for(std::size_t index = 0; count > index; ++index) {
+			auto result = std::optional<T>{};
+			{
+				auto lk = std::unique_lock{mutex};
+				cv.wait(lk, [&] { return stopped || results[index].has_value(); });
+				if(stopped) {
+					break;
+				}
+				result = std::move(results[index]);
+				results[index] = std::nullopt;
+				consumed_count = index + 1;
+				cv.notify_all();
+			}
+
+			if(!consume(index, std::move(*result))) {
+				break;
+			}
+		}
+		stop(nullptr);
+	} catch(...) {
+		stop(std::current_exception());
+	}
+
+	for(auto& thread : threads) {
+		thread.join();
+	}
+
+	if(first_exception) {
+		std::rethrow_exception(first_exception);
+	}
+}
+
+} // namespace ecsact::detail
@@ -1,6 +1,22 @@
 #pragma once
 
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <system_error>
 #include <type_traits>
+#include <utility>
+#include <vector>
+#include "ecsact/interpret/eval.hh"
+
+#include "./eval_counters.hh"
+#include "./parallel.hh"
+#include "./simd_scan.hh"
+#include "./trace.hh"
 
 namespace ecsact::detail {
 
@@ -22,4 +38,140 @@ void stream_get_until(auto& stream, auto& output, auto&& delimiters) {
 	}
 }
 
+/**
+ * Input over a contiguous buffer that is owned elsewhere. Reads return views
+ * into the buffer instead of copying. EOF is reported the same way a
+ * `std::istream` would: only after a read runs off the end of the buffer.
+ */
+struct buffer_input {
+	std::string_view buffer;
+	std::size_t      position = 0;
+	bool             reached_end = false;
+
+	explicit operator bool() const noexcept {
+		return !reached_end;
+	}
+
+	bool eof() const noexcept {
+		return reached_end;
+	}
+
+	/**
+	 * Returns everything from the current position up to and including the
+	 * first delimiter, or the rest of the buffer if there is no delimiter.
+	 */
+	template<std::size_t N>
+	auto get_until(const std::array<char, N>& delimiters) -> std::string_view {
+		auto start = position;
+		auto end = find_first_of(buffer, start, delimiters);
+		if(end == std::string_view::npos) {
+			position = buffer.size();
+			reached_end = true;
+			return buffer.substr(start);
+		}
+
+		position = end + 1;
+		return buffer.substr(start, position - start);
+	}
+};
+
+template<typename InputStream>
+constexpr bool is_buffer_input_v =
+	std::is_same_v<std::remove_cvref_t<InputStream>, buffer_input>;
+
+/**
+ * Reads the whole file at @p file_path in text mode. Returns an empty string if
+ * the file cannot be read.
+ */
+inline auto read_file_contents( //
+	const std::filesystem::path& file_path
+) -> std::string {
+	auto contents = std::string{};
+	auto file = std::ifstream{file_path};
+	if(!file) {
+		return contents;
+	}
+
+	auto ec = std::error_code{};
+	auto file_size = std::filesystem::file_size(file_path, ec);
+	if(ec) {
+		return contents;
+	}
+
+	// Text mode may translate line endings so the actual amount read can be
+	// less than the size on disk.
+	contents.resize(file_size);
+	file.read(contents.data(), static_cast<std::streamsize>(file_size));
+	contents.resize(static_cast<std::size_t>(file.gcount()));
+
+	return contents;
+}
+
+/**
+ * Files read into memory for evaluation. Each source views the matching
+ * contents.
+ */
+struct source_files {
+	std::vector<std::string> contents;
+	std::vector<eval_source> sources;
+
+	/** Time spent reading, including any time added by the caller */
+	std::chrono::nanoseconds read_time = {};
+};
+
+/**
+ * Reads every file of @p files on up to @p jobs threads with @p read_fn, which
+ * is given a path and returns its contents.
+ */
+template<typename ReadFn>
+auto read_source_files( //
+	std::vector<std::filesystem::path> files,
+	int                                jobs,
+	ReadFn&&                           read_fn
+) -> source_files {
+	auto result = source_files{};
+	result.contents.resize(files.size());
+	{
+		auto timer = scoped_phase_timer{&result.read_time};
+		auto phase_span = scoped_trace_span{"phase", "read_files"};
+		parallel_for(files.size(), resolve_job_count(jobs), [&](auto i) {
+			auto file_span = scoped_trace_span{"file", "read_file", files[i]};
+			result.contents[i] = read_fn(files[i]);
+		});
+	}
+
+	result.sources.reserve(files.size());
+	for(std::size_t index = 0; files.size() > index; ++index) {
+		result.sources.push_back(eval_source{
+			.file_path = std::move(files[index]),
+			.source = result.contents[index],
+		});
+	}
+
+	return result;
+}
+
+inline auto read_source_files( //
+	std::vector<std::filesystem::path> files,
+	int                                jobs
+) -> source_files {
+	return read_source_files(std::move(files), jobs, [](const auto& file_path) {
+		return read_file_contents(file_path);
+	});
+}
+
+/**
+ * Adds @p read_time to @p stats after an evaluation, which resets the stats it
+ * reports to.
+ */
+inline void record_read_time(
+	eval_stats*              stats,
+	std::chrono::nanoseconds read_time
+) {
+	if(stats) {
+		stats->phase_times.read_files = read_time;
+		stats->phase_times.total += read_time;
+	}
+}
+
 } // namespace ecsact::detail
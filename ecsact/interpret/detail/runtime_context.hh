@@ -0,0 +1,32 @@
+#pragma once
+
+#include "parse-resolver-runtime/context.h"
+
+namespace ecsact::detail {
+
+/**
+ * Makes @p context the calling thread's runtime context for the lifetime of
+ * this object. A null @p context leaves the current context alone.
+ */
+class scoped_runtime_context {
+	ecsact_runtime_context* _previous = nullptr;
+	bool                    _active;
+
+public:
+	explicit scoped_runtime_context(ecsact_runtime_context* context)
+		: _active(context != nullptr) {
+		if(_active) {
+			_previous = ecsact_set_thread_runtime_context(context);
+		}
+	}
+
+	scoped_runtime_context(const scoped_runtime_context&) = delete;
+
+	~scoped_runtime_context() {
+		if(_active) {
+			ecsact_set_thread_runtime_context(_previous);
+		}
+	}
+};
+
+} // namespace ecsact::detail
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if defined(__AVX2__)
+#	include <immintrin.h>
+#	define ECSACT_INTERPRET_SIMD_SCAN_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || \
+	(defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#	include <emmintrin.h>
+#	define ECSACT_INTERPRET_SIMD_SCAN_SSE2
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#	include <arm_neon.h>
+#	define ECSACT_INTERPRET_SIMD_SCAN_NEON
+#endif
+
+namespace ecsact::detail {
+
+/**
+ * One vector register worth of input compared against a few characters at
+ * once. `match_mask` has `mask_bits` bits set for each of the `width` bytes at
+ * `data` equal to any of the splatted characters, the first byte in the lowest
+ * bits.
+ */
+#if defined(ECSACT_INTERPRET_SIMD_SCAN_AVX2)
+struct scan_block {
+	using vector = __m256i;
+
+	static constexpr std::size_t width = 32;
+	static constexpr std::size_t mask_bits = 1;
+
+	static auto splat(char c) -> vector {
+		return _mm256_set1_epi8(c);
+	}
+
+	template<std::size_t N>
+	static auto match_mask(const char* data, const vector (&chars)[N])
+		-> uint64_t {
+		auto block = _mm256_loadu_si256(reinterpret_cast<const vector*>(data));
+		auto matches = _mm256_setzero_si256();
+		for(auto& c : chars) {
+			matches = _mm256_or_si256(matches, _mm256_cmpeq_epi8(block, c));
+		}
+
+		return static_cast<uint32_t>(_mm256_movemask_epi8(matches));
+	}
+};
+#elif defined(ECSACT_INTERPRET_SIMD_SCAN_SSE2)
+struct scan_block {
+	using vector = __m128i;
+
+	static constexpr std::size_t width = 16;
+	static constexpr std::size_t mask_bits = 1;
+
+	static auto splat(char c) -> vector {
+		return _mm_set1_epi8(c);
+	}
+
+	template<std::size_t N>
+	static auto match_mask(const char* data, const vector (&chars)[N])
+		-> uint64_t {
+		auto block = _mm_loadu_si128(reinterpret_cast<const vector*>(data));
+		auto matches = _mm_setzero_si128();
+		for(auto& c : chars) {
+			matches = _mm_or_si128(matches, _mm_cmpeq_epi8(block, c));
+		}
+
+		return static_cast<uint32_t>(_mm_movemask_epi8(matches));
+	}
+};
+#elif defined(ECSACT_INTERPRET_SIMD_SCAN_NEON)
+struct scan_block {
+	using vector = uint8x16_t;
+
+	static constexpr std::size_t width = 16;
+	static constexpr std::size_t mask_bits = 4;
+
+	static auto splat(char c) -> vector {
+		return vdupq_n_u8(static_cast<uint8_t>(c));
+	}
+
+	template<std::size_t N>
+	static auto match_mask(const char* data, const vector (&chars)[N])
+		-> uint64_t {
+		auto block = vld1q_u8(reinterpret_cast<const uint8_t*>(data));
+		auto matches = vdupq_n_u8(0);
+		for(auto& c : chars) {
+			matches = vorrq_u8(matches, vceqq_u8(block, c));
+		}
+
+		// NEON has no movemask. Narrowing each 16 bit lane by 4 leaves 4 bits per
+		// byte in a 64 bit mask instead.
+		auto nibbles = vshrn_n_u16(vreinterpretq_u16_u8(matches), 4);
+		return vget_lane_u64(vreinterpret_u64_u8(nibbles), 0);
+	}
+};
+#endif
+
+template<std::size_t N>
+auto find_first_of_scalar(
+	std::string_view           str,
+	std::size_t                start,
+	const std::array<char, N>& chars
+) -> std::size_t {
+	for(auto index = start; str.size() > index; ++index) {
+		for(auto c : chars) {
+			if(str[index] == c) {
+				return index;
+			}
+		}
+	}
+
+	return std::string_view::npos;
+}
+
+/**
+ * Index of the first character of @p str at or after @p start that is one of
+ * @p chars, or `npos`. Same as `std::string_view::find_first_of` but compares
+ * a whole vector register of input against every character at once where the
+ * target supports it (AVX2, SSE2 or NEON).
+ */
+template<std::size_t N>
+auto find_first_of(
+	std::string_view           str,
+	std::size_t                start,
+	const std::array<char, N>& chars
+) -> std::size_t {
+#if defined(ECSACT_INTERPRET_SIMD_SCAN_AVX2) || \
+	defined(ECSACT_INTERPRET_SIMD_SCAN_SSE2) ||    \
+	defined(ECSACT_INTERPRET_SIMD_SCAN_NEON)
+	constexpr auto width = scan_block::width;
+
+	if(start >= str.size()) {
+		return std::string_view::npos;
+	}
+
+	// Plain array since the vector types carry attributes std::array drops
+	scan_block::vector splatted[N];
+	for(std::size_t i = 0; N > i; ++i) {
+		splatted[i] = scan_block::splat(chars[i]);
+	}
+
+	// Index of the first match in the block at @p offset that is not one of its
+	// first @p skip characters
+	auto first_match = [&](std::size_t offset, std::size_t skip) {
+		auto mask = scan_block::match_mask(str.data() + offset, splatted);
+		mask >>= skip * scan_block::mask_bits;
+		if(mask == 0) {
+			return std::string_view::npos;
+		}
+		return offset + skip + std::countr_zero(mask) / scan_block::mask_bits;
+	};
+
+	auto index = start;
+	for(; str.size() - index >= width; index += width) {
+		if(auto match = first_match(index, 0); match != std::string_view::npos) {
+			return match;
+		}
+	}
+
+	auto remaining = str.size() - index;
+	if(remaining == 0) {
+		return std::string_view::npos;
+	}
+
+	// The last block ends at the end of @p str so it doesn't read past it,
+	// overlapping characters that were already checked
+	if(str.size() >= width) {
+		auto offset = str.size() - width;
+		return first_match(offset, index - offset);
+	}
+
+	// Too short for a whole block. Matches in the padding are ignored.
+	char padded[width] = {};
+	std::memcpy(padded, str.data() + index, remaining);
+	auto mask = scan_block::match_mask(padded, splatted);
+	auto match = static_cast<std::size_t>(std::countr_zero(mask)) /
+		scan_block::mask_bits;
+	if(remaining > match) {
+		return index + match;
+	}
+
+	return std::string_view::npos;
+#else
+	return find_first_of_scalar(str, start, chars);
+#endif
+}
+
+} // namespace ecsact::detail
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace ecsact::detail {
+
+/**
+ * Stack that keeps up to @p InlineSize elements inside itself and moves them
+ * to the heap once it grows past that. Elements are constructed in place in
+ * their slot and slots are reused after a pop.
+ *
+ * Only trivially copyable elements are supported so growing and moving the
+ * stack is a plain copy of the live elements.
+ */
+template<typename T, std::size_t InlineSize>
+class small_stack {
+	static_assert(std::is_trivially_copyable_v<T>);
+	static_assert(std::is_trivially_destructible_v<T>);
+	static_assert(InlineSize > 0);
+
+	std::size_t          _size = 0;
+	std::size_t          _capacity = InlineSize;
+	T*                   _data = _inline;
+	std::unique_ptr<T[]> _heap;
+	T                    _inline[InlineSize];
+
+	/**
+	 * Copy of the live elements in a buffer twice the current capacity. The
+	 * current buffer stays valid until the copy is adopted.
+	 */
+	auto grown_copy() const -> std::unique_ptr<T[]> {
+		auto heap = std::make_unique_for_overwrite<T[]>(_capacity * 2);
+		std::copy_n(_data, _size, heap.get());
+		return heap;
+	}
+
+	auto adopt(std::unique_ptr<T[]> heap) noexcept -> void {
+		_heap = std::move(heap);
+		_data = _heap.get();
+		_capacity *= 2;
+	}
+
+	auto grow() -> void {
+		adopt(grown_copy());
+	}
+
+	auto copy_from(const small_stack& other) -> void {
+		_size = 0;
+		reserve(other._size);
+		std::copy_n(other._data, other._size, _data);
+		_size = other._size;
+	}
+
+	auto move_from(small_stack& other) noexcept -> void {
+		if(other._heap) {
+			_heap = std::move(other._heap);
+			_data = _heap.get();
+			_capacity = other._capacity;
+		} else {
+			_heap.reset();
+			_data = _inline;
+			_capacity = InlineSize;
+			std::copy_n(other._inline, other._size, _inline);
+		}
+
+		_size = other._size;
+		other._size = 0;
+		other._capacity = InlineSize;
+		other._data = other._inline;
+	}
+
+public:
+	using value_type = T;
+	using size_type = std::size_t;
+	using reference = T&;
+	using const_reference = const T&;
+
+	small_stack() = default;
+
+	small_stack(const small_stack& other) {
+		copy_from(other);
+	}
+
+	small_stack(small_stack&& other) noexcept {
+		move_from(other);
+	}
+
+	auto operator=(const small_stack& other) -> small_stack& {
+		if(this != &other) {
+			copy_from(other);
+		}
+		return *this;
+	}
+
+	auto operator=(small_stack&& other) noexcept -> small_stack& {
+		if(this != &other) {
+			move_from(other);
+		}
+		return *this;
+	}
+
+	[[nodiscard]] T* data() noexcept {
+		return _data;
+	}
+
+	[[nodiscard]] const T* data() const noexcept {
+		return _data;
+	}
+
+	[[nodiscard]] reference top() {
+		assert(_size > 0);
+		return _data[_size - 1];
+	}
+
+	[[nodiscard]] const_reference top() const {
+		assert(_size > 0);
+		return _data[_size - 1];
+	}
+
+	[[nodiscard]] size_type size() const noexcept {
+		return _size;
+	}
+
+	[[nodiscard]] bool empty() const noexcept {
+		return _size == 0;
+	}
+
+	/**
+	 * Number of elements that fit before the stack has to grow again
+	 */
+	[[nodiscard]] size_type capacity() const noexcept {
+		return _capacity;
+	}
+
+	/**
+	 * Whether the elements are still stored inside the stack itself
+	 */
+	[[nodiscard]] bool is_inline() const noexcept {
+		return _data == _inline;
+	}
+
+	void reserve(size_type capacity) {
+		while(_capacity < capacity) {
+			grow();
+		}
+	}
+
+	void push(const value_type& value) {
+		emplace(value);
+	}
+
+	/**
+	 * Constructs a new element on top of the stack from @p args. Without any
+	 * arguments the element is value initialized. @p args may refer to elements
+	 * of the stack itself.
+	 */
+	template<typename... Args>
+	reference emplace(Args&&... args) {
+		if(_size == _capacity) {
+			// Construct into the new buffer while the old one, which args may point
+			// into, is still alive
+			auto heap = grown_copy();
+			std::construct_at(heap.get() + _size, std::forward<Args>(args)...);
+			adopt(std::move(heap));
+			return _data[_size++];
+		}
+		return *std::construct_at(_data + _size++, std::forward<Args>(args)...);
+	}
+
+	void pop() noexcept {
+		assert(_size > 0);
+		--_size;
+	}
+
+	void swap(small_stack& other) noexcept {
+		auto tmp = std::move(other);
+		other = std::move(*this);
+		*this = std::move(tmp);
+	}
+
+	/**
+	 * Drops every element. Heap storage is kept for reuse.
+	 */
+	void clear() noexcept {
+		_size = 0;
+	}
+
+	/**
+	 * Drops elements off the top or pushes value initialized ones until there
+	 * are @p size elements
+	 */
+	void resize(size_type size) {
+		reserve(size);
+		for(auto i = _size; size > i; ++i) {
+			std::construct_at(_data + i);
+		}
+		_size = size;
+	}
+};
+
+} // namespace ecsact::detail
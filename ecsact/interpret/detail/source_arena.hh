@@ -0,0 +1,144 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace ecsact::detail {
+
+/**
+ * Bump allocator for statement sources read from a stream. Sources are
+ * written one at a time and released in reverse order, matching how
+ * `statement_reader` pushes and pops its statement stack. Released memory is
+ * kept around so once the arena is warmed up reading does not allocate.
+ *
+ * Finished sources never move. Only the source currently being written may be
+ * moved to a bigger block, which is fine because nothing refers to it yet.
+ */
+class source_arena {
+public:
+	/**
+	 * Position in the arena. Rewinding to a mark releases everything written
+	 * after it.
+	 */
+	struct mark {
+		std::size_t block = 0;
+		std::size_t offset = 0;
+	};
+
+	static constexpr std::size_t default_block_size = 4096;
+
+	using value_type = char;
+
+	/**
+	 * Starts a new empty source after everything still in use.
+	 */
+	void begin_source() noexcept {
+		_begin = _top;
+	}
+
+	/**
+	 * Reopens the last finished source starting at @p source_mark so more can
+	 * be appended to it. The source must still be the last thing written.
+	 */
+	void resume_source(mark source_mark, std::size_t source_size) noexcept {
+		assert(source_mark.block < _blocks.size());
+		_block = source_mark.block;
+		_begin = source_mark.offset;
+		_top = source_mark.offset + source_size;
+	}
+
+	/**
+	 * Start of the source currently being written.
+	 */
+	[[nodiscard]] auto source_mark() const noexcept -> mark {
+		return {_block, _begin};
+	}
+
+	/**
+	 * The source currently being written.
+	 */
+	[[nodiscard]] auto source() const noexcept -> std::string_view {
+		if(_blocks.empty()) {
+			return {};
+		}
+		return {_blocks[_block].data.get() + _begin, _top - _begin};
+	}
+
+	void push_back(char c) {
+		if(_blocks.empty() || _top == _blocks[_block].capacity) {
+			grow();
+		}
+		_blocks[_block].data[_top++] = c;
+	}
+
+	[[nodiscard]] auto back() noexcept -> char& {
+		assert(_top > _begin);
+		return _blocks[_block].data[_top - 1];
+	}
+
+	/**
+	 * Releases @p m and everything written after it.
+	 */
+	void rewind(mark m) noexcept {
+		_block = m.block;
+		_begin = m.offset;
+		_top = m.offset;
+	}
+
+	/**
+	 * Releases everything. Blocks are kept for reuse.
+	 */
+	void clear() noexcept {
+		rewind({});
+	}
+
+private:
+	struct block {
+		std::unique_ptr<char[]> data;
+		std::size_t             capacity = 0;
+	};
+
+	std::vector<block> _blocks;
+	std::size_t        _block = 0;
+	std::size_t        _begin = 0;
+	std::size_t        _top = 0;
+
+	/**
+	 * Moves the source being written to the next block, allocating it if the
+	 * next block does not exist yet or is too small.
+	 */
+	void grow() {
+		auto source_size = _top - _begin;
+		auto next_block = _blocks.empty() ? 0 : _block + 1;
+		auto min_capacity = std::max(default_block_size, source_size * 2);
+
+		if(next_block == _blocks.size()) {
+			_blocks.emplace_back();
+		}
+
+		auto& next = _blocks[next_block];
+		if(next.capacity < min_capacity) {
+			// Blocks past the current one never hold anything in use
+			next.data = std::unique_ptr<char[]>(new char[min_capacity]);
+			next.capacity = min_capacity;
+		}
+
+		if(source_size > 0) {
+			std::copy_n(
+				_blocks[_block].data.get() + _begin,
+				source_size,
+				next.data.get()
+			);
+		}
+
+		_block = next_block;
+		_begin = 0;
+		_top = source_size;
+	}
+};
+
+} // namespace ecsact::detail
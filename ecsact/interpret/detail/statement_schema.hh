@@ -0,0 +1,244 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+#include "ecsact/parse/statements.h"
+
+namespace ecsact::detail {
+
+/**
+ * Set of statement types with one bit per `ecsact_statement_type`
+ */
+using statement_type_mask = uint64_t;
+
+constexpr auto statement_type_bit(ecsact_statement_type type)
+	-> statement_type_mask {
+	return statement_type_mask{1} << static_cast<unsigned>(type);
+}
+
+template<ecsact_statement_type... Types>
+constexpr auto statement_types =
+	(statement_type_mask{} | ... | statement_type_bit(Types));
+
+/**
+ * Every statement parameter the interpreter understands
+ */
+enum class statement_param_name : uint8_t {
+	stream,
+	transient,
+	lazy,
+	parallel,
+};
+
+constexpr auto statement_param_names = std::array<std::string_view, 4>{
+	"stream",
+	"transient",
+	"lazy",
+	"parallel",
+};
+
+using statement_param_mask = uint8_t;
+
+constexpr auto statement_param_bit(statement_param_name name)
+	-> statement_param_mask {
+	return statement_param_mask{1} << static_cast<unsigned>(name);
+}
+
+template<statement_param_name... Names>
+constexpr auto statement_params_of =
+	(statement_param_mask{} | ... | statement_param_bit(Names));
+
+/**
+ * Parameter names all have different lengths so the length alone picks the
+ * only candidate and a single comparison confirms it.
+ */
+constexpr auto statement_param_by_length = [] {
+	auto table = std::array<int8_t, 16>{};
+	table.fill(-1);
+	for(std::size_t i = 0; statement_param_names.size() > i; ++i) {
+		auto& entry = table.at(statement_param_names[i].size());
+		if(entry != -1) {
+			throw "statement parameter names must have unique lengths";
+		}
+		entry = static_cast<int8_t>(i);
+	}
+	return table;
+}();
+
+constexpr auto find_statement_param_name(std::string_view name)
+	-> std::optional<statement_param_name> {
+	if(name.size() >= statement_param_by_length.size()) {
+		return std::nullopt;
+	}
+
+	auto index = statement_param_by_length[name.size()];
+	if(index == -1 || statement_param_names[index] != name) {
+		return std::nullopt;
+	}
+
+	return static_cast<statement_param_name>(index);
+}
+
+/**
+ * What a statement type accepts. `contexts` holds the statement types that may
+ * directly contain it where `ECSACT_STATEMENT_NONE` means the top level.
+ */
+struct statement_schema {
+	statement_type_mask  contexts = 0;
+	statement_param_mask params = 0;
+};
+
+constexpr auto statement_schema_of(ecsact_statement_type type)
+	-> statement_schema {
+	using enum statement_param_name;
+
+	switch(type) {
+		case ECSACT_STATEMENT_NONE:
+		case ECSACT_STATEMENT_UNKNOWN:
+		case ECSACT_STATEMENT_PACKAGE:
+			return {};
+		case ECSACT_STATEMENT_IMPORT:
+		case ECSACT_STATEMENT_TRANSIENT:
+		case ECSACT_STATEMENT_ENUM:
+			return {.contexts = statement_types<ECSACT_STATEMENT_NONE>};
+		case ECSACT_STATEMENT_COMPONENT:
+			return {
+				.contexts = statement_types<ECSACT_STATEMENT_NONE>,
+				.params = statement_params_of<stream, transient>,
+			};
+		case ECSACT_STATEMENT_SYSTEM:
+			return {
+				.contexts = statement_types<
+					ECSACT_STATEMENT_NONE,
+					ECSACT_STATEMENT_SYSTEM,
+					ECSACT_STATEMENT_ACTION>,
+				.params = statement_params_of<lazy, parallel>,
+			};
+		case ECSACT_STATEMENT_ACTION:
+			return {
+				.contexts = statement_types<ECSACT_STATEMENT_NONE>,
+				.params = statement_params_of<parallel>,
+			};
+		case ECSACT_STATEMENT_ENUM_VALUE:
+			return {.contexts = statement_types<ECSACT_STATEMENT_ENUM>};
+		case ECSACT_STATEMENT_BUILTIN_TYPE_FIELD:
+		case ECSACT_STATEMENT_USER_TYPE_FIELD:
+		case ECSACT_STATEMENT_ENTITY_FIELD:
+			return {
+				.contexts = statement_types<
+					ECSACT_STATEMENT_COMPONENT,
+					ECSACT_STATEMENT_TRANSIENT,
+					ECSACT_STATEMENT_ACTION>,
+			};
+		case ECSACT_STATEMENT_SYSTEM_COMPONENT:
+			return {
+				.contexts = statement_types<
+					ECSACT_STATEMENT_SYSTEM,
+					ECSACT_STATEMENT_ACTION,
+					ECSACT_STATEMENT_SYSTEM_COMPONENT,
+					ECSACT_STATEMENT_SYSTEM_WITH>,
+			};
+		case ECSACT_STATEMENT_SYSTEM_GENERATES:
+		case ECSACT_STATEMENT_SYSTEM_NOTIFY:
+			return {
+				.contexts =
+					statement_types<ECSACT_STATEMENT_SYSTEM, ECSACT_STATEMENT_ACTION>,
+			};
+		case ECSACT_STATEMENT_SYSTEM_WITH:
+			return {.contexts = statement_types<ECSACT_STATEMENT_SYSTEM_COMPONENT>};
+		case ECSACT_STATEMENT_ENTITY_CONSTRAINT:
+			return {.contexts = statement_types<ECSACT_STATEMENT_SYSTEM_GENERATES>};
+		case ECSACT_STATEMENT_SYSTEM_NOTIFY_COMPONENT:
+			return {.contexts = statement_types<ECSACT_STATEMENT_SYSTEM_NOTIFY>};
+	}
+
+	return {};
+}
+
+/**
+ * Statement parameters decoded into their accepted value types. A parameter
+ * given a value of any other type is left empty, as if it was never given.
+ */
+struct statement_params {
+	std::optional<std::variant<bool, std::string_view>> stream;
+	std::optional<bool>                                 transient;
+	std::optional<std::variant<bool, int32_t>>          lazy;
+	std::optional<std::variant<bool, std::string_view>> parallel;
+};
+
+template<typename T>
+constexpr auto decode_param_value(const ecsact_statement_parameter_value& value)
+	-> std::optional<T> {
+	if constexpr(std::is_same_v<T, bool>) {
+		if(value.type == ECSACT_STATEMENT_PARAM_VALUE_TYPE_BOOL) {
+			return value.data.bool_value;
+		}
+	} else if constexpr(std::is_same_v<T, int32_t>) {
+		if(value.type == ECSACT_STATEMENT_PARAM_VALUE_TYPE_INTEGER) {
+			return value.data.integer_value;
+		}
+	} else if constexpr(std::is_same_v<T, std::string_view>) {
+		if(value.type == ECSACT_STATEMENT_PARAM_VALUE_TYPE_STRING) {
+			return std::string_view{
+				value.data.string_value.data,
+				static_cast<std::size_t>(value.data.string_value.length),
+			};
+		}
+	}
+
+	return std::nullopt;
+}
+
+template<typename FirstT, typename SecondT>
+constexpr auto decode_param_value(
+	const ecsact_statement_parameter_value& value
+) -> std::optional<std::variant<FirstT, SecondT>> {
+	if(auto first = decode_param_value<FirstT>(value)) {
+		return *first;
+	}
+	if(auto second = decode_param_value<SecondT>(value)) {
+		return *second;
+	}
+	return std::nullopt;
+}
+
+/**
+ * Stores @p value in the @p name member of @p params if it has an accepted
+ * type. Later values of the same parameter replace earlier ones.
+ */
+constexpr auto set_statement_param(
+	statement_params&                       params,
+	statement_param_name                    name,
+	const ecsact_statement_parameter_value& value
+) -> void {
+	auto assign = [](auto& member, auto decoded) {
+		if(decoded) {
+			member = decoded;
+		}
+	};
+
+	switch(name) {
+		case statement_param_name::stream:
+			assign(params.stream, decode_param_value<bool, std::string_view>(value));
+			break;
+		case statement_param_name::transient:
+			assign(params.transient, decode_param_value<bool>(value));
+			break;
+		case statement_param_name::lazy:
+			assign(params.lazy, decode_param_value<bool, int32_t>(value));
+			break;
+		case statement_param_name::parallel:
+			assign(
+				params.parallel,
+				decode_param_value<bool, std::string_view>(value)
+			);
+			break;
+	}
+}
+
+} // namespace ecsact::detail
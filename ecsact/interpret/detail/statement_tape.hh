@@ -0,0 +1,82 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "ecsact/parse/statements.h"
+#include "ecsact/parse/status.h"
+
+namespace ecsact::detail {
+
+/**
+ * Line and character a reader reached, reported as the location of errors
+ */
+struct source_position {
+	int line = 0;
+	int character = 0;
+};
+
+/**
+ * A statement exactly as a `statement_reader` read it
+ */
+struct tape_statement {
+	ecsact_statement    statement;
+	ecsact_parse_status status;
+
+	/**
+	 * Reader position right after the statement was read
+	 */
+	source_position position;
+
+	/**
+	 * Location of the statement source in `statement_tape::source`
+	 */
+	int32_t source_offset = 0;
+	int32_t source_length = 0;
+
+	/**
+	 * Number of statements the reader had on its stack underneath this one.
+	 * Those statements are its context.
+	 */
+	int32_t depth = 0;
+};
+
+/**
+ * Every statement of one source in reading order. A source is read onto its
+ * tape once and every evaluation phase walks the tape instead of the reader,
+ * so a tape may be evaluated again without reading its source again.
+ * Statements view `source` which must outlive the tape.
+ */
+struct statement_tape {
+	std::string_view            source;
+	std::vector<tape_statement> statements;
+
+	auto source_of(const tape_statement& entry) const -> std::string_view {
+		return source.substr(
+			static_cast<std::size_t>(entry.source_offset),
+			static_cast<std::size_t>(entry.source_length)
+		);
+	}
+
+	/**
+	 * Index of the first statement after the block that the statement at
+	 * @p index begins, or the tape size if the block is never closed.
+	 */
+	auto skip_block(std::size_t index) const -> std::size_t {
+		auto block_depth = 1;
+		while(block_depth > 0 && statements.size() > ++index) {
+			auto code = statements[index].status.code;
+			if(code == ECSACT_PARSE_STATUS_BLOCK_BEGIN) {
+				block_depth += 1;
+			} else if(code == ECSACT_PARSE_STATUS_BLOCK_END) {
+				block_depth -= 1;
+			}
+		}
+
+		return std::min(index + 1, statements.size());
+	}
+};
+
+} // namespace ecsact::detail
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include "parse-resolver-runtime/trace.h"
+
+namespace ecsact::detail {
+
+/**
+ * Trace span lasting for the lifetime of this object. Does nothing unless a
+ * trace is being recorded. See parse-resolver-runtime/trace.h
+ */
+class scoped_trace_span {
+	bool _active;
+
+public:
+	scoped_trace_span(
+		const char*      category,
+		const char*      name,
+		std::string_view detail = {}
+	)
+		: _active(ecsact_trace_begin(
+				category,
+				name,
+				detail.data(),
+				static_cast<int32_t>(detail.size())
+			)) {
+	}
+
+	/**
+	 * Shows @p path with the span. It is only converted while tracing.
+	 */
+	scoped_trace_span(
+		const char*                  category,
+		const char*                  name,
+		const std::filesystem::path& path
+	)
+		: _active(false) {
+		if(ecsact_is_tracing()) {
+			auto detail = path.string();
+			_active = ecsact_trace_begin(
+				category,
+				name,
+				detail.data(),
+				static_cast<int32_t>(detail.size())
+			);
+		}
+	}
+
+	scoped_trace_span(const scoped_trace_span&) = delete;
+
+	~scoped_trace_span() {
+		if(_active) {
+			ecsact_trace_end();
+		}
+	}
+};
+
+/**
+ * Records a trace for the lifetime of this object and writes it to @p path,
+ * or to the path in the `ECSACT_INTERPRET_TRACE` environment variable if
+ * @p path is empty. Does nothing if neither is set or a trace is already being
+ * recorded, in which case spans are added to that trace instead. A trace that
+ * can't be written is dropped.
+ */
+class scoped_trace_file {
+	std::string _path;
+
+public:
+	explicit scoped_trace_file(const std::filesystem::path& path) {
+		if(!path.empty()) {
+			_path = path.string();
+		} else if(auto env_path = std::getenv("ECSACT_INTERPRET_TRACE")) {
+			_path = env_path;
+		}
+
+		if(_path.empty() || ecsact_is_tracing()) {
+			_path.clear();
+			return;
+		}
+
+		ecsact_start_trace();
+	}
+
+	scoped_trace_file(const scoped_trace_file&) = delete;
+
+	~scoped_trace_file() {
+		if(!_path.empty()) {
+			ecsact_stop_trace(_path.c_str());
+		}
+	}
+};
+
+} // namespace ecsact::detail
@@ -1,6 +1,6 @@
 #include "ecsact/interpret/eval.h"
 
-#include <set>
+#include <algorithm>
 #include <unordered_map>
 #include <string_view>
 #include <vector>
@@ -10,15 +10,28 @@
 #include <optional>
 #include <span>
 #include <variant>
+#include <functional>
 #include "ecsact/parse/status.h"
 #include "ecsact/runtime/dynamic.h"
 #include "ecsact/runtime/meta.hh"
 #include "ecsact/runtime/meta.h"
+#include "magic_enum.hpp"
 #include "ecsact/interpret/detail/file_eval_error.hh"
+#include "ecsact/interpret/detail/eval_counters.hh"
+#include "ecsact/interpret/detail/runtime_context.hh"
+#include "ecsact/interpret/detail/statement_schema.hh"
+#include "ecsact/interpret/detail/trace.hh"
 #include "ecsact/interpret/eval_error.h"
+#include "parse-resolver-runtime/lookup.h"
+#include "parse-resolver-runtime/views.hh"
 
-using ecsact::meta::system_assoc_capabilities;
-using ecsact::meta::system_capabilities;
+using ecsact::detail::find_statement_param_name;
+using ecsact::detail::scoped_trace_span;
+using ecsact::detail::set_statement_param;
+using ecsact::detail::statement_param_bit;
+using ecsact::detail::statement_params;
+using ecsact::detail::statement_schema_of;
+using ecsact::detail::statement_type_bit;
 
 using namespace std::string_literals;
 using namespace std::string_view_literals;
@@ -38,17 +51,15 @@ auto as_sv(ecsact_statement_sv sv) -> std::string_view {
 
 static auto expect_context(
 	std::span<const ecsact_statement>& context_stack,
-	std::vector<ecsact_statement_type> context_types
+	const ecsact_statement&            statement
 ) -> std::tuple<const ecsact_statement*, ecsact_eval_error> {
+	auto context_types = statement_schema_of(statement.type).contexts;
+
 	if(context_stack.empty()) {
-		for(auto context_type : context_types) {
-			if(context_type == ECSACT_STATEMENT_NONE) {
-				return {nullptr, ecsact_eval_error{}};
-			}
+		if(context_types & statement_type_bit(ECSACT_STATEMENT_NONE)) {
+			return {nullptr, ecsact_eval_error{}};
 		}
-	}
 
-	if(context_stack.empty()) {
 		return {
 			nullptr,
 			ecsact_eval_error{
@@ -60,10 +71,8 @@ static auto expect_context(
 	}
 
 	auto& context = context_stack.back();
-	for(auto context_type : context_types) {
-		if(context.type == context_type) {
-			return {&context, ecsact_eval_error{}};
-		}
+	if(context_types & statement_type_bit(context.type)) {
+		return {&context, ecsact_eval_error{}};
 	}
 
 	return {
@@ -85,121 +94,58 @@ static auto view_statement_params( //
 	};
 }
 
-template<typename T>
-static auto statement_param( //
+/**
+ * Decodes every parameter of @p statement in a single pass. Parameters not
+ * accepted by the statement type are reported as errors.
+ */
+static auto decode_statement_params(
 	const ecsact_statement& statement,
-	std::string_view        param_name
-) -> std::optional<T>;
-
-template<>
-auto statement_param<int32_t>( //
-	const ecsact_statement& statement,
-	std::string_view        in_param_name
-) -> std::optional<int32_t> {
-	auto result = std::optional<int32_t>{};
-	for(auto& param : view_statement_params(statement)) {
-		auto param_name =
-			std::string_view{param.name.data, static_cast<size_t>(param.name.length)};
-		if(param_name != in_param_name) {
-			continue;
-		}
-
-		if(param.value.type != ECSACT_STATEMENT_PARAM_VALUE_TYPE_INTEGER) {
-			break;
-		}
-
-		result = param.value.data.integer_value;
-	}
-
-	return result;
-}
-
-template<>
-auto statement_param<bool>( //
-	const ecsact_statement& statement,
-	std::string_view        param_name
-) -> std::optional<bool> {
-	auto result = std::optional<bool>{};
-	for(auto& param : view_statement_params(statement)) {
-		if(std::string_view{
-				 param.name.data,
-				 static_cast<size_t>(param.name.length)
-			 } != param_name) {
-			continue;
-		}
-
-		if(param.value.type != ECSACT_STATEMENT_PARAM_VALUE_TYPE_BOOL) {
-			break;
-		}
-
-		result = param.value.data.bool_value;
-	}
-
-	return result;
-}
-
-template<>
-auto statement_param<std::string_view>( //
-	const ecsact_statement& statement,
-	std::string_view        param_name
-) -> std::optional<std::string_view> {
-	auto result = std::optional<std::string_view>{};
-	for(auto& param : view_statement_params(statement)) {
-		if(std::string_view{
-				 param.name.data,
-				 static_cast<size_t>(param.name.length)
-			 } != param_name) {
-			continue;
-		}
-
-		if(param.value.type != ECSACT_STATEMENT_PARAM_VALUE_TYPE_STRING) {
-			break;
-		}
+	const ecsact_statement* context
+) -> std::tuple<statement_params, std::optional<ecsact_eval_error>> {
+	auto allowed_params = statement_schema_of(statement.type).params;
+	auto context_type = context ? context->type : ECSACT_STATEMENT_NONE;
+	auto params = statement_params{};
 
-		result = std::string_view{
-			param.value.data.string_value.data,
-			static_cast<size_t>(param.value.data.string_value.length),
+	if(allowed_params == 0 && statement.parameters_length > 0) {
+		return {
+			params,
+			ecsact_eval_error{
+				.code = ECSACT_EVAL_ERR_PARAMETERS_NOT_ALLOWED,
+				.relevant_content = {},
+				.context_type = context_type,
+			},
 		};
 	}
 
-	return result;
-}
-
-template<typename FirstT, typename SecondT>
-auto statement_param( //
-	const ecsact_statement& statement,
-	std::string_view        param_name
-) -> std::optional<std::variant<FirstT, SecondT>> {
-	using result_variant_t = std::variant<FirstT, SecondT>;
-
-	{
-		auto first_result = statement_param<FirstT>(statement, param_name);
-		if(first_result) {
-			return result_variant_t{*first_result};
+	for(auto& param : view_statement_params(statement)) {
+		auto name = find_statement_param_name(as_sv(param.name));
+		if(!name || !(allowed_params & statement_param_bit(*name))) {
+			return {
+				params,
+				ecsact_eval_error{
+					.code = ECSACT_EVAL_ERR_UNKNOWN_PARAMETER_NAME,
+					.relevant_content = param.name,
+					.context_type = context_type,
+				},
+			};
 		}
-	}
 
-	{
-		auto second_result = statement_param<SecondT>(statement, param_name);
-		if(second_result) {
-			return result_variant_t{*second_result};
-		}
+		set_statement_param(params, *name, param.value);
 	}
 
-	return std::nullopt;
+	return {params, std::nullopt};
 }
 
-static auto parallel_param(const ecsact_statement& statement
-) -> std::variant<ecsact_parallel_execution, ecsact_eval_error_code> {
+static auto parallel_param(const statement_params& params)
+	-> std::variant<ecsact_parallel_execution, ecsact_eval_error_code> {
 	using result_t =
 		std::variant<ecsact_parallel_execution, ecsact_eval_error_code>;
 
-	auto param = statement_param<bool, std::string_view>(statement, "parallel");
-	if(!param) {
+	if(!params.parallel) {
 		return ECSACT_PAR_EXEC_AUTO;
 	}
 
-	auto result = std::visit(
+	return std::visit(
 		overloaded{
 			[&](bool param) -> result_t {
 				return param ? ECSACT_PAR_EXEC_PREFERRED : ECSACT_PAR_EXEC_DENY;
@@ -216,79 +162,31 @@ static auto parallel_param(const ecsact_statement& statement
 				}
 			}
 		},
-		*param
+		*params.parallel
 	);
-	return result;
-}
-
-auto allow_statement_params( //
-	const ecsact_statement& statement,
-	const ecsact_statement* context,
-	auto&&                  allowed_param_names
-) -> std::optional<ecsact_eval_error> {
-	if(std::size(allowed_param_names) == 0 && statement.parameters_length > 0) {
-		return ecsact_eval_error{
-			.code = ECSACT_EVAL_ERR_PARAMETERS_NOT_ALLOWED,
-			.relevant_content = {},
-			.context_type = context ? context->type : ECSACT_STATEMENT_NONE,
-		};
-	}
-
-	for(auto& param : view_statement_params(statement)) {
-		auto param_name =
-			std::string_view{param.name.data, static_cast<size_t>(param.name.length)};
-		auto valid_param_name = false;
-
-		for(auto&& allowed_param_name : allowed_param_names) {
-			if(param_name == allowed_param_name) {
-				valid_param_name = true;
-				break;
-			}
-		}
-
-		if(!valid_param_name) {
-			return ecsact_eval_error{
-				.code = ECSACT_EVAL_ERR_UNKNOWN_PARAMETER_NAME,
-				.relevant_content = param.name,
-				.context_type = context ? context->type : ECSACT_STATEMENT_NONE,
-			};
-		}
-	}
-
-	return std::nullopt;
 }
 
 auto disallow_statement_params( //
 	const ecsact_statement& statement,
 	const ecsact_statement* context
 ) -> std::optional<ecsact_eval_error> {
-	return allow_statement_params(
-		statement,
-		context,
-		std::array<std::string_view, 0>{}
-	);
+	return std::get<1>(decode_statement_params(statement, context));
 }
 
 std::optional<ecsact_field_id> find_field_by_name(
 	ecsact_composite_id compo_id,
 	std::string_view    target_field_name
 ) {
-	std::vector<ecsact_field_id> field_ids;
-	field_ids.resize(ecsact_meta_count_fields(compo_id));
-	ecsact_meta_get_field_ids(
+	auto field_id = ecsact_lookup_field(
 		compo_id,
-		static_cast<int32_t>(field_ids.size()),
-		field_ids.data(),
-		nullptr
+		target_field_name.data(),
+		static_cast<int32_t>(target_field_name.size())
 	);
-	for(auto& field_id : field_ids) {
-		std::string field_name = ecsact_meta_field_name(compo_id, field_id);
-		if(field_name == target_field_name) {
-			return field_id;
-		}
+	if(field_id == ECSACT_INVALID_ID(field)) {
+		return {};
 	}
 
-	return {};
+	return field_id;
 }
 
 template<typename R, typename T>
@@ -302,8 +200,8 @@ static std::optional<R> cast_optional_id(std::optional<T> opt_id) {
 
 template<typename T>
 std::optional<T> find_by_name(
-	ecsact_package_id  package_id,
-	const std::string& name
+	ecsact_package_id package_id,
+	std::string_view  name
 );
 
 template<typename T>
@@ -312,135 +210,169 @@ std::optional<T> find_by_statement(
 	const ecsact_statement& statement
 );
 
-template<>
-std::optional<ecsact_component_id> find_by_name(
-	ecsact_package_id  package_id,
-	const std::string& lookup_name
-) {
-	auto pkg_name = ecsact::meta::package_name(package_id);
-	for(auto id : ecsact::meta::get_component_ids(package_id)) {
-		auto comp_name = ecsact::meta::component_name(id);
-		if(lookup_name == comp_name) {
-			return id;
-		}
-
-		if(lookup_name == pkg_name + "." + comp_name) {
-			return id;
-		}
+template<typename T>
+static auto valid_id_or_nullopt(T id) -> std::optional<T> {
+	if(id == static_cast<T>(-1)) {
+		return {};
 	}
 
-	for(auto dep_pkg_id : ecsact::meta::get_dependencies(package_id)) {
-		auto dep_pkg_name = ecsact::meta::package_name(dep_pkg_id);
+	return id;
+}
 
-		for(auto id : ecsact::meta::get_component_ids(dep_pkg_id)) {
-			auto comp_name = ecsact::meta::component_name(id);
+/**
+ * Same as `valid_id_or_nullopt` for the result of a runtime name lookup. The
+ * lookup is recorded to the current eval counters, if any.
+ */
+template<typename T>
+static auto lookup_result(T id) -> std::optional<T> {
+	auto result = valid_id_or_nullopt(id);
+	if(auto counters = ecsact::detail::current_eval_counters) {
+		counters->count_lookup(result.has_value());
+	}
+	return result;
+}
 
-			if(lookup_name == dep_pkg_name + "." + comp_name) {
-				return id;
-			}
-		}
+/**
+ * Statement stack `ecsact_eval_statements` is currently evaluating along with
+ * the declarations its statements were already resolved to. `indices` and
+ * `ids` are indexed the same as `stack`.
+ */
+struct resolved_statement_stack {
+	std::vector<ecsact_statement>              stack;
+	std::vector<int32_t>                       indices;
+	std::vector<std::optional<ecsact_decl_id>> ids;
+
+	auto push(
+		const ecsact_statement&       statement,
+		int32_t                       index,
+		std::optional<ecsact_decl_id> id
+	) -> void {
+		stack.push_back(statement);
+		indices.push_back(index);
+		ids.push_back(id);
+	}
+
+	auto pop() -> void {
+		stack.pop_back();
+		indices.pop_back();
+		ids.pop_back();
 	}
+};
 
-	return {};
-}
+static thread_local const resolved_statement_stack* current_resolved_stack =
+	nullptr;
 
-template<>
-std::optional<ecsact_transient_id> find_by_name(
-	ecsact_package_id  package_id,
-	const std::string& lookup_name
-) {
-	auto pkg_name = ecsact::meta::package_name(package_id);
-	for(auto id : ecsact::meta::get_transient_ids(package_id)) {
-		auto trans_name = ecsact::meta::transient_name(id);
-		if(lookup_name == trans_name) {
-			return id;
-		}
+class scoped_resolved_stack {
+	const resolved_statement_stack* _previous;
 
-		if(lookup_name == pkg_name + "." + trans_name) {
-			return id;
-		}
+public:
+	explicit scoped_resolved_stack(const resolved_statement_stack& resolved)
+		: _previous(current_resolved_stack) {
+		current_resolved_stack = &resolved;
 	}
 
-	for(auto dep_pkg_id : ecsact::meta::get_dependencies(package_id)) {
-		auto dep_pkg_name = ecsact::meta::package_name(dep_pkg_id);
+	scoped_resolved_stack(const scoped_resolved_stack&) = delete;
 
-		for(auto id : ecsact::meta::get_transient_ids(dep_pkg_id)) {
-			auto trans_name = ecsact::meta::transient_name(id);
+	~scoped_resolved_stack() {
+		current_resolved_stack = _previous;
+	}
+};
 
-			if(lookup_name == dep_pkg_name + "." + trans_name) {
-				return id;
-			}
-		}
+/**
+ * @returns the declaration @p statement was already resolved to if it is part
+ *          of the current resolved stack and its type is one of @p types
+ */
+template<typename T>
+static auto resolved_id(
+	const ecsact_statement&               statement,
+	ecsact::detail::statement_type_mask types
+) -> std::optional<T> {
+	auto resolved = current_resolved_stack;
+	if(!resolved || !(types & statement_type_bit(statement.type))) {
+		return {};
 	}
 
-	return {};
+	auto begin = resolved->stack.data();
+	auto end = begin + resolved->stack.size();
+	auto less = std::less<const ecsact_statement*>{};
+	if(less(&statement, begin) || !less(&statement, end)) {
+		return {};
+	}
+
+	return cast_optional_id<T>(resolved->ids[&statement - begin]);
 }
 
 template<>
-std::optional<ecsact_system_id> find_by_name(
-	ecsact_package_id  package_id,
-	const std::string& name
+std::optional<ecsact_component_id> find_by_name(
+	ecsact_package_id package_id,
+	std::string_view  lookup_name
 ) {
-	for(auto id : ecsact::meta::get_system_ids(package_id)) {
-		if(name == ecsact::meta::system_name(id)) {
-			return id;
-		}
-	}
+	auto span = scoped_trace_span{"lookup", "find_by_name", lookup_name};
+	return lookup_result(ecsact_lookup_component(
+		package_id,
+		lookup_name.data(),
+		static_cast<int32_t>(lookup_name.size())
+	));
+}
 
-	return {};
+template<>
+std::optional<ecsact_transient_id> find_by_name(
+	ecsact_package_id package_id,
+	std::string_view  lookup_name
+) {
+	auto span = scoped_trace_span{"lookup", "find_by_name", lookup_name};
+	return lookup_result(ecsact_lookup_transient(
+		package_id,
+		lookup_name.data(),
+		static_cast<int32_t>(lookup_name.size())
+	));
 }
 
 template<>
-std::optional<ecsact_action_id> find_by_name(
-	ecsact_package_id  package_id,
-	const std::string& name
+std::optional<ecsact_system_id> find_by_name(
+	ecsact_package_id package_id,
+	std::string_view  name
 ) {
-	for(auto id : ecsact::meta::get_action_ids(package_id)) {
-		if(name == ecsact::meta::action_name(id)) {
-			return id;
-		}
-	}
+	auto span = scoped_trace_span{"lookup", "find_by_name", name};
+	return lookup_result(ecsact_lookup_system(
+		package_id,
+		name.data(),
+		static_cast<int32_t>(name.size())
+	));
+}
 
-	return {};
+template<>
+std::optional<ecsact_action_id> find_by_name(
+	ecsact_package_id package_id,
+	std::string_view  name
+) {
+	auto span = scoped_trace_span{"lookup", "find_by_name", name};
+	return lookup_result(ecsact_lookup_action(
+		package_id,
+		name.data(),
+		static_cast<int32_t>(name.size())
+	));
 }
 
 template<>
 std::optional<ecsact_enum_id> find_by_name(
-	ecsact_package_id  package_id,
-	const std::string& lookup_name
+	ecsact_package_id package_id,
+	std::string_view  lookup_name
 ) {
-	auto pkg_name = ecsact::meta::package_name(package_id);
-	for(auto id : ecsact::meta::get_enum_ids(package_id)) {
-		auto enum_name = ecsact::meta::enum_name(id);
-		if(lookup_name == enum_name) {
-			return id;
-		}
-
-		if(lookup_name == pkg_name + "." + enum_name) {
-			return id;
-		}
-	}
-
-	for(auto dep_pkg_id : ecsact::meta::get_dependencies(package_id)) {
-		auto dep_pkg_name = ecsact::meta::package_name(dep_pkg_id);
-
-		for(auto id : ecsact::meta::get_enum_ids(dep_pkg_id)) {
-			auto enum_name = ecsact::meta::enum_name(id);
-
-			if(lookup_name == dep_pkg_name + "." + enum_name) {
-				return id;
-			}
-		}
-	}
-
-	return {};
+	auto span = scoped_trace_span{"lookup", "find_by_name", lookup_name};
+	return lookup_result(ecsact_lookup_enum(
+		package_id,
+		lookup_name.data(),
+		static_cast<int32_t>(lookup_name.size())
+	));
 }
 
 template<>
 std::optional<ecsact_composite_id> find_by_name(
-	ecsact_package_id  pkg_id,
-	const std::string& name
+	ecsact_package_id pkg_id,
+	std::string_view  name
 ) {
+	auto span = scoped_trace_span{"lookup", "find_by_name", name};
 	if(auto id = find_by_name<ecsact_component_id>(pkg_id, name)) {
 		return ecsact_id_cast<ecsact_composite_id>(*id);
 	}
@@ -458,9 +390,10 @@ std::optional<ecsact_composite_id> find_by_name(
 
 template<>
 std::optional<ecsact_decl_id> find_by_name(
-	ecsact_package_id  pkg_id,
-	const std::string& name
+	ecsact_package_id pkg_id,
+	std::string_view  name
 ) {
+	auto span = scoped_trace_span{"lookup", "find_by_name", name};
 	if(auto id = find_by_name<ecsact_component_id>(pkg_id, name)) {
 		return ecsact_id_cast<ecsact_decl_id>(*id);
 	}
@@ -482,9 +415,10 @@ std::optional<ecsact_decl_id> find_by_name(
 
 template<>
 std::optional<ecsact_component_like_id> find_by_name(
-	ecsact_package_id  pkg_id,
-	const std::string& name
+	ecsact_package_id pkg_id,
+	std::string_view  name
 ) {
+	auto span = scoped_trace_span{"lookup", "find_by_name", name};
 	if(auto id = find_by_name<ecsact_component_id>(pkg_id, name)) {
 		return ecsact_id_cast<ecsact_component_like_id>(*id);
 	}
@@ -501,8 +435,7 @@ auto find_user_field_type_by_name(
 	std::string_view  user_type_name,
 	int32_t           length
 ) -> std::optional<ecsact_field_type> {
-	auto enum_id =
-		find_by_name<ecsact_enum_id>(package_id, std::string{user_type_name});
+	auto enum_id = find_by_name<ecsact_enum_id>(package_id, user_type_name);
 	if(enum_id) {
 		return ecsact_field_type{
 			.kind = ECSACT_TYPE_KIND_ENUM,
@@ -527,7 +460,7 @@ auto find_field_by_full_name(
 	auto field_name = field_full_name.substr(last_dot_idx + 1);
 
 	auto composite_id =
-		find_by_name<ecsact_composite_id>(package_id, std::string{composite_name});
+		find_by_name<ecsact_composite_id>(package_id, composite_name);
 
 	if(!composite_id) {
 		return {};
@@ -547,6 +480,7 @@ auto find_field_by_full_name(
 				.field_id = *field_id,
 			},
 		},
+		.length = 1,
 	};
 }
 
@@ -555,12 +489,20 @@ std::optional<ecsact_composite_id> find_by_statement(
 	ecsact_package_id       package_id,
 	const ecsact_statement& statement
 ) {
+	constexpr auto types = ecsact::detail::statement_types<
+		ECSACT_STATEMENT_COMPONENT,
+		ECSACT_STATEMENT_TRANSIENT,
+		ECSACT_STATEMENT_ACTION>;
+	if(auto id = resolved_id<ecsact_composite_id>(statement, types)) {
+		return id;
+	}
+
 	switch(statement.type) {
 		case ECSACT_STATEMENT_COMPONENT:
 			return cast_optional_id<ecsact_composite_id>(
 				find_by_name<ecsact_component_id>(
 					package_id,
-					std::string(
+					std::string_view(
 						statement.data.component_statement.component_name.data,
 						statement.data.component_statement.component_name.length
 					)
@@ -570,7 +512,7 @@ std::optional<ecsact_composite_id> find_by_statement(
 			return cast_optional_id<ecsact_composite_id>(
 				find_by_name<ecsact_transient_id>(
 					package_id,
-					std::string(
+					std::string_view(
 						statement.data.transient_statement.transient_name.data,
 						statement.data.transient_statement.transient_name.length
 					)
@@ -580,7 +522,7 @@ std::optional<ecsact_composite_id> find_by_statement(
 			return cast_optional_id<ecsact_composite_id>(
 				find_by_name<ecsact_action_id>(
 					package_id,
-					std::string(
+					std::string_view(
 						statement.data.action_statement.action_name.data,
 						statement.data.action_statement.action_name.length
 					)
@@ -598,12 +540,20 @@ std::optional<ecsact_component_like_id> find_by_statement(
 	ecsact_package_id       package_id,
 	const ecsact_statement& statement
 ) {
+	constexpr auto types = ecsact::detail::statement_types<
+		ECSACT_STATEMENT_COMPONENT,
+		ECSACT_STATEMENT_TRANSIENT,
+		ECSACT_STATEMENT_SYSTEM_COMPONENT>;
+	if(auto id = resolved_id<ecsact_component_like_id>(statement, types)) {
+		return id;
+	}
+
 	switch(statement.type) {
 		case ECSACT_STATEMENT_COMPONENT:
 			return cast_optional_id<ecsact_component_like_id>(
 				find_by_name<ecsact_component_id>(
 					package_id,
-					std::string(
+					std::string_view(
 						statement.data.component_statement.component_name.data,
 						statement.data.component_statement.component_name.length
 					)
@@ -613,7 +563,7 @@ std::optional<ecsact_component_like_id> find_by_statement(
 			return cast_optional_id<ecsact_component_like_id>(
 				find_by_name<ecsact_transient_id>(
 					package_id,
-					std::string(
+					std::string_view(
 						statement.data.transient_statement.transient_name.data,
 						statement.data.transient_statement.transient_name.length
 					)
@@ -622,7 +572,7 @@ std::optional<ecsact_component_like_id> find_by_statement(
 		case ECSACT_STATEMENT_SYSTEM_COMPONENT:
 			return find_by_name<ecsact_component_like_id>(
 				package_id,
-				std::string(
+				std::string_view(
 					statement.data.system_component_statement.component_name.data,
 					statement.data.system_component_statement.component_name.length
 				)
@@ -639,12 +589,19 @@ std::optional<ecsact_system_like_id> find_by_statement(
 	ecsact_package_id       package_id,
 	const ecsact_statement& statement
 ) {
+	constexpr auto types = ecsact::detail::statement_types<
+		ECSACT_STATEMENT_SYSTEM,
+		ECSACT_STATEMENT_ACTION>;
+	if(auto id = resolved_id<ecsact_system_like_id>(statement, types)) {
+		return id;
+	}
+
 	switch(statement.type) {
 		case ECSACT_STATEMENT_SYSTEM:
 			return cast_optional_id<ecsact_system_like_id>(
 				find_by_name<ecsact_system_id>(
 					package_id,
-					std::string(
+					std::string_view(
 						statement.data.system_statement.system_name.data,
 						statement.data.system_statement.system_name.length
 					)
@@ -654,7 +611,7 @@ std::optional<ecsact_system_like_id> find_by_statement(
 			return cast_optional_id<ecsact_system_like_id>(
 				find_by_name<ecsact_action_id>(
 					package_id,
-					std::string(
+					std::string_view(
 						statement.data.action_statement.action_name.data,
 						statement.data.action_statement.action_name.length
 					)
@@ -683,7 +640,7 @@ static ecsact_eval_error eval_import_statement(
 	const ecsact_statement&            statement
 ) {
 	auto& data = statement.data.import_statement;
-	auto [context, err] = expect_context(context_stack, {ECSACT_STATEMENT_NONE});
+	auto [context, err] = expect_context(context_stack, statement);
 	if(err.code != ECSACT_EVAL_OK) {
 		err.relevant_content = data.import_package_name;
 		return err;
@@ -693,16 +650,13 @@ static ecsact_eval_error eval_import_statement(
 		return *err;
 	}
 
-	auto import_name = std::string{
-		data.import_package_name.data,
-		static_cast<size_t>(data.import_package_name.length),
-	};
+	auto import_name = as_sv(data.import_package_name);
 
-	for(auto dep_pkg_id : ecsact::meta::get_package_ids()) {
+	for(auto dep_pkg_id : ecsact::interpret::views::package_ids()) {
 		if(dep_pkg_id == package_id) {
 			continue;
 		}
-		if(ecsact::meta::package_name(dep_pkg_id) == import_name) {
+		if(ecsact::interpret::views::package_name(dep_pkg_id) == import_name) {
 			ecsact_add_dependency(package_id, dep_pkg_id);
 			return {};
 		}
@@ -720,21 +674,20 @@ static ecsact_eval_error eval_component_statement(
 	const ecsact_statement&            statement
 ) {
 	auto& data = statement.data.component_statement;
-	auto [context, err] = expect_context(context_stack, {ECSACT_STATEMENT_NONE});
+	auto [context, err] = expect_context(context_stack, statement);
 	if(err.code != ECSACT_EVAL_OK) {
 		err.relevant_content = data.component_name;
 		return err;
 	}
 
-	constexpr auto allowed_params = std::array{"stream"sv, "transient"sv};
-	if(auto err = allow_statement_params(statement, context, allowed_params)) {
-		return *err;
+	auto [params, params_err] = decode_statement_params(statement, context);
+	if(params_err) {
+		return *params_err;
 	}
 
-	auto stream_param =
-		statement_param<bool, std::string_view>(statement, "stream"sv);
-	auto transient_param = statement_param<bool>(statement, "transient"sv);
-	auto component_type = ECSACT_COMPONENT_TYPE_NONE;
+	auto& stream_param = params.stream;
+	auto& transient_param = params.transient;
+	auto  component_type = ECSACT_COMPONENT_TYPE_NONE;
 
 	if(stream_param) {
 		auto stream_type = std::get_if<std::string_view>(&stream_param.value());
@@ -766,7 +719,8 @@ static ecsact_eval_error eval_component_statement(
 		}
 	}
 
-	auto name = std::string(data.component_name.data, data.component_name.length);
+	auto name =
+		std::string_view(data.component_name.data, data.component_name.length);
 
 	auto existing_decl = find_by_name<ecsact_decl_id>(package_id, name);
 	if(existing_decl) {
@@ -793,7 +747,7 @@ static ecsact_eval_error eval_transient_statement(
 	const ecsact_statement&            statement
 ) {
 	auto& data = statement.data.transient_statement;
-	auto [context, err] = expect_context(context_stack, {ECSACT_STATEMENT_NONE});
+	auto [context, err] = expect_context(context_stack, statement);
 	if(err.code != ECSACT_EVAL_OK) {
 		err.relevant_content = data.transient_name;
 		return err;
@@ -803,7 +757,8 @@ static ecsact_eval_error eval_transient_statement(
 		return *err;
 	}
 
-	auto name = std::string(data.transient_name.data, data.transient_name.length);
+	auto name =
+		std::string_view(data.transient_name.data, data.transient_name.length);
 	auto existing_decl = find_by_name<ecsact_decl_id>(package_id, name);
 	if(existing_decl) {
 		return ecsact_eval_error{
@@ -828,30 +783,20 @@ static ecsact_eval_error eval_system_statement(
 ) {
 	auto& data = statement.data.system_statement;
 	auto  parent_sys_like_id = std::optional<ecsact_system_like_id>{};
-	auto [context, err] = expect_context(
-		context_stack,
-		{
-			ECSACT_STATEMENT_NONE,
-			ECSACT_STATEMENT_SYSTEM,
-			ECSACT_STATEMENT_ACTION,
-		}
-	);
+	auto [context, err] = expect_context(context_stack, statement);
 
 	if(err.code != ECSACT_EVAL_OK) {
 		err.relevant_content = data.system_name;
 		return err;
 	}
 
-	if(auto err = allow_statement_params(
-			 statement,
-			 context,
-			 std::array{"lazy"sv, "parallel"sv}
-		 )) {
-		return *err;
+	auto [params, params_err] = decode_statement_params(statement, context);
+	if(params_err) {
+		return *params_err;
 	}
 
-	auto lazy_value = [&]() -> int32_t {
-		auto lazy_param = statement_param<bool, int32_t>(statement, "lazy");
+	auto& lazy_param = params.lazy;
+	auto  lazy_value = [&]() -> int32_t {
 		if(!lazy_param) {
 			return 0;
 		}
@@ -876,7 +821,8 @@ static ecsact_eval_error eval_system_statement(
 		}
 	}
 
-	auto name = std::string(data.system_name.data, data.system_name.length);
+	auto name =
+		std::string_view(data.system_name.data, data.system_name.length);
 
 	auto existing_decl = find_by_name<ecsact_decl_id>(package_id, name);
 	if(existing_decl) {
@@ -900,7 +846,7 @@ static ecsact_eval_error eval_system_statement(
 		ecsact_set_system_lazy_iteration_rate(sys_id, lazy_value);
 	}
 
-	auto parallel = parallel_param(statement);
+	auto parallel = parallel_param(params);
 	if(auto err_code = std::get_if<ecsact_eval_error_code>(&parallel)) {
 		return ecsact_eval_error{
 			.code = *err_code,
@@ -922,18 +868,19 @@ static ecsact_eval_error eval_action_statement(
 	const ecsact_statement&            statement
 ) {
 	auto& data = statement.data.action_statement;
-	auto [context, err] = expect_context(context_stack, {ECSACT_STATEMENT_NONE});
+	auto [context, err] = expect_context(context_stack, statement);
 	if(err.code != ECSACT_EVAL_OK) {
 		err.relevant_content = data.action_name;
 		return err;
 	}
 
-	if(auto err =
-			 allow_statement_params(statement, context, std::array{"parallel"sv})) {
-		return *err;
+	auto [params, params_err] = decode_statement_params(statement, context);
+	if(params_err) {
+		return *params_err;
 	}
 
-	auto name = std::string(data.action_name.data, data.action_name.length);
+	auto name =
+		std::string_view(data.action_name.data, data.action_name.length);
 
 	auto existing_decl = find_by_name<ecsact_decl_id>(package_id, name);
 	if(existing_decl) {
@@ -949,7 +896,7 @@ static ecsact_eval_error eval_action_statement(
 		data.action_name.length
 	);
 
-	auto parallel = parallel_param(statement);
+	auto parallel = parallel_param(params);
 	if(auto err_code = std::get_if<ecsact_eval_error_code>(&parallel)) {
 		return ecsact_eval_error{
 			.code = *err_code,
@@ -971,7 +918,7 @@ static ecsact_eval_error eval_enum_statement(
 	const ecsact_statement&            statement
 ) {
 	auto& data = statement.data.enum_statement;
-	auto [context, err] = expect_context(context_stack, {ECSACT_STATEMENT_NONE});
+	auto [context, err] = expect_context(context_stack, statement);
 	if(err.code != ECSACT_EVAL_OK) {
 		err.relevant_content = data.enum_name;
 		return err;
@@ -981,7 +928,7 @@ static ecsact_eval_error eval_enum_statement(
 		return *err;
 	}
 
-	auto name = std::string(data.enum_name.data, data.enum_name.length);
+	auto name = std::string_view(data.enum_name.data, data.enum_name.length);
 
 	auto existing_decl = find_by_name<ecsact_decl_id>(package_id, name);
 	if(existing_decl) {
@@ -1002,7 +949,7 @@ static ecsact_eval_error eval_enum_value_statement(
 	const ecsact_statement&            statement
 ) {
 	auto& data = statement.data.enum_value_statement;
-	auto [context, err] = expect_context(context_stack, {ECSACT_STATEMENT_ENUM});
+	auto [context, err] = expect_context(context_stack, statement);
 	if(err.code != ECSACT_EVAL_OK) {
 		err.relevant_content = data.name;
 		return err;
@@ -1014,9 +961,14 @@ static ecsact_eval_error eval_enum_value_statement(
 
 	auto& context_data = context->data.enum_statement;
 	auto  enum_name =
-		std::string(context_data.enum_name.data, context_data.enum_name.length);
+		std::string_view(context_data.enum_name.data, context_data.enum_name.length);
 
-	auto enum_id = find_by_name<ecsact_enum_id>(package_id, enum_name);
+	constexpr auto enum_types =
+		ecsact::detail::statement_types<ECSACT_STATEMENT_ENUM>;
+	auto enum_id = resolved_id<ecsact_enum_id>(*context, enum_types);
+	if(!enum_id) {
+		enum_id = find_by_name<ecsact_enum_id>(package_id, enum_name);
+	}
 	if(!enum_id) {
 		return ecsact_eval_error{
 			.code = ECSACT_EVAL_ERR_INVALID_CONTEXT,
@@ -1035,14 +987,7 @@ static ecsact_eval_error eval_builtin_type_field_statement(
 	const ecsact_statement&            statement
 ) {
 	auto& data = statement.data.field_statement;
-	auto [context, err] = expect_context(
-		context_stack,
-		{
-			ECSACT_STATEMENT_COMPONENT,
-			ECSACT_STATEMENT_TRANSIENT,
-			ECSACT_STATEMENT_ACTION,
-		}
-	);
+	auto [context, err] = expect_context(context_stack, statement);
 	if(err.code != ECSACT_EVAL_OK) {
 		err.relevant_content = data.field_name;
 		return err;
@@ -1060,16 +1005,11 @@ static ecsact_eval_error eval_builtin_type_field_statement(
 		};
 	}
 
-	std::string field_name(data.field_name.data, data.field_name.length);
-
-	for(auto field_id : ecsact::meta::get_field_ids(*compo_id)) {
-		std::string other_field_name = ecsact_meta_field_name(*compo_id, field_id);
-		if(field_name == other_field_name) {
-			return ecsact_eval_error{
-				.code = ECSACT_EVAL_ERR_FIELD_NAME_ALREADY_EXISTS,
-				.relevant_content = data.field_name,
-			};
-		}
+	if(find_field_by_name(*compo_id, as_sv(data.field_name))) {
+		return ecsact_eval_error{
+			.code = ECSACT_EVAL_ERR_FIELD_NAME_ALREADY_EXISTS,
+			.relevant_content = data.field_name,
+		};
 	}
 
 	ecsact_add_field(
@@ -1092,14 +1032,7 @@ static ecsact_eval_error eval_user_type_field_statement(
 	const ecsact_statement&            statement
 ) {
 	auto& data = statement.data.user_type_field_statement;
-	auto [context, err] = expect_context(
-		context_stack,
-		{
-			ECSACT_STATEMENT_COMPONENT,
-			ECSACT_STATEMENT_TRANSIENT,
-			ECSACT_STATEMENT_ACTION,
-		}
-	);
+	auto [context, err] = expect_context(context_stack, statement);
 
 	if(err.code != ECSACT_EVAL_OK) {
 		err.relevant_content = data.user_type_name;
@@ -1119,16 +1052,11 @@ static ecsact_eval_error eval_user_type_field_statement(
 		};
 	}
 
-	std::string field_name(data.field_name.data, data.field_name.length);
-
-	for(auto field_id : ecsact::meta::get_field_ids(*compo_id)) {
-		std::string other_field_name = ecsact_meta_field_name(*compo_id, field_id);
-		if(field_name == other_field_name) {
-			return ecsact_eval_error{
-				.code = ECSACT_EVAL_ERR_FIELD_NAME_ALREADY_EXISTS,
-				.relevant_content = data.field_name,
-			};
-		}
+	if(find_field_by_name(*compo_id, as_sv(data.field_name))) {
+		return ecsact_eval_error{
+			.code = ECSACT_EVAL_ERR_FIELD_NAME_ALREADY_EXISTS,
+			.relevant_content = data.field_name,
+		};
 	}
 
 	auto field_type_lookup =
@@ -1180,57 +1108,6 @@ static ecsact_eval_error eval_entity_field_statement(
 	);
 }
 
-static auto get_with_field_ids(
-	ecsact_system_like_id                sys_like_id,
-	ecsact_component_like_id             comp_like_id,
-	std::span<const ecsact_statement_sv> fields
-) -> std::vector<ecsact_field_id> {
-	auto with_field_ids = std::vector<ecsact_field_id>{};
-	for(int i = 0; fields.size() > i; ++i) {
-		auto assoc_field_name =
-			std::string_view{fields[i].data, static_cast<size_t>(fields[i].length)};
-
-		auto assoc_field_id = std::optional<ecsact_field_id>{};
-
-		for(auto field_id : ecsact::meta::get_field_ids(comp_like_id)) {
-			std::string field_name = ecsact_meta_field_name(
-				ecsact_id_cast<ecsact_composite_id>(comp_like_id),
-				field_id
-			);
-			if(assoc_field_name == field_name) {
-				assoc_field_id = field_id;
-				break;
-			}
-		}
-
-		assert(assoc_field_id.has_value());
-		with_field_ids.emplace_back(*assoc_field_id);
-	}
-	return with_field_ids;
-}
-
-static auto find_capabilities_for( //
-	auto sys_like_id,
-	auto id
-) -> std::optional<ecsact_system_capability> {
-	for(auto&& [comp_id, caps] : ecsact::meta::system_capabilities(sys_like_id)) {
-		if(ecsact_id_cast<decltype(id)>(comp_id) == id) {
-			return caps;
-		}
-	}
-
-	auto parent = ecsact::meta::get_parent_system_id(
-		// NOTE: this cast only works because we wrote the meta runtime for the
-		// interpreter. This is bad practice.
-		static_cast<ecsact_system_id>(sys_like_id)
-	);
-	if(parent) {
-		return find_capabilities_for(*parent, id);
-	}
-
-	return {};
-}
-
 static auto eval_system_with_statement_data_common(
 	ecsact_system_like_id                sys_like_id,
 	ecsact_component_like_id             comp_like_id,
@@ -1238,21 +1115,10 @@ static auto eval_system_with_statement_data_common(
 ) -> ecsact_eval_error {
 	auto with_field_ids = std::vector<ecsact_field_id>{};
 	for(int i = 0; fields.size() > i; ++i) {
-		auto assoc_field_name =
-			std::string_view{fields[i].data, static_cast<size_t>(fields[i].length)};
-
-		auto assoc_field_id = std::optional<ecsact_field_id>{};
-
-		for(auto field_id : ecsact::meta::get_field_ids(comp_like_id)) {
-			std::string field_name = ecsact_meta_field_name(
-				ecsact_id_cast<ecsact_composite_id>(comp_like_id),
-				field_id
-			);
-			if(assoc_field_name == field_name) {
-				assoc_field_id = field_id;
-				break;
-			}
-		}
+		auto assoc_field_id = find_field_by_name(
+			ecsact_id_cast<ecsact_composite_id>(comp_like_id),
+			as_sv(fields[i])
+		);
 
 		if(!assoc_field_id) {
 			return ecsact_eval_error{
@@ -1304,43 +1170,43 @@ static auto find_assoc_ids_with_fields( //
 	auto            target_field_names
 ) -> std::vector<ecsact_system_assoc_id> {
 	assert(std::size(target_field_names) > 0);
-	auto assoc_ids = std::set<ecsact_system_assoc_id>{};
-	for(auto assoc_id : ecsact::meta::system_assoc_ids(sys_like_id)) {
-		auto assoc_comp_id =
-			ecsact::meta::system_assoc_component_id(sys_like_id, assoc_id);
-		if(assoc_comp_id != comp_like_id) {
-			continue;
+
+	auto target_field_ids = std::vector<ecsact_field_id>{};
+	target_field_ids.reserve(std::size(target_field_names));
+	for(auto target_field_name : target_field_names) {
+		auto field_id = find_field_by_name(
+			ecsact_id_cast<ecsact_composite_id>(comp_like_id),
+			as_sv(target_field_name)
+		);
+		if(field_id) {
+			target_field_ids.push_back(*field_id);
 		}
+	}
 
-		auto fields = ecsact::meta::system_assoc_fields(sys_like_id, assoc_id);
-		auto matching_fields = std::vector<ecsact_field_id>{};
-		for(auto field : fields) {
-			auto field_name = ecsact::meta::field_name(comp_like_id, field);
-			auto found_target_field = false;
-			for(auto target_field_name : target_field_names) {
-				if(field_name == as_sv(target_field_name)) {
-					found_target_field = true;
-					matching_fields.push_back(field);
-				}
-			}
+	auto candidates = ecsact::interpret::views::system_assoc_ids(
+		ecsact_id_cast<ecsact_system_like_id>(sys_like_id),
+		ecsact_id_cast<ecsact_component_like_id>(comp_like_id)
+	);
 
-			if(!found_target_field) {
-				break;
-			}
-		}
+	auto assoc_ids = std::vector<ecsact_system_assoc_id>{};
+	for(auto assoc_id : candidates) {
+		auto fields = ecsact::interpret::views::system_assoc_fields(
+			ecsact_id_cast<ecsact_system_like_id>(sys_like_id),
+			assoc_id
+		);
+		auto all_fields_targeted = std::ranges::all_of(fields, [&](auto field) {
+			return std::ranges::find(target_field_ids, field) !=
+				target_field_ids.end();
+		});
 
-		assert(matching_fields.size() <= fields.size());
-		if(matching_fields.size() == fields.size()) {
-			assoc_ids.insert(assoc_id);
+		if(all_fields_targeted) {
+			assoc_ids.push_back(assoc_id);
 		}
 	}
 
 	assert(!assoc_ids.empty());
 
-	return std::vector<ecsact_system_assoc_id>{
-		assoc_ids.begin(),
-		assoc_ids.end()
-	};
+	return assoc_ids;
 }
 
 static ecsact_eval_error eval_system_component_statement(
@@ -1348,15 +1214,7 @@ static ecsact_eval_error eval_system_component_statement(
 	std::span<const ecsact_statement>& context_stack,
 	const ecsact_statement&            statement
 ) {
-	auto [context, err] = expect_context(
-		context_stack,
-		{
-			ECSACT_STATEMENT_SYSTEM,
-			ECSACT_STATEMENT_ACTION,
-			ECSACT_STATEMENT_SYSTEM_COMPONENT,
-			ECSACT_STATEMENT_SYSTEM_WITH,
-		}
-	);
+	auto [context, err] = expect_context(context_stack, statement);
 
 	if(err.code != ECSACT_EVAL_OK) {
 		err.relevant_content =
@@ -1372,7 +1230,7 @@ static ecsact_eval_error eval_system_component_statement(
 	auto  sys_like_id = std::optional<ecsact_system_like_id>{};
 	auto  assoc_id = std::optional<ecsact_system_assoc_id>{};
 
-	std::string comp_like_name(
+	auto comp_like_name = std::string_view(
 		statement_data.component_name.data,
 		statement_data.component_name.length
 	);
@@ -1553,7 +1411,11 @@ static ecsact_eval_error eval_system_component_statement(
 	}
 
 	if(assoc_id) {
-		for(auto& entry : system_assoc_capabilities(*sys_like_id, *assoc_id)) {
+		auto assoc_caps = ecsact::interpret::views::system_assoc_capabilities(
+			*sys_like_id,
+			*assoc_id
+		);
+		for(auto& entry : assoc_caps) {
 			if(entry.first == *comp_like_id) {
 				return ecsact_eval_error{
 					.code = ECSACT_EVAL_ERR_MULTIPLE_CAPABILITIES_SAME_COMPONENT_LIKE,
@@ -1562,13 +1424,15 @@ static ecsact_eval_error eval_system_component_statement(
 			}
 		}
 	} else {
-		for(auto& entry : system_capabilities(*sys_like_id)) {
-			if(entry.first == *comp_like_id) {
-				return ecsact_eval_error{
-					.code = ECSACT_EVAL_ERR_MULTIPLE_CAPABILITIES_SAME_COMPONENT_LIKE,
-					.relevant_content = statement_data.component_name,
-				};
-			}
+		auto existing_cap = ecsact::interpret::views::system_capability(
+			*sys_like_id,
+			*comp_like_id
+		);
+		if(existing_cap) {
+			return ecsact_eval_error{
+				.code = ECSACT_EVAL_ERR_MULTIPLE_CAPABILITIES_SAME_COMPONENT_LIKE,
+				.relevant_content = statement_data.component_name,
+			};
 		}
 	}
 
@@ -1595,13 +1459,7 @@ static ecsact_eval_error eval_system_generates_statement(
 	std::span<const ecsact_statement>& context_stack,
 	const ecsact_statement&            statement
 ) {
-	auto [context, err] = expect_context(
-		context_stack,
-		{
-			ECSACT_STATEMENT_SYSTEM,
-			ECSACT_STATEMENT_ACTION,
-		}
-	);
+	auto [context, err] = expect_context(context_stack, statement);
 
 	if(err.code != ECSACT_EVAL_OK) {
 		return err;
@@ -1646,8 +1504,7 @@ static ecsact_eval_error eval_system_with_statement(
 		};
 	}
 
-	auto [context, err] =
-		expect_context(context_stack, {ECSACT_STATEMENT_SYSTEM_COMPONENT});
+	auto [context, err] = expect_context(context_stack, statement);
 
 	if(err.code != ECSACT_EVAL_OK) {
 		if(statement.data.system_with_statement.with_field_name_list_count > 0) {
@@ -1673,7 +1530,7 @@ static ecsact_eval_error eval_system_with_statement(
 		};
 	}
 
-	auto comp_name = std::string(
+	auto comp_name = std::string_view(
 		context_data.component_name.data,
 		context_data.component_name.length
 	);
@@ -1725,13 +1582,7 @@ static auto eval_system_notify_statement(
 	std::span<const ecsact_statement>& context_stack,
 	const ecsact_statement&            statement
 ) -> ecsact_eval_error {
-	auto [context, err] = expect_context(
-		context_stack,
-		{
-			ECSACT_STATEMENT_SYSTEM,
-			ECSACT_STATEMENT_ACTION,
-		}
-	);
+	auto [context, err] = expect_context(context_stack, statement);
 
 	if(err.code != ECSACT_EVAL_OK) {
 		return err;
@@ -1794,8 +1645,7 @@ static auto eval_system_notify_component_statement(
 		};
 	}
 
-	auto [context, err] =
-		expect_context(context_stack, {ECSACT_STATEMENT_SYSTEM_NOTIFY});
+	auto [context, err] = expect_context(context_stack, statement);
 
 	if(err.code != ECSACT_EVAL_OK) {
 		return err;
@@ -1825,7 +1675,7 @@ static auto eval_system_notify_component_statement(
 		context_stack[context_stack.size() - 2]
 	);
 
-	auto comp_like_name = std::string( //
+	auto comp_like_name = std::string_view( //
 		data.component_name.data,
 		data.component_name.length
 	);
@@ -1913,7 +1763,7 @@ static ecsact_eval_error eval_entity_constraint_statement(
 
 	auto& data = statement.data.entity_constraint_statement;
 
-	std::string comp_name(
+	auto comp_name = std::string_view(
 		data.constraint_component_name.data,
 		data.constraint_component_name.length
 	);
@@ -1956,6 +1806,14 @@ static ecsact_eval_error eval_entity_constraint_statement(
 	return {};
 }
 
+/**
+ * Null terminated name of @p type shown on its trace spans
+ */
+static auto statement_span_name(ecsact_statement_type type) -> const char* {
+	auto name = magic_enum::enum_name(type);
+	return name.empty() ? "ECSACT_STATEMENT_UNKNOWN" : name.data();
+}
+
 ecsact_eval_error ecsact_eval_statement(
 	ecsact_package_id       package_id,
 	int32_t                 statement_stack_size,
@@ -1967,6 +1825,10 @@ ecsact_eval_error ecsact_eval_statement(
 
 	auto&     statement = statement_stack[statement_stack_size - 1];
 	std::span context_statements(statement_stack, statement_stack_size - 1);
+	auto      span = scoped_trace_span{
+		"statement",
+		statement_span_name(statement.type),
+	};
 
 	auto err = [&]() -> std::optional<ecsact_eval_error> {
 		switch(statement.type) {
@@ -2092,6 +1954,178 @@ ecsact_package_id ecsact_eval_package_statement(
 	);
 }
 
+ecsact_package_id ecsact_eval_package_statement_in_context(
+	ecsact_runtime_context*         context,
+	const ecsact_package_statement* package_statement
+) {
+	auto context_scope = ecsact::detail::scoped_runtime_context{context};
+	return ecsact_eval_package_statement(package_statement);
+}
+
+ecsact_eval_error ecsact_eval_statement_in_context(
+	ecsact_runtime_context* context,
+	ecsact_package_id       package_id,
+	int32_t                 statement_stack_size,
+	const ecsact_statement* statement_stack
+) {
+	auto context_scope = ecsact::detail::scoped_runtime_context{context};
+	return ecsact_eval_statement(
+		package_id,
+		statement_stack_size,
+		statement_stack
+	);
+}
+
+/**
+ * Looks up the declaration @p statement created or refers to so the
+ * statements nested in it don't have to each look it up by name again
+ */
+static auto resolve_statement(
+	ecsact_package_id       package_id,
+	const ecsact_statement& statement
+) -> std::optional<ecsact_decl_id> {
+	switch(statement.type) {
+		case ECSACT_STATEMENT_COMPONENT:
+		case ECSACT_STATEMENT_TRANSIENT:
+		case ECSACT_STATEMENT_ACTION:
+			return cast_optional_id<ecsact_decl_id>(
+				find_by_statement<ecsact_composite_id>(package_id, statement)
+			);
+		case ECSACT_STATEMENT_SYSTEM:
+			return cast_optional_id<ecsact_decl_id>(
+				find_by_statement<ecsact_system_like_id>(package_id, statement)
+			);
+		case ECSACT_STATEMENT_SYSTEM_COMPONENT:
+			return cast_optional_id<ecsact_decl_id>(
+				find_by_statement<ecsact_component_like_id>(package_id, statement)
+			);
+		case ECSACT_STATEMENT_ENUM: {
+			auto& data = statement.data.enum_statement;
+			return cast_optional_id<ecsact_decl_id>(find_by_name<ecsact_enum_id>(
+				package_id,
+				std::string_view(data.enum_name.data, data.enum_name.length)
+			));
+		}
+		default:
+			break;
+	}
+
+	return {};
+}
+
+void ecsact_eval_statements(
+	ecsact_package_id            package_id,
+	int32_t                      statement_count,
+	const ecsact_statement*      statements,
+	const int32_t*               parent_indices,
+	int32_t                      max_error_count,
+	ecsact_eval_statement_error* out_errors,
+	int32_t*                     out_error_count
+) {
+	auto count = static_cast<size_t>(std::max(statement_count, 0));
+	auto has_children = std::vector<bool>(count);
+	for(auto i = 0; statement_count > i; ++i) {
+		auto parent = parent_indices[i];
+		if(parent >= 0 && parent < i) {
+			has_children[parent] = true;
+		}
+	}
+
+	auto skipped = std::vector<bool>(count);
+	auto resolved_ids = std::vector<std::optional<ecsact_decl_id>>(count);
+	auto resolved = resolved_statement_stack{};
+	auto resolved_scope = scoped_resolved_stack{resolved};
+	auto error_count = int32_t{};
+
+	auto report_error = [&](int32_t index, ecsact_eval_error err) {
+		if(out_errors && max_error_count > error_count) {
+			out_errors[error_count] = ecsact_eval_statement_error{
+				.statement_index = index,
+				.error = err,
+			};
+		}
+		error_count += 1;
+	};
+
+	for(auto i = 0; statement_count > i; ++i) {
+		auto parent = parent_indices[i];
+		if(parent < -1 || parent >= i) {
+			skipped[i] = true;
+			report_error(
+				i,
+				ecsact_eval_error{
+					.code = ECSACT_EVAL_ERR_INVALID_CONTEXT,
+					.relevant_content = {},
+					.context_type = ECSACT_STATEMENT_NONE,
+				}
+			);
+			continue;
+		}
+
+		if(parent != -1 && skipped[parent]) {
+			skipped[i] = true;
+			continue;
+		}
+
+		// Statements are usually in depth first order, so the parent is almost
+		// always on the stack already and only finished siblings get popped
+		while(!resolved.indices.empty() && resolved.indices.back() != parent) {
+			resolved.pop();
+		}
+
+		if(resolved.indices.empty() && parent != -1) {
+			auto chain = std::vector<int32_t>{};
+			for(auto index = parent; index != -1; index = parent_indices[index]) {
+				chain.push_back(index);
+			}
+			for(auto itr = chain.rbegin(); itr != chain.rend(); ++itr) {
+				resolved.push(statements[*itr], *itr, resolved_ids[*itr]);
+			}
+		}
+
+		resolved.push(statements[i], i, std::nullopt);
+		auto err = ecsact_eval_statement(
+			package_id,
+			static_cast<int32_t>(resolved.stack.size()),
+			resolved.stack.data()
+		);
+
+		if(err.code != ECSACT_EVAL_OK) {
+			skipped[i] = true;
+			report_error(i, err);
+		} else if(has_children[i]) {
+			resolved_ids[i] = resolve_statement(package_id, statements[i]);
+			resolved.ids.back() = resolved_ids[i];
+		}
+	}
+
+	if(out_error_count) {
+		*out_error_count = error_count;
+	}
+}
+
+void ecsact_eval_statements_in_context(
+	ecsact_runtime_context*      context,
+	ecsact_package_id            package_id,
+	int32_t                      statement_count,
+	const ecsact_statement*      statements,
+	const int32_t*               parent_indices,
+	int32_t                      max_error_count,
+	ecsact_eval_statement_error* out_errors,
+	int32_t*                     out_error_count
+) {
+	auto context_scope = ecsact::detail::scoped_runtime_context{context};
+	ecsact_eval_statements(
+		package_id,
+		statement_count,
+		statements,
+		parent_indices,
+		max_error_count,
+		out_errors,
+		out_error_count
+	);
+}
+
 void ecsact_eval_reset() {
 }
 
@@ -2110,10 +2144,12 @@ void ecsact::detail::check_file_eval_error(
 
 			auto act_id = find_by_name<ecsact_action_id>(
 				package_id,
-				std::string(data.action_name.data, data.action_name.length)
+				std::string_view(data.action_name.data, data.action_name.length)
 			);
 
-			auto caps = ecsact::meta::system_capabilities(*act_id);
+			auto caps = ecsact::interpret::views::system_capabilities(
+				ecsact_id_cast<ecsact_system_like_id>(*act_id)
+			);
 			if(caps.empty()) {
 				in_out_error.code = ECSACT_EVAL_ERR_NO_CAPABILITIES;
 				in_out_error.relevant_content = {
@@ -5,6 +5,7 @@
 #include "ecsact/parse/statements.h"
 #include "ecsact/runtime/common.h"
 #include "ecsact/interpret/eval_error.h"
+#include "parse-resolver-runtime/context.h"
 
 typedef struct ecsact_eval_error {
 	ecsact_eval_error_code code;
@@ -32,6 +33,76 @@ ecsact_eval_error ecsact_eval_statement(
 	const ecsact_statement* statement_stack
 );
 
+typedef struct ecsact_eval_statement_error {
+	/**
+	 * Index of the statement that failed to evaluate
+	 */
+	int32_t           statement_index;
+	ecsact_eval_error error;
+} ecsact_eval_statement_error;
+
+/**
+ * Evaluates a flattened tree of statements in one call. Each statement is
+ * evaluated the same way `ecsact_eval_statement` would with the chain of its
+ * parents as the statement stack. The declaration a parent statement resolved
+ * to is remembered for all of its children instead of being looked up again.
+ * Children of a statement that failed to evaluate are skipped.
+ * @param package_id the package the statements should be evaluated in
+ * @param statement_count size of `statements` and `parent_indices`
+ * @param statements statements in evaluation order
+ * @param parent_indices index of the statement directly containing each
+ *        statement or -1 for top level statements. Parents must come before
+ *        their children.
+ * @param max_error_count size of `out_errors`
+ * @param out_errors errors in statement order. May be NULL.
+ * @param out_error_count total number of errors, which may be more than
+ *        `max_error_count`. May be NULL.
+ */
+void ecsact_eval_statements(
+	ecsact_package_id            package_id,
+	int32_t                      statement_count,
+	const ecsact_statement*      statements,
+	const int32_t*               parent_indices,
+	int32_t                      max_error_count,
+	ecsact_eval_statement_error* out_errors,
+	int32_t*                     out_error_count
+);
+
+/**
+ * Same as `ecsact_eval_package_statement` except the package is created in
+ * @p context instead of the calling thread's current context.
+ */
+ecsact_package_id ecsact_eval_package_statement_in_context(
+	ecsact_runtime_context*         context,
+	const ecsact_package_statement* package_statement
+);
+
+/**
+ * Same as `ecsact_eval_statement` except the statement is evaluated in
+ * @p context instead of the calling thread's current context.
+ */
+ecsact_eval_error ecsact_eval_statement_in_context(
+	ecsact_runtime_context* context,
+	ecsact_package_id       package_id,
+	int32_t                 statement_stack_size,
+	const ecsact_statement* statement_stack
+);
+
+/**
+ * Same as `ecsact_eval_statements` except the statements are evaluated in
+ * @p context instead of the calling thread's current context.
+ */
+void ecsact_eval_statements_in_context(
+	ecsact_runtime_context*      context,
+	ecsact_package_id            package_id,
+	int32_t                      statement_count,
+	const ecsact_statement*      statements,
+	const int32_t*               parent_indices,
+	int32_t                      max_error_count,
+	ecsact_eval_statement_error* out_errors,
+	int32_t*                     out_error_count
+);
+
 ECSACT_DEPRECATED("unneeded since interpreter does not hold state")
 void ecsact_eval_reset();
 
@@ -1,14 +1,203 @@
 #pragma once
 
+#include <chrono>
+#include <cstdint>
 #include <filesystem>
+#include <map>
+#include <span>
+#include <string>
+#include <string_view>
 #include <vector>
+#include "ecsact/parse/statements.h"
+#include "parse-resolver-runtime/context.h"
 
 #include "parse_eval_error.hh"
 
 namespace ecsact {
 
+/**
+ * Wall time spent in each `eval_files` phase. Phases that were not reached
+ * because an earlier phase reported errors stay zero.
+ */
+struct eval_phase_times {
+	/**
+	 * Reading files from disk. Always zero for in memory sources.
+	 */
+	std::chrono::nanoseconds read_files{};
+
+	/**
+	 * Finding the files reachable from the roots. Zero without roots, see
+	 * `eval_files_options::root_packages`.
+	 */
+	std::chrono::nanoseconds select_roots{};
+	std::chrono::nanoseconds parse_package_statements{};
+	std::chrono::nanoseconds parse_imports{};
+
+	/**
+	 * Unknown and cyclic import checks
+	 */
+	std::chrono::nanoseconds check_imports{};
+	std::chrono::nanoseconds eval_package_statements{};
+
+	/**
+	 * Import evaluation and every declaration statement in dependency order
+	 */
+	std::chrono::nanoseconds eval_declarations{};
+	std::chrono::nanoseconds total{};
+};
+
+/**
+ * Resolver runtime objects that exist in the evaluated packages once
+ * `eval_files` returns.
+ */
+struct eval_object_counts {
+	int64_t packages = 0;
+	int64_t components = 0;
+	int64_t transients = 0;
+	int64_t systems = 0;
+	int64_t actions = 0;
+	int64_t enums = 0;
+	int64_t fields = 0;
+};
+
+struct eval_stats {
+	eval_phase_times phase_times;
+
+	/**
+	 * Successfully parsed statements by type. Block end statements are not
+	 * counted.
+	 */
+	std::map<ecsact_statement_type, int64_t> statements_parsed;
+
+	/**
+	 * Total size of all the evaluated sources
+	 */
+	int64_t bytes_read = 0;
+
+	eval_object_counts objects_created;
+
+	/**
+	 * Name lookups made against the resolver runtime while evaluating
+	 * declarations. A single reference may take more than one lookup when it can
+	 * resolve to several kinds of declarations (e.g. component or transient).
+	 */
+	int64_t symbol_lookups = 0;
+	int64_t symbol_lookup_misses = 0;
+};
+
+struct eval_files_options {
+	/**
+	 * Number of threads used to read the given files and parse their package and
+	 * import statements. These phases do not touch the resolver runtime so each
+	 * file can be handled in parallel. Values less than 1 use the hardware
+	 * concurrency.
+	 */
+	int jobs = 1;
+
+	/**
+	 * Number of files whose declaration statements may be parsed ahead of the
+	 * file being evaluated. Parsing happens on `jobs - 1` threads, but at least
+	 * one, while the calling thread evaluates files in import order. Zero parses
+	 * each file right before evaluating it.
+	 */
+	int pipeline_depth = 0;
+
+	/**
+	 * Evaluation stops once this many errors were reported and no more than this
+	 * many are returned. Zero means no limit.
+	 */
+	int max_errors = 0;
+
+	/**
+	 * Only return the errors of the first file reporting any. No file is
+	 * evaluated after a file whose declarations failed either way, but the
+	 * earlier phases check every file.
+	 */
+	bool stop_at_first_failing_file = false;
+
+	/**
+	 * Fill in `parse_eval_error::error_message` of the returned errors. When
+	 * false the messages are left empty and may be formatted later with
+	 * `format_error_messages` while the sources are still around. Unknown root
+	 * package errors only name the root when formatted here.
+	 */
+	bool format_messages = true;
+
+	/**
+	 * Only evaluate the files of these packages and of the packages they
+	 * transitively import. Every other file stops after its package and import
+	 * statements, which are all that is needed to follow the imports. Files
+	 * without a package name are always evaluated so their errors are reported.
+	 * A root that no file declares is reported as an
+	 * `ECSACT_EVAL_ERR_UNKNOWN_ROOT_PACKAGE` error with no source index. Empty,
+	 * and `main_package_root` unset, evaluates every file.
+	 */
+	std::vector<std::string> root_packages;
+
+	/**
+	 * Use the `main package` as a root as well. See `root_packages`. Reports an
+	 * `ECSACT_EVAL_ERR_NO_MAIN_PACKAGE` error if no file declares one.
+	 */
+	bool main_package_root = false;
+
+	/**
+	 * When set, overwritten with statistics about the evaluation
+	 */
+	eval_stats* stats = nullptr;
+
+	/**
+	 * When set, a Chrome trace event file with spans for each phase, file,
+	 * statement and expensive runtime call is written here once evaluation is
+	 * done. Empty uses the `ECSACT_INTERPRET_TRACE` environment variable if it
+	 * is set. Ignored while a trace is already being recorded, see
+	 * parse-resolver-runtime/trace.h
+	 */
+	std::filesystem::path trace_path;
+
+	/**
+	 * Runtime context to evaluate into. Null uses the calling thread's current
+	 * context. See parse-resolver-runtime/context.h
+	 */
+	ecsact_runtime_context* context = nullptr;
+};
+
+/**
+ * An ecsact source that is already in memory.
+ */
+struct eval_source {
+	/**
+	 * Path reported as the package source file path. Does not need to exist.
+	 */
+	std::filesystem::path file_path;
+
+	/**
+	 * Full ecsact source text. Statements are parsed directly out of this buffer
+	 * so it must stay alive until `eval_files` returns.
+	 */
+	std::string_view source;
+};
+
+std::vector<parse_eval_error> eval_files(
+	std::vector<std::filesystem::path> files,
+	eval_files_options                 options = {}
+);
+
+/**
+ * Same as above except the sources are provided directly instead of being read
+ * from disk. `parse_eval_error::source_index` indexes into @p sources.
+ */
 std::vector<parse_eval_error> eval_files(
-	std::vector<std::filesystem::path> files
+	std::span<const eval_source> sources,
+	eval_files_options           options = {}
+);
+
+/**
+ * Formats the message of each of @p errors that doesn't have one yet.
+ * @p sources are the sources the errors were reported for.
+ */
+void format_error_messages(
+	std::span<parse_eval_error>  errors,
+	std::span<const eval_source> sources
 );
 
 } // namespace ecsact
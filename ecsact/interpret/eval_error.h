@@ -91,6 +91,15 @@ typedef enum ecsact_eval_error_code {
 	/// Field type is not allowed in 'with' statement
 	ECSACT_EVAL_ERR_INVALID_ASSOC_FIELD_TYPE,
 
+	/// Package imports form a cycle.
+	ECSACT_EVAL_ERR_CYCLIC_IMPORT,
+
+	/// No file declares a package given as an evaluation root.
+	ECSACT_EVAL_ERR_UNKNOWN_ROOT_PACKAGE,
+
+	/// The main package was to be an evaluation root but no file declares one.
+	ECSACT_EVAL_ERR_NO_MAIN_PACKAGE,
+
 	/// Internal error. Should not happen and is an indiciation of a bug.
 	ECSACT_EVAL_ERR_INTERNAL = 999,
 
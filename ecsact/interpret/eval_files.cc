@@ -1,89 +1,142 @@
 #include "ecsact/interpret/eval.hh"
 
+#include <chrono>
 #include <filesystem>
+#include <span>
+#include <string>
 #include <vector>
-#include <array>
-#include <fstream>
 #include <utility>
 #include "ecsact/parse.h"
 #include "ecsact/interpret/eval.h"
 
-#include "./detail/check_set.hh"
-#include "./detail/fixed_stack.hh"
+#include "./detail/parallel.hh"
 #include "./detail/read_util.hh"
-#include "./detail/stack_util.hh"
-#include "./detail/string_util.hh"
 #include "./detail/eval_parse.hh"
+#include "./detail/eval_counters.hh"
+#include "./detail/runtime_context.hh"
+#include "./detail/trace.hh"
 
 namespace fs = std::filesystem;
 using ecsact::parse_eval_error;
 
-std::vector<parse_eval_error> ecsact::eval_files(std::vector<fs::path> files) {
-	using ecsact::detail::check_cyclic_imports;
-	using ecsact::detail::check_set;
-	using ecsact::detail::check_unknown_imports;
-	using ecsact::detail::eval_imports;
-	using ecsact::detail::eval_package_statements;
+std::vector<parse_eval_error> ecsact::eval_files(
+	std::vector<fs::path> files,
+	eval_files_options    options
+) {
+	using ecsact::detail::read_source_files;
+	using ecsact::detail::record_read_time;
+	using ecsact::detail::scoped_trace_file;
+	using ecsact::detail::scoped_trace_span;
+
+	auto trace = scoped_trace_file{options.trace_path};
+	auto span = scoped_trace_span{"eval", "eval_files"};
+
+	auto files_read = read_source_files(std::move(files), options.jobs);
+	auto errors = eval_files(
+		std::span<const eval_source>{files_read.sources},
+		options
+	);
+	record_read_time(options.stats, files_read.read_time);
+	return errors;
+}
+
+/**
+ * `eval_files` of @p sources without roots. When @p selection is set the
+ * sources are the ones it picked and its states are evaluated.
+ */
+static auto eval_sources(
+	std::span<const ecsact::eval_source> sources,
+	const ecsact::eval_files_options&    options,
+	ecsact::detail::root_selection*      selection
+) -> std::vector<parse_eval_error> {
+	using ecsact::detail::buffer_input;
+	using ecsact::detail::error_budget_of;
+	using ecsact::detail::eval_file_states;
 	using ecsact::detail::eval_parse_state;
-	using ecsact::detail::fixed_stack;
-	using ecsact::detail::get_sorted_states;
-	using ecsact::detail::parse_eval_declarations;
-	using ecsact::detail::parse_imports;
-	using ecsact::detail::parse_package_statements;
-	using ecsact::detail::stream_get_until;
-	using ecsact::detail::try_top;
-
-	std::vector<parse_eval_error>                errors;
-	std::vector<eval_parse_state<std::ifstream>> file_states;
-	file_states.reserve(files.size());
-	for(auto file_path : files) {
-		auto& file_state = file_states.emplace_back();
-		file_state.file_path = file_path;
-		file_state.reader.stream.open(file_path);
-	}
+	using ecsact::detail::resolve_job_count;
+	using ecsact::detail::scoped_phase_timer;
+	using ecsact::detail::scoped_runtime_context;
+	using ecsact::detail::scoped_trace_file;
+	using ecsact::detail::scoped_trace_span;
 
-	parse_package_statements(file_states, errors);
-	if(!errors.empty()) {
-		return errors;
-	}
+	auto trace = scoped_trace_file{options.trace_path};
+	auto span = scoped_trace_span{"eval", "eval_files"};
+	auto context_scope = scoped_runtime_context{options.context};
 
-	parse_imports(file_states, errors);
-	if(!errors.empty()) {
-		return errors;
+	auto stats = options.stats;
+	if(stats) {
+		*stats = {};
+		for(auto& source : sources) {
+			stats->bytes_read += static_cast<int64_t>(source.source.size());
+		}
 	}
+	auto timer = scoped_phase_timer{stats ? &stats->phase_times.total : nullptr};
 
-	check_unknown_imports(file_states, errors);
-	if(!errors.empty()) {
-		return errors;
+	std::vector<parse_eval_error>               errors;
+	std::vector<eval_parse_state<buffer_input>> file_states;
+	if(selection) {
+		file_states = std::move(selection->states);
+	} else {
+		file_states.reserve(sources.size());
+		for(auto& source : sources) {
+			auto& file_state = file_states.emplace_back();
+			file_state.file_path = source.file_path;
+			file_state.reader.stream.buffer = source.source;
+		}
 	}
 
-	check_cyclic_imports(file_states, errors);
-	if(!errors.empty()) {
-		return errors;
+	eval_file_states(
+		file_states,
+		errors,
+		resolve_job_count(options.jobs),
+		{},
+		stats,
+		options.pipeline_depth,
+		error_budget_of(options)
+	);
+
+	if(options.format_messages) {
+		auto phase_span = scoped_trace_span{"phase", "format_error_messages"};
+		ecsact::format_error_messages(errors, sources);
 	}
 
-	eval_package_statements(file_states, errors);
-	if(!errors.empty()) {
-		return errors;
+	return errors;
+}
+
+std::vector<parse_eval_error> ecsact::eval_files(
+	std::span<const eval_source> sources,
+	eval_files_options           options
+) {
+	using ecsact::detail::eval_root_sources;
+	using ecsact::detail::has_roots;
+
+	if(has_roots(options)) {
+		return eval_root_sources(
+			sources,
+			options,
+			[](auto selected, auto selected_options, auto& selection) {
+				return eval_sources(selected, selected_options, &selection);
+			}
+		);
 	}
 
-	auto sorted_file_states = get_sorted_states(file_states);
-	auto source_index = 0;
-	for(auto& file_state_ref : sorted_file_states) {
-		auto& file_state = file_state_ref.get();
+	return eval_sources(sources, options, nullptr);
+}
 
-		eval_imports(source_index, file_state, errors);
-		if(!errors.empty()) {
-			return errors;
+void ecsact::format_error_messages(
+	std::span<parse_eval_error>  errors,
+	std::span<const eval_source> sources
+) {
+	for(auto& err : errors) {
+		if(!err.error_message.empty()) {
+			continue;
 		}
 
-		parse_eval_declarations(source_index, file_state, errors);
-		if(!errors.empty()) {
-			return errors;
+		auto source = std::string_view{};
+		if(err.source_index >= 0 &&
+			 sources.size() > static_cast<std::size_t>(err.source_index)) {
+			source = sources[err.source_index].source;
 		}
-
-		source_index += 1;
+		err.error_message = format_error_message(err, source);
 	}
-
-	return errors;
 }
@@ -0,0 +1,267 @@
+#include "ecsact/interpret/eval_session.hh"
+
+#include <chrono>
+#include <functional>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include "ecsact/runtime/dynamic.h"
+#include "ecsact/parse.h"
+#include "ecsact/interpret/eval.h"
+
+#include "./detail/parallel.hh"
+#include "./detail/read_util.hh"
+#include "./detail/eval_parse.hh"
+#include "./detail/eval_counters.hh"
+#include "./detail/runtime_context.hh"
+#include "./detail/trace.hh"
+
+namespace fs = std::filesystem;
+using ecsact::eval_session;
+using ecsact::parse_eval_error;
+
+static auto file_key(const fs::path& file_path) -> std::string {
+	return file_path.generic_string();
+}
+
+eval_session::eval_session(ecsact_runtime_context* context)
+	: _context(context) {
+}
+
+auto eval_session::eval_files( //
+	std::vector<fs::path> files,
+	eval_files_options    options
+) -> std::vector<parse_eval_error> {
+	using ecsact::detail::read_source_files;
+	using ecsact::detail::record_read_time;
+	using ecsact::detail::scoped_trace_file;
+	using ecsact::detail::scoped_trace_span;
+
+	auto trace = scoped_trace_file{options.trace_path};
+	auto span = scoped_trace_span{"eval", "eval_files"};
+
+	auto files_read = read_source_files(std::move(files), options.jobs);
+	auto errors = eval_files(
+		std::span<const eval_source>{files_read.sources},
+		options
+	);
+	record_read_time(options.stats, files_read.read_time);
+	return errors;
+}
+
+auto eval_session::eval_files( //
+	std::span<const eval_source> sources,
+	eval_files_options           options
+) -> std::vector<parse_eval_error> {
+	using ecsact::detail::eval_root_sources;
+	using ecsact::detail::has_roots;
+
+	if(has_roots(options)) {
+		return eval_root_sources(
+			sources,
+			options,
+			[this](auto selected, auto selected_options, auto& selection) {
+				return eval_sources(selected, selected_options, &selection);
+			}
+		);
+	}
+
+	return eval_sources(sources, options, nullptr);
+}
+
+auto eval_session::eval_sources( //
+	std::span<const eval_source> sources,
+	const eval_files_options&    options,
+	detail::root_selection*      selection
+) -> std::vector<parse_eval_error> {
+	using ecsact::detail::buffer_input;
+	using ecsact::detail::error_budget_of;
+	using ecsact::detail::eval_file_states;
+	using ecsact::detail::eval_parse_state;
+	using ecsact::detail::resolve_job_count;
+	using ecsact::detail::scoped_phase_timer;
+	using ecsact::detail::scoped_runtime_context;
+	using ecsact::detail::scoped_trace_file;
+	using ecsact::detail::scoped_trace_span;
+
+	auto trace = scoped_trace_file{options.trace_path};
+	auto span = scoped_trace_span{"eval", "eval_files"};
+	auto context_scope = scoped_runtime_context{_context};
+
+	auto stats = options.stats;
+	if(stats) {
+		*stats = {};
+	}
+	auto timer = scoped_phase_timer{stats ? &stats->phase_times.total : nullptr};
+
+	auto keys = std::vector<std::string>{};
+	auto hashes = std::vector<std::size_t>{};
+	auto dirty = std::vector<bool>{};
+	keys.reserve(sources.size());
+	hashes.reserve(sources.size());
+	dirty.reserve(sources.size());
+
+	// Package names whose importers must be evaluated again
+	auto dirty_package_names = std::vector<std::string_view>{};
+
+	for(auto& source : sources) {
+		auto& key = keys.emplace_back(file_key(source.file_path));
+		auto  hash = std::hash<std::string_view>{}(source.source);
+		hashes.push_back(hash);
+
+		auto itr = _files.find(key);
+		auto changed = itr == _files.end() || !itr->second.evaluated ||
+			itr->second.content_hash != hash;
+		dirty.push_back(changed);
+
+		if(changed && itr != _files.end()) {
+			dirty_package_names.push_back(itr->second.package_name);
+		}
+	}
+
+	auto removed_keys = std::vector<std::string>{};
+	{
+		auto given_keys =
+			std::unordered_set<std::string_view>{keys.begin(), keys.end()};
+		for(auto& [key, record] : _files) {
+			if(!given_keys.contains(key)) {
+				removed_keys.push_back(key);
+				dirty_package_names.push_back(record.package_name);
+			}
+		}
+	}
+
+	// Clean files whose previous imports are still valid, indexed by the package
+	// names they import.
+	auto importers =
+		std::unordered_map<std::string_view, std::vector<std::size_t>>{};
+	for(std::size_t index = 0; sources.size() > index; ++index) {
+		if(dirty[index]) {
+			continue;
+		}
+		for(auto& import_name : _files.at(keys[index]).imports) {
+			importers[import_name].push_back(index);
+		}
+	}
+
+	while(!dirty_package_names.empty()) {
+		auto package_name = dirty_package_names.back();
+		dirty_package_names.pop_back();
+
+		auto itr = importers.find(package_name);
+		if(itr == importers.end()) {
+			continue;
+		}
+
+		for(auto importer : itr->second) {
+			if(!dirty[importer]) {
+				dirty[importer] = true;
+				dirty_package_names.push_back(_files.at(keys[importer]).package_name);
+			}
+		}
+	}
+
+	for(auto& key : removed_keys) {
+		auto itr = _files.find(key);
+		if(itr->second.package_id) {
+			ecsact_destroy_package(*itr->second.package_id);
+		}
+		_files.erase(itr);
+	}
+
+	auto external_packages = std::unordered_set<std::string_view>{};
+	auto dirty_indices = std::vector<std::size_t>{};
+	for(std::size_t index = 0; sources.size() > index; ++index) {
+		auto itr = _files.find(keys[index]);
+		if(!dirty[index]) {
+			external_packages.insert(itr->second.package_name);
+			continue;
+		}
+
+		dirty_indices.push_back(index);
+		if(itr != _files.end() && itr->second.package_id) {
+			ecsact_destroy_package(*itr->second.package_id);
+			itr->second.package_id = std::nullopt;
+		}
+	}
+
+	auto errors = std::vector<parse_eval_error>{};
+	auto file_states = std::vector<eval_parse_state<buffer_input>>{};
+	file_states.reserve(dirty_indices.size());
+	for(auto index : dirty_indices) {
+		if(selection) {
+			file_states.push_back(std::move(selection->states[index]));
+		} else {
+			auto& file_state = file_states.emplace_back();
+			file_state.file_path = sources[index].file_path;
+			file_state.reader.stream.buffer = sources[index].source;
+		}
+		if(stats) {
+			stats->bytes_read += static_cast<int64_t>(sources[index].source.size());
+		}
+	}
+
+	eval_file_states(
+		file_states,
+		errors,
+		resolve_job_count(options.jobs),
+		external_packages,
+		stats,
+		options.pipeline_depth,
+		error_budget_of(options)
+	);
+
+	for(auto& err : errors) {
+		if(err.source_index >= 0) {
+			err.source_index = static_cast<int>(dirty_indices[err.source_index]);
+		}
+	}
+
+	for(std::size_t i = 0; dirty_indices.size() > i; ++i) {
+		auto& file_state = file_states[i];
+		auto  index = dirty_indices[i];
+		auto& record = _files[keys[index]];
+
+		record.content_hash = hashes[index];
+		record.evaluated = errors.empty();
+		record.package_id = file_state.package_id;
+		record.package_name = std::move(file_state.package_name);
+		record.imports = std::move(file_state.imports);
+	}
+
+	_last_evaluated_count = dirty_indices.size();
+
+	if(options.format_messages) {
+		auto phase_span = scoped_trace_span{"phase", "format_error_messages"};
+		format_error_messages(errors, sources);
+	}
+
+	return errors;
+}
+
+auto eval_session::package_id( //
+	const fs::path& file_path
+) const -> std::optional<ecsact_package_id> {
+	auto itr = _files.find(file_key(file_path));
+	if(itr == _files.end()) {
+		return std::nullopt;
+	}
+
+	return itr->second.package_id;
+}
+
+auto eval_session::last_evaluated_count() const -> std::size_t {
+	return _last_evaluated_count;
+}
+
+auto eval_session::clear() -> void {
+	auto context_scope = ecsact::detail::scoped_runtime_context{_context};
+	for(auto& [_, record] : _files) {
+		if(record.package_id) {
+			ecsact_destroy_package(*record.package_id);
+		}
+	}
+
+	_files.clear();
+	_last_evaluated_count = 0;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "ecsact/runtime/common.h"
+#include "parse-resolver-runtime/context.h"
+
+#include "eval.hh"
+#include "parse_eval_error.hh"
+
+namespace ecsact {
+
+namespace detail {
+struct root_selection;
+}
+
+/**
+ * Incremental version of `eval_files`. Remembers a content hash for every file
+ * path it evaluated and on later calls only re-evaluates the files whose
+ * content changed plus every file that transitively imports one of them. The
+ * previous packages of those files are destroyed with `ecsact_destroy_package`
+ * before they are evaluated again. Packages of files that are no longer given
+ * are destroyed as well. `eval_files_options::stats` only covers the files
+ * that were evaluated again. With `eval_files_options::root_packages` the
+ * files that aren't reachable from the roots count as not given.
+ *
+ * Packages created by a session are left alone when the session is destroyed.
+ * Call `clear` to destroy them.
+ *
+ * A session always evaluates into the runtime context it was created with.
+ * `eval_files_options::context` is ignored.
+ */
+class eval_session {
+public:
+	eval_session() = default;
+
+	/**
+	 * Session evaluating into @p context instead of the calling thread's current
+	 * context.
+	 */
+	explicit eval_session(ecsact_runtime_context* context);
+
+	eval_session(eval_session&&) = default;
+	eval_session(const eval_session&) = delete;
+	auto operator=(eval_session&&) -> eval_session& = default;
+	auto operator=(const eval_session&) -> eval_session& = delete;
+
+	auto eval_files( //
+		std::vector<std::filesystem::path> files,
+		eval_files_options                 options = {}
+	) -> std::vector<parse_eval_error>;
+
+	auto eval_files( //
+		std::span<const eval_source> sources,
+		eval_files_options           options = {}
+	) -> std::vector<parse_eval_error>;
+
+	/**
+	 * Package evaluated for @p file_path, if any.
+	 */
+	auto package_id( //
+		const std::filesystem::path& file_path
+	) const -> std::optional<ecsact_package_id>;
+
+	/**
+	 * Number of files that were evaluated by the last `eval_files` call.
+	 */
+	auto last_evaluated_count() const -> std::size_t;
+
+	/**
+	 * Destroys every package created by this session and forgets all files.
+	 */
+	auto clear() -> void;
+
+private:
+	/**
+	 * `eval_files` of @p sources without roots. When @p selection is set the
+	 * sources are the ones it picked and its states are evaluated.
+	 */
+	auto eval_sources( //
+		std::span<const eval_source> sources,
+		const eval_files_options&    options,
+		detail::root_selection*      selection
+	) -> std::vector<parse_eval_error>;
+
+	struct file_record {
+		std::size_t                      content_hash = 0;
+		bool                             evaluated = false;
+		std::optional<ecsact_package_id> package_id;
+		std::string                      package_name;
+		std::vector<std::string>         imports;
+	};
+
+	ecsact_runtime_context*                      _context = nullptr;
+	std::unordered_map<std::string, file_record> _files;
+	std::size_t                                  _last_evaluated_count = 0;
+};
+
+} // namespace ecsact
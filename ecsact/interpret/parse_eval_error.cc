@@ -0,0 +1,80 @@
+#include "ecsact/interpret/parse_eval_error.hh"
+
+#include <cassert>
+#include <string>
+#include <string_view>
+#include "magic_enum.hpp"
+
+template<>
+struct magic_enum::customize::enum_range<ecsact_eval_error_code> {
+	static constexpr int min = 0;
+	static constexpr int max = 2000;
+};
+
+static auto error_content( //
+	const ecsact::parse_eval_error& err,
+	std::string_view                source
+) -> std::string_view {
+	if(err.content_offset < 0) {
+		return {};
+	}
+
+	auto offset = static_cast<std::size_t>(err.content_offset);
+	if(offset > source.size()) {
+		return {};
+	}
+
+	return source.substr(offset, static_cast<std::size_t>(err.content_length));
+}
+
+auto ecsact::format_error_message( //
+	const parse_eval_error& err,
+	std::string_view        source
+) -> std::string {
+	auto content = error_content(err, source);
+
+	if(err.parse_status != ECSACT_PARSE_STATUS_OK) {
+		switch(err.parse_status) {
+			case ECSACT_PARSE_STATUS_SYNTAX_ERROR:
+				return "Failed to parse statement. Syntax error.";
+			case ECSACT_PARSE_STATUS_UNEXPECTED_EOF:
+				return "Failed to parse statement. Unexpected EOF.";
+			default:
+				return "Unknown parse error.";
+		}
+	}
+
+	switch(err.eval_error) {
+		case ECSACT_EVAL_ERR_EXPECTED_PACKAGE_STATEMENT:
+			return "Must have package statement as first statement in file.";
+		case ECSACT_EVAL_ERR_UNKNOWN_IMPORT:
+			return "Unknown import package '" + std::string(content) + "'";
+		case ECSACT_EVAL_ERR_CYCLIC_IMPORT:
+			return "Cyclic import package '" + std::string(content) + "'";
+		case ECSACT_EVAL_ERR_UNKNOWN_ROOT_PACKAGE:
+			if(content.empty()) {
+				return "Unknown root package";
+			}
+			return "Unknown root package '" + std::string(content) + "'";
+		case ECSACT_EVAL_ERR_NO_MAIN_PACKAGE:
+			return "No main package to use as root";
+		default:
+			break;
+	}
+
+	auto err_code_str = std::string{magic_enum::enum_name(err.eval_error)};
+	if(!err_code_str.empty()) {
+		err_code_str = err_code_str.substr(16);
+	} else {
+		assert(false && "Magic Enum failed to get error name");
+	}
+
+	auto error_message = err_code_str + " (" +
+		std::to_string(magic_enum::enum_integer(err.eval_error)) + ")";
+	if(!content.empty()) {
+		error_message += " near: ";
+		error_message += content;
+	}
+
+	return error_message;
+}
@@ -1,16 +1,50 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include "ecsact/parse/status.h"
 #include "ecsact/interpret/eval_error.h"
 
 namespace ecsact {
 
+/**
+ * An error reported by `eval_files`. Errors are recorded as plain data and
+ * their message is only formatted when asked for, see
+ * `eval_files_options::format_messages`.
+ */
 struct parse_eval_error {
 	ecsact_eval_error_code eval_error = {};
-	int                    source_index = -1;
-	int                    line = -1;
-	int                    character = -1;
-	std::string            error_message;
+
+	/**
+	 * Set instead of `eval_error` when a statement failed to parse
+	 */
+	ecsact_parse_status_code parse_status = ECSACT_PARSE_STATUS_OK;
+
+	int source_index = -1;
+	int line = -1;
+	int character = -1;
+
+	/**
+	 * Byte offset and length of the content the error is about in the source at
+	 * `source_index`. The offset is -1 if there is no such content.
+	 */
+	int content_offset = -1;
+	int content_length = 0;
+
+	/**
+	 * Empty until formatted
+	 */
+	std::string error_message;
 };
 
+/**
+ * Formats the message of @p err. @p source is the source at
+ * `parse_eval_error::source_index` and is only used for the content the error
+ * is about.
+ */
+auto format_error_message( //
+	const parse_eval_error& err,
+	std::string_view        source
+) -> std::string;
+
 } // namespace ecsact
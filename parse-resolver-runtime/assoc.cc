@@ -5,25 +5,53 @@
 #include <unordered_map>
 #include <algorithm>
 #include <utility>
-#include <memory>
+#include <cstddef>
+#include <cstdint>
 #include <stdexcept>
+#include "parse-resolver-runtime/export.h"
+#include "parse-resolver-runtime/lookup.h"
+#include "parse-resolver-runtime/views.hh"
+#include "parse-resolver-runtime/context.hh"
+#include "parse-resolver-runtime/def_pool.hh"
+#include "parse-resolver-runtime/fingerprint.hh"
+#include "parse-resolver-runtime/freeze.hh"
 #include "parse-resolver-runtime/ids.hh"
 #include "parse-resolver-runtime/lifecycle.hh"
+#include "parse-resolver-runtime/memory.hh"
 
+using ecsact::interpret::details::add_memory;
+using ecsact::interpret::details::assoc_state;
+using ecsact::interpret::details::current_context;
+using ecsact::interpret::details::def_pool;
+using ecsact::interpret::details::ensure_mutable;
 using ecsact::interpret::details::event_ref;
+using ecsact::interpret::details::fingerprint_fact;
+using ecsact::interpret::details::fingerprint_fact_kind;
+using ecsact::interpret::details::fingerprint_key;
 using ecsact::interpret::details::gen_next_id;
+using ecsact::interpret::details::heap_bytes;
 using ecsact::interpret::details::on_destroy;
+using ecsact::interpret::details::state_ptr;
+
+namespace views = ecsact::interpret::views;
 
 struct assoc_info {
 	using cap_comp_list_t =
 		std::vector<std::pair<ecsact_component_like_id, ecsact_system_capability>>;
 
 	ecsact_system_assoc_id       id;
+	ecsact_system_like_id        system_id;
 	ecsact_component_like_id     comp_id;
 	std::vector<ecsact_field_id> assoc_fields;
 
 	cap_comp_list_t caps;
 
+	/**
+	 * Stands in for the association in fingerprint facts. Made from the system,
+	 * the component and how many associations the pair had before this one.
+	 */
+	uint64_t fingerprint_key = 0;
+
 	std::vector<event_ref> event_refs;
 
 	assoc_info() = default;
@@ -31,17 +59,64 @@ struct assoc_info {
 	~assoc_info() = default;
 };
 
-using system_assoc_map_info_t = std::unordered_map<
-	ecsact_system_like_id,
-	std::vector<std::shared_ptr<assoc_info>>>;
+using assoc_id_list_t = std::vector<ecsact_system_assoc_id>;
+
+struct ecsact::interpret::details::assoc_state {
+	def_pool<assoc_info> assoc_defs;
+
+	/**
+	 * Index into `assoc_defs` for each association ID. -1 for IDs that are not
+	 * associations.
+	 */
+	std::vector<int32_t> assoc_slots;
+
+	/**
+	 * Associations of each system in the order they were added
+	 */
+	std::unordered_map<ecsact_system_like_id, assoc_id_list_t> system_assoc_ids;
+
+	/**
+	 * Associations of each (system, component) pair in the order they were
+	 * added. Keyed by `system_component_key`.
+	 */
+	std::unordered_map<uint64_t, assoc_id_list_t> system_component_assoc_ids;
+};
+
+auto ecsact::interpret::details::make_assoc_state() -> state_ptr<assoc_state> {
+	return state_ptr<assoc_state>{new assoc_state{}};
+}
+
+auto ecsact::interpret::details::destroy_state(assoc_state* state) -> void {
+	delete state;
+}
 
-static system_assoc_map_info_t system_assoc_info{};
+static auto state() -> assoc_state& {
+	return *current_context().assoc;
+}
+
+static auto system_component_key(
+	ecsact_system_like_id    system_id,
+	ecsact_component_like_id component_id
+) -> uint64_t {
+	return (static_cast<uint64_t>(static_cast<uint32_t>(system_id)) << 32) |
+		static_cast<uint32_t>(component_id);
+}
+
+static auto find_assoc_slot(ecsact_system_assoc_id assoc_id) -> int32_t {
+	auto& slots = state().assoc_slots;
+	auto  index = static_cast<int32_t>(assoc_id);
+	if(index < 0 || index >= static_cast<int32_t>(slots.size())) {
+		return -1;
+	}
+	return slots[index];
+}
 
 static auto get_system_assoc_list( //
 	ecsact_system_like_id system_id
-) -> std::vector<std::shared_ptr<assoc_info>>* {
-	auto itr = system_assoc_info.find(system_id);
-	if(itr != system_assoc_info.end()) {
+) -> const assoc_id_list_t* {
+	auto& system_assoc_ids = state().system_assoc_ids;
+	auto  itr = system_assoc_ids.find(system_id);
+	if(itr != system_assoc_ids.end()) {
 		return &itr->second;
 	}
 
@@ -51,73 +126,191 @@ static auto get_system_assoc_list( //
 static auto get_assoc_info( //
 	ecsact_system_like_id  system_id,
 	ecsact_system_assoc_id assoc_id
-) -> std::shared_ptr<assoc_info> {
-	auto list = get_system_assoc_list(system_id);
-	if(!list) {
-		return {};
+) -> assoc_info* {
+	auto slot = find_assoc_slot(assoc_id);
+	if(slot == -1) {
+		return nullptr;
+	}
+
+	auto& info = state().assoc_defs[slot];
+	if(info.system_id != system_id) {
+		return nullptr;
+	}
+
+	return &info;
+}
+
+template<typename ID>
+static auto key_of(ID id) -> uint64_t {
+	return fingerprint_key(ecsact_id_cast<ecsact_decl_id>(id));
+}
+
+/**
+ * Adds the fact made of @p values to, or removes it from, the fingerprint of
+ * the package owning the system of @p info
+ */
+template<typename... Values>
+static auto update_fact(const assoc_info& info, bool add, Values... values)
+	-> void {
+	auto decl_id = ecsact_id_cast<ecsact_decl_id>(info.system_id);
+	auto fact = fingerprint_fact(values...);
+	if(add) {
+		ecsact::interpret::details::add_fingerprint_fact(decl_id, fact);
+	} else {
+		ecsact::interpret::details::remove_fingerprint_fact(decl_id, fact);
 	}
+}
 
-	auto itr = std::find_if( //
-		list->begin(),
-		list->end(),
-		[=](const auto& item) -> bool { return item->id == assoc_id; }
+static auto update_field_fact(
+	const assoc_info& info,
+	bool              add,
+	ecsact_field_id   field_id
+) -> void {
+	update_fact(
+		info,
+		add,
+		fingerprint_fact_kind::assoc_field,
+		info.fingerprint_key,
+		field_id
 	);
+}
 
-	if(itr == list->end()) {
-		return {};
+static auto update_capability_fact(
+	const assoc_info&        info,
+	bool                     add,
+	ecsact_component_like_id comp_id,
+	ecsact_system_capability cap
+) -> void {
+	update_fact(
+		info,
+		add,
+		fingerprint_fact_kind::assoc_capability,
+		info.fingerprint_key,
+		key_of(comp_id),
+		cap
+	);
+}
+
+static auto erase_assoc_id( //
+	auto&                  index,
+	auto                   key,
+	ecsact_system_assoc_id assoc_id
+) -> void {
+	auto itr = index.find(key);
+	if(itr == index.end()) {
+		return;
 	}
 
-	return *itr;
+	std::erase(itr->second, assoc_id);
+	if(itr->second.empty()) {
+		index.erase(itr);
+	}
 }
 
 ecsact_system_assoc_id ecsact_add_system_assoc( //
 	ecsact_system_like_id    system_id,
 	ecsact_component_like_id component_id
 ) {
-	auto itr = system_assoc_info.find(system_id);
-	if(itr == system_assoc_info.end()) {
-		itr = system_assoc_info.insert(system_assoc_info.end(), {system_id, {}});
-	}
-
-	auto& info = itr->second.emplace_back(std::make_shared<assoc_info>());
-	info->id = gen_next_id<ecsact_system_assoc_id>();
-	info->comp_id = component_id;
+	ensure_mutable(__func__);
+	auto& assocs = state();
+	auto  assoc_id = gen_next_id<ecsact_system_assoc_id>();
+	auto  slot = assocs.assoc_defs.emplace();
+
+	auto index = static_cast<std::size_t>(assoc_id);
+	if(index >= assocs.assoc_slots.size()) {
+		assocs.assoc_slots.resize(index + 1, -1);
+	}
+	assocs.assoc_slots[index] = slot;
+
+	auto& info = assocs.assoc_defs[slot];
+	info.id = assoc_id;
+	info.system_id = system_id;
+	info.comp_id = component_id;
+
+	auto  key = system_component_key(system_id, component_id);
+	auto& pair_assoc_ids = assocs.system_component_assoc_ids[key];
+	assocs.system_assoc_ids[system_id].push_back(assoc_id);
+	info.fingerprint_key = fingerprint_fact(
+		fingerprint_fact_kind::assoc,
+		key_of(system_id),
+		key_of(component_id),
+		pair_assoc_ids.size()
+	);
+	pair_assoc_ids.push_back(assoc_id);
+	update_fact(info, true, info.fingerprint_key);
 
-	info->event_refs
-		.emplace_back(on_destroy(system_id, [system_id, assoc_id = info->id]() {
+	info.event_refs
+		.emplace_back(on_destroy(system_id, [system_id, assoc_id]() {
 			ecsact_remove_system_assoc(system_id, assoc_id);
 		}));
 
-	info->event_refs
-		.emplace_back(on_destroy(component_id, [system_id, assoc_id = info->id]() {
+	info.event_refs
+		.emplace_back(on_destroy(component_id, [system_id, assoc_id]() {
 			ecsact_remove_system_assoc(system_id, assoc_id);
 		}));
 
-	return info->id;
+	return assoc_id;
 }
 
 void ecsact_remove_system_assoc( //
 	ecsact_system_like_id  system_id,
 	ecsact_system_assoc_id assoc_id
 ) {
-	auto list = get_system_assoc_list(system_id);
-	if(!list) {
-		// No associations. Why did you try to remove? User error.
+	ensure_mutable(__func__);
+	auto info = get_assoc_info(system_id, assoc_id);
+	if(!info) {
+		// Unknown association id. User error.
 		return;
 	}
 
-	auto itr = std::find_if( //
-		list->begin(),
-		list->end(),
-		[=](const auto& item) -> bool { return item->id == assoc_id; }
+	for(auto field_id : info->assoc_fields) {
+		update_field_fact(*info, false, field_id);
+	}
+	for(auto [comp_id, cap] : info->caps) {
+		update_capability_fact(*info, false, comp_id, cap);
+	}
+	update_fact(*info, false, info->fingerprint_key);
+
+	auto& assocs = state();
+	erase_assoc_id(assocs.system_assoc_ids, system_id, assoc_id);
+	erase_assoc_id(
+		assocs.system_component_assoc_ids,
+		system_component_key(system_id, info->comp_id),
+		assoc_id
 	);
 
-	if(itr == list->end()) {
-		// Unknown association id. User error.
+	auto& slot = assocs.assoc_slots[static_cast<std::size_t>(assoc_id)];
+	assocs.assoc_defs.release(slot);
+	slot = -1;
+}
+
+void ecsact_lookup_system_assoc_ids(
+	ecsact_system_like_id    system_id,
+	ecsact_component_like_id component_id,
+	int32_t                  max_assoc_count,
+	ecsact_system_assoc_id*  out_assoc_ids,
+	int32_t*                 out_assoc_count
+) {
+	auto& index = state().system_component_assoc_ids;
+	auto  itr = index.find(system_component_key(system_id, component_id));
+	if(itr == index.end()) {
+		if(out_assoc_count) {
+			*out_assoc_count = 0;
+		}
 		return;
 	}
 
-	list->erase(itr);
+	auto& list = itr->second;
+	if(out_assoc_count) {
+		*out_assoc_count = static_cast<int32_t>(list.size());
+	}
+
+	for(int32_t i = 0; max_assoc_count > i; ++i) {
+		if(i >= list.size()) {
+			break;
+		}
+		out_assoc_ids[i] = list[i];
+	}
 }
 
 void ecsact_add_system_assoc_field(
@@ -125,6 +318,7 @@ void ecsact_add_system_assoc_field(
 	ecsact_system_assoc_id assoc_id,
 	ecsact_field_id        field_id
 ) {
+	ensure_mutable(__func__);
 	auto info = get_assoc_info(system_id, assoc_id);
 	if(!info) {
 		return;
@@ -142,6 +336,7 @@ void ecsact_add_system_assoc_field(
 	}
 
 	info->assoc_fields.push_back(field_id);
+	update_field_fact(*info, true, field_id);
 }
 
 void ecsact_remove_system_assoc_field(
@@ -149,6 +344,7 @@ void ecsact_remove_system_assoc_field(
 	ecsact_system_assoc_id assoc_id,
 	ecsact_field_id        field_id
 ) {
+	ensure_mutable(__func__);
 	auto info = get_assoc_info(system_id, assoc_id);
 	if(!info) {
 		return;
@@ -166,6 +362,7 @@ void ecsact_remove_system_assoc_field(
 	}
 
 	info->assoc_fields.erase(itr);
+	update_field_fact(*info, false, field_id);
 }
 
 void ecsact_set_system_assoc_capability(
@@ -174,6 +371,7 @@ void ecsact_set_system_assoc_capability(
 	ecsact_component_like_id comp_id,
 	ecsact_system_capability cap
 ) {
+	ensure_mutable(__func__);
 	auto info = get_assoc_info(system_id, assoc_id);
 	if(!info) {
 		return;
@@ -185,6 +383,10 @@ void ecsact_set_system_assoc_capability(
 		[&](const auto& entry) -> bool { return entry.first == comp_id; }
 	);
 
+	if(itr != info->caps.end()) {
+		update_capability_fact(*info, false, comp_id, itr->second);
+	}
+
 	if(cap == ECSACT_SYS_CAP_NONE) {
 		if(itr != info->caps.end()) {
 			info->caps.erase(itr);
@@ -197,6 +399,7 @@ void ecsact_set_system_assoc_capability(
 	} else {
 		itr->second = cap;
 	}
+	update_capability_fact(*info, true, comp_id, cap);
 }
 
 int32_t ecsact_meta_system_assoc_count( //
@@ -232,8 +435,7 @@ void ecsact_meta_system_assoc_ids(
 		if(i >= list->size()) {
 			break;
 		}
-		auto& assoc = list->at(i);
-		out_assoc_ids[i] = assoc->id;
+		out_assoc_ids[i] = list->at(i);
 	}
 }
 
@@ -333,16 +535,16 @@ void ecsact_meta_system_assoc_capabilities(
 
 static auto get_legacy_assoc_info( //
 	ecsact_system_like_id id
-) -> std::shared_ptr<assoc_info> {
+) -> assoc_info* {
 	auto list = get_system_assoc_list(id);
 	if(!list || list->empty()) {
-		return {};
+		return nullptr;
 	}
 	// shouldn't be using the legacy API!
 	if(list->size() > 1) {
 		throw std::logic_error{"invalid use of legacy api"};
 	}
-	return list->at(0);
+	return get_assoc_info(id, list->at(0));
 }
 
 [[deprecated]]
@@ -430,3 +632,235 @@ void ecsact_meta_system_association_capabilities(
 		out_capabilities_count
 	);
 }
+
+auto ecsact::interpret::views::system_assoc_ids(ecsact_system_like_id system_id)
+	-> std::span<const ecsact_system_assoc_id> {
+	auto& assoc_ids = state().system_assoc_ids;
+	auto  itr = assoc_ids.find(system_id);
+	if(itr == assoc_ids.end()) {
+		return {};
+	}
+
+	return itr->second;
+}
+
+auto ecsact::interpret::views::system_assoc_ids(
+	ecsact_system_like_id    system_id,
+	ecsact_component_like_id component_id
+) -> std::span<const ecsact_system_assoc_id> {
+	auto& index = state().system_component_assoc_ids;
+	auto  itr = index.find(system_component_key(system_id, component_id));
+	if(itr == index.end()) {
+		return {};
+	}
+
+	return itr->second;
+}
+
+auto ecsact::interpret::views::system_assoc_fields(
+	ecsact_system_like_id  system_id,
+	ecsact_system_assoc_id assoc_id
+) -> std::span<const ecsact_field_id> {
+	if(auto info = get_assoc_info(system_id, assoc_id)) {
+		return info->assoc_fields;
+	}
+
+	return {};
+}
+
+auto ecsact::interpret::views::system_assoc_capabilities(
+	ecsact_system_like_id  system_id,
+	ecsact_system_assoc_id assoc_id
+)
+	-> std::span<
+		const std::pair<ecsact_component_like_id, ecsact_system_capability>> {
+	if(auto info = get_assoc_info(system_id, assoc_id)) {
+		return info->caps;
+	}
+
+	return {};
+}
+
+/**
+ * Writes @p value to @p row of @p column unless the column was skipped
+ */
+template<typename T, typename V>
+static auto set_column(T* column, int32_t row, V value) -> void {
+	if(column != nullptr) {
+		column[row] = static_cast<T>(value);
+	}
+}
+
+/**
+ * Calls @p fn with every association of the system-likes of @p package_id in
+ * export order. See parse-resolver-runtime/export.h
+ */
+template<typename Fn>
+static auto for_each_export_assoc(ecsact_package_id package_id, Fn&& fn)
+	-> void {
+	auto export_system_like = [&](ecsact_system_like_id system_id) {
+		auto assoc_ids = get_system_assoc_list(system_id);
+		if(assoc_ids == nullptr) {
+			return;
+		}
+		for(auto assoc_id : *assoc_ids) {
+			fn(state().assoc_defs[find_assoc_slot(assoc_id)]);
+		}
+	};
+
+	for(auto id : views::system_ids(package_id)) {
+		export_system_like(ecsact_id_cast<ecsact_system_like_id>(id));
+	}
+	for(auto id : views::action_ids(package_id)) {
+		export_system_like(ecsact_id_cast<ecsact_system_like_id>(id));
+	}
+}
+
+void ecsact_export_package_assocs(
+	ecsact_package_id package_id,
+	int32_t           max_assoc_count,
+	ecsact_assoc_rows out_rows,
+	int32_t*          out_assoc_count
+) {
+	auto row = int32_t{};
+	auto field_row = int32_t{};
+	auto capability_row = int32_t{};
+	for_each_export_assoc(package_id, [&](const assoc_info& info) {
+		auto field_count = static_cast<int32_t>(info.assoc_fields.size());
+		auto capability_count = static_cast<int32_t>(info.caps.size());
+		if(max_assoc_count > row) {
+			set_column(out_rows.system_ids, row, info.system_id);
+			set_column(out_rows.assoc_ids, row, info.id);
+			set_column(out_rows.component_ids, row, info.comp_id);
+			set_column(out_rows.first_field_rows, row, field_row);
+			set_column(out_rows.field_counts, row, field_count);
+			set_column(out_rows.first_capability_rows, row, capability_row);
+			set_column(out_rows.capability_counts, row, capability_count);
+		}
+
+		row += 1;
+		field_row += field_count;
+		capability_row += capability_count;
+	});
+
+	if(out_assoc_count != nullptr) {
+		*out_assoc_count = row;
+	}
+}
+
+void ecsact_export_package_assoc_fields(
+	ecsact_package_id       package_id,
+	int32_t                 max_field_count,
+	ecsact_assoc_field_rows out_rows,
+	int32_t*                out_field_count
+) {
+	auto row = int32_t{};
+	for_each_export_assoc(package_id, [&](const assoc_info& info) {
+		for(auto field_id : info.assoc_fields) {
+			if(max_field_count > row) {
+				set_column(out_rows.assoc_ids, row, info.id);
+				set_column(out_rows.field_ids, row, field_id);
+			}
+
+			row += 1;
+		}
+	});
+
+	if(out_field_count != nullptr) {
+		*out_field_count = row;
+	}
+}
+
+void ecsact_export_package_assoc_capabilities(
+	ecsact_package_id            package_id,
+	int32_t                      max_capability_count,
+	ecsact_assoc_capability_rows out_rows,
+	int32_t*                     out_capability_count
+) {
+	auto row = int32_t{};
+	for_each_export_assoc(package_id, [&](const assoc_info& info) {
+		for(auto& [comp_id, cap] : info.caps) {
+			if(max_capability_count > row) {
+				set_column(out_rows.assoc_ids, row, info.id);
+				set_column(out_rows.component_ids, row, comp_id);
+				set_column(out_rows.capabilities, row, cap);
+			}
+
+			row += 1;
+		}
+	});
+
+	if(out_capability_count != nullptr) {
+		*out_capability_count = row;
+	}
+}
+
+/**
+ * Adds the heap memory owned by the associations in @p assoc_ids
+ */
+static auto add_assoc_list_memory(
+	ecsact_system_like_id        system_id,
+	const assoc_id_list_t&       assoc_ids,
+	ecsact_runtime_memory_usage& usage
+) -> void {
+	auto bytes = heap_bytes(assoc_ids);
+	for(auto assoc_id : assoc_ids) {
+		if(auto info = get_assoc_info(system_id, assoc_id)) {
+			bytes += heap_bytes(info->assoc_fields) + heap_bytes(info->caps) +
+				heap_bytes(info->event_refs);
+		}
+	}
+	add_memory(usage, ECSACT_MEMORY_TABLE_ASSOCIATIONS, 0, bytes);
+}
+
+auto ecsact::interpret::details::add_assoc_memory_usage(
+	ecsact_runtime_memory_usage& usage
+) -> void {
+	auto& assocs = state();
+
+	add_memory(
+		usage,
+		ECSACT_MEMORY_TABLE_ASSOCIATIONS,
+		assocs.assoc_defs.size(),
+		assocs.assoc_defs.storage_bytes() + heap_bytes(assocs.assoc_slots) +
+			heap_bytes(assocs.system_assoc_ids) +
+			heap_bytes(assocs.system_component_assoc_ids)
+	);
+
+	for(auto& [system_id, assoc_ids] : assocs.system_assoc_ids) {
+		add_assoc_list_memory(system_id, assoc_ids, usage);
+	}
+
+	for(auto& [_, assoc_ids] : assocs.system_component_assoc_ids) {
+		add_memory(
+			usage,
+			ECSACT_MEMORY_TABLE_ASSOCIATIONS,
+			0,
+			heap_bytes(assoc_ids)
+		);
+	}
+}
+
+auto ecsact::interpret::details::add_assoc_memory_usage(
+	std::span<const ecsact_system_like_id> system_ids,
+	ecsact_runtime_memory_usage&           usage
+) -> void {
+	for(auto system_id : system_ids) {
+		auto assoc_ids = get_system_assoc_list(system_id);
+		if(assoc_ids == nullptr) {
+			continue;
+		}
+
+		// Each association is also listed once by its (system, component) pair
+		add_memory(
+			usage,
+			ECSACT_MEMORY_TABLE_ASSOCIATIONS,
+			assoc_ids->size(),
+			static_cast<int64_t>(
+				assoc_ids->size() *
+				(sizeof(assoc_info) + sizeof(int32_t) + sizeof(ecsact_system_assoc_id))
+			)
+		);
+		add_assoc_list_memory(system_id, *assoc_ids, usage);
+	}
+}
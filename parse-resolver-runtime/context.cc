@@ -0,0 +1,68 @@
+#include "parse-resolver-runtime/context.hh"
+
+#include "parse-resolver-runtime/freeze.hh"
+
+using ecsact::interpret::details::current_context;
+using ecsact::interpret::details::ensure_mutable;
+using ecsact::interpret::details::make_assoc_state;
+using ecsact::interpret::details::make_lifecycle_state;
+using ecsact::interpret::details::make_resolver_state;
+
+ecsact_runtime_context::ecsact_runtime_context()
+	: lifecycle(make_lifecycle_state())
+	, assoc(make_assoc_state())
+	, resolver(make_resolver_state()) {
+}
+
+ecsact_runtime_context::~ecsact_runtime_context() = default;
+
+static thread_local ecsact_runtime_context* thread_context = nullptr;
+
+static auto default_context() -> ecsact_runtime_context& {
+	static ecsact_runtime_context context;
+	return context;
+}
+
+auto ecsact::interpret::details::current_context() -> ecsact_runtime_context& {
+	if(thread_context) {
+		return *thread_context;
+	}
+
+	return default_context();
+}
+
+ecsact_runtime_context* ecsact_create_runtime_context() {
+	return new ecsact_runtime_context{};
+}
+
+void ecsact_destroy_runtime_context(ecsact_runtime_context* context) {
+	delete context;
+}
+
+void ecsact_reset_runtime() {
+	ensure_mutable(__func__);
+
+	auto& context = current_context();
+
+	// Same order as the context destructor
+	context.resolver.reset();
+	context.assoc.reset();
+	context.lifecycle.reset();
+
+	context.lifecycle = make_lifecycle_state();
+	context.assoc = make_assoc_state();
+	context.resolver = make_resolver_state();
+	context.last_id = 0;
+}
+
+ecsact_runtime_context* ecsact_set_thread_runtime_context(
+	ecsact_runtime_context* context
+) {
+	auto previous = thread_context;
+	thread_context = context;
+	return previous;
+}
+
+ecsact_runtime_context* ecsact_get_thread_runtime_context() {
+	return thread_context;
+}
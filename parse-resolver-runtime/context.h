@@ -0,0 +1,53 @@
+#ifndef ECSACT_PARSE_RESOLVER_RUNTIME_CONTEXT_H
+#define ECSACT_PARSE_RESOLVER_RUNTIME_CONTEXT_H
+
+/**
+ * Opaque handle owning all of the parse resolver runtime state: packages,
+ * declarations, associations, IDs and destroy callbacks.
+ *
+ * Every dynamic, meta and lookup function operates on the calling thread's
+ * current context. Threads start out with the default context which exists
+ * for the lifetime of the process. Different contexts may be used on different
+ * threads at the same time, but a single context is not thread safe unless it
+ * is frozen (see freeze.h).
+ */
+typedef struct ecsact_runtime_context ecsact_runtime_context;
+
+/**
+ * Creates a new empty context. Must be destroyed with
+ * `ecsact_destroy_runtime_context`.
+ */
+ecsact_runtime_context* ecsact_create_runtime_context();
+
+/**
+ * Destroys @p context and everything in it. Destroy callbacks are not invoked.
+ * @p context must not be the current context of any thread.
+ */
+void ecsact_destroy_runtime_context(ecsact_runtime_context* context);
+
+/**
+ * Empties the calling thread's current context as if it was just created.
+ * Packages, declarations, associations and destroy callbacks are all dropped
+ * at once without invoking any destroy callbacks, and IDs start over. Takes
+ * time proportional to what the context holds.
+ *
+ * Throws `std::logic_error` while the runtime is frozen (see freeze.h).
+ */
+void ecsact_reset_runtime();
+
+/**
+ * Makes @p context the current context of the calling thread. Passing NULL
+ * restores the default context.
+ * @returns the previous current context. NULL if it was the default context.
+ */
+ecsact_runtime_context* ecsact_set_thread_runtime_context(
+	ecsact_runtime_context* context
+);
+
+/**
+ * @returns the current context of the calling thread. NULL if it is the
+ *          default context.
+ */
+ecsact_runtime_context* ecsact_get_thread_runtime_context();
+
+#endif // ECSACT_PARSE_RESOLVER_RUNTIME_CONTEXT_H
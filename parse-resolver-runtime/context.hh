@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include "parse-resolver-runtime/context.h"
+
+namespace ecsact::interpret::details {
+
+/**
+ * State of each runtime translation unit. Defined in the translation unit
+ * that owns it along with its `make_state` and `destroy_state` overloads.
+ */
+struct lifecycle_state;
+struct assoc_state;
+struct resolver_state;
+
+auto destroy_state(lifecycle_state*) -> void;
+auto destroy_state(assoc_state*) -> void;
+auto destroy_state(resolver_state*) -> void;
+
+struct state_deleter {
+	template<typename State>
+	auto operator()(State* state) const -> void {
+		destroy_state(state);
+	}
+};
+
+template<typename State>
+using state_ptr = std::unique_ptr<State, state_deleter>;
+
+auto make_lifecycle_state() -> state_ptr<lifecycle_state>;
+auto make_assoc_state() -> state_ptr<assoc_state>;
+auto make_resolver_state() -> state_ptr<resolver_state>;
+
+/**
+ * The calling thread's current context
+ */
+auto current_context() -> ecsact_runtime_context&;
+
+} // namespace ecsact::interpret::details
+
+struct ecsact_runtime_context {
+	std::atomic_int32_t last_id = 0;
+	std::atomic_bool    frozen = false;
+
+	// Destroyed in reverse order. Associations and declarations hold event refs
+	// into the lifecycle state so it must outlive them.
+	ecsact::interpret::details::state_ptr<
+		ecsact::interpret::details::lifecycle_state>
+		lifecycle;
+	ecsact::interpret::details::state_ptr<ecsact::interpret::details::assoc_state>
+		assoc;
+	ecsact::interpret::details::state_ptr<
+		ecsact::interpret::details::resolver_state>
+		resolver;
+
+	ecsact_runtime_context();
+	ecsact_runtime_context(const ecsact_runtime_context&) = delete;
+	~ecsact_runtime_context();
+};
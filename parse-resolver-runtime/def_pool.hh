@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <deque>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "parse-resolver-runtime/memory.hh"
+
+namespace ecsact::interpret::details {
+
+/**
+ * Dense storage for definitions of a single kind. Definitions are addressed by
+ * index and never move so references stay valid while other definitions are
+ * created or released. Released indices are reused by later definitions.
+ */
+template<typename T>
+class def_pool {
+	std::deque<T>        _defs;
+	std::vector<int32_t> _free_indices;
+
+public:
+	/**
+	 * Default constructs a new definition and returns its index
+	 */
+	auto emplace() -> int32_t {
+		if(!_free_indices.empty()) {
+			auto index = _free_indices.back();
+			_free_indices.pop_back();
+			return index;
+		}
+
+		_defs.emplace_back();
+		return static_cast<int32_t>(_defs.size() - 1);
+	}
+
+	/**
+	 * Resets the definition at @p index back to a default constructed one so
+	 * anything it owns is freed. The index may be handed out again by a later
+	 * `emplace`.
+	 */
+	auto release(int32_t index) -> void {
+		assert(index >= 0 && index < static_cast<int32_t>(_defs.size()));
+		std::destroy_at(&_defs[index]);
+		std::construct_at(&_defs[index]);
+		_free_indices.push_back(index);
+	}
+
+	auto operator[](int32_t index) -> T& {
+		return _defs[index];
+	}
+
+	auto operator[](int32_t index) const -> const T& {
+		return _defs[index];
+	}
+
+	auto size() const -> std::size_t {
+		return _defs.size() - _free_indices.size();
+	}
+
+	/**
+	 * Estimated bytes of the pool storage, released definitions included. Heap
+	 * memory owned by the definitions is not.
+	 */
+	auto storage_bytes() const -> int64_t {
+		return heap_bytes(_defs) + heap_bytes(_free_indices);
+	}
+};
+
+} // namespace ecsact::interpret::details
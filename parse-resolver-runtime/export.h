@@ -0,0 +1,173 @@
+#ifndef ECSACT_PARSE_RESOLVER_RUNTIME_EXPORT_H
+#define ECSACT_PARSE_RESOLVER_RUNTIME_EXPORT_H
+
+#include <stdint.h>
+#include "ecsact/runtime/common.h"
+#include "ecsact/runtime/definitions.h"
+
+/**
+ * Bulk export functions specific to the parse resolver runtime. Each fills
+ * caller provided column arrays with one row per element of a whole package
+ * instead of taking a call, and a lookup, per element the way the
+ * `ecsact_meta_*` functions do.
+ *
+ * Any column may be null to skip it. At most @p max_*_count rows are written
+ * and the total number of rows is stored in @p out_*_count if it is not null,
+ * so calling with a max count of 0 only counts the rows.
+ *
+ * Rows of the same owner are adjacent and in the same order as their owners'
+ * rows. Owner rows hold the range of their rows in the other tables so the
+ * rows may be split across threads by owner.
+ *
+ * Composites are exported as components, then transients, then actions. System
+ * likes are exported as systems, nested systems included, then actions. Each
+ * in creation order. Everything else is in the same order as the matching
+ * `ecsact_meta_*` function reports it.
+ *
+ * Export functions read the runtime the same way the `ecsact_meta_*` functions
+ * do. While the runtime is frozen (see parse-resolver-runtime/freeze.h) they
+ * may be called from several threads at once.
+ *
+ * Throws `std::out_of_range` if the package ID is not a package.
+ */
+
+typedef struct ecsact_composite_rows {
+	ecsact_composite_id* composite_ids;
+
+	/** Index of the composite's first row in the field rows */
+	int32_t* first_field_rows;
+	int32_t* field_counts;
+
+	/** See parse-resolver-runtime/layout.h */
+	int32_t* sizes;
+	int32_t* alignments;
+} ecsact_composite_rows;
+
+typedef struct ecsact_field_rows {
+	ecsact_composite_id* composite_ids;
+	ecsact_field_id*     field_ids;
+
+	/** Valid for the lifetime of the runtime context */
+	const char**       names;
+	ecsact_field_type* types;
+
+	/** Same as `ecsact_meta_field_offset` */
+	int32_t* offsets;
+} ecsact_field_rows;
+
+typedef struct ecsact_system_like_rows {
+	ecsact_system_like_id* system_ids;
+
+	/** Index of the system's first row in the capability rows */
+	int32_t* first_capability_rows;
+	int32_t* capability_counts;
+
+	/** Index of the system's first row in the generates rows */
+	int32_t* first_generates_rows;
+	int32_t* generates_counts;
+
+	/** Index of the system's first row in the association rows */
+	int32_t* first_assoc_rows;
+	int32_t* assoc_counts;
+} ecsact_system_like_rows;
+
+typedef struct ecsact_capability_rows {
+	ecsact_system_like_id*    system_ids;
+	ecsact_component_like_id* component_ids;
+	ecsact_system_capability* capabilities;
+} ecsact_capability_rows;
+
+/**
+ * One row per component of each generates block
+ */
+typedef struct ecsact_generates_rows {
+	ecsact_system_like_id*      system_ids;
+	ecsact_system_generates_id* generates_ids;
+	ecsact_component_id*        component_ids;
+	ecsact_system_generate*     generate_flags;
+} ecsact_generates_rows;
+
+typedef struct ecsact_assoc_rows {
+	ecsact_system_like_id*    system_ids;
+	ecsact_system_assoc_id*   assoc_ids;
+	ecsact_component_like_id* component_ids;
+
+	/** Index of the association's first row in the association field rows */
+	int32_t* first_field_rows;
+	int32_t* field_counts;
+
+	/**
+	 * Index of the association's first row in the association capability rows
+	 */
+	int32_t* first_capability_rows;
+	int32_t* capability_counts;
+} ecsact_assoc_rows;
+
+typedef struct ecsact_assoc_field_rows {
+	ecsact_system_assoc_id* assoc_ids;
+	ecsact_field_id*        field_ids;
+} ecsact_assoc_field_rows;
+
+typedef struct ecsact_assoc_capability_rows {
+	ecsact_system_assoc_id*   assoc_ids;
+	ecsact_component_like_id* component_ids;
+	ecsact_system_capability* capabilities;
+} ecsact_assoc_capability_rows;
+
+void ecsact_export_package_composites(
+	ecsact_package_id     package_id,
+	int32_t               max_composite_count,
+	ecsact_composite_rows out_rows,
+	int32_t*              out_composite_count
+);
+
+void ecsact_export_package_fields(
+	ecsact_package_id package_id,
+	int32_t           max_field_count,
+	ecsact_field_rows out_rows,
+	int32_t*          out_field_count
+);
+
+void ecsact_export_package_system_likes(
+	ecsact_package_id       package_id,
+	int32_t                 max_system_count,
+	ecsact_system_like_rows out_rows,
+	int32_t*                out_system_count
+);
+
+void ecsact_export_package_capabilities(
+	ecsact_package_id      package_id,
+	int32_t                max_capability_count,
+	ecsact_capability_rows out_rows,
+	int32_t*               out_capability_count
+);
+
+void ecsact_export_package_generates(
+	ecsact_package_id     package_id,
+	int32_t               max_generates_count,
+	ecsact_generates_rows out_rows,
+	int32_t*              out_generates_count
+);
+
+void ecsact_export_package_assocs(
+	ecsact_package_id package_id,
+	int32_t           max_assoc_count,
+	ecsact_assoc_rows out_rows,
+	int32_t*          out_assoc_count
+);
+
+void ecsact_export_package_assoc_fields(
+	ecsact_package_id       package_id,
+	int32_t                 max_field_count,
+	ecsact_assoc_field_rows out_rows,
+	int32_t*                out_field_count
+);
+
+void ecsact_export_package_assoc_capabilities(
+	ecsact_package_id            package_id,
+	int32_t                      max_capability_count,
+	ecsact_assoc_capability_rows out_rows,
+	int32_t*                     out_capability_count
+);
+
+#endif // ECSACT_PARSE_RESOLVER_RUNTIME_EXPORT_H
@@ -0,0 +1,28 @@
+#ifndef ECSACT_PARSE_RESOLVER_RUNTIME_FINGERPRINT_H
+#define ECSACT_PARSE_RESOLVER_RUNTIME_FINGERPRINT_H
+
+#include <stdint.h>
+#include "ecsact/runtime/common.h"
+
+/**
+ * Structural hash of everything @p package_id declares: its name, whether it
+ * is the main package, its dependencies, declarations, fields, enum values,
+ * capabilities, associations, generates, nested systems and system settings.
+ *
+ * The fingerprint is kept up to date by every runtime function that changes
+ * the package so reading it is constant time. Declarations are identified by
+ * their name and their position in the package rather than by ID, so
+ * evaluating the same package again, even into a different context, after
+ * whitespace or comment only edits gives the same fingerprint. The order
+ * capabilities, notify settings and generates components were set in is not
+ * part of it.
+ *
+ * Fingerprints of dependencies are not included. Combine them with those of
+ * `ecsact_meta_get_dependencies` to notice changes to imported declarations.
+ * Fingerprints are only comparable between runs of the same build.
+ *
+ * Throws `std::out_of_range` if @p package_id is not a package.
+ */
+uint64_t ecsact_package_fingerprint(ecsact_package_id package_id);
+
+#endif // ECSACT_PARSE_RESOLVER_RUNTIME_FINGERPRINT_H
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+#include "ecsact/runtime/common.h"
+
+namespace ecsact::interpret::details {
+
+/**
+ * Package fingerprints are the wrapping sum of a hash for every fact the
+ * package holds. Facts are added as the package is built and subtracted when
+ * they no longer hold, so a fingerprint only depends on what is in the
+ * package and not on the order it was built in. Settings at their default
+ * value are not facts.
+ */
+enum class fingerprint_fact_kind : uint8_t {
+	package,
+	main_package,
+	dependency,
+	declaration,
+	component_type,
+	field,
+	enum_value,
+	capability,
+	nested_systems,
+	generates,
+	generates_component,
+	lazy_iteration_rate,
+	parallel_execution,
+	notify_setting,
+	assoc,
+	assoc_field,
+	assoc_capability,
+};
+
+constexpr auto fingerprint_mix(uint64_t value) -> uint64_t {
+	value ^= value >> 30;
+	value *= 0xbf58476d1ce4e5b9;
+	value ^= value >> 27;
+	value *= 0x94d049bb133111eb;
+	value ^= value >> 31;
+	return value;
+}
+
+/**
+ * FNV-1a so names hash the same on every standard library
+ */
+constexpr auto fingerprint_hash(std::string_view str) -> uint64_t {
+	auto hash = uint64_t{0xcbf29ce484222325};
+	for(auto c : str) {
+		hash ^= static_cast<uint8_t>(c);
+		hash *= 0x100000001b3;
+	}
+	return hash;
+}
+
+template<typename T>
+constexpr auto fingerprint_value(T value) -> uint64_t {
+	if constexpr(std::is_convertible_v<T, std::string_view>) {
+		return fingerprint_hash(value);
+	} else if constexpr(std::is_enum_v<T>) {
+		return static_cast<uint64_t>(static_cast<int64_t>(value));
+	} else {
+		return static_cast<uint64_t>(value);
+	}
+}
+
+/**
+ * Order dependent hash of @p values. Strings are hashed by content and
+ * everything else by value.
+ */
+template<typename... Values>
+constexpr auto fingerprint_fact(Values... values) -> uint64_t {
+	auto hash = uint64_t{0x9e3779b97f4a7c15};
+	((hash = fingerprint_mix(hash ^ fingerprint_value(values))), ...);
+	return hash;
+}
+
+/**
+ * Stands in for @p id in facts. Made of the owning package name and the
+ * position of the declaration in it, so unlike the ID it doesn't depend on
+ * what else was created before. IDs that are not declarations are used as is.
+ */
+auto fingerprint_key(ecsact_decl_id id) -> uint64_t;
+
+/**
+ * Adds @p fact to, or removes it from, the fingerprint of the package that
+ * owns @p id. Does nothing if @p id has no owner.
+ */
+auto add_fingerprint_fact(ecsact_decl_id id, uint64_t fact) -> void;
+auto remove_fingerprint_fact(ecsact_decl_id id, uint64_t fact) -> void;
+
+} // namespace ecsact::interpret::details
@@ -0,0 +1,28 @@
+#include "parse-resolver-runtime/freeze.hh"
+
+#include <stdexcept>
+#include <string>
+#include "parse-resolver-runtime/context.hh"
+#include "parse-resolver-runtime/freeze.h"
+
+using ecsact::interpret::details::current_context;
+
+auto ecsact::interpret::details::ensure_mutable(const char* fn_name) -> void {
+	if(current_context().frozen.load(std::memory_order_acquire)) {
+		throw std::logic_error{
+			std::string{fn_name} + " called while the runtime is frozen"
+		};
+	}
+}
+
+auto ecsact::interpret::details::set_frozen(bool value) -> void {
+	current_context().frozen.store(value, std::memory_order_release);
+}
+
+void ecsact_unfreeze_runtime() {
+	ecsact::interpret::details::set_frozen(false);
+}
+
+bool ecsact_is_runtime_frozen() {
+	return current_context().frozen.load(std::memory_order_acquire);
+}
@@ -0,0 +1,26 @@
+#ifndef ECSACT_PARSE_RESOLVER_RUNTIME_FREEZE_H
+#define ECSACT_PARSE_RESOLVER_RUNTIME_FREEZE_H
+
+#include <stdbool.h>
+
+/**
+ * Freezes the parse resolver runtime. Anything computed lazily (e.g. composite
+ * layouts) is computed up front so that from then on no `ecsact_meta_*` or
+ * `ecsact_lookup_*` function writes to the runtime. While frozen those
+ * functions may be called from any number of threads at once without
+ * synchronization.
+ *
+ * Every dynamic function that would change the runtime throws
+ * `std::logic_error` while it is frozen.
+ */
+void ecsact_freeze_runtime();
+
+/**
+ * Allows changes to the runtime again. Must not be called while other threads
+ * are still reading from the runtime.
+ */
+void ecsact_unfreeze_runtime();
+
+bool ecsact_is_runtime_frozen();
+
+#endif // ECSACT_PARSE_RESOLVER_RUNTIME_FREEZE_H
@@ -0,0 +1,13 @@
+#pragma once
+
+namespace ecsact::interpret::details {
+
+/**
+ * Throws `std::logic_error` mentioning @p fn_name if the runtime is frozen.
+ * Called at the start of every function that changes the runtime.
+ */
+auto ensure_mutable(const char* fn_name) -> void;
+
+auto set_frozen(bool frozen) -> void;
+
+} // namespace ecsact::interpret::details
@@ -1,11 +1,12 @@
 #include "parse-resolver-runtime/ids.hh"
 
-#include <atomic>
+#include <limits>
 #include <stdexcept>
-
-static std::atomic_int32_t last_id = 0;
+#include "parse-resolver-runtime/context.hh"
 
 auto ecsact::interpret::details::gen_next_id_() -> int32_t {
+	auto& last_id = current_context().last_id;
+
 	// Getting here would be crazy and if we were to do anything about it we'd
 	// have to implement an "ID recycling" mechanism which I think is overkill.
 	if(last_id == std::numeric_limits<int32_t>::max()) {
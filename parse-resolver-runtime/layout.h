@@ -0,0 +1,26 @@
+#ifndef ECSACT_PARSE_RESOLVER_RUNTIME_LAYOUT_H
+#define ECSACT_PARSE_RESOLVER_RUNTIME_LAYOUT_H
+
+#include <stdint.h>
+#include "ecsact/runtime/common.h"
+
+/**
+ * Composite layout functions specific to the parse resolver runtime. Fields
+ * are laid out in field ID order with the same padding a C compiler would use
+ * for the equivalent struct. `ecsact_meta_field_offset` uses the same layout.
+ *
+ * Layouts are computed once and cached until a field is added to the
+ * composite or an enum used by one of its fields changes its storage type.
+ */
+
+/**
+ * @returns size in bytes of the composite including trailing padding
+ */
+int32_t ecsact_composite_layout_size(ecsact_composite_id composite_id);
+
+/**
+ * @returns alignment in bytes of the composite. 1 if it has no fields.
+ */
+int32_t ecsact_composite_layout_alignment(ecsact_composite_id composite_id);
+
+#endif // ECSACT_PARSE_RESOLVER_RUNTIME_LAYOUT_H
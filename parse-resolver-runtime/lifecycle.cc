@@ -1,28 +1,79 @@
 #include "parse-resolver-runtime/lifecycle.hh"
 
 #include <array>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 #include "ecsact/runtime/common.h"
+#include "parse-resolver-runtime/context.hh"
+#include "parse-resolver-runtime/memory.hh"
+#include "parse-resolver-runtime/trace.hh"
 
+using ecsact::interpret::details::add_memory;
 using ecsact::interpret::details::castable_destroyable_ids_t;
+using ecsact::interpret::details::current_context;
 using ecsact::interpret::details::destroyable_id_t;
 using ecsact::interpret::details::event_ref_id;
+using ecsact::interpret::details::heap_bytes;
+using ecsact::interpret::details::trace_span;
+
+struct lifecycle_callback_entry {
+	int                   destroyable_id;
+	std::function<void()> callback;
+};
 
 struct lifecycle_callback_info {
-	event_ref_id                          last_event_ref_id = {};
-	std::unordered_map<event_ref_id, int> callback_id;
-	std::unordered_map<event_ref_id, std::function<void()>> callbacks;
+	event_ref_id last_event_ref_id = {};
+
+	std::unordered_map<event_ref_id, lifecycle_callback_entry> callbacks;
+
+	/**
+	 * Event refs registered for each destroyable ID so triggering only touches
+	 * the callbacks attached to the destroyed ID.
+	 */
+	std::unordered_map<int, std::vector<event_ref_id>> event_refs_by_id;
 
 	auto gen_next_id() -> event_ref_id {
 		using storage_t = std::underlying_type_t<event_ref_id>;
 		reinterpret_cast<storage_t&>(last_event_ref_id) += 1;
 		return last_event_ref_id;
 	}
+
+	auto remove(event_ref_id ref_id) -> void {
+		auto itr = callbacks.find(ref_id);
+		if(itr == callbacks.end()) {
+			return;
+		}
+
+		auto refs_itr = event_refs_by_id.find(itr->second.destroyable_id);
+		if(refs_itr != event_refs_by_id.end()) {
+			auto& refs = refs_itr->second;
+			std::erase(refs, ref_id);
+			if(refs.empty()) {
+				event_refs_by_id.erase(refs_itr);
+			}
+		}
+
+		callbacks.erase(itr);
+	}
 };
 
-static std::array< //
-	lifecycle_callback_info,
-	std::variant_size_v<castable_destroyable_ids_t>>
-	lifecycle_info = {};
+struct ecsact::interpret::details::lifecycle_state {
+	std::array< //
+		lifecycle_callback_info,
+		std::variant_size_v<castable_destroyable_ids_t>>
+		info = {};
+};
+
+auto ecsact::interpret::details::make_lifecycle_state()
+	-> state_ptr<lifecycle_state> {
+	return state_ptr<lifecycle_state>{new lifecycle_state{}};
+}
+
+auto ecsact::interpret::details::destroy_state(lifecycle_state* state)
+	-> void {
+	delete state;
+}
 
 static auto destroyable_id_as_int(castable_destroyable_ids_t id) -> int {
 	return std::visit([](auto id) { return static_cast<int>(id); }, id);
@@ -32,14 +83,41 @@ static auto destroyable_id_as_int(destroyable_id_t id) -> int {
 	return std::visit([](auto id) { return static_cast<int>(id); }, id);
 }
 
-static auto callback_indices(destroyable_id_t id) -> std::vector<int> {
-	auto result = std::vector<int>{};
-	result.emplace_back(static_cast<int>(id.index()));
+/**
+ * Callback info indices to trigger for a destroyed ID. Kept inline since every
+ * destroy looks them up.
+ */
+struct callback_index_list {
+	/**
+	 * The ID's own kind and each castable kind it may be cast to
+	 */
+	static constexpr auto max_count = 1 +
+		std::variant_size_v<castable_destroyable_ids_t> -
+		std::variant_size_v<destroyable_id_t>;
+
+	std::array<int, max_count> indices = {};
+	int                        count = 0;
+
+	auto push_back(int index) -> void {
+		indices[count] = index;
+		count += 1;
+	}
+
+	auto begin() const {
+		return indices.begin();
+	}
+
+	auto end() const {
+		return indices.begin() + count;
+	}
+};
+
+static auto callback_indices(destroyable_id_t id) -> callback_index_list {
+	auto result = callback_index_list{};
+	result.push_back(static_cast<int>(id.index()));
 
 	auto add_castable_id = [&]<typename T>(T v) -> void {
-		result.emplace_back( //
-			static_cast<int>(castable_destroyable_ids_t{v}.index())
-		);
+		result.push_back(static_cast<int>(castable_destroyable_ids_t{v}.index()));
 	};
 
 	std::visit(
@@ -66,10 +144,24 @@ static auto callback_indices(destroyable_id_t id) -> std::vector<int> {
 ecsact::interpret::details::event_ref::event_ref() = default;
 
 ecsact::interpret::details::event_ref::event_ref(event_ref&& other) {
+	owner_ = other.owner_;
+	destroyable_index_ = other.destroyable_index_;
 	id_ = other.id_;
 	other.id_ = {};
 }
 
+auto ecsact::interpret::details::event_ref::operator=(event_ref&& other)
+	-> event_ref& {
+	if(this != &other) {
+		clear();
+		owner_ = other.owner_;
+		destroyable_index_ = other.destroyable_index_;
+		id_ = other.id_;
+		other.id_ = {};
+	}
+	return *this;
+}
+
 ecsact::interpret::details::event_ref::~event_ref() {
 	clear();
 }
@@ -79,17 +171,11 @@ auto ecsact::interpret::details::event_ref::clear() -> void {
 		return;
 	}
 
-	if(destroyable_index_ >= lifecycle_info.size()) {
+	if(!owner_ || destroyable_index_ >= owner_->info.size()) {
 		return;
 	}
 
-	auto& info = lifecycle_info[destroyable_index_];
-	// if(info.callbacks.contains(id_)) {
-	// 	info.callbacks.erase(id_);
-	// }
-	// if(info.callback_id.contains(id_)) {
-	// 	info.callback_id.erase(id_);
-	// }
+	owner_->info[destroyable_index_].remove(id_);
 	id_ = {};
 }
 
@@ -97,34 +183,96 @@ auto ecsact::interpret::details::on_destroy( //
 	castable_destroyable_ids_t id,
 	std::function<void()>      callback
 ) -> event_ref {
-	auto& info = lifecycle_info[static_cast<int>(id.index())];
+	auto& state = *current_context().lifecycle;
+	auto& info = state.info[static_cast<int>(id.index())];
 
 	auto ref = event_ref{};
+	ref.owner_ = &state;
 	ref.destroyable_index_ = static_cast<int>(id.index());
 	ref.id_ = info.gen_next_id();
-	info.callbacks[ref.id_] = callback;
-	info.callback_id[ref.id_] = destroyable_id_as_int(id);
+
+	auto destroyable_id = destroyable_id_as_int(id);
+	info.callbacks.emplace(
+		ref.id_,
+		lifecycle_callback_entry{
+			.destroyable_id = destroyable_id,
+			.callback = std::move(callback),
+		}
+	);
+	info.event_refs_by_id[destroyable_id].push_back(ref.id_);
 	return ref;
 }
 
 auto ecsact::interpret::details::trigger_on_destroy( //
 	destroyable_id_t id
 ) -> void {
+	auto  span = trace_span{"runtime", "trigger_on_destroy"};
+	auto& state = *current_context().lifecycle;
+	auto  destroyable_id = destroyable_id_as_int(id);
 	for(auto index : callback_indices(id)) {
-		auto& info = lifecycle_info[index];
-		for(auto itr = info.callback_id.begin(); itr != info.callback_id.end();) {
-			auto& event_ref = itr->first;
-			auto  callback_id = itr->second;
-			if(callback_id == destroyable_id_as_int(id)) {
-				auto callbacks_itr = info.callbacks.find(event_ref);
-				if(callbacks_itr != info.callbacks.end()) {
-					callbacks_itr->second();
-					info.callbacks.erase(callbacks_itr);
-				}
-				itr = info.callback_id.erase(itr);
-			} else {
-				++itr;
+		auto& info = state.info[index];
+
+		// Take the whole list up front. Callbacks may register or clear other
+		// event refs while we are calling them.
+		auto refs_node = info.event_refs_by_id.extract(destroyable_id);
+		if(refs_node.empty()) {
+			continue;
+		}
+
+		for(auto ref_id : refs_node.mapped()) {
+			auto itr = info.callbacks.find(ref_id);
+			if(itr == info.callbacks.end()) {
+				// Cleared by an earlier callback
+				continue;
 			}
+
+			auto callback = std::move(itr->second.callback);
+			info.callbacks.erase(itr);
+			callback();
+		}
+	}
+}
+
+auto ecsact::interpret::details::add_lifecycle_memory_usage(
+	ecsact_runtime_memory_usage& usage
+) -> void {
+	for(auto& info : current_context().lifecycle->info) {
+		auto bytes = heap_bytes(info.callbacks) + heap_bytes(info.event_refs_by_id);
+		for(auto& [_, refs] : info.event_refs_by_id) {
+			bytes += heap_bytes(refs);
+		}
+		add_memory(
+			usage,
+			ECSACT_MEMORY_TABLE_DESTROY_CALLBACKS,
+			info.callbacks.size(),
+			bytes
+		);
+	}
+}
+
+auto ecsact::interpret::details::add_lifecycle_memory_usage(
+	std::span<const int32_t>     ids,
+	ecsact_runtime_memory_usage& usage
+) -> void {
+	using callback_node_t =
+		std::pair<const event_ref_id, lifecycle_callback_entry>;
+	constexpr auto callback_bytes =
+		sizeof(callback_node_t) + sizeof(void*) + sizeof(std::size_t);
+
+	for(auto& info : current_context().lifecycle->info) {
+		for(auto id : ids) {
+			auto itr = info.event_refs_by_id.find(id);
+			if(itr == info.event_refs_by_id.end()) {
+				continue;
+			}
+
+			auto& refs = itr->second;
+			add_memory(
+				usage,
+				ECSACT_MEMORY_TABLE_DESTROY_CALLBACKS,
+				refs.size(),
+				heap_bytes(refs) + static_cast<int64_t>(refs.size() * callback_bytes)
+			);
 		}
 	}
 }
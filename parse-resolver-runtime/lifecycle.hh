@@ -8,6 +8,8 @@ namespace ecsact::interpret::details {
 
 enum class event_ref_id : int;
 
+struct lifecycle_state;
+
 class event_ref;
 
 /**
@@ -47,14 +49,21 @@ class event_ref {
 	friend auto on_destroy(castable_destroyable_ids_t, std::function<void()>)
 		-> event_ref;
 
-	int          destroyable_index_;
-	event_ref_id id_;
+	lifecycle_state* owner_ = nullptr;
+	int              destroyable_index_ = 0;
+	event_ref_id     id_ = {};
 
 	event_ref();
 
 public:
 	event_ref(event_ref&&);
+	auto operator=(event_ref&&) -> event_ref&;
 	~event_ref();
+
+	/**
+	 * Unregisters the callback. Does nothing if it was already called or
+	 * cleared.
+	 */
 	auto clear() -> void;
 };
 } // namespace ecsact::interpret::details
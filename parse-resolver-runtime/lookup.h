@@ -0,0 +1,89 @@
+#ifndef ECSACT_PARSE_RESOLVER_RUNTIME_LOOKUP_H
+#define ECSACT_PARSE_RESOLVER_RUNTIME_LOOKUP_H
+
+#include <stdint.h>
+#include "ecsact/runtime/common.h"
+
+/**
+ * Lookup functions specific to the parse resolver runtime. Declarations are
+ * indexed by name when they are created so these lookups are constant time and
+ * do not allocate.
+ *
+ * Names are resolved as seen from the @p scope_package_id package. Unless
+ * stated otherwise a name may either be a plain declaration name in the scope
+ * package or a fully qualified name (e.g. `example.pkg.MyComponent`) where the
+ * package is the scope package or one of its dependencies.
+ */
+
+/**
+ * @returns ECSACT_INVALID_ID(component) if no component was found
+ */
+ecsact_component_id ecsact_lookup_component(
+	ecsact_package_id scope_package_id,
+	const char*       component_name,
+	int32_t           component_name_len
+);
+
+/**
+ * @returns ECSACT_INVALID_ID(transient) if no transient was found
+ */
+ecsact_transient_id ecsact_lookup_transient(
+	ecsact_package_id scope_package_id,
+	const char*       transient_name,
+	int32_t           transient_name_len
+);
+
+/**
+ * Systems may only be looked up by their plain name in the scope package.
+ * @returns ECSACT_INVALID_ID(system) if no system was found
+ */
+ecsact_system_id ecsact_lookup_system(
+	ecsact_package_id scope_package_id,
+	const char*       system_name,
+	int32_t           system_name_len
+);
+
+/**
+ * Actions may only be looked up by their plain name in the scope package.
+ * @returns ECSACT_INVALID_ID(action) if no action was found
+ */
+ecsact_action_id ecsact_lookup_action(
+	ecsact_package_id scope_package_id,
+	const char*       action_name,
+	int32_t           action_name_len
+);
+
+/**
+ * @returns ECSACT_INVALID_ID(enum) if no enum was found
+ */
+ecsact_enum_id ecsact_lookup_enum(
+	ecsact_package_id scope_package_id,
+	const char*       enum_name,
+	int32_t           enum_name_len
+);
+
+/**
+ * Field of @p composite_id named exactly @p field_name. If several fields share
+ * the name the first one added is returned.
+ * @returns ECSACT_INVALID_ID(field) if no field was found
+ */
+ecsact_field_id ecsact_lookup_field(
+	ecsact_composite_id composite_id,
+	const char*         field_name,
+	int32_t             field_name_len
+);
+
+/**
+ * Associations of @p system_id with @p component_id in the order they were
+ * added. Output parameters behave the same as
+ * `ecsact_meta_system_assoc_ids`.
+ */
+void ecsact_lookup_system_assoc_ids(
+	ecsact_system_like_id    system_id,
+	ecsact_component_like_id component_id,
+	int32_t                  max_assoc_count,
+	ecsact_system_assoc_id*  out_assoc_ids,
+	int32_t*                 out_assoc_count
+);
+
+#endif // ECSACT_PARSE_RESOLVER_RUNTIME_LOOKUP_H
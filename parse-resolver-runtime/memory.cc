@@ -0,0 +1,102 @@
+#include "parse-resolver-runtime/memory.h"
+
+#include <cstdint>
+#include <vector>
+#include "parse-resolver-runtime/memory.hh"
+#include "parse-resolver-runtime/views.hh"
+
+using ecsact::interpret::details::add_assoc_memory_usage;
+using ecsact::interpret::details::add_lifecycle_memory_usage;
+using ecsact::interpret::details::add_resolver_memory_usage;
+
+namespace views = ecsact::interpret::views;
+
+static auto sum_total_bytes(ecsact_runtime_memory_usage& usage) -> void {
+	usage.total_bytes = 0;
+	for(auto& entry : usage.tables) {
+		usage.total_bytes += entry.bytes;
+	}
+}
+
+void ecsact_get_runtime_memory_usage(ecsact_runtime_memory_usage* out_usage) {
+	*out_usage = {};
+	add_resolver_memory_usage(*out_usage);
+	add_assoc_memory_usage(*out_usage);
+	add_lifecycle_memory_usage(*out_usage);
+	sum_total_bytes(*out_usage);
+}
+
+void ecsact_get_package_memory_usage(
+	ecsact_package_id            package_id,
+	ecsact_runtime_memory_usage* out_usage
+) {
+	auto usage = ecsact_runtime_memory_usage{};
+	add_resolver_memory_usage(package_id, usage);
+
+	auto system_ids = std::vector<ecsact_system_like_id>{};
+	auto ids = std::vector<int32_t>{static_cast<int32_t>(package_id)};
+	auto add_ids = [&](auto decl_ids) {
+		for(auto id : decl_ids) {
+			ids.push_back(static_cast<int32_t>(id));
+		}
+	};
+
+	for(auto id : views::system_ids(package_id)) {
+		system_ids.push_back(ecsact_id_cast<ecsact_system_like_id>(id));
+	}
+	for(auto id : views::action_ids(package_id)) {
+		system_ids.push_back(ecsact_id_cast<ecsact_system_like_id>(id));
+	}
+	add_ids(system_ids);
+	add_ids(views::component_ids(package_id));
+	add_ids(views::transient_ids(package_id));
+	add_ids(views::enum_ids(package_id));
+
+	add_assoc_memory_usage(system_ids, usage);
+	add_lifecycle_memory_usage(ids, usage);
+	sum_total_bytes(usage);
+	*out_usage = usage;
+}
+
+const char* ecsact_runtime_memory_table_name( //
+	ecsact_runtime_memory_table table
+) {
+	switch(table) {
+		case ECSACT_MEMORY_TABLE_NAMES:
+			return "names";
+		case ECSACT_MEMORY_TABLE_ID_SLOTS:
+			return "id slots";
+		case ECSACT_MEMORY_TABLE_PACKAGES:
+			return "packages";
+		case ECSACT_MEMORY_TABLE_COMPONENTS:
+			return "components";
+		case ECSACT_MEMORY_TABLE_TRANSIENTS:
+			return "transients";
+		case ECSACT_MEMORY_TABLE_SYSTEMS:
+			return "systems";
+		case ECSACT_MEMORY_TABLE_ACTIONS:
+			return "actions";
+		case ECSACT_MEMORY_TABLE_ENUMS:
+			return "enums";
+		case ECSACT_MEMORY_TABLE_FIELDS:
+			return "fields";
+		case ECSACT_MEMORY_TABLE_ENUM_VALUES:
+			return "enum values";
+		case ECSACT_MEMORY_TABLE_CAPABILITIES:
+			return "capabilities";
+		case ECSACT_MEMORY_TABLE_GENERATES:
+			return "generates";
+		case ECSACT_MEMORY_TABLE_NOTIFY_SETTINGS:
+			return "notify settings";
+		case ECSACT_MEMORY_TABLE_NAME_INDEXES:
+			return "name indexes";
+		case ECSACT_MEMORY_TABLE_ASSOCIATIONS:
+			return "associations";
+		case ECSACT_MEMORY_TABLE_DESTROY_CALLBACKS:
+			return "destroy callbacks";
+		case ECSACT_MEMORY_TABLE_COUNT:
+			break;
+	}
+
+	return "";
+}
@@ -0,0 +1,79 @@
+#ifndef ECSACT_PARSE_RESOLVER_RUNTIME_MEMORY_H
+#define ECSACT_PARSE_RESOLVER_RUNTIME_MEMORY_H
+
+#include <stdint.h>
+#include "ecsact/runtime/common.h"
+
+/**
+ * Memory accounting for the parse resolver runtime. Byte counts estimate the
+ * memory each table of the current context holds, computed from the sizes
+ * and capacities of the containers involved. Allocator overhead and whatever
+ * destroy callbacks capture are not included.
+ */
+
+typedef enum ecsact_runtime_memory_table {
+	/** Interned names. Every distinct name is stored once. */
+	ECSACT_MEMORY_TABLE_NAMES,
+
+	/** Per ID bookkeeping including full names */
+	ECSACT_MEMORY_TABLE_ID_SLOTS,
+	ECSACT_MEMORY_TABLE_PACKAGES,
+	ECSACT_MEMORY_TABLE_COMPONENTS,
+	ECSACT_MEMORY_TABLE_TRANSIENTS,
+	ECSACT_MEMORY_TABLE_SYSTEMS,
+	ECSACT_MEMORY_TABLE_ACTIONS,
+	ECSACT_MEMORY_TABLE_ENUMS,
+	ECSACT_MEMORY_TABLE_FIELDS,
+	ECSACT_MEMORY_TABLE_ENUM_VALUES,
+	ECSACT_MEMORY_TABLE_CAPABILITIES,
+
+	/** Counts every component of every generates block */
+	ECSACT_MEMORY_TABLE_GENERATES,
+	ECSACT_MEMORY_TABLE_NOTIFY_SETTINGS,
+
+	/** Declaration and field name lookup tables */
+	ECSACT_MEMORY_TABLE_NAME_INDEXES,
+	ECSACT_MEMORY_TABLE_ASSOCIATIONS,
+	ECSACT_MEMORY_TABLE_DESTROY_CALLBACKS,
+
+	ECSACT_MEMORY_TABLE_COUNT,
+} ecsact_runtime_memory_table;
+
+typedef struct ecsact_runtime_memory_entry {
+	/** Number of entries in the table */
+	int64_t count;
+	int64_t bytes;
+} ecsact_runtime_memory_entry;
+
+typedef struct ecsact_runtime_memory_usage {
+	/** Indexed by `ecsact_runtime_memory_table` */
+	ecsact_runtime_memory_entry tables[ECSACT_MEMORY_TABLE_COUNT];
+
+	/** Sum of the bytes of every table */
+	int64_t total_bytes;
+} ecsact_runtime_memory_usage;
+
+/**
+ * Reports the memory held by the whole current context, including storage
+ * kept around for reuse after declarations are destroyed.
+ */
+void ecsact_get_runtime_memory_usage(ecsact_runtime_memory_usage* out_usage);
+
+/**
+ * Reports the memory held by @p package_id and everything it owns. Names are
+ * counted for every declaration, field and enum value of the package even if
+ * they are shared with other packages.
+ *
+ * Throws `std::out_of_range` if @p package_id is not a package.
+ */
+void ecsact_get_package_memory_usage(
+	ecsact_package_id            package_id,
+	ecsact_runtime_memory_usage* out_usage
+);
+
+/**
+ * @returns a static name for @p table (e.g. "fields")
+ */
+const char* ecsact_runtime_memory_table_name(ecsact_runtime_memory_table table);
+
+#endif // ECSACT_PARSE_RESOLVER_RUNTIME_MEMORY_H
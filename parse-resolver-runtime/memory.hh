@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "ecsact/runtime/common.h"
+#include "parse-resolver-runtime/memory.h"
+
+namespace ecsact::interpret::details {
+
+/**
+ * Estimated heap bytes held by standard containers. Node based containers
+ * are estimated as one allocation per element holding the value, the cached
+ * hash and the pointers common implementations keep next to it.
+ */
+template<typename T>
+auto heap_bytes(const std::vector<T>& v) -> int64_t {
+	return static_cast<int64_t>(v.capacity() * sizeof(T));
+}
+
+inline auto heap_bytes(const std::string& str) -> int64_t {
+	// Short strings are stored inline
+	if(str.capacity() < sizeof(std::string)) {
+		return 0;
+	}
+	return static_cast<int64_t>(str.capacity() + 1);
+}
+
+template<typename T>
+auto heap_bytes(const std::deque<T>& d) -> int64_t {
+	return static_cast<int64_t>(d.size() * sizeof(T));
+}
+
+template<typename K, typename V>
+auto heap_bytes(const std::map<K, V>& m) -> int64_t {
+	constexpr auto node_size = sizeof(std::pair<const K, V>) + 4 * sizeof(void*);
+	return static_cast<int64_t>(m.size() * node_size);
+}
+
+template<typename K, typename V, typename... Rest>
+auto heap_bytes(const std::unordered_map<K, V, Rest...>& m) -> int64_t {
+	constexpr auto node_size =
+		sizeof(std::pair<const K, V>) + sizeof(void*) + sizeof(std::size_t);
+	return static_cast<int64_t>(
+		m.size() * node_size + m.bucket_count() * sizeof(void*)
+	);
+}
+
+template<typename K, typename... Rest>
+auto heap_bytes(const std::unordered_set<K, Rest...>& s) -> int64_t {
+	constexpr auto node_size = sizeof(K) + sizeof(void*) + sizeof(std::size_t);
+	return static_cast<int64_t>(
+		s.size() * node_size + s.bucket_count() * sizeof(void*)
+	);
+}
+
+inline auto add_memory(
+	ecsact_runtime_memory_usage& usage,
+	ecsact_runtime_memory_table  table,
+	std::size_t                  count,
+	int64_t                      bytes
+) -> void {
+	usage.tables[table].count += static_cast<int64_t>(count);
+	usage.tables[table].bytes += bytes;
+}
+
+/**
+ * Each runtime translation unit reports the tables it owns. The overloads
+ * taking IDs only report what belongs to those IDs.
+ */
+auto add_resolver_memory_usage(ecsact_runtime_memory_usage& usage) -> void;
+auto add_resolver_memory_usage(
+	ecsact_package_id            package_id,
+	ecsact_runtime_memory_usage& usage
+) -> void;
+
+auto add_assoc_memory_usage(ecsact_runtime_memory_usage& usage) -> void;
+auto add_assoc_memory_usage(
+	std::span<const ecsact_system_like_id> system_ids,
+	ecsact_runtime_memory_usage&           usage
+) -> void;
+
+auto add_lifecycle_memory_usage(ecsact_runtime_memory_usage& usage) -> void;
+auto add_lifecycle_memory_usage(
+	std::span<const int32_t>     ids,
+	ecsact_runtime_memory_usage& usage
+) -> void;
+
+} // namespace ecsact::interpret::details
@@ -2,29 +2,82 @@
 #include "ecsact/runtime/meta.h"
 
 #include <map>
+#include <algorithm>
 #include <string>
-#include <atomic>
 #include <vector>
 #include <limits>
+#include <iterator>
 #include <variant>
 #include <cassert>
+#include <cstdint>
 #include <optional>
 #include <stdexcept>
+#include <string_view>
+#include <type_traits>
 #include <unordered_map>
+#include "parse-resolver-runtime/context.hh"
+#include "parse-resolver-runtime/def_pool.hh"
+#include "parse-resolver-runtime/export.h"
+#include "parse-resolver-runtime/fingerprint.h"
+#include "parse-resolver-runtime/fingerprint.hh"
+#include "parse-resolver-runtime/freeze.h"
+#include "parse-resolver-runtime/freeze.hh"
+#include "parse-resolver-runtime/ids.hh"
+#include "parse-resolver-runtime/layout.h"
 #include "parse-resolver-runtime/lifecycle.hh"
-
+#include "parse-resolver-runtime/lookup.h"
+#include "parse-resolver-runtime/memory.hh"
+#include "parse-resolver-runtime/string_pool.hh"
+#include "parse-resolver-runtime/trace.hh"
+#include "parse-resolver-runtime/views.hh"
+
+using ecsact::interpret::details::add_memory;
+using ecsact::interpret::details::current_context;
+using ecsact::interpret::details::def_pool;
+using ecsact::interpret::details::ensure_mutable;
+using ecsact::interpret::details::event_ref;
+using ecsact::interpret::details::fingerprint_fact;
+using ecsact::interpret::details::fingerprint_fact_kind;
+using ecsact::interpret::details::fingerprint_key;
+using ecsact::interpret::details::gen_next_id;
+using ecsact::interpret::details::heap_bytes;
+using ecsact::interpret::details::on_destroy;
+using ecsact::interpret::details::resolver_state;
+using ecsact::interpret::details::state_ptr;
+using ecsact::interpret::details::string_pool;
+using ecsact::interpret::details::trace_span;
 using ecsact::interpret::details::trigger_on_destroy;
 
 struct field {
-	std::string       name;
+	std::string_view  name;
 	ecsact_field_type type;
 };
 
+/**
+ * C struct layout of a composite. Computed lazily and cached on the composite
+ * until a field is added or an enum changes its storage type.
+ */
+struct composite_layout {
+	/** Indexed by field ID */
+	std::vector<int32_t> offsets;
+	int32_t              size = 0;
+	int32_t              alignment = 1;
+	uint64_t             enum_storage_epoch = 0;
+	bool                 valid = false;
+};
+
 class composite {
 	int32_t _last_field_id = -1;
 
 public:
 	std::map<ecsact_field_id, field> fields;
+	composite_layout                 layout;
+
+	/**
+	 * Keys view the `name` of the field they map to. If several fields share a
+	 * name the first one added is kept.
+	 */
+	std::unordered_map<std::string_view, ecsact_field_id> field_names;
 
 	inline ecsact_field_id next_field_id() {
 		return static_cast<ecsact_field_id>(++_last_field_id);
@@ -34,36 +87,42 @@ public:
 struct component_like : composite {};
 
 struct comp_def : component_like {
-	std::string           name;
+	std::string_view      name;
 	ecsact_component_type comp_type;
 };
 
 struct trans_def : component_like {
-	std::string name;
+	std::string_view name;
 };
 
 struct system_like {
-	using cap_comp_map_t =
-		std::unordered_map<ecsact_component_like_id, ecsact_system_capability>;
-
-	struct cap_entry {
-		ecsact_system_capability cap;
-	};
-
 	struct gen_entry {
 		ecsact_component_id    comp_id;
 		ecsact_system_generate flag;
 	};
 
-	using caps_t = std::unordered_map< //
-		ecsact_component_like_id,
-		cap_entry>;
+	using caps_t = std::vector< //
+		std::pair<ecsact_component_like_id, ecsact_system_capability>>;
+
+	/** in the order they were first set */
 	caps_t caps;
 
-	using generates_t = std::unordered_map<
-		ecsact_system_generates_id,
-		std::unordered_map<ecsact_component_id, ecsact_system_generate>>;
+	/**
+	 * Index into `caps` for each component with a capability
+	 */
+	std::unordered_map<ecsact_component_like_id, int32_t> cap_indices;
+
+	struct generates_def {
+		/** Number of generates blocks added to the system before this one */
+		int32_t ordinal = 0;
+
+		std::unordered_map<ecsact_component_id, ecsact_system_generate> components;
+	};
+
+	using generates_t =
+		std::unordered_map<ecsact_system_generates_id, generates_def>;
 	generates_t generates;
+	int32_t     generates_added = 0;
 
 	using notify_settings_t = std::unordered_map< //
 		ecsact_component_like_id,
@@ -79,26 +138,31 @@ struct system_like {
 };
 
 struct action_def : composite, system_like {
-	std::string name;
+	std::string_view name;
 };
 
 struct system_def : system_like {
-	std::string name;
-	int32_t     lazy_iteration_rate = 0;
+	std::string_view name;
+	int32_t          lazy_iteration_rate = 0;
 };
 
 struct enum_value {
-	std::string name;
-	int32_t     value;
+	std::string_view name;
+	int32_t          value;
 };
 
 class enum_def {
 	int32_t _last_enum_value_id = -1;
 
 public:
-	std::string                                name;
+	std::string_view                           name;
 	std::map<ecsact_enum_value_id, enum_value> enum_values;
 
+	/** Kept up to date by `ecsact_add_enum_value` */
+	int32_t             min_value = std::numeric_limits<int32_t>::max();
+	int32_t             max_value = std::numeric_limits<int32_t>::min();
+	ecsact_builtin_type storage_type = ECSACT_U8;
+
 	inline ecsact_enum_value_id next_enum_value_id() {
 		return static_cast<ecsact_enum_value_id>(++_last_enum_value_id);
 	}
@@ -107,11 +171,16 @@ public:
 using any_def = std::variant<comp_def, action_def, system_def>;
 
 struct package_def {
-	std::string name;
-	bool        main;
-	std::string source_file_path;
+	std::string_view name;
+	bool             main;
+	std::string      source_file_path;
 
-	std::vector<ecsact_package_id>   dependencies;
+	std::vector<ecsact_package_id> dependencies;
+
+	/**
+	 * Declarations owned by this package, including nested systems. Destroying
+	 * the package destroys exactly these.
+	 */
 	std::vector<ecsact_system_id>    systems;
 	std::vector<ecsact_action_id>    actions;
 	std::vector<ecsact_component_id> components;
@@ -120,65 +189,443 @@ struct package_def {
 
 	/** in execution order */
 	std::vector<ecsact_system_like_id> top_level_systems;
+
+	/**
+	 * Declaration name lookup tables. Keys view the `name` of the declaration
+	 * they map to so no allocation is needed to insert or lookup.
+	 */
+	template<typename ID>
+	using name_index_t = std::unordered_map<std::string_view, ID>;
+
+	name_index_t<ecsact_component_id> component_names;
+	name_index_t<ecsact_transient_id> transient_names;
+	name_index_t<ecsact_system_id>    system_names;
+	name_index_t<ecsact_action_id>    action_names;
+	name_index_t<ecsact_enum_id>      enum_names;
+
+	/**
+	 * Packages that may be referred to by name in a fully qualified lookup. This
+	 * is the package itself and its dependencies.
+	 */
+	name_index_t<ecsact_package_id> visible_packages;
+
+	std::vector<event_ref> event_refs;
+
+	/** Declarations created in this package so far */
+	int32_t declaration_count = 0;
+
+	/** See parse-resolver-runtime/fingerprint.h */
+	uint64_t fingerprint = 0;
+};
+
+/**
+ * What kind of definition an ID refers to. Every ID comes from the same
+ * counter so an ID is only ever bound to one kind.
+ */
+enum class def_kind : int8_t {
+	none,
+	package,
+	component,
+	transient,
+	system,
+	action,
+	enum_,
+};
+
+/**
+ * Per ID entry in `def_slots`. `index` is the location of the definition in
+ * the pool for `kind`.
+ */
+struct def_slot {
+	def_kind          kind = def_kind::none;
+	int32_t           index = -1;
+	ecsact_package_id owner = static_cast<ecsact_package_id>(-1);
+
+	/**
+	 * Number of declarations created in the owning package before this one
+	 */
+	int32_t ordinal = -1;
+};
+
+/**
+ * Full name of a declaration stored as its parent and its own name. The
+ * joined name is only built when it is first read and is dropped whenever the
+ * parent changes.
+ */
+struct full_name_entry {
+	/**
+	 * Declarations without a full name are enums and unnamed systems. Their
+	 * full name reads as an empty string.
+	 */
+	bool named = false;
+
+	/**
+	 * System-like the declaration is nested in or -1 if the owning package is
+	 * the parent
+	 */
+	ecsact_decl_id   parent = static_cast<ecsact_decl_id>(-1);
+	std::string_view leaf;
+
+	/** Interned `parent + "." + leaf` or `nullptr` if not yet built */
+	const char* joined = nullptr;
+};
+
+struct ecsact::interpret::details::resolver_state {
+	/**
+	 * Every name in this runtime is interned here. Each definition holds a
+	 * reference on its names which is released when it is destroyed, see
+	 * `release_names`.
+	 */
+	string_pool names;
+	/** Indexed by ID */
+	std::vector<def_slot> def_slots;
+	/** Indexed by ID */
+	std::vector<full_name_entry> full_names;
+	/** Live packages in creation order */
+	std::vector<ecsact_package_id>   package_ids;
+	def_pool<package_def>            package_defs;
+	def_pool<comp_def>               comp_defs;
+	def_pool<trans_def>              trans_defs;
+	def_pool<system_def>             sys_defs;
+	def_pool<action_def>             act_defs;
+	def_pool<enum_def>               enum_defs;
+	std::optional<ecsact_package_id> main_package_id;
+
+	/**
+	 * Bumped whenever an enum storage type changes. Composite layouts computed
+	 * at an older epoch may be stale.
+	 */
+	uint64_t enum_storage_epoch = 0;
 };
 
-static std::atomic_int32_t                                   last_id = 0;
-static std::unordered_map<ecsact_decl_id, std::string>       full_names;
-static std::unordered_map<ecsact_package_id, package_def>    package_defs;
-static std::unordered_map<ecsact_decl_id, ecsact_package_id> def_owner_map;
-static std::unordered_map<ecsact_component_id, comp_def>     comp_defs;
-static std::unordered_map<ecsact_transient_id, trans_def>    trans_defs;
-static std::unordered_map<ecsact_system_id, system_def>      sys_defs;
-static std::unordered_map<ecsact_action_id, action_def>      act_defs;
-static std::unordered_map<ecsact_enum_id, enum_def>          enum_defs;
-static std::optional<ecsact_package_id>                      main_package_id;
+auto ecsact::interpret::details::make_resolver_state()
+	-> state_ptr<resolver_state> {
+	return state_ptr<resolver_state>{new resolver_state{}};
+}
+
+auto ecsact::interpret::details::destroy_state(resolver_state* state) -> void {
+	delete state;
+}
+
+static auto state() -> resolver_state& {
+	return *current_context().resolver;
+}
+
+template<typename Def>
+constexpr auto kind_of() -> def_kind {
+	if constexpr(std::is_same_v<Def, package_def>) {
+		return def_kind::package;
+	} else if constexpr(std::is_same_v<Def, comp_def>) {
+		return def_kind::component;
+	} else if constexpr(std::is_same_v<Def, trans_def>) {
+		return def_kind::transient;
+	} else if constexpr(std::is_same_v<Def, system_def>) {
+		return def_kind::system;
+	} else if constexpr(std::is_same_v<Def, action_def>) {
+		return def_kind::action;
+	} else if constexpr(std::is_same_v<Def, enum_def>) {
+		return def_kind::enum_;
+	}
+}
+
+template<typename Def>
+static auto pool_of() -> def_pool<Def>& {
+	if constexpr(std::is_same_v<Def, package_def>) {
+		return state().package_defs;
+	} else if constexpr(std::is_same_v<Def, comp_def>) {
+		return state().comp_defs;
+	} else if constexpr(std::is_same_v<Def, trans_def>) {
+		return state().trans_defs;
+	} else if constexpr(std::is_same_v<Def, system_def>) {
+		return state().sys_defs;
+	} else if constexpr(std::is_same_v<Def, action_def>) {
+		return state().act_defs;
+	} else if constexpr(std::is_same_v<Def, enum_def>) {
+		return state().enum_defs;
+	}
+}
+
+template<typename ID>
+static auto find_slot(ID id) -> def_slot* {
+	auto& def_slots = state().def_slots;
+	auto  index = static_cast<int32_t>(id);
+	if(index < 0 || index >= static_cast<int32_t>(def_slots.size())) {
+		return nullptr;
+	}
+	return &def_slots[index];
+}
+
+/**
+ * Definition for @p id or `nullptr` if @p id isn't a `Def`
+ */
+template<typename Def, typename ID>
+static auto find_def(ID id) -> Def* {
+	auto slot = find_slot(id);
+	if(slot == nullptr || slot->kind != kind_of<Def>()) {
+		return nullptr;
+	}
+	return &pool_of<Def>()[slot->index];
+}
+
+template<typename Def, typename ID>
+static auto get_def(ID id) -> Def& {
+	auto def = find_def<Def>(id);
+	if(def == nullptr) {
+		throw std::out_of_range("Invalid definition ID");
+	}
+	return *def;
+}
+
+template<typename Def, typename ID>
+static auto create_def(ID id) -> Def& {
+	auto& defs = state();
+	auto  index = static_cast<int32_t>(id);
+	if(index >= static_cast<int32_t>(defs.def_slots.size())) {
+		defs.def_slots.resize(index + 1);
+		defs.full_names.resize(index + 1);
+	}
+
+	auto& slot = defs.def_slots[index];
+	assert(slot.kind == def_kind::none);
+	slot.kind = kind_of<Def>();
+	slot.index = pool_of<Def>().emplace();
+	return pool_of<Def>()[slot.index];
+}
+
+template<typename Def, typename ID>
+static auto release_def(ID id) -> void {
+	auto slot = find_slot(id);
+	assert(slot && slot->kind == kind_of<Def>());
+	pool_of<Def>().release(slot->index);
+	*slot = {};
+}
+
+static auto intern(const char* str, int32_t str_len) -> std::string_view {
+	return state().names.intern(std::string_view(str, str_len));
+}
+
+static auto full_name_entry_of(ecsact_decl_id id) -> full_name_entry& {
+	return state().full_names.at(static_cast<int32_t>(id));
+}
 
 template<typename T>
 static ecsact_package_id owner_package_id(T id) {
-	ecsact_decl_id decl_id = ecsact_id_cast<ecsact_decl_id>(id);
-	if(!def_owner_map.contains(decl_id)) {
+	auto slot = find_slot(ecsact_id_cast<ecsact_decl_id>(id));
+	if(slot == nullptr) {
 		return (ecsact_package_id)-1;
 	}
-	return def_owner_map.at(decl_id);
-}
-
-template<typename Callback>
-void visit_each_def_collection(Callback&& callback) {
-	callback(comp_defs);
-	callback(trans_defs);
-	callback(sys_defs);
-	callback(act_defs);
+	return slot->owner;
 }
 
 template<typename T>
 static void set_package_owner(T id, ecsact_package_id owner) {
-	assert(package_defs.contains(owner));
-	def_owner_map[ecsact_id_cast<ecsact_decl_id>(id)] = owner;
+	auto pkg_def = find_def<package_def>(owner);
+	assert(pkg_def);
+	auto slot = find_slot(ecsact_id_cast<ecsact_decl_id>(id));
+	slot->owner = owner;
+	slot->ordinal = pkg_def->declaration_count++;
 }
 
-static composite& get_composite(ecsact_composite_id id) {
-	if(comp_defs.contains((ecsact_component_id)id)) {
-		return comp_defs.at((ecsact_component_id)id);
+static auto fingerprint_package(ecsact_decl_id id) -> package_def* {
+	auto slot = find_slot(id);
+	if(slot == nullptr) {
+		return nullptr;
+	}
+	if(slot->kind == def_kind::package) {
+		return &state().package_defs[slot->index];
+	}
+	return find_def<package_def>(slot->owner);
+}
+
+auto ecsact::interpret::details::fingerprint_key(ecsact_decl_id id)
+	-> uint64_t {
+	auto slot = find_slot(id);
+	if(slot == nullptr || slot->kind == def_kind::none) {
+		return fingerprint_fact(static_cast<int32_t>(id));
 	}
 
-	if(trans_defs.contains((ecsact_transient_id)id)) {
-		return trans_defs.at((ecsact_transient_id)id);
+	auto pkg_def = fingerprint_package(id);
+	auto pkg_name = pkg_def ? pkg_def->name : std::string_view{};
+	if(slot->kind == def_kind::package) {
+		return fingerprint_fact(pkg_name);
 	}
+	return fingerprint_fact(pkg_name, slot->ordinal);
+}
 
-	if(act_defs.contains((ecsact_action_id)id)) {
-		return act_defs.at((ecsact_action_id)id);
+auto ecsact::interpret::details::add_fingerprint_fact(
+	ecsact_decl_id id,
+	uint64_t       fact
+) -> void {
+	if(auto pkg_def = fingerprint_package(id)) {
+		pkg_def->fingerprint += fact;
 	}
+}
 
-	throw std::invalid_argument("Invalid composite ID");
+auto ecsact::interpret::details::remove_fingerprint_fact(
+	ecsact_decl_id id,
+	uint64_t       fact
+) -> void {
+	if(auto pkg_def = fingerprint_package(id)) {
+		pkg_def->fingerprint -= fact;
+	}
 }
 
-static system_like& get_system_like(ecsact_system_like_id id) {
-	if(sys_defs.contains((ecsact_system_id)id)) {
-		return sys_defs.at((ecsact_system_id)id);
+template<typename ID>
+static auto key_of(ID id) -> uint64_t {
+	return fingerprint_key(ecsact_id_cast<ecsact_decl_id>(id));
+}
+
+/**
+ * Adds the fact made of @p values to the fingerprint of the package owning
+ * @p id
+ */
+template<typename ID, typename... Values>
+static auto add_fact(ID id, Values... values) -> void {
+	ecsact::interpret::details::add_fingerprint_fact(
+		ecsact_id_cast<ecsact_decl_id>(id),
+		fingerprint_fact(values...)
+	);
+}
+
+template<typename ID, typename... Values>
+static auto remove_fact(ID id, Values... values) -> void {
+	ecsact::interpret::details::remove_fingerprint_fact(
+		ecsact_id_cast<ecsact_decl_id>(id),
+		fingerprint_fact(values...)
+	);
+}
+
+template<typename ID>
+static auto add_declaration_fact(ID id, std::string_view name) -> void {
+	auto slot = find_slot(ecsact_id_cast<ecsact_decl_id>(id));
+	add_fact(
+		id,
+		fingerprint_fact_kind::declaration,
+		key_of(id),
+		slot->kind,
+		name
+	);
+}
+
+static auto full_name(ecsact_decl_id id) -> const char* {
+	auto& entry = full_name_entry_of(id);
+	if(entry.joined != nullptr) {
+		return entry.joined;
+	}
+
+	if(!entry.named) {
+		entry.joined = state().names.intern("").data();
+		return entry.joined;
+	}
+
+	// Nested systems are prefixed by their parent's full name. A parent without
+	// one is substituted by the package that owns it.
+	auto prefix = std::string_view{};
+	auto prefix_pkg_id = owner_package_id(id);
+	if(find_slot(entry.parent) != nullptr) {
+		prefix = full_name(entry.parent);
+		if(prefix.empty()) {
+			prefix_pkg_id = owner_package_id(entry.parent);
+		}
+	}
+	if(prefix.empty()) {
+		if(auto pkg_def = find_def<package_def>(prefix_pkg_id)) {
+			prefix = pkg_def->name;
+		}
+	}
+
+	auto joined = std::string{};
+	joined.reserve(prefix.size() + 1 + entry.leaf.size());
+	joined += prefix;
+	joined += '.';
+	joined += entry.leaf;
+	entry.joined = state().names.intern(joined).data();
+	return entry.joined;
+}
+
+template<typename ID>
+static auto set_full_name(ID id, std::string_view leaf) -> void {
+	full_name_entry_of(ecsact_id_cast<ecsact_decl_id>(id)) = {
+		.named = true,
+		.leaf = leaf,
+	};
+}
+
+/**
+ * Adds the systems nested in @p parent from position @p first on to the
+ * fingerprint of its package or removes them. Each one is a fact of its own so
+ * appending a nested system doesn't rehash the ones before it. Call before and
+ * after changing the systems from @p first on.
+ */
+static auto update_nested_systems_fact(
+	ecsact_system_like_id parent,
+	const system_like&    parent_def,
+	bool                  add,
+	std::size_t           first = 0
+) -> void {
+	auto  decl_id = ecsact_id_cast<ecsact_decl_id>(parent);
+	auto& nested_systems = parent_def.nested_systems;
+	for(auto index = first; nested_systems.size() > index; ++index) {
+		auto fact = fingerprint_fact(
+			fingerprint_fact_kind::nested_systems,
+			key_of(parent),
+			index,
+			key_of(nested_systems[index])
+		);
+		if(add) {
+			ecsact::interpret::details::add_fingerprint_fact(decl_id, fact);
+		} else {
+			ecsact::interpret::details::remove_fingerprint_fact(decl_id, fact);
+		}
+	}
+}
+
+static auto release_joined_full_name(ecsact_decl_id id) -> void {
+	auto& entry = full_name_entry_of(id);
+	if(entry.joined != nullptr) {
+		state().names.release(entry.joined);
+		entry.joined = nullptr;
+	}
+}
+
+/**
+ * Drops the joined full name of @p sys_id and of every system nested in it
+ */
+static auto invalidate_full_names(ecsact_system_id sys_id) -> void {
+	release_joined_full_name(ecsact_id_cast<ecsact_decl_id>(sys_id));
+	auto& def = get_def<system_def>(sys_id);
+	for(auto nested_sys_id : def.nested_systems) {
+		invalidate_full_names(nested_sys_id);
+	}
+}
+
+static composite& get_composite(ecsact_composite_id id) {
+	if(auto slot = find_slot(id)) {
+		switch(slot->kind) {
+			case def_kind::component:
+				return state().comp_defs[slot->index];
+			case def_kind::transient:
+				return state().trans_defs[slot->index];
+			case def_kind::action:
+				return state().act_defs[slot->index];
+			default:
+				break;
+		}
 	}
 
-	if(act_defs.contains((ecsact_action_id)id)) {
-		return act_defs.at((ecsact_action_id)id);
+	throw std::invalid_argument("Invalid composite ID");
+}
+
+static system_like& get_system_like(ecsact_system_like_id id) {
+	if(auto slot = find_slot(id)) {
+		switch(slot->kind) {
+			case def_kind::system:
+				return state().sys_defs[slot->index];
+			case def_kind::action:
+				return state().act_defs[slot->index];
+			default:
+				break;
+		}
 	}
 
 	throw std::invalid_argument("Invalid system-like ID");
@@ -186,7 +633,7 @@ static system_like& get_system_like(ecsact_system_like_id id) {
 
 template<typename T>
 static T next_id() {
-	return static_cast<T>(last_id++);
+	return gen_next_id<T>();
 }
 
 ecsact_package_id ecsact_create_package(
@@ -194,56 +641,96 @@ ecsact_package_id ecsact_create_package(
 	const char* package_name,
 	int32_t     package_name_len
 ) {
+	ensure_mutable(__func__);
 	auto  pkg_id = next_id<ecsact_package_id>();
-	auto& pkg = package_defs[pkg_id];
-	pkg.name = std::string_view(package_name, package_name_len);
+	auto& pkg = create_def<package_def>(pkg_id);
+	state().package_ids.push_back(pkg_id);
+	pkg.name = intern(package_name, package_name_len);
+	pkg.visible_packages.emplace(pkg.name, pkg_id);
+	add_fact(pkg_id, fingerprint_fact_kind::package, pkg.name);
 	if(main_package) {
-		main_package_id = pkg_id;
+		state().main_package_id = pkg_id;
+		add_fact(pkg_id, fingerprint_fact_kind::main_package);
 	}
 	return pkg_id;
 }
 
 ecsact_package_id ecsact_meta_main_package() {
-	if(main_package_id) {
+	if(auto& main_package_id = state().main_package_id) {
 		return *main_package_id;
 	}
 
 	return (ecsact_package_id)-1;
 }
 
-void ecsact_destroy_package(ecsact_package_id package_id) {
-	auto itr = package_defs.find(package_id);
-	if(itr == package_defs.end()) {
-		return;
+/**
+ * Releases the names interned for @p def
+ */
+template<typename Def>
+static auto release_names(const Def& def) -> void {
+	auto& names = state().names;
+	names.release(def.name);
+	if constexpr(std::is_base_of_v<composite, Def>) {
+		for(auto& [_, field] : def.fields) {
+			names.release(field.name);
+		}
+	}
+	if constexpr(std::is_same_v<Def, enum_def>) {
+		for(auto& [_, value] : def.enum_values) {
+			names.release(value.name);
+		}
 	}
+}
 
-	package_defs.erase(itr);
+template<typename Def, typename ID>
+static void release_decl(ID id) {
+	auto decl_id = ecsact_id_cast<ecsact_decl_id>(id);
+	release_joined_full_name(decl_id);
+	full_name_entry_of(decl_id) = {};
+	release_names(get_def<Def>(id));
+	release_def<Def>(id);
+}
 
-	visit_each_def_collection([&](auto& defs) {
-		for(auto itr = defs.begin(); itr != defs.end();) {
-			if(owner_package_id(itr->first) != package_id) {
-				++itr;
-			} else {
-				trigger_on_destroy(itr->first);
-				itr = defs.erase(itr);
-			}
-		}
-	});
+template<typename Def, typename ID>
+static void destroy_decl(ID id) {
+	trigger_on_destroy(id);
+	release_decl<Def>(id);
+}
 
-	auto owner_itr = def_owner_map.begin();
-	while(owner_itr != def_owner_map.end()) {
-		if(owner_itr->second != package_id) {
-			++owner_itr;
-		} else {
-			owner_itr = def_owner_map.erase(owner_itr);
-		}
+void ecsact_destroy_package(ecsact_package_id package_id) {
+	ensure_mutable(__func__);
+	auto span = trace_span{"runtime", "ecsact_destroy_package"};
+	auto pkg_def = find_def<package_def>(package_id);
+	if(!pkg_def) {
+		return;
+	}
+
+	for(auto comp_id : pkg_def->components) {
+		destroy_decl<comp_def>(comp_id);
+	}
+	for(auto trans_id : pkg_def->transients) {
+		destroy_decl<trans_def>(trans_id);
+	}
+	for(auto sys_id : pkg_def->systems) {
+		destroy_decl<system_def>(sys_id);
+	}
+	for(auto act_id : pkg_def->actions) {
+		destroy_decl<action_def>(act_id);
+	}
+	for(auto enum_id : pkg_def->enums) {
+		release_decl<enum_def>(enum_id);
 	}
 
+	// Package definition is erased after its destroy callbacks are triggered so
+	// they may still refer to it. Its name lookup tables still have keys viewing
+	// the released declaration names but are only destroyed from here on.
 	trigger_on_destroy(package_id);
+	release_decl<package_def>(package_id);
+	std::erase(state().package_ids, package_id);
 }
 
 int32_t ecsact_meta_count_packages() {
-	return static_cast<int32_t>(package_defs.size());
+	return static_cast<int32_t>(state().package_ids.size());
 }
 
 void ecsact_meta_get_package_ids(
@@ -251,22 +738,27 @@ void ecsact_meta_get_package_ids(
 	ecsact_package_id* out_package_ids,
 	int32_t*           out_package_count
 ) {
-	auto itr = package_defs.begin();
+	auto& package_ids = state().package_ids;
+	auto  itr = package_ids.begin();
 	for(int i = 0; max_package_count > i; ++i, ++itr) {
-		if(itr == package_defs.end()) {
+		if(itr == package_ids.end()) {
 			break;
 		}
-		out_package_ids[i] = itr->first;
+		out_package_ids[i] = *itr;
 	}
 
 	if(out_package_count != nullptr) {
-		*out_package_count = static_cast<int32_t>(package_defs.size());
+		*out_package_count = static_cast<int32_t>(package_ids.size());
 	}
 }
 
+uint64_t ecsact_package_fingerprint(ecsact_package_id package_id) {
+	return get_def<package_def>(package_id).fingerprint;
+}
+
 const char* ecsact_meta_package_name(ecsact_package_id package_id) {
-	if(package_defs.contains(package_id)) {
-		return package_defs.at(package_id).name.c_str();
+	if(auto def = find_def<package_def>(package_id)) {
+		return def->name.data();
 	}
 
 	return nullptr;
@@ -277,15 +769,18 @@ ecsact_component_id ecsact_create_component(
 	const char*       component_name,
 	int32_t           component_name_len
 ) {
-	auto& pkg_def = package_defs.at(owner);
+	ensure_mutable(__func__);
+	auto& pkg_def = get_def<package_def>(owner);
 	auto  comp_id = next_id<ecsact_component_id>();
 	auto  decl_id = ecsact_id_cast<ecsact_decl_id>(comp_id);
 	pkg_def.components.push_back(comp_id);
+	auto& def = create_def<comp_def>(comp_id);
 	set_package_owner(comp_id, owner);
-	auto& def = comp_defs[comp_id];
-	def.name = std::string_view(component_name, component_name_len);
+	def.name = intern(component_name, component_name_len);
 	def.comp_type = ECSACT_COMPONENT_TYPE_NONE;
-	full_names[decl_id] = pkg_def.name + "." + def.name;
+	set_full_name(decl_id, def.name);
+	pkg_def.component_names.try_emplace(def.name, comp_id);
+	add_declaration_fact(comp_id, def.name);
 
 	return comp_id;
 }
@@ -295,14 +790,17 @@ ecsact_transient_id ecsact_create_transient(
 	const char*       transient_name,
 	int32_t           transient_name_len
 ) {
-	auto& pkg_def = package_defs.at(owner);
+	ensure_mutable(__func__);
+	auto& pkg_def = get_def<package_def>(owner);
 	auto  trans_id = next_id<ecsact_transient_id>();
 	auto  decl_id = ecsact_id_cast<ecsact_decl_id>(trans_id);
 	pkg_def.transients.push_back(trans_id);
+	auto& def = create_def<trans_def>(trans_id);
 	set_package_owner(trans_id, owner);
-	auto& def = trans_defs[trans_id];
-	def.name = std::string_view(transient_name, transient_name_len);
-	full_names[decl_id] = pkg_def.name + "." + def.name;
+	def.name = intern(transient_name, transient_name_len);
+	set_full_name(decl_id, def.name);
+	pkg_def.transient_names.try_emplace(def.name, trans_id);
+	add_declaration_fact(trans_id, def.name);
 
 	return trans_id;
 }
@@ -312,20 +810,21 @@ ecsact_system_id ecsact_create_system(
 	const char*       system_name,
 	int32_t           system_name_len
 ) {
-	auto&      pkg_def = package_defs.at(owner);
+	ensure_mutable(__func__);
+	auto&      pkg_def = get_def<package_def>(owner);
 	const auto sys_id = next_id<ecsact_system_id>();
 	const auto decl_id = ecsact_id_cast<ecsact_decl_id>(sys_id);
 	const auto sys_like_id = ecsact_id_cast<ecsact_system_like_id>(sys_id);
 	pkg_def.systems.push_back(sys_id);
 	pkg_def.top_level_systems.push_back(sys_like_id);
+	auto& def = create_def<system_def>(sys_id);
 	set_package_owner(sys_id, owner);
-	auto& def = sys_defs[sys_id];
-	def.name = std::string_view(system_name, system_name_len);
-	if(def.name.empty()) {
-		full_names[decl_id] = "";
-	} else {
-		full_names[decl_id] = pkg_def.name + "." + def.name;
+	def.name = intern(system_name, system_name_len);
+	if(!def.name.empty()) {
+		set_full_name(decl_id, def.name);
 	}
+	pkg_def.system_names.try_emplace(def.name, sys_id);
+	add_declaration_fact(sys_id, def.name);
 
 	return sys_id;
 }
@@ -335,16 +834,19 @@ ecsact_action_id ecsact_create_action(
 	const char*       action_name,
 	int32_t           action_name_len
 ) {
-	auto&      pkg_def = package_defs.at(owner);
+	ensure_mutable(__func__);
+	auto&      pkg_def = get_def<package_def>(owner);
 	const auto act_id = next_id<ecsact_action_id>();
 	const auto decl_id = ecsact_id_cast<ecsact_decl_id>(act_id);
 	const auto sys_like_id = ecsact_id_cast<ecsact_system_like_id>(act_id);
 	pkg_def.actions.push_back(act_id);
 	pkg_def.top_level_systems.push_back(sys_like_id);
+	auto& def = create_def<action_def>(act_id);
 	set_package_owner(act_id, owner);
-	auto& def = act_defs[act_id];
-	def.name = std::string_view(action_name, action_name_len);
-	full_names[decl_id] = pkg_def.name + "." + def.name;
+	def.name = intern(action_name, action_name_len);
+	set_full_name(decl_id, def.name);
+	pkg_def.action_names.try_emplace(def.name, act_id);
+	add_declaration_fact(act_id, def.name);
 
 	return act_id;
 }
@@ -354,31 +856,78 @@ ecsact_enum_id ecsact_create_enum(
 	const char*       enum_name,
 	int32_t           enum_name_len
 ) {
-	auto& pkg_def = package_defs.at(owner);
+	ensure_mutable(__func__);
+	auto& pkg_def = get_def<package_def>(owner);
 	auto  enum_id = next_id<ecsact_enum_id>();
-	auto& def = enum_defs[enum_id];
-	def.name = std::string_view(enum_name, enum_name_len);
+	auto& def = create_def<enum_def>(enum_id);
+	set_package_owner(enum_id, owner);
+	def.name = intern(enum_name, enum_name_len);
 	pkg_def.enums.push_back(enum_id);
+	pkg_def.enum_names.try_emplace(def.name, enum_id);
+	add_declaration_fact(enum_id, def.name);
 
 	return enum_id;
 }
 
+static auto enum_storage_type( //
+	int32_t min_value,
+	int32_t max_value
+) -> ecsact_builtin_type {
+	using std::numeric_limits;
+
+	if(min_value < 0) {
+		if(max_value > numeric_limits<int16_t>::max()) {
+			return ECSACT_I32;
+		}
+		if(max_value > numeric_limits<int8_t>::max()) {
+			return ECSACT_I16;
+		}
+		return ECSACT_I8;
+	} else {
+		if(max_value > numeric_limits<uint16_t>::max()) {
+			return ECSACT_U32;
+		}
+		if(max_value > numeric_limits<uint8_t>::max()) {
+			return ECSACT_U16;
+		}
+		return ECSACT_U8;
+	}
+}
+
 ecsact_enum_value_id ecsact_add_enum_value(
 	ecsact_enum_id enum_id,
 	int32_t        value,
 	const char*    value_name,
 	int32_t        value_name_len
 ) {
-	auto& def = enum_defs.at(enum_id);
+	ensure_mutable(__func__);
+	auto& def = get_def<enum_def>(enum_id);
 	auto  enum_value_id = def.next_enum_value_id();
 	auto& enum_value = def.enum_values[enum_value_id];
-	enum_value.name = std::string(value_name, value_name_len);
+	enum_value.name = intern(value_name, value_name_len);
 	enum_value.value = value;
+	add_fact(
+		enum_id,
+		fingerprint_fact_kind::enum_value,
+		key_of(enum_id),
+		enum_value_id,
+		enum_value.name,
+		value
+	);
+
+	def.min_value = std::min(def.min_value, value);
+	def.max_value = std::max(def.max_value, value);
+	auto storage_type = enum_storage_type(def.min_value, def.max_value);
+	if(storage_type != def.storage_type) {
+		def.storage_type = storage_type;
+		state().enum_storage_epoch += 1;
+	}
+
 	return enum_value_id;
 }
 
 int32_t ecsact_meta_count_systems(ecsact_package_id package_id) {
-	auto& pkg_def = package_defs.at(package_id);
+	auto& pkg_def = get_def<package_def>(package_id);
 	return static_cast<int32_t>(pkg_def.systems.size());
 }
 
@@ -388,7 +937,7 @@ void ecsact_meta_get_system_ids(
 	ecsact_system_id* out_system_ids,
 	int32_t*          out_system_count
 ) {
-	auto& pkg_def = package_defs.at(package_id);
+	auto& pkg_def = get_def<package_def>(package_id);
 	auto  itr = pkg_def.systems.begin();
 	for(int32_t i = 0; max_system_count > i && itr != pkg_def.systems.end();
 			++i) {
@@ -402,7 +951,7 @@ void ecsact_meta_get_system_ids(
 }
 
 int32_t ecsact_meta_count_actions(ecsact_package_id package_id) {
-	auto& pkg_def = package_defs.at(package_id);
+	auto& pkg_def = get_def<package_def>(package_id);
 	return static_cast<int32_t>(pkg_def.actions.size());
 }
 
@@ -412,7 +961,7 @@ void ecsact_meta_get_action_ids(
 	ecsact_action_id* out_action_ids,
 	int32_t*          out_action_count
 ) {
-	auto& pkg_def = package_defs.at(package_id);
+	auto& pkg_def = get_def<package_def>(package_id);
 	auto  itr = pkg_def.actions.begin();
 	for(int32_t i = 0; max_action_count > i && itr != pkg_def.actions.end();
 			++i) {
@@ -426,33 +975,33 @@ void ecsact_meta_get_action_ids(
 }
 
 int32_t ecsact_meta_count_components(ecsact_package_id package_id) {
-	auto& pkg_def = package_defs.at(package_id);
+	auto& pkg_def = get_def<package_def>(package_id);
 	return static_cast<int32_t>(pkg_def.components.size());
 }
 
 int32_t ecsact_meta_count_transients(ecsact_package_id package_id) {
-	auto& pkg_def = package_defs.at(package_id);
+	auto& pkg_def = get_def<package_def>(package_id);
 	return static_cast<int32_t>(pkg_def.transients.size());
 }
 
 const char* ecsact_meta_component_name(ecsact_component_id comp_id) {
-	return comp_defs.at(comp_id).name.c_str();
+	return get_def<comp_def>(comp_id).name.data();
 }
 
 const char* ecsact_meta_transient_name(ecsact_transient_id trans) {
-	return trans_defs.at(trans).name.c_str();
+	return get_def<trans_def>(trans).name.data();
 }
 
 const char* ecsact_meta_system_name(ecsact_system_id sys_id) {
-	return sys_defs.at(sys_id).name.c_str();
+	return get_def<system_def>(sys_id).name.data();
 }
 
 const char* ecsact_meta_action_name(ecsact_action_id act_id) {
-	return act_defs.at(act_id).name.c_str();
+	return get_def<action_def>(act_id).name.data();
 }
 
 int32_t ecsact_meta_count_enums(ecsact_package_id package_id) {
-	auto& pkg_def = package_defs.at(package_id);
+	auto& pkg_def = get_def<package_def>(package_id);
 	return static_cast<int32_t>(pkg_def.enums.size());
 }
 
@@ -462,7 +1011,7 @@ void ecsact_meta_get_enum_ids(
 	ecsact_enum_id*   out_enum_ids,
 	int32_t*          out_enum_count
 ) {
-	auto& pkg_def = package_defs.at(package_id);
+	auto& pkg_def = get_def<package_def>(package_id);
 
 	auto itr = pkg_def.enums.begin();
 	for(int i = 0; max_enum_count > i && itr != pkg_def.enums.end(); ++i) {
@@ -476,42 +1025,11 @@ void ecsact_meta_get_enum_ids(
 }
 
 ecsact_builtin_type ecsact_meta_enum_storage_type(ecsact_enum_id enum_id) {
-	using std::numeric_limits;
-
-	auto&   def = enum_defs.at(enum_id);
-	int32_t min_value = numeric_limits<int32_t>::max();
-	int32_t max_value = numeric_limits<int32_t>::min();
-	for(auto& [_, enum_value] : def.enum_values) {
-		if(enum_value.value > max_value) {
-			max_value = enum_value.value;
-		}
-
-		if(enum_value.value < min_value) {
-			min_value = enum_value.value;
-		}
-	}
-
-	if(min_value < 0) {
-		if(max_value > numeric_limits<int16_t>::max()) {
-			return ECSACT_I32;
-		}
-		if(max_value > numeric_limits<int8_t>::max()) {
-			return ECSACT_I16;
-		}
-		return ECSACT_I8;
-	} else {
-		if(max_value > numeric_limits<uint16_t>::max()) {
-			return ECSACT_U32;
-		}
-		if(max_value > numeric_limits<uint8_t>::max()) {
-			return ECSACT_U16;
-		}
-		return ECSACT_U8;
-	}
+	return get_def<enum_def>(enum_id).storage_type;
 }
 
 int32_t ecsact_meta_count_enum_values(ecsact_enum_id enum_id) {
-	auto& def = enum_defs.at(enum_id);
+	auto& def = get_def<enum_def>(enum_id);
 	return static_cast<int32_t>(def.enum_values.size());
 }
 
@@ -521,7 +1039,7 @@ void ecsact_meta_get_enum_value_ids(
 	ecsact_enum_value_id* out_enum_value_ids,
 	int32_t*              out_enum_values_count
 ) {
-	auto& def = enum_defs.at(enum_id);
+	auto& def = get_def<enum_def>(enum_id);
 
 	auto itr = def.enum_values.begin();
 	for(int i = 0; max_enum_value_ids > i && itr != def.enum_values.end(); ++i) {
@@ -538,15 +1056,15 @@ const char* ecsact_meta_enum_value_name(
 	ecsact_enum_id       enum_id,
 	ecsact_enum_value_id enum_value_id
 ) {
-	auto& def = enum_defs.at(enum_id);
-	return def.enum_values.at(enum_value_id).name.c_str();
+	auto& def = get_def<enum_def>(enum_id);
+	return def.enum_values.at(enum_value_id).name.data();
 }
 
 int32_t ecsact_meta_enum_value(
 	ecsact_enum_id       enum_id,
 	ecsact_enum_value_id enum_value_id
 ) {
-	auto& def = enum_defs.at(enum_id);
+	auto& def = get_def<enum_def>(enum_id);
 	return def.enum_values.at(enum_value_id).value;
 }
 
@@ -556,7 +1074,7 @@ void ecsact_meta_get_component_ids(
 	ecsact_component_id* out_component_ids,
 	int32_t*             out_component_count
 ) {
-	auto& pkg_def = package_defs.at(package_id);
+	auto& pkg_def = get_def<package_def>(package_id);
 	auto  itr = pkg_def.components.begin();
 	for(int32_t i = 0; max_component_count > i && itr != pkg_def.components.end();
 			++i) {
@@ -575,7 +1093,7 @@ void ecsact_meta_get_transient_ids(
 	ecsact_transient_id* out_transient_ids,
 	int32_t*             out_transient_count
 ) {
-	auto& pkg_def = package_defs.at(package_id);
+	auto& pkg_def = get_def<package_def>(package_id);
 	auto  itr = pkg_def.transients.begin();
 	for(int32_t i = 0; max_transient_count > i && itr != pkg_def.transients.end();
 			++i) {
@@ -588,19 +1106,53 @@ void ecsact_meta_get_transient_ids(
 	}
 }
 
+static auto field_type_fingerprint(ecsact_field_type type) -> uint64_t {
+	switch(type.kind) {
+		case ECSACT_TYPE_KIND_BUILTIN:
+			return fingerprint_fact(type.kind, type.type.builtin, type.length);
+		case ECSACT_TYPE_KIND_ENUM:
+			return fingerprint_fact(
+				type.kind,
+				key_of(type.type.enum_id),
+				type.length
+			);
+		case ECSACT_TYPE_KIND_FIELD_INDEX:
+			return fingerprint_fact(
+				type.kind,
+				key_of(type.type.field_index.composite_id),
+				type.type.field_index.field_id,
+				type.length
+			);
+	}
+
+	return fingerprint_fact(type.kind, type.length);
+}
+
 ecsact_field_id ecsact_add_field(
 	ecsact_composite_id composite_id,
 	ecsact_field_type   field_type,
 	const char*         field_name,
 	int32_t             field_name_len
 ) {
+	ensure_mutable(__func__);
 	auto& def = get_composite(composite_id);
 	auto  field_id = def.next_field_id();
 
-	def.fields[field_id] = {
-		.name = std::string(field_name, field_name_len),
+	auto& field = def.fields[field_id];
+	field = {
+		.name = intern(field_name, field_name_len),
 		.type = field_type,
 	};
+	def.field_names.try_emplace(field.name, field_id);
+	def.layout.valid = false;
+	add_fact(
+		composite_id,
+		fingerprint_fact_kind::field,
+		key_of(composite_id),
+		field_id,
+		field.name,
+		field_type_fingerprint(field_type)
+	);
 
 	return field_id;
 }
@@ -634,7 +1186,7 @@ const char* ecsact_meta_field_name(
 	ecsact_field_id     field_id
 ) {
 	auto& def = get_composite(composite_id);
-	return def.fields.at(field_id).name.c_str();
+	return def.fields.at(field_id).name.data();
 }
 
 ecsact_field_type ecsact_meta_field_type(
@@ -669,48 +1221,110 @@ static auto enum_type_size(ecsact_enum_id enum_id) {
 	return builtin_type_size(ecsact_meta_enum_storage_type(enum_id));
 }
 
-static auto field_type_size(ecsact_field_type type) -> int32_t {
-	auto base_size = 0;
+/**
+ * Size of a single element of @p type, which is also its alignment
+ */
+static auto field_element_size(ecsact_field_type type) -> int32_t {
 	switch(type.kind) {
 		case ECSACT_TYPE_KIND_BUILTIN:
-			base_size = builtin_type_size(type.type.builtin);
-			break;
+			return builtin_type_size(type.type.builtin);
 		case ECSACT_TYPE_KIND_ENUM:
-			base_size = enum_type_size(type.type.enum_id);
-			break;
+			return enum_type_size(type.type.enum_id);
 		case ECSACT_TYPE_KIND_FIELD_INDEX:
-			base_size = field_type_size(ecsact_meta_field_type(
+			return field_element_size(ecsact_meta_field_type(
 				type.type.field_index.composite_id,
 				type.type.field_index.field_id
 			));
-			break;
 	}
 
-	return base_size * type.length;
+	return 0;
+}
+
+/**
+ * Size of all elements of @p type. A length of 0 is treated as a single
+ * element.
+ */
+static auto field_type_size(ecsact_field_type type) -> int32_t {
+	return field_element_size(type) * std::max(type.length, 1);
+}
+
+/**
+ * Lays out the fields of @p def in field ID order the same way a C compiler
+ * would lay out the equivalent struct.
+ */
+static auto get_layout(composite& def) -> const composite_layout& {
+	auto& layout = def.layout;
+	auto  enum_storage_epoch = state().enum_storage_epoch;
+	if(layout.valid && layout.enum_storage_epoch == enum_storage_epoch) {
+		return layout;
+	}
+
+	layout.offsets.clear();
+	layout.size = 0;
+	layout.alignment = 1;
+	if(!def.fields.empty()) {
+		auto last_field_id = static_cast<int32_t>(def.fields.rbegin()->first);
+		layout.offsets.resize(last_field_id + 1, 0);
+	}
+
+	for(auto& [field_id, field] : def.fields) {
+		auto alignment = std::max(field_element_size(field.type), 1);
+		auto offset = (layout.size + alignment - 1) / alignment * alignment;
+
+		layout.offsets[static_cast<int32_t>(field_id)] = offset;
+		layout.size = offset + field_type_size(field.type);
+		layout.alignment = std::max(layout.alignment, alignment);
+	}
+
+	layout.size = (layout.size + layout.alignment - 1) / layout.alignment *
+		layout.alignment;
+	layout.enum_storage_epoch = enum_storage_epoch;
+	layout.valid = true;
+	return layout;
 }
 
 int32_t ecsact_meta_field_offset(
 	ecsact_composite_id composite_id,
 	ecsact_field_id     field_id
 ) {
-	auto& def = get_composite(composite_id);
-	auto  largest_field_size = 0;
-	auto  current_field_index = 0;
-	auto  field_index = 0;
-	for(auto& field : def.fields) {
-		auto size = field_type_size(field.second.type);
-		if(size > largest_field_size) {
-			largest_field_size = size;
-		}
+	auto& layout = get_layout(get_composite(composite_id));
+	auto  index = static_cast<int32_t>(field_id);
+	if(index < 0 || index >= static_cast<int32_t>(layout.offsets.size())) {
+		return 0;
+	}
+
+	return layout.offsets[index];
+}
+
+int32_t ecsact_composite_layout_size(ecsact_composite_id composite_id) {
+	return get_layout(get_composite(composite_id)).size;
+}
 
-		if(field.first == field_id) {
-			field_index = current_field_index;
+int32_t ecsact_composite_layout_alignment(ecsact_composite_id composite_id) {
+	return get_layout(get_composite(composite_id)).alignment;
+}
+
+void ecsact_freeze_runtime() {
+	// Layouts and full names are the only things computed on read. Compute them
+	// all now so concurrent readers never write.
+	auto& def_slots = state().def_slots;
+	for(std::size_t id = 0; def_slots.size() > id; ++id) {
+		switch(def_slots[id].kind) {
+			case def_kind::component:
+			case def_kind::transient:
+			case def_kind::action:
+				get_layout(get_composite(static_cast<ecsact_composite_id>(id)));
+				break;
+			default:
+				break;
 		}
 
-		current_field_index += 1;
+		if(def_slots[id].kind != def_kind::none) {
+			full_name(static_cast<ecsact_decl_id>(id));
+		}
 	}
 
-	return static_cast<int32_t>(field_index * largest_field_size);
+	ecsact::interpret::details::set_frozen(true);
 }
 
 void ecsact_set_system_capability(
@@ -718,16 +1332,59 @@ void ecsact_set_system_capability(
 	ecsact_component_like_id comp_like_id,
 	ecsact_system_capability cap
 ) {
+	ensure_mutable(__func__);
 	auto& def = get_system_like(sys_id);
-	def.caps[comp_like_id].cap = cap;
+	auto [itr, inserted] = def.cap_indices.try_emplace(
+		comp_like_id,
+		static_cast<int32_t>(def.caps.size())
+	);
+	if(inserted) {
+		def.caps.emplace_back(comp_like_id, cap);
+	} else {
+		auto& existing_cap = def.caps[itr->second].second;
+		remove_fact(
+			sys_id,
+			fingerprint_fact_kind::capability,
+			key_of(sys_id),
+			key_of(comp_like_id),
+			existing_cap
+		);
+		existing_cap = cap;
+	}
+
+	add_fact(
+		sys_id,
+		fingerprint_fact_kind::capability,
+		key_of(sys_id),
+		key_of(comp_like_id),
+		cap
+	);
 }
 
 void ecsact_unset_system_capability(
 	ecsact_system_like_id    sys_id,
 	ecsact_component_like_id comp_like_id
 ) {
+	ensure_mutable(__func__);
 	auto& def = get_system_like(sys_id);
-	def.caps.erase(comp_like_id);
+	auto  itr = def.cap_indices.find(comp_like_id);
+	if(itr == def.cap_indices.end()) {
+		return;
+	}
+
+	auto index = itr->second;
+	remove_fact(
+		sys_id,
+		fingerprint_fact_kind::capability,
+		key_of(sys_id),
+		key_of(comp_like_id),
+		def.caps[index].second
+	);
+	def.cap_indices.erase(itr);
+	def.caps.erase(def.caps.begin() + index);
+	for(auto i = index; static_cast<int32_t>(def.caps.size()) > i; ++i) {
+		def.cap_indices[def.caps[i].first] = i;
+	}
 }
 
 int32_t ecsact_meta_system_capabilities_count(ecsact_system_like_id system_id) {
@@ -743,16 +1400,13 @@ void ecsact_meta_system_capabilities(
 	int32_t*                  out_capabilities_count
 ) {
 	auto& def = get_system_like(system_id);
-	auto  itr = def.caps.begin();
 	for(int i = 0; max_capabilities_count > i; ++i) {
-		if(i >= def.caps.size() || itr == def.caps.end()) {
+		if(i >= def.caps.size()) {
 			break;
 		}
 
-		out_capability_component_ids[i] = itr->first;
-		out_capabilities[i] = itr->second.cap;
-
-		++itr;
+		out_capability_component_ids[i] = def.caps[i].first;
+		out_capabilities[i] = def.caps[i].second;
 	}
 
 	if(out_capabilities_count != nullptr) {
@@ -764,7 +1418,8 @@ void ecsact_remove_child_system(
 	ecsact_system_like_id parent,
 	ecsact_system_id      child
 ) {
-	auto& child_def = sys_defs.at(child);
+	ensure_mutable(__func__);
+	auto& child_def = get_def<system_def>(child);
 	if(child_def.parent_system_id != parent) {
 		return;
 	}
@@ -778,27 +1433,31 @@ void ecsact_remove_child_system(
 
 	child_def.parent_system_id = (ecsact_system_like_id)-1;
 	if(itr != parent_def.nested_systems.end()) {
-		auto& pkg_def = package_defs.at(owner_package_id(parent));
+		auto& pkg_def = get_def<package_def>(owner_package_id(parent));
 		pkg_def.top_level_systems.push_back(
 			ecsact_id_cast<ecsact_system_like_id>(*itr)
 		);
+		auto index = static_cast<std::size_t>(
+			std::distance(parent_def.nested_systems.begin(), itr)
+		);
+		update_nested_systems_fact(parent, parent_def, false, index);
 		parent_def.nested_systems.erase(itr);
+		update_nested_systems_fact(parent, parent_def, true, index);
 	}
 
-	if(!child_def.name.empty()) {
-		auto& pkg_def = package_defs.at(owner_package_id(child));
-		auto  child_decl_id = ecsact_id_cast<ecsact_decl_id>(child);
-		full_names.at(child_decl_id) = pkg_def.name + "." + child_def.name;
-	}
+	full_name_entry_of(ecsact_id_cast<ecsact_decl_id>(child)).parent =
+		static_cast<ecsact_decl_id>(-1);
+	invalidate_full_names(child);
 }
 
 void ecsact_add_child_system(
 	ecsact_system_like_id parent,
 	ecsact_system_id      child
 ) {
-	auto& child_def = sys_defs.at(child);
+	ensure_mutable(__func__);
+	auto& child_def = get_def<system_def>(child);
 	auto& parent_def = get_system_like(parent);
-	auto& pkg_def = package_defs.at(owner_package_id(parent));
+	auto& pkg_def = get_def<package_def>(owner_package_id(parent));
 
 	if((int32_t)child_def.parent_system_id != -1) {
 		ecsact_remove_child_system(parent, child);
@@ -806,30 +1465,29 @@ void ecsact_add_child_system(
 
 	child_def.parent_system_id = parent;
 	parent_def.nested_systems.push_back(child);
+	update_nested_systems_fact(
+		parent,
+		parent_def,
+		true,
+		parent_def.nested_systems.size() - 1
+	);
 
-	auto iter = std::find(
-		pkg_def.top_level_systems.begin(),
-		pkg_def.top_level_systems.end(),
+	// Children are usually added right after they were created so search from
+	// the most recent top level system
+	auto& top_level_systems = pkg_def.top_level_systems;
+	auto  iter = std::find(
+		top_level_systems.rbegin(),
+		top_level_systems.rend(),
 		ecsact_id_cast<ecsact_system_like_id>(child)
 	);
 
-	if(iter != pkg_def.top_level_systems.end()) {
-		pkg_def.top_level_systems.erase(iter);
+	if(iter != top_level_systems.rend()) {
+		top_level_systems.erase(std::next(iter).base());
 	}
 
-	if(!child_def.name.empty()) {
-		auto child_decl_id = ecsact_id_cast<ecsact_decl_id>(child);
-		auto parent_decl_id = ecsact_id_cast<ecsact_decl_id>(parent);
-
-		auto& child_full_name = full_names.at(child_decl_id);
-		if(!full_names.at(parent_decl_id).empty()) {
-			child_full_name = full_names.at(parent_decl_id);
-		} else {
-			child_full_name = pkg_def.name;
-		}
-
-		child_full_name += "." + child_def.name;
-	}
+	full_name_entry_of(ecsact_id_cast<ecsact_decl_id>(child)).parent =
+		ecsact_id_cast<ecsact_decl_id>(parent);
+	invalidate_full_names(child);
 }
 
 void ecsact_set_package_source_file_path(
@@ -837,20 +1495,21 @@ void ecsact_set_package_source_file_path(
 	const char*       source_file_path,
 	int32_t           source_file_path_len
 ) {
+	ensure_mutable(__func__);
 	assert(source_file_path_len > 0);
-	auto& def = package_defs.at(package_id);
+	auto& def = get_def<package_def>(package_id);
 
 	def.source_file_path = std::string(source_file_path, source_file_path_len);
 }
 
 const char* ecsact_meta_package_file_path(ecsact_package_id package_id) {
-	auto& def = package_defs.at(package_id);
+	auto& def = get_def<package_def>(package_id);
 	return def.source_file_path.c_str();
 }
 
 const char* ecsact_meta_enum_name(ecsact_enum_id enum_id) {
-	auto& def = enum_defs.at(enum_id);
-	return def.name.c_str();
+	auto& def = get_def<enum_def>(enum_id);
+	return def.name.data();
 }
 
 const char* ecsact_meta_registry_name(ecsact_registry_id) {
@@ -859,7 +1518,7 @@ const char* ecsact_meta_registry_name(ecsact_registry_id) {
 }
 
 int32_t ecsact_meta_count_dependencies(ecsact_package_id package_id) {
-	auto& pkg_def = package_defs.at(package_id);
+	auto& pkg_def = get_def<package_def>(package_id);
 	return static_cast<int32_t>(pkg_def.dependencies.size());
 }
 
@@ -869,7 +1528,7 @@ void ecsact_meta_get_dependencies(
 	ecsact_package_id* out_package_ids,
 	int32_t*           out_dependencies_count
 ) {
-	auto& pkg_def = package_defs.at(package_id);
+	auto& pkg_def = get_def<package_def>(package_id);
 	auto  itr = pkg_def.dependencies.begin();
 	for(int i = 0; max_dependency_count > i; ++i, ++itr) {
 		if(itr == pkg_def.dependencies.end()) {
@@ -887,14 +1546,173 @@ void ecsact_add_dependency(
 	ecsact_package_id target,
 	ecsact_package_id dependency
 ) {
-	auto& tgt_pkg_def = package_defs.at(target);
-	if(package_defs.contains(dependency)) {
-		tgt_pkg_def.dependencies.push_back(dependency);
+	ensure_mutable(__func__);
+	auto& tgt_pkg_def = get_def<package_def>(target);
+	auto  dep_pkg_def = find_def<package_def>(dependency);
+	if(!dep_pkg_def) {
+		return;
 	}
+
+	tgt_pkg_def.dependencies.push_back(dependency);
+	add_fact(target, fingerprint_fact_kind::dependency, dep_pkg_def->name);
+	auto [_, inserted] =
+		tgt_pkg_def.visible_packages.try_emplace(dep_pkg_def->name, dependency);
+	if(!inserted) {
+		return;
+	}
+
+	// Erased when the dependency is destroyed so lookups can't resolve to a
+	// destroyed package.
+	tgt_pkg_def.event_refs.emplace_back(on_destroy(dependency, [=] {
+		auto target_pkg_def = find_def<package_def>(target);
+		if(!target_pkg_def) {
+			return;
+		}
+
+		auto& visible = target_pkg_def->visible_packages;
+		for(auto vis_itr = visible.begin(); vis_itr != visible.end(); ++vis_itr) {
+			if(vis_itr->second == dependency) {
+				visible.erase(vis_itr);
+				break;
+			}
+		}
+	}));
+}
+
+template<typename ID>
+static auto lookup_decl(
+	ecsact_package_id scope_package_id,
+	const char*       name,
+	int32_t           name_len,
+	bool              allow_qualified,
+	package_def::name_index_t<ID> package_def::*index
+) -> ID {
+	auto pkg_def_ptr = find_def<package_def>(scope_package_id);
+	if(!pkg_def_ptr) {
+		return static_cast<ID>(-1);
+	}
+
+	auto& pkg_def = *pkg_def_ptr;
+	auto  lookup_name = std::string_view(name, name_len);
+	auto  itr = (pkg_def.*index).find(lookup_name);
+	if(itr != (pkg_def.*index).end()) {
+		return itr->second;
+	}
+
+	if(!allow_qualified) {
+		return static_cast<ID>(-1);
+	}
+
+	auto last_dot_idx = lookup_name.find_last_of('.');
+	if(last_dot_idx == std::string_view::npos) {
+		return static_cast<ID>(-1);
+	}
+
+	auto vis_itr =
+		pkg_def.visible_packages.find(lookup_name.substr(0, last_dot_idx));
+	if(vis_itr == pkg_def.visible_packages.end()) {
+		return static_cast<ID>(-1);
+	}
+
+	auto& vis_pkg_def = get_def<package_def>(vis_itr->second);
+	auto  vis_decl_itr =
+		(vis_pkg_def.*index).find(lookup_name.substr(last_dot_idx + 1));
+	if(vis_decl_itr == (vis_pkg_def.*index).end()) {
+		return static_cast<ID>(-1);
+	}
+
+	return vis_decl_itr->second;
+}
+
+ecsact_component_id ecsact_lookup_component(
+	ecsact_package_id scope_package_id,
+	const char*       component_name,
+	int32_t           component_name_len
+) {
+	return lookup_decl(
+		scope_package_id,
+		component_name,
+		component_name_len,
+		true,
+		&package_def::component_names
+	);
+}
+
+ecsact_transient_id ecsact_lookup_transient(
+	ecsact_package_id scope_package_id,
+	const char*       transient_name,
+	int32_t           transient_name_len
+) {
+	return lookup_decl(
+		scope_package_id,
+		transient_name,
+		transient_name_len,
+		true,
+		&package_def::transient_names
+	);
+}
+
+ecsact_system_id ecsact_lookup_system(
+	ecsact_package_id scope_package_id,
+	const char*       system_name,
+	int32_t           system_name_len
+) {
+	return lookup_decl(
+		scope_package_id,
+		system_name,
+		system_name_len,
+		false,
+		&package_def::system_names
+	);
+}
+
+ecsact_action_id ecsact_lookup_action(
+	ecsact_package_id scope_package_id,
+	const char*       action_name,
+	int32_t           action_name_len
+) {
+	return lookup_decl(
+		scope_package_id,
+		action_name,
+		action_name_len,
+		false,
+		&package_def::action_names
+	);
+}
+
+ecsact_enum_id ecsact_lookup_enum(
+	ecsact_package_id scope_package_id,
+	const char*       enum_name,
+	int32_t           enum_name_len
+) {
+	return lookup_decl(
+		scope_package_id,
+		enum_name,
+		enum_name_len,
+		true,
+		&package_def::enum_names
+	);
+}
+
+ecsact_field_id ecsact_lookup_field(
+	ecsact_composite_id composite_id,
+	const char*         field_name,
+	int32_t             field_name_len
+) {
+	auto& def = get_composite(composite_id);
+	auto  itr = def.field_names.find(std::string_view{
+		field_name,
+		static_cast<std::size_t>(field_name_len),
+	});
+	if(itr == def.field_names.end()) {
+		return static_cast<ecsact_field_id>(-1);
+	}
+
+	return itr->second;
 }
 
 const char* ecsact_meta_decl_full_name(ecsact_decl_id id) {
-	return full_names.at(id).c_str();
+	return full_name(id);
 }
 
 int32_t ecsact_meta_count_child_systems(ecsact_system_like_id system_id) {
@@ -932,7 +1750,7 @@ ecsact_system_like_id ecsact_meta_get_parent_system_id(
 }
 
 int32_t ecsact_meta_count_top_level_systems(ecsact_package_id package_id) {
-	auto& pkg_def = package_defs.at(package_id);
+	auto& pkg_def = get_def<package_def>(package_id);
 	return static_cast<int32_t>(pkg_def.top_level_systems.size());
 }
 
@@ -942,7 +1760,7 @@ void ecsact_meta_get_top_level_systems(
 	ecsact_system_like_id* out_systems,
 	int32_t*               out_systems_count
 ) {
-	auto& pkg_def = package_defs.at(package_id);
+	auto& pkg_def = get_def<package_def>(package_id);
 
 	auto itr = pkg_def.top_level_systems.begin();
 	for(int i = 0; max_systems_count > i; ++i, ++itr) {
@@ -960,18 +1778,61 @@ void ecsact_meta_get_top_level_systems(
 ecsact_system_generates_id ecsact_add_system_generates(
 	ecsact_system_like_id system_id
 ) {
+	ensure_mutable(__func__);
 	auto& sys_like_def = get_system_like(system_id);
 	auto  gen_id = next_id<ecsact_system_generates_id>();
-	sys_like_def.generates[gen_id] = {};
+	auto& gen_def = sys_like_def.generates[gen_id];
+	gen_def.ordinal = sys_like_def.generates_added++;
+	add_fact(
+		system_id,
+		fingerprint_fact_kind::generates,
+		key_of(system_id),
+		gen_def.ordinal
+	);
 	return gen_id;
 }
 
+static auto generates_component_fact(
+	ecsact_system_like_id             system_id,
+	const system_like::generates_def& gen_def,
+	ecsact_component_id               component_id,
+	ecsact_system_generate            generate_flag
+) -> uint64_t {
+	return fingerprint_fact(
+		fingerprint_fact_kind::generates_component,
+		key_of(system_id),
+		gen_def.ordinal,
+		key_of(component_id),
+		generate_flag
+	);
+}
+
 void ecsact_remove_system_generates(
 	ecsact_system_like_id      system_id,
 	ecsact_system_generates_id generates_id
 ) {
+	ensure_mutable(__func__);
 	auto& sys_like_def = get_system_like(system_id);
-	sys_like_def.generates.erase(generates_id);
+	auto  itr = sys_like_def.generates.find(generates_id);
+	if(itr == sys_like_def.generates.end()) {
+		return;
+	}
+
+	auto& gen_def = itr->second;
+	auto  decl_id = ecsact_id_cast<ecsact_decl_id>(system_id);
+	for(auto [comp_id, flag] : gen_def.components) {
+		ecsact::interpret::details::remove_fingerprint_fact(
+			decl_id,
+			generates_component_fact(system_id, gen_def, comp_id, flag)
+		);
+	}
+	remove_fact(
+		system_id,
+		fingerprint_fact_kind::generates,
+		key_of(system_id),
+		gen_def.ordinal
+	);
+	sys_like_def.generates.erase(itr);
 }
 
 void ecsact_system_generates_set_component(
@@ -980,9 +1841,24 @@ void ecsact_system_generates_set_component(
 	ecsact_component_id        component_id,
 	ecsact_system_generate     generate_flag
 ) {
+	ensure_mutable(__func__);
 	auto& sys_like_def = get_system_like(system_id);
-	auto& gen_comps = sys_like_def.generates.at(generates_id);
-	gen_comps[component_id] = generate_flag;
+	auto& gen_def = sys_like_def.generates.at(generates_id);
+	auto  decl_id = ecsact_id_cast<ecsact_decl_id>(system_id);
+	auto [itr, inserted] =
+		gen_def.components.try_emplace(component_id, generate_flag);
+	if(!inserted) {
+		ecsact::interpret::details::remove_fingerprint_fact(
+			decl_id,
+			generates_component_fact(system_id, gen_def, component_id, itr->second)
+		);
+		itr->second = generate_flag;
+	}
+
+	ecsact::interpret::details::add_fingerprint_fact(
+		decl_id,
+		generates_component_fact(system_id, gen_def, component_id, generate_flag)
+	);
 }
 
 void ecsact_system_generates_unset_component(
@@ -990,9 +1866,19 @@ void ecsact_system_generates_unset_component(
 	ecsact_system_generates_id generates_id,
 	ecsact_component_id        component_id
 ) {
+	ensure_mutable(__func__);
 	auto& sys_like_def = get_system_like(system_id);
-	auto& gen_comps = sys_like_def.generates.at(generates_id);
-	gen_comps.erase(component_id);
+	auto& gen_def = sys_like_def.generates.at(generates_id);
+	auto  itr = gen_def.components.find(component_id);
+	if(itr == gen_def.components.end()) {
+		return;
+	}
+
+	ecsact::interpret::details::remove_fingerprint_fact(
+		ecsact_id_cast<ecsact_decl_id>(system_id),
+		generates_component_fact(system_id, gen_def, component_id, itr->second)
+	);
+	gen_def.components.erase(itr);
 }
 
 int32_t ecsact_meta_count_system_generates_ids(ecsact_system_like_id system_id
@@ -1029,7 +1915,7 @@ int32_t ecsact_meta_count_system_generates_components(
 	ecsact_system_generates_id generates_id
 ) {
 	auto& sys_like_def = get_system_like(system_id);
-	auto& gen_def = sys_like_def.generates.at(generates_id);
+	auto& gen_def = sys_like_def.generates.at(generates_id).components;
 	return static_cast<int32_t>(gen_def.size());
 }
 
@@ -1042,7 +1928,7 @@ void ecsact_meta_system_generates_components(
 	int32_t*                   out_components_count
 ) {
 	auto& sys_like_def = get_system_like(system_id);
-	auto& gen_def = sys_like_def.generates.at(generates_id);
+	auto& gen_def = sys_like_def.generates.at(generates_id).components;
 
 	auto itr = gen_def.begin();
 	for(int i = 0; max_components_count > i; ++i, ++itr) {
@@ -1063,14 +1949,32 @@ void ecsact_set_system_lazy_iteration_rate( //
 	ecsact_system_id system_id,
 	int32_t          iteration_rate
 ) {
-	auto& def = sys_defs.at(system_id);
+	ensure_mutable(__func__);
+	auto& def = get_def<system_def>(system_id);
+	if(def.lazy_iteration_rate != 0) {
+		remove_fact(
+			system_id,
+			fingerprint_fact_kind::lazy_iteration_rate,
+			key_of(system_id),
+			def.lazy_iteration_rate
+		);
+	}
+
 	def.lazy_iteration_rate = iteration_rate;
+	if(iteration_rate != 0) {
+		add_fact(
+			system_id,
+			fingerprint_fact_kind::lazy_iteration_rate,
+			key_of(system_id),
+			iteration_rate
+		);
+	}
 }
 
 int32_t ecsact_meta_get_lazy_iteration_rate( //
 	ecsact_system_id system_id
 ) {
-	auto& def = sys_defs.at(system_id);
+	auto& def = get_def<system_def>(system_id);
 	return def.lazy_iteration_rate;
 }
 
@@ -1078,8 +1982,26 @@ void ecsact_set_system_parallel_execution( //
 	ecsact_system_like_id     system_like_id,
 	ecsact_parallel_execution parallel_execution
 ) {
+	ensure_mutable(__func__);
 	auto& def = get_system_like(system_like_id);
+	if(def.parallel_execution != ecsact_parallel_execution{}) {
+		remove_fact(
+			system_like_id,
+			fingerprint_fact_kind::parallel_execution,
+			key_of(system_like_id),
+			def.parallel_execution
+		);
+	}
+
 	def.parallel_execution = parallel_execution;
+	if(parallel_execution != ecsact_parallel_execution{}) {
+		add_fact(
+			system_like_id,
+			fingerprint_fact_kind::parallel_execution,
+			key_of(system_like_id),
+			parallel_execution
+		);
+	}
 }
 
 ecsact_parallel_execution ecsact_meta_get_system_parallel_execution( //
@@ -1127,42 +2049,614 @@ auto ecsact_set_system_notify_component_setting(
 	ecsact_component_like_id     component_like_id,
 	ecsact_system_notify_setting setting
 ) -> void {
+	ensure_mutable(__func__);
 	auto& def = get_system_like(system_like_id);
+	auto  itr = def.notify_settings.find(component_like_id);
+	if(itr != def.notify_settings.end()) {
+		remove_fact(
+			system_like_id,
+			fingerprint_fact_kind::notify_setting,
+			key_of(system_like_id),
+			key_of(component_like_id),
+			itr->second
+		);
+	}
+
 	if(setting == ECSACT_SYS_NOTIFY_NONE) {
-		def.notify_settings.erase(component_like_id);
-	} else {
-		def.notify_settings[component_like_id] = setting;
+		if(itr != def.notify_settings.end()) {
+			def.notify_settings.erase(itr);
+		}
+		return;
 	}
+
+	def.notify_settings[component_like_id] = setting;
+	add_fact(
+		system_like_id,
+		fingerprint_fact_kind::notify_setting,
+		key_of(system_like_id),
+		key_of(component_like_id),
+		setting
+	);
 }
 
 auto ecsact_meta_component_type( //
 	ecsact_component_like_id comp_like_id
 ) -> ecsact_component_type {
 	auto comp_def =
-		comp_defs.find(static_cast<ecsact_component_id>(comp_like_id));
-	if(comp_def == comp_defs.end()) {
+		find_def<::comp_def>(static_cast<ecsact_component_id>(comp_like_id));
+	if(!comp_def) {
 		// NOTE: this is temporary until we remove the transient fns and instead
 		// embrace components with transient statement params
 		auto trans_def =
-			trans_defs.find(static_cast<ecsact_transient_id>(comp_like_id));
-		if(trans_def != trans_defs.end()) {
+			find_def<::trans_def>(static_cast<ecsact_transient_id>(comp_like_id));
+		if(trans_def) {
 			return ECSACT_COMPONENT_TYPE_TRANSIENT;
 		}
 
 		return ECSACT_COMPONENT_TYPE_NONE;
 	}
 
-	return comp_def->second.comp_type;
+	return comp_def->comp_type;
 }
 
 auto ecsact_set_component_type( //
 	ecsact_component_id   component_id,
 	ecsact_component_type comp_type
 ) -> void {
-	auto comp_def = comp_defs.find(component_id);
-	if(comp_def == comp_defs.end()) {
+	ensure_mutable(__func__);
+	auto comp_def = find_def<::comp_def>(component_id);
+	if(!comp_def) {
 		return;
 	}
 
-	comp_def->second.comp_type = comp_type;
+	if(comp_def->comp_type != ECSACT_COMPONENT_TYPE_NONE) {
+		remove_fact(
+			component_id,
+			fingerprint_fact_kind::component_type,
+			key_of(component_id),
+			comp_def->comp_type
+		);
+	}
+
+	comp_def->comp_type = comp_type;
+	if(comp_type != ECSACT_COMPONENT_TYPE_NONE) {
+		add_fact(
+			component_id,
+			fingerprint_fact_kind::component_type,
+			key_of(component_id),
+			comp_type
+		);
+	}
+}
+
+auto ecsact::interpret::views::package_ids()
+	-> std::span<const ecsact_package_id> {
+	return state().package_ids;
+}
+
+auto ecsact::interpret::views::package_name(ecsact_package_id package_id)
+	-> std::string_view {
+	if(auto def = find_def<package_def>(package_id)) {
+		return def->name;
+	}
+
+	return {};
+}
+
+auto ecsact::interpret::views::dependencies(ecsact_package_id package_id)
+	-> std::span<const ecsact_package_id> {
+	return get_def<package_def>(package_id).dependencies;
+}
+
+auto ecsact::interpret::views::component_ids(ecsact_package_id package_id)
+	-> std::span<const ecsact_component_id> {
+	return get_def<package_def>(package_id).components;
+}
+
+auto ecsact::interpret::views::transient_ids(ecsact_package_id package_id)
+	-> std::span<const ecsact_transient_id> {
+	return get_def<package_def>(package_id).transients;
+}
+
+auto ecsact::interpret::views::action_ids(ecsact_package_id package_id)
+	-> std::span<const ecsact_action_id> {
+	return get_def<package_def>(package_id).actions;
+}
+
+auto ecsact::interpret::views::enum_ids(ecsact_package_id package_id)
+	-> std::span<const ecsact_enum_id> {
+	return get_def<package_def>(package_id).enums;
+}
+
+auto ecsact::interpret::views::system_ids(ecsact_package_id package_id)
+	-> std::span<const ecsact_system_id> {
+	return get_def<package_def>(package_id).systems;
+}
+
+auto ecsact::interpret::views::top_level_systems(ecsact_package_id package_id)
+	-> std::span<const ecsact_system_like_id> {
+	return get_def<package_def>(package_id).top_level_systems;
+}
+
+auto ecsact::interpret::views::child_system_ids(ecsact_system_like_id system_id)
+	-> std::span<const ecsact_system_id> {
+	return get_system_like(system_id).nested_systems;
+}
+
+auto ecsact::interpret::views::system_capabilities(
+	ecsact_system_like_id system_id
+)
+	-> std::span<
+		const std::pair<ecsact_component_like_id, ecsact_system_capability>> {
+	return get_system_like(system_id).caps;
+}
+
+auto ecsact::interpret::views::system_capability(
+	ecsact_system_like_id    system_id,
+	ecsact_component_like_id component_id
+) -> std::optional<ecsact_system_capability> {
+	auto& def = get_system_like(system_id);
+	auto  itr = def.cap_indices.find(component_id);
+	if(itr == def.cap_indices.end()) {
+		return std::nullopt;
+	}
+
+	return def.caps[itr->second].second;
+}
+
+/**
+ * Writes @p value to @p row of @p column unless the column was skipped
+ */
+template<typename T, typename V>
+static auto set_column(T* column, int32_t row, V value) -> void {
+	if(column != nullptr) {
+		column[row] = static_cast<T>(value);
+	}
+}
+
+/**
+ * Calls @p fn with every composite of @p package in export order. See
+ * parse-resolver-runtime/export.h
+ */
+template<typename Fn>
+static auto for_each_export_composite(const package_def& package, Fn&& fn)
+	-> void {
+	for(auto id : package.components) {
+		fn(ecsact_id_cast<ecsact_composite_id>(id), get_def<comp_def>(id));
+	}
+	for(auto id : package.transients) {
+		fn(ecsact_id_cast<ecsact_composite_id>(id), get_def<trans_def>(id));
+	}
+	for(auto id : package.actions) {
+		fn(ecsact_id_cast<ecsact_composite_id>(id), get_def<action_def>(id));
+	}
+}
+
+/**
+ * Calls @p fn with every system-like of @p package in export order. See
+ * parse-resolver-runtime/export.h
+ */
+template<typename Fn>
+static auto for_each_export_system_like(const package_def& package, Fn&& fn)
+	-> void {
+	for(auto id : package.systems) {
+		fn(ecsact_id_cast<ecsact_system_like_id>(id), get_def<system_def>(id));
+	}
+	for(auto id : package.actions) {
+		fn(ecsact_id_cast<ecsact_system_like_id>(id), get_def<action_def>(id));
+	}
+}
+
+static auto generates_component_count(const system_like& def) -> int32_t {
+	auto count = std::size_t{};
+	for(auto& [_, gen_def] : def.generates) {
+		count += gen_def.components.size();
+	}
+	return static_cast<int32_t>(count);
+}
+
+void ecsact_export_package_composites(
+	ecsact_package_id     package_id,
+	int32_t               max_composite_count,
+	ecsact_composite_rows out_rows,
+	int32_t*              out_composite_count
+) {
+	auto& package = get_def<package_def>(package_id);
+	auto  with_layout =
+		out_rows.sizes != nullptr || out_rows.alignments != nullptr;
+
+	auto row = int32_t{};
+	auto field_row = int32_t{};
+	for_each_export_composite(package, [&](auto id, composite& def) {
+		auto field_count = static_cast<int32_t>(def.fields.size());
+		if(max_composite_count > row) {
+			set_column(out_rows.composite_ids, row, id);
+			set_column(out_rows.first_field_rows, row, field_row);
+			set_column(out_rows.field_counts, row, field_count);
+			if(with_layout) {
+				auto& layout = get_layout(def);
+				set_column(out_rows.sizes, row, layout.size);
+				set_column(out_rows.alignments, row, layout.alignment);
+			}
+		}
+
+		row += 1;
+		field_row += field_count;
+	});
+
+	if(out_composite_count != nullptr) {
+		*out_composite_count = row;
+	}
+}
+
+void ecsact_export_package_fields(
+	ecsact_package_id package_id,
+	int32_t           max_field_count,
+	ecsact_field_rows out_rows,
+	int32_t*          out_field_count
+) {
+	auto& package = get_def<package_def>(package_id);
+
+	auto row = int32_t{};
+	for_each_export_composite(package, [&](auto id, composite& def) {
+		const composite_layout* layout = nullptr;
+		if(out_rows.offsets != nullptr && max_field_count > row) {
+			layout = &get_layout(def);
+		}
+
+		for(auto& [field_id, field] : def.fields) {
+			if(max_field_count > row) {
+				set_column(out_rows.composite_ids, row, id);
+				set_column(out_rows.field_ids, row, field_id);
+				set_column(out_rows.names, row, field.name.data());
+				set_column(out_rows.types, row, field.type);
+				if(layout) {
+					set_column(
+						out_rows.offsets,
+						row,
+						layout->offsets[static_cast<int32_t>(field_id)]
+					);
+				}
+			}
+
+			row += 1;
+		}
+	});
+
+	if(out_field_count != nullptr) {
+		*out_field_count = row;
+	}
+}
+
+void ecsact_export_package_system_likes(
+	ecsact_package_id       package_id,
+	int32_t                 max_system_count,
+	ecsact_system_like_rows out_rows,
+	int32_t*                out_system_count
+) {
+	auto& package = get_def<package_def>(package_id);
+	auto  with_assocs = out_rows.first_assoc_rows != nullptr ||
+		out_rows.assoc_counts != nullptr;
+
+	auto row = int32_t{};
+	auto capability_row = int32_t{};
+	auto generates_row = int32_t{};
+	auto assoc_row = int32_t{};
+	for_each_export_system_like(package, [&](auto id, system_like& def) {
+		auto capability_count = static_cast<int32_t>(def.caps.size());
+		auto generates_count = generates_component_count(def);
+		auto assoc_count = int32_t{};
+		if(with_assocs) {
+			assoc_count = static_cast<int32_t>(
+				ecsact::interpret::views::system_assoc_ids(id).size()
+			);
+		}
+
+		if(max_system_count > row) {
+			set_column(out_rows.system_ids, row, id);
+			set_column(out_rows.first_capability_rows, row, capability_row);
+			set_column(out_rows.capability_counts, row, capability_count);
+			set_column(out_rows.first_generates_rows, row, generates_row);
+			set_column(out_rows.generates_counts, row, generates_count);
+			set_column(out_rows.first_assoc_rows, row, assoc_row);
+			set_column(out_rows.assoc_counts, row, assoc_count);
+		}
+
+		row += 1;
+		capability_row += capability_count;
+		generates_row += generates_count;
+		assoc_row += assoc_count;
+	});
+
+	if(out_system_count != nullptr) {
+		*out_system_count = row;
+	}
+}
+
+void ecsact_export_package_capabilities(
+	ecsact_package_id      package_id,
+	int32_t                max_capability_count,
+	ecsact_capability_rows out_rows,
+	int32_t*               out_capability_count
+) {
+	auto& package = get_def<package_def>(package_id);
+
+	auto row = int32_t{};
+	for_each_export_system_like(package, [&](auto id, system_like& def) {
+		for(auto& [comp_id, cap] : def.caps) {
+			if(max_capability_count > row) {
+				set_column(out_rows.system_ids, row, id);
+				set_column(out_rows.component_ids, row, comp_id);
+				set_column(out_rows.capabilities, row, cap);
+			}
+
+			row += 1;
+		}
+	});
+
+	if(out_capability_count != nullptr) {
+		*out_capability_count = row;
+	}
+}
+
+void ecsact_export_package_generates(
+	ecsact_package_id     package_id,
+	int32_t               max_generates_count,
+	ecsact_generates_rows out_rows,
+	int32_t*              out_generates_count
+) {
+	auto& package = get_def<package_def>(package_id);
+
+	auto row = int32_t{};
+	for_each_export_system_like(package, [&](auto id, system_like& def) {
+		for(auto& [generates_id, gen_def] : def.generates) {
+			for(auto& [comp_id, flag] : gen_def.components) {
+				if(max_generates_count > row) {
+					set_column(out_rows.system_ids, row, id);
+					set_column(out_rows.generates_ids, row, generates_id);
+					set_column(out_rows.component_ids, row, comp_id);
+					set_column(out_rows.generate_flags, row, flag);
+				}
+
+				row += 1;
+			}
+		}
+	});
+
+	if(out_generates_count != nullptr) {
+		*out_generates_count = row;
+	}
+}
+
+/**
+ * Counts @p name and its null terminator towards @p names
+ */
+static auto add_name_memory(
+	ecsact_runtime_memory_entry& names,
+	std::string_view             name
+) -> void {
+	names.count += 1;
+	names.bytes += static_cast<int64_t>(name.size() + 1);
+}
+
+static auto add_composite_memory(
+	const composite&             def,
+	ecsact_runtime_memory_usage& usage,
+	ecsact_runtime_memory_entry* names
+) -> int64_t {
+	add_memory(
+		usage,
+		ECSACT_MEMORY_TABLE_FIELDS,
+		def.fields.size(),
+		heap_bytes(def.fields)
+	);
+	add_memory(
+		usage,
+		ECSACT_MEMORY_TABLE_NAME_INDEXES,
+		def.field_names.size(),
+		heap_bytes(def.field_names)
+	);
+
+	if(names) {
+		for(auto& [_, field] : def.fields) {
+			add_name_memory(*names, field.name);
+		}
+	}
+
+	return heap_bytes(def.layout.offsets);
+}
+
+static auto add_system_like_memory(
+	const system_like&           def,
+	ecsact_runtime_memory_usage& usage
+) -> int64_t {
+	add_memory(
+		usage,
+		ECSACT_MEMORY_TABLE_CAPABILITIES,
+		def.caps.size(),
+		heap_bytes(def.caps) + heap_bytes(def.cap_indices)
+	);
+
+	auto generates_count = std::size_t{};
+	auto generates_bytes = heap_bytes(def.generates);
+	for(auto& [_, gen_def] : def.generates) {
+		generates_count += gen_def.components.size();
+		generates_bytes += heap_bytes(gen_def.components);
+	}
+	add_memory(
+		usage,
+		ECSACT_MEMORY_TABLE_GENERATES,
+		generates_count,
+		generates_bytes
+	);
+
+	add_memory(
+		usage,
+		ECSACT_MEMORY_TABLE_NOTIFY_SETTINGS,
+		def.notify_settings.size(),
+		heap_bytes(def.notify_settings)
+	);
+
+	return heap_bytes(def.nested_systems);
+}
+
+/**
+ * Adds everything owned by @p def to @p usage except the storage of the
+ * definitions themselves. Names are only added if @p names is set.
+ */
+static auto add_package_memory(
+	const package_def&           def,
+	ecsact_runtime_memory_usage& usage,
+	ecsact_runtime_memory_entry* names
+) -> void {
+	add_memory(
+		usage,
+		ECSACT_MEMORY_TABLE_PACKAGES,
+		0,
+		heap_bytes(def.source_file_path) + heap_bytes(def.dependencies) +
+			heap_bytes(def.systems) + heap_bytes(def.actions) +
+			heap_bytes(def.components) + heap_bytes(def.transients) +
+			heap_bytes(def.enums) + heap_bytes(def.top_level_systems) +
+			heap_bytes(def.event_refs)
+	);
+
+	add_memory(
+		usage,
+		ECSACT_MEMORY_TABLE_NAME_INDEXES,
+		def.component_names.size() + def.transient_names.size() +
+			def.system_names.size() + def.action_names.size() +
+			def.enum_names.size() + def.visible_packages.size(),
+		heap_bytes(def.component_names) + heap_bytes(def.transient_names) +
+			heap_bytes(def.system_names) + heap_bytes(def.action_names) +
+			heap_bytes(def.enum_names) + heap_bytes(def.visible_packages)
+	);
+
+	auto add_name = [&](std::string_view name) {
+		if(names) {
+			add_name_memory(*names, name);
+		}
+	};
+	add_name(def.name);
+
+	for(auto id : def.components) {
+		auto& comp = get_def<comp_def>(id);
+		add_name(comp.name);
+		auto bytes = add_composite_memory(comp, usage, names);
+		add_memory(usage, ECSACT_MEMORY_TABLE_COMPONENTS, 0, bytes);
+	}
+
+	for(auto id : def.transients) {
+		auto& trans = get_def<trans_def>(id);
+		add_name(trans.name);
+		auto bytes = add_composite_memory(trans, usage, names);
+		add_memory(usage, ECSACT_MEMORY_TABLE_TRANSIENTS, 0, bytes);
+	}
+
+	for(auto id : def.systems) {
+		auto& sys = get_def<system_def>(id);
+		add_name(sys.name);
+		auto bytes = add_system_like_memory(sys, usage);
+		add_memory(usage, ECSACT_MEMORY_TABLE_SYSTEMS, 0, bytes);
+	}
+
+	for(auto id : def.actions) {
+		auto& act = get_def<action_def>(id);
+		add_name(act.name);
+		auto bytes = add_composite_memory(act, usage, names) +
+			add_system_like_memory(act, usage);
+		add_memory(usage, ECSACT_MEMORY_TABLE_ACTIONS, 0, bytes);
+	}
+
+	for(auto id : def.enums) {
+		auto& enum_ = get_def<enum_def>(id);
+		add_name(enum_.name);
+		add_memory(
+			usage,
+			ECSACT_MEMORY_TABLE_ENUM_VALUES,
+			enum_.enum_values.size(),
+			heap_bytes(enum_.enum_values)
+		);
+		if(names) {
+			for(auto& [_, value] : enum_.enum_values) {
+				add_name_memory(*names, value.name);
+			}
+		}
+	}
+}
+
+auto ecsact::interpret::details::add_resolver_memory_usage(
+	ecsact_runtime_memory_usage& usage
+) -> void {
+	auto& defs = state();
+
+	add_memory(
+		usage,
+		ECSACT_MEMORY_TABLE_NAMES,
+		defs.names.string_count(),
+		defs.names.storage_bytes()
+	);
+	add_memory(
+		usage,
+		ECSACT_MEMORY_TABLE_ID_SLOTS,
+		defs.def_slots.size(),
+		heap_bytes(defs.def_slots) + heap_bytes(defs.full_names)
+	);
+
+	auto add_pool = [&](ecsact_runtime_memory_table table, auto& pool) {
+		add_memory(usage, table, pool.size(), pool.storage_bytes());
+	};
+	add_pool(ECSACT_MEMORY_TABLE_PACKAGES, defs.package_defs);
+	add_pool(ECSACT_MEMORY_TABLE_COMPONENTS, defs.comp_defs);
+	add_pool(ECSACT_MEMORY_TABLE_TRANSIENTS, defs.trans_defs);
+	add_pool(ECSACT_MEMORY_TABLE_SYSTEMS, defs.sys_defs);
+	add_pool(ECSACT_MEMORY_TABLE_ACTIONS, defs.act_defs);
+	add_pool(ECSACT_MEMORY_TABLE_ENUMS, defs.enum_defs);
+	add_memory(
+		usage,
+		ECSACT_MEMORY_TABLE_PACKAGES,
+		0,
+		heap_bytes(defs.package_ids)
+	);
+
+	for(auto package_id : defs.package_ids) {
+		add_package_memory(get_def<package_def>(package_id), usage, nullptr);
+	}
+}
+
+auto ecsact::interpret::details::add_resolver_memory_usage(
+	ecsact_package_id            package_id,
+	ecsact_runtime_memory_usage& usage
+) -> void {
+	auto& def = get_def<package_def>(package_id);
+
+	auto add_defs = [&](auto table, std::size_t count, std::size_t size) {
+		add_memory(usage, table, count, static_cast<int64_t>(count * size));
+	};
+	add_defs(ECSACT_MEMORY_TABLE_PACKAGES, 1, sizeof(package_def));
+	add_defs(
+		ECSACT_MEMORY_TABLE_COMPONENTS,
+		def.components.size(),
+		sizeof(comp_def)
+	);
+	add_defs(
+		ECSACT_MEMORY_TABLE_TRANSIENTS,
+		def.transients.size(),
+		sizeof(trans_def)
+	);
+	add_defs(ECSACT_MEMORY_TABLE_SYSTEMS, def.systems.size(), sizeof(system_def));
+	add_defs(ECSACT_MEMORY_TABLE_ACTIONS, def.actions.size(), sizeof(action_def));
+	add_defs(ECSACT_MEMORY_TABLE_ENUMS, def.enums.size(), sizeof(enum_def));
+
+	auto id_count = 1 + def.components.size() + def.transients.size() +
+		def.systems.size() + def.actions.size() + def.enums.size();
+	add_memory(
+		usage,
+		ECSACT_MEMORY_TABLE_ID_SLOTS,
+		id_count,
+		static_cast<int64_t>(
+			id_count * (sizeof(def_slot) + sizeof(full_name_entry))
+		)
+	);
+
+	add_package_memory(def, usage, &usage.tables[ECSACT_MEMORY_TABLE_NAMES]);
 }
@@ -0,0 +1,855 @@
+#include "parse-resolver-runtime/snapshot.h"
+
+#include <array>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <algorithm>
+#include <initializer_list>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include "ecsact/runtime/meta.h"
+#include "ecsact/runtime/dynamic.h"
+#include "parse-resolver-runtime/context.hh"
+#include "parse-resolver-runtime/freeze.hh"
+
+using ecsact::interpret::details::current_context;
+using ecsact::interpret::details::ensure_mutable;
+
+namespace {
+
+constexpr auto snapshot_magic =
+	std::array<char, 8>{'E', 'C', 'S', 'A', 'C', 'T', 'R', 'S'};
+constexpr auto snapshot_version = uint32_t{1};
+
+/**
+ * Each record is replayed with the dynamic function of the same name. Records
+ * that create something store the ID it had as their first argument.
+ */
+enum class snapshot_op : int32_t {
+	create_package,
+	create_component,
+	create_transient,
+	create_system,
+	create_action,
+	create_enum,
+	add_system_generates,
+	add_system_assoc,
+	set_package_source_file_path,
+	add_dependency,
+	set_component_type,
+	add_enum_value,
+	add_field,
+	set_system_capability,
+	add_child_system,
+	set_system_lazy_iteration_rate,
+	set_system_parallel_execution,
+	set_system_notify_component_setting,
+	system_generates_set_component,
+	add_system_assoc_field,
+	set_system_assoc_capability,
+	count,
+};
+
+struct snapshot_header {
+	std::array<char, 8> magic;
+	uint32_t            version;
+	uint32_t            record_count;
+	uint64_t            source_hash;
+	int32_t             last_id;
+	uint32_t            strings_size;
+};
+
+/**
+ * Strings are stored as an offset and length into the string table that
+ * follows the records.
+ */
+struct snapshot_record {
+	snapshot_op op;
+	int32_t     args[7];
+};
+
+static_assert(sizeof(snapshot_header) == 32);
+static_assert(sizeof(snapshot_record) == 32);
+
+template<typename T>
+auto collect(int32_t count, auto&& get_fn) -> std::vector<T> {
+	auto out = std::vector<T>(static_cast<std::size_t>(count));
+	get_fn(count, out.data(), &count);
+	out.resize(static_cast<std::size_t>(count));
+	return out;
+}
+
+template<typename ID>
+auto arg(ID id) -> int32_t {
+	return static_cast<int32_t>(id);
+}
+
+class snapshot_writer {
+	/**
+	 * Records that create IDs. Replayed first in ID order so every ID can be
+	 * recreated the same way it was originally generated.
+	 */
+	std::vector<snapshot_record> id_records;
+	std::vector<snapshot_record> records;
+	std::string                  strings;
+
+	static auto make_record( //
+		snapshot_op                    op,
+		std::initializer_list<int32_t> args
+	) -> snapshot_record {
+		auto record = snapshot_record{.op = op, .args = {}};
+		std::copy(args.begin(), args.end(), record.args);
+		return record;
+	}
+
+	auto add_id(snapshot_op op, std::initializer_list<int32_t> args) -> void {
+		id_records.push_back(make_record(op, args));
+	}
+
+	auto add(snapshot_op op, std::initializer_list<int32_t> args) -> void {
+		records.push_back(make_record(op, args));
+	}
+
+	auto str(const char* s) -> std::array<int32_t, 2> {
+		auto view = std::string_view{s != nullptr ? s : ""};
+		auto offset = static_cast<int32_t>(strings.size());
+		strings += view;
+		return {offset, static_cast<int32_t>(view.size())};
+	}
+
+	auto write_fields(ecsact_composite_id comp_id) -> void {
+		auto field_ids = collect<ecsact_field_id>(
+			ecsact_meta_count_fields(comp_id),
+			[&](auto... args) { ecsact_meta_get_field_ids(comp_id, args...); }
+		);
+
+		for(auto field_id : field_ids) {
+			auto type = ecsact_meta_field_type(comp_id, field_id);
+			auto name = str(ecsact_meta_field_name(comp_id, field_id));
+			auto type_a = int32_t{};
+			auto type_b = int32_t{};
+			switch(type.kind) {
+				case ECSACT_TYPE_KIND_BUILTIN:
+					type_a = arg(type.type.builtin);
+					break;
+				case ECSACT_TYPE_KIND_ENUM:
+					type_a = arg(type.type.enum_id);
+					break;
+				case ECSACT_TYPE_KIND_FIELD_INDEX:
+					type_a = arg(type.type.field_index.composite_id);
+					type_b = arg(type.type.field_index.field_id);
+					break;
+			}
+
+			add(
+				snapshot_op::add_field,
+				{
+					arg(comp_id),
+					arg(type.kind),
+					type_a,
+					type_b,
+					type.length,
+					name[0],
+					name[1],
+				}
+			);
+		}
+	}
+
+	auto write_system_like(ecsact_system_like_id sys_id) -> void {
+		auto caps_count = ecsact_meta_system_capabilities_count(sys_id);
+		auto cap_comps = std::vector<ecsact_component_like_id>(caps_count);
+		auto caps = std::vector<ecsact_system_capability>(caps_count);
+		ecsact_meta_system_capabilities(
+			sys_id,
+			caps_count,
+			cap_comps.data(),
+			caps.data(),
+			&caps_count
+		);
+		for(auto i = 0; caps_count > i; ++i) {
+			add(
+				snapshot_op::set_system_capability,
+				{arg(sys_id), arg(cap_comps[i]), arg(caps[i])}
+			);
+		}
+
+		auto notify_count = ecsact_meta_system_notify_settings_count(sys_id);
+		auto notify_comps = std::vector<ecsact_component_like_id>(notify_count);
+		auto notify_settings =
+			std::vector<ecsact_system_notify_setting>(notify_count);
+		ecsact_meta_system_notify_settings(
+			sys_id,
+			notify_count,
+			notify_comps.data(),
+			notify_settings.data(),
+			&notify_count
+		);
+		for(auto i = 0; notify_count > i; ++i) {
+			add(
+				snapshot_op::set_system_notify_component_setting,
+				{arg(sys_id), arg(notify_comps[i]), arg(notify_settings[i])}
+			);
+		}
+
+		auto parallel = ecsact_meta_get_system_parallel_execution(sys_id);
+		if(parallel != ECSACT_PAR_EXEC_AUTO) {
+			add(
+				snapshot_op::set_system_parallel_execution,
+				{arg(sys_id), arg(parallel)}
+			);
+		}
+
+		auto gen_ids = collect<ecsact_system_generates_id>(
+			ecsact_meta_count_system_generates_ids(sys_id),
+			[&](auto... args) { ecsact_meta_system_generates_ids(sys_id, args...); }
+		);
+		for(auto gen_id : gen_ids) {
+			add_id(snapshot_op::add_system_generates, {arg(gen_id), arg(sys_id)});
+
+			auto gen_count =
+				ecsact_meta_count_system_generates_components(sys_id, gen_id);
+			auto gen_comps = std::vector<ecsact_component_id>(gen_count);
+			auto gen_flags = std::vector<ecsact_system_generate>(gen_count);
+			ecsact_meta_system_generates_components(
+				sys_id,
+				gen_id,
+				gen_count,
+				gen_comps.data(),
+				gen_flags.data(),
+				&gen_count
+			);
+			for(auto i = 0; gen_count > i; ++i) {
+				add(
+					snapshot_op::system_generates_set_component,
+					{arg(sys_id), arg(gen_id), arg(gen_comps[i]), arg(gen_flags[i])}
+				);
+			}
+		}
+
+		auto assoc_ids = collect<ecsact_system_assoc_id>(
+			ecsact_meta_system_assoc_count(sys_id),
+			[&](auto... args) { ecsact_meta_system_assoc_ids(sys_id, args...); }
+		);
+		for(auto assoc_id : assoc_ids) {
+			add_id(
+				snapshot_op::add_system_assoc,
+				{
+					arg(assoc_id),
+					arg(sys_id),
+					arg(ecsact_meta_system_assoc_component_id(sys_id, assoc_id)),
+				}
+			);
+
+			auto field_ids = collect<ecsact_field_id>(
+				ecsact_meta_system_assoc_fields_count(sys_id, assoc_id),
+				[&](auto... args) {
+					ecsact_meta_system_assoc_fields(sys_id, assoc_id, args...);
+				}
+			);
+			for(auto field_id : field_ids) {
+				add(
+					snapshot_op::add_system_assoc_field,
+					{arg(sys_id), arg(assoc_id), arg(field_id)}
+				);
+			}
+
+			auto assoc_caps_count =
+				ecsact_meta_system_assoc_capabilities_count(sys_id, assoc_id);
+			auto assoc_cap_comps =
+				std::vector<ecsact_component_like_id>(assoc_caps_count);
+			auto assoc_caps = std::vector<ecsact_system_capability>(assoc_caps_count);
+			ecsact_meta_system_assoc_capabilities(
+				sys_id,
+				assoc_id,
+				assoc_caps_count,
+				assoc_cap_comps.data(),
+				assoc_caps.data(),
+				&assoc_caps_count
+			);
+			for(auto i = 0; assoc_caps_count > i; ++i) {
+				add(
+					snapshot_op::set_system_assoc_capability,
+					{
+						arg(sys_id),
+						arg(assoc_id),
+						arg(assoc_cap_comps[i]),
+						arg(assoc_caps[i]),
+					}
+				);
+			}
+		}
+	}
+
+	/**
+	 * Children are added parent first so full names are built from the
+	 * parent's final full name.
+	 */
+	auto write_child_systems(ecsact_system_like_id parent_id) -> void {
+		auto child_ids = collect<ecsact_system_id>(
+			ecsact_meta_count_child_systems(parent_id),
+			[&](auto... args) {
+				ecsact_meta_get_child_system_ids(parent_id, args...);
+			}
+		);
+
+		for(auto child_id : child_ids) {
+			add(snapshot_op::add_child_system, {arg(parent_id), arg(child_id)});
+			write_child_systems(ecsact_id_cast<ecsact_system_like_id>(child_id));
+		}
+	}
+
+	auto write_package(ecsact_package_id pkg_id, bool main) -> void {
+		auto name = str(ecsact_meta_package_name(pkg_id));
+		add_id(
+			snapshot_op::create_package,
+			{arg(pkg_id), main ? 1 : 0, name[0], name[1]}
+		);
+
+		auto file_path = ecsact_meta_package_file_path(pkg_id);
+		if(file_path != nullptr && file_path[0] != '\0') {
+			auto path = str(file_path);
+			add(
+				snapshot_op::set_package_source_file_path,
+				{arg(pkg_id), path[0], path[1]}
+			);
+		}
+
+		auto dep_ids = collect<ecsact_package_id>(
+			ecsact_meta_count_dependencies(pkg_id),
+			[&](auto... args) { ecsact_meta_get_dependencies(pkg_id, args...); }
+		);
+		for(auto dep_id : dep_ids) {
+			add(snapshot_op::add_dependency, {arg(pkg_id), arg(dep_id)});
+		}
+
+		auto enum_ids = collect<ecsact_enum_id>(
+			ecsact_meta_count_enums(pkg_id),
+			[&](auto... args) { ecsact_meta_get_enum_ids(pkg_id, args...); }
+		);
+		for(auto enum_id : enum_ids) {
+			auto enum_name = str(ecsact_meta_enum_name(enum_id));
+			add_id(
+				snapshot_op::create_enum,
+				{arg(enum_id), arg(pkg_id), enum_name[0], enum_name[1]}
+			);
+
+			auto value_ids = collect<ecsact_enum_value_id>(
+				ecsact_meta_count_enum_values(enum_id),
+				[&](auto... args) { ecsact_meta_get_enum_value_ids(enum_id, args...); }
+			);
+			for(auto value_id : value_ids) {
+				auto value_name = str(ecsact_meta_enum_value_name(enum_id, value_id));
+				add(
+					snapshot_op::add_enum_value,
+					{
+						arg(enum_id),
+						ecsact_meta_enum_value(enum_id, value_id),
+						value_name[0],
+						value_name[1],
+					}
+				);
+			}
+		}
+
+		auto comp_ids = collect<ecsact_component_id>(
+			ecsact_meta_count_components(pkg_id),
+			[&](auto... args) { ecsact_meta_get_component_ids(pkg_id, args...); }
+		);
+		for(auto comp_id : comp_ids) {
+			auto comp_name = str(ecsact_meta_component_name(comp_id));
+			add_id(
+				snapshot_op::create_component,
+				{arg(comp_id), arg(pkg_id), comp_name[0], comp_name[1]}
+			);
+
+			auto comp_type = ecsact_meta_component_type(
+				ecsact_id_cast<ecsact_component_like_id>(comp_id)
+			);
+			if(comp_type != ECSACT_COMPONENT_TYPE_NONE) {
+				add(
+					snapshot_op::set_component_type,
+					{arg(comp_id), arg(comp_type)}
+				);
+			}
+
+			write_fields(ecsact_id_cast<ecsact_composite_id>(comp_id));
+		}
+
+		auto trans_ids = collect<ecsact_transient_id>(
+			ecsact_meta_count_transients(pkg_id),
+			[&](auto... args) { ecsact_meta_get_transient_ids(pkg_id, args...); }
+		);
+		for(auto trans_id : trans_ids) {
+			auto trans_name = str(ecsact_meta_transient_name(trans_id));
+			add_id(
+				snapshot_op::create_transient,
+				{arg(trans_id), arg(pkg_id), trans_name[0], trans_name[1]}
+			);
+			write_fields(ecsact_id_cast<ecsact_composite_id>(trans_id));
+		}
+
+		auto act_ids = collect<ecsact_action_id>(
+			ecsact_meta_count_actions(pkg_id),
+			[&](auto... args) { ecsact_meta_get_action_ids(pkg_id, args...); }
+		);
+		for(auto act_id : act_ids) {
+			auto act_name = str(ecsact_meta_action_name(act_id));
+			add_id(
+				snapshot_op::create_action,
+				{arg(act_id), arg(pkg_id), act_name[0], act_name[1]}
+			);
+			write_fields(ecsact_id_cast<ecsact_composite_id>(act_id));
+			write_system_like(ecsact_id_cast<ecsact_system_like_id>(act_id));
+			write_child_systems(ecsact_id_cast<ecsact_system_like_id>(act_id));
+		}
+
+		auto sys_ids = collect<ecsact_system_id>(
+			ecsact_meta_count_systems(pkg_id),
+			[&](auto... args) { ecsact_meta_get_system_ids(pkg_id, args...); }
+		);
+		for(auto sys_id : sys_ids) {
+			auto sys_name = str(ecsact_meta_system_name(sys_id));
+			add_id(
+				snapshot_op::create_system,
+				{arg(sys_id), arg(pkg_id), sys_name[0], sys_name[1]}
+			);
+
+			auto lazy_rate = ecsact_meta_get_lazy_iteration_rate(sys_id);
+			if(lazy_rate != 0) {
+				add(
+					snapshot_op::set_system_lazy_iteration_rate,
+					{arg(sys_id), lazy_rate}
+				);
+			}
+
+			auto sys_like_id = ecsact_id_cast<ecsact_system_like_id>(sys_id);
+			write_system_like(sys_like_id);
+
+			auto parent_id = ecsact_meta_get_parent_system_id(sys_id);
+			if(parent_id == ECSACT_INVALID_ID(system_like)) {
+				write_child_systems(sys_like_id);
+			}
+		}
+	}
+
+public:
+	auto write_runtime() -> void {
+		auto main_pkg_id = ecsact_meta_main_package();
+		auto pkg_ids = collect<ecsact_package_id>(
+			ecsact_meta_count_packages(),
+			[&](auto... args) { ecsact_meta_get_package_ids(args...); }
+		);
+
+		for(auto pkg_id : pkg_ids) {
+			write_package(pkg_id, pkg_id == main_pkg_id);
+		}
+
+		std::stable_sort(
+			id_records.begin(),
+			id_records.end(),
+			[](const auto& a, const auto& b) { return a.args[0] < b.args[0]; }
+		);
+	}
+
+	auto size() const -> std::size_t {
+		return sizeof(snapshot_header) +
+			sizeof(snapshot_record) * (id_records.size() + records.size()) +
+			strings.size();
+	}
+
+	auto copy_to(uint64_t source_hash, std::byte* out) const -> void {
+		auto header = snapshot_header{
+			.magic = snapshot_magic,
+			.version = snapshot_version,
+			.record_count =
+				static_cast<uint32_t>(id_records.size() + records.size()),
+			.source_hash = source_hash,
+			.last_id = current_context().last_id.load(),
+			.strings_size = static_cast<uint32_t>(strings.size()),
+		};
+
+		std::memcpy(out, &header, sizeof(header));
+		out += sizeof(header);
+		std::memcpy(
+			out,
+			id_records.data(),
+			sizeof(snapshot_record) * id_records.size()
+		);
+		out += sizeof(snapshot_record) * id_records.size();
+		std::memcpy(out, records.data(), sizeof(snapshot_record) * records.size());
+		out += sizeof(snapshot_record) * records.size();
+		std::memcpy(out, strings.data(), strings.size());
+	}
+};
+
+auto read_header(const void* data, int32_t size, snapshot_header& header)
+	-> bool {
+	if(data == nullptr || size < static_cast<int32_t>(sizeof(header))) {
+		return false;
+	}
+
+	std::memcpy(&header, data, sizeof(header));
+	if(header.magic != snapshot_magic || header.version != snapshot_version) {
+		return false;
+	}
+
+	auto expected_size = sizeof(header) +
+		sizeof(snapshot_record) * std::size_t{header.record_count} +
+		std::size_t{header.strings_size};
+	return expected_size == static_cast<std::size_t>(size);
+}
+
+class snapshot_loader {
+	std::string_view strings;
+	int32_t          min_next_id = 0;
+
+	auto str(const snapshot_record& record, int index) const
+		-> std::string_view {
+		auto offset = record.args[index];
+		auto length = record.args[index + 1];
+		if(offset < 0 || length < 0 ||
+			 static_cast<std::size_t>(offset) + length > strings.size()) {
+			throw std::invalid_argument{"string out of bounds"};
+		}
+		return strings.substr(offset, length);
+	}
+
+	/**
+	 * Makes the next generated ID be the one stored in @p record.
+	 */
+	auto expect_id(const snapshot_record& record) -> int32_t {
+		auto id = record.args[0];
+		if(id < min_next_id) {
+			throw std::invalid_argument{"IDs out of order"};
+		}
+		current_context().last_id = id;
+		min_next_id = id + 1;
+		return id;
+	}
+
+	template<typename ID>
+	auto check_id(ID created_id, int32_t expected_id) -> void {
+		if(static_cast<int32_t>(created_id) != expected_id) {
+			throw std::invalid_argument{"ID mismatch"};
+		}
+	}
+
+	template<typename ID>
+	static auto id(const snapshot_record& record, int index) -> ID {
+		return static_cast<ID>(record.args[index]);
+	}
+
+public:
+	explicit snapshot_loader(std::string_view strings) : strings(strings) {
+	}
+
+	auto replay(const snapshot_record& r) -> void {
+		switch(r.op) {
+			case snapshot_op::create_package: {
+				auto expected_id = expect_id(r);
+				auto name = str(r, 2);
+				check_id(
+					ecsact_create_package(r.args[1] != 0, name.data(), name.size()),
+					expected_id
+				);
+				break;
+			}
+			case snapshot_op::create_component: {
+				auto expected_id = expect_id(r);
+				auto name = str(r, 2);
+				check_id(
+					ecsact_create_component(
+						id<ecsact_package_id>(r, 1),
+						name.data(),
+						name.size()
+					),
+					expected_id
+				);
+				break;
+			}
+			case snapshot_op::create_transient: {
+				auto expected_id = expect_id(r);
+				auto name = str(r, 2);
+				check_id(
+					ecsact_create_transient(
+						id<ecsact_package_id>(r, 1),
+						name.data(),
+						name.size()
+					),
+					expected_id
+				);
+				break;
+			}
+			case snapshot_op::create_system: {
+				auto expected_id = expect_id(r);
+				auto name = str(r, 2);
+				check_id(
+					ecsact_create_system(
+						id<ecsact_package_id>(r, 1),
+						name.data(),
+						name.size()
+					),
+					expected_id
+				);
+				break;
+			}
+			case snapshot_op::create_action: {
+				auto expected_id = expect_id(r);
+				auto name = str(r, 2);
+				check_id(
+					ecsact_create_action(
+						id<ecsact_package_id>(r, 1),
+						name.data(),
+						name.size()
+					),
+					expected_id
+				);
+				break;
+			}
+			case snapshot_op::create_enum: {
+				auto expected_id = expect_id(r);
+				auto name = str(r, 2);
+				check_id(
+					ecsact_create_enum(
+						id<ecsact_package_id>(r, 1),
+						name.data(),
+						name.size()
+					),
+					expected_id
+				);
+				break;
+			}
+			case snapshot_op::add_system_generates: {
+				auto expected_id = expect_id(r);
+				check_id(
+					ecsact_add_system_generates(id<ecsact_system_like_id>(r, 1)),
+					expected_id
+				);
+				break;
+			}
+			case snapshot_op::add_system_assoc: {
+				auto expected_id = expect_id(r);
+				check_id(
+					ecsact_add_system_assoc(
+						id<ecsact_system_like_id>(r, 1),
+						id<ecsact_component_like_id>(r, 2)
+					),
+					expected_id
+				);
+				break;
+			}
+			case snapshot_op::set_package_source_file_path: {
+				auto path = str(r, 1);
+				ecsact_set_package_source_file_path(
+					id<ecsact_package_id>(r, 0),
+					path.data(),
+					path.size()
+				);
+				break;
+			}
+			case snapshot_op::add_dependency:
+				ecsact_add_dependency(
+					id<ecsact_package_id>(r, 0),
+					id<ecsact_package_id>(r, 1)
+				);
+				break;
+			case snapshot_op::set_component_type:
+				ecsact_set_component_type(
+					id<ecsact_component_id>(r, 0),
+					id<ecsact_component_type>(r, 1)
+				);
+				break;
+			case snapshot_op::add_enum_value: {
+				auto name = str(r, 2);
+				ecsact_add_enum_value(
+					id<ecsact_enum_id>(r, 0),
+					r.args[1],
+					name.data(),
+					name.size()
+				);
+				break;
+			}
+			case snapshot_op::add_field: {
+				auto type = ecsact_field_type{};
+				type.kind = id<ecsact_type_kind>(r, 1);
+				type.length = r.args[4];
+				switch(type.kind) {
+					case ECSACT_TYPE_KIND_BUILTIN:
+						type.type.builtin = id<ecsact_builtin_type>(r, 2);
+						break;
+					case ECSACT_TYPE_KIND_ENUM:
+						type.type.enum_id = id<ecsact_enum_id>(r, 2);
+						break;
+					case ECSACT_TYPE_KIND_FIELD_INDEX:
+						type.type.field_index.composite_id = id<ecsact_composite_id>(r, 2);
+						type.type.field_index.field_id = id<ecsact_field_id>(r, 3);
+						break;
+					default:
+						throw std::invalid_argument{"invalid field type kind"};
+				}
+
+				auto name = str(r, 5);
+				ecsact_add_field(
+					id<ecsact_composite_id>(r, 0),
+					type,
+					name.data(),
+					name.size()
+				);
+				break;
+			}
+			case snapshot_op::set_system_capability:
+				ecsact_set_system_capability(
+					id<ecsact_system_like_id>(r, 0),
+					id<ecsact_component_like_id>(r, 1),
+					id<ecsact_system_capability>(r, 2)
+				);
+				break;
+			case snapshot_op::add_child_system:
+				ecsact_add_child_system(
+					id<ecsact_system_like_id>(r, 0),
+					id<ecsact_system_id>(r, 1)
+				);
+				break;
+			case snapshot_op::set_system_lazy_iteration_rate:
+				ecsact_set_system_lazy_iteration_rate(
+					id<ecsact_system_id>(r, 0),
+					r.args[1]
+				);
+				break;
+			case snapshot_op::set_system_parallel_execution:
+				ecsact_set_system_parallel_execution(
+					id<ecsact_system_like_id>(r, 0),
+					id<ecsact_parallel_execution>(r, 1)
+				);
+				break;
+			case snapshot_op::set_system_notify_component_setting:
+				ecsact_set_system_notify_component_setting(
+					id<ecsact_system_like_id>(r, 0),
+					id<ecsact_component_like_id>(r, 1),
+					id<ecsact_system_notify_setting>(r, 2)
+				);
+				break;
+			case snapshot_op::system_generates_set_component:
+				ecsact_system_generates_set_component(
+					id<ecsact_system_like_id>(r, 0),
+					id<ecsact_system_generates_id>(r, 1),
+					id<ecsact_component_id>(r, 2),
+					id<ecsact_system_generate>(r, 3)
+				);
+				break;
+			case snapshot_op::add_system_assoc_field:
+				ecsact_add_system_assoc_field(
+					id<ecsact_system_like_id>(r, 0),
+					id<ecsact_system_assoc_id>(r, 1),
+					id<ecsact_field_id>(r, 2)
+				);
+				break;
+			case snapshot_op::set_system_assoc_capability:
+				ecsact_set_system_assoc_capability(
+					id<ecsact_system_like_id>(r, 0),
+					id<ecsact_system_assoc_id>(r, 1),
+					id<ecsact_component_like_id>(r, 2),
+					id<ecsact_system_capability>(r, 3)
+				);
+				break;
+			default:
+				throw std::invalid_argument{"unknown record"};
+		}
+	}
+};
+
+auto destroy_all_packages() -> void {
+	auto pkg_ids = collect<ecsact_package_id>(
+		ecsact_meta_count_packages(),
+		[&](auto... args) { ecsact_meta_get_package_ids(args...); }
+	);
+
+	for(auto pkg_id : pkg_ids) {
+		ecsact_destroy_package(pkg_id);
+	}
+}
+} // namespace
+
+void ecsact_save_runtime_snapshot(
+	uint64_t source_hash,
+	int32_t  max_size,
+	void*    out_data,
+	int32_t* out_size
+) {
+	auto writer = snapshot_writer{};
+	writer.write_runtime();
+
+	auto size = writer.size();
+	if(out_data != nullptr && static_cast<std::size_t>(max_size) >= size) {
+		writer.copy_to(source_hash, static_cast<std::byte*>(out_data));
+	}
+
+	if(out_size != nullptr) {
+		*out_size = static_cast<int32_t>(size);
+	}
+}
+
+bool ecsact_read_runtime_snapshot_source_hash(
+	const void* data,
+	int32_t     size,
+	uint64_t*   out_source_hash
+) {
+	auto header = snapshot_header{};
+	if(!read_header(data, size, header)) {
+		return false;
+	}
+
+	if(out_source_hash != nullptr) {
+		*out_source_hash = header.source_hash;
+	}
+	return true;
+}
+
+void ecsact_load_runtime_snapshot(const void* data, int32_t size) {
+	ensure_mutable(__func__);
+	if(ecsact_meta_count_packages() > 0) {
+		throw std::logic_error{
+			"ecsact_load_runtime_snapshot called with packages in the runtime"
+		};
+	}
+
+	auto header = snapshot_header{};
+	if(!read_header(data, size, header)) {
+		throw std::invalid_argument{"Invalid runtime snapshot header"};
+	}
+
+	auto records = static_cast<const std::byte*>(data) + sizeof(header);
+	auto strings = std::string_view{
+		reinterpret_cast<const char*>(records) +
+			sizeof(snapshot_record) * header.record_count,
+		header.strings_size,
+	};
+
+	auto prev_last_id = current_context().last_id.load();
+	auto loader = snapshot_loader{strings};
+	try {
+		for(auto i = 0u; header.record_count > i; ++i) {
+			// Records are copied out rather than cast in place since @p data has no
+			// alignment requirements.
+			auto record = snapshot_record{};
+			std::memcpy(
+				&record,
+				records + sizeof(snapshot_record) * i,
+				sizeof(record)
+			);
+			loader.replay(record);
+		}
+	} catch(const std::exception& err) {
+		destroy_all_packages();
+		current_context().last_id = prev_last_id;
+		throw std::invalid_argument{
+			std::string{"Invalid runtime snapshot: "} + err.what()
+		};
+	}
+
+	current_context().last_id = header.last_id;
+}
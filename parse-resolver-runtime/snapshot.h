@@ -0,0 +1,58 @@
+#ifndef ECSACT_PARSE_RESOLVER_RUNTIME_SNAPSHOT_H
+#define ECSACT_PARSE_RESOLVER_RUNTIME_SNAPSHOT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Binary snapshots of the parse resolver runtime. A snapshot stores everything
+ * the interpreter resolved (packages, dependencies, composites and their
+ * fields, enums, systems, capabilities, generates, notify settings,
+ * associations and parallel/lazy settings) so tools can skip parsing and
+ * evaluating unchanged sources on startup.
+ *
+ * A snapshot is a fixed size header followed by fixed size records and a
+ * string table. Records are read in place so a snapshot may be loaded straight
+ * from a memory mapped file. Snapshots use the native byte order and are only
+ * meant to be loaded by the same version of this library that wrote them.
+ */
+
+/**
+ * Writes a snapshot of the current context to @p out_data. @p source_hash is
+ * stored as is so callers can tell whether the sources the snapshot was made
+ * from have changed (see `ecsact_read_runtime_snapshot_source_hash`).
+ *
+ * @param max_size size of @p out_data in bytes. Nothing is written if the
+ *        snapshot does not fit.
+ * @param out_size set to the size of the snapshot in bytes. May be NULL.
+ */
+void ecsact_save_runtime_snapshot(
+	uint64_t source_hash,
+	int32_t  max_size,
+	void*    out_data,
+	int32_t* out_size
+);
+
+/**
+ * Reads the source hash stored by `ecsact_save_runtime_snapshot` without
+ * loading the snapshot.
+ * @returns false if @p data is not a snapshot this library can load
+ */
+bool ecsact_read_runtime_snapshot_source_hash(
+	const void* data,
+	int32_t     size,
+	uint64_t*   out_source_hash
+);
+
+/**
+ * Rebuilds the current context from a snapshot in a single pass. Every
+ * package, declaration, generates and association keeps the ID it had when
+ * the snapshot was saved. Full names are rebuilt along the way.
+ *
+ * Throws `std::logic_error` if the current context already has packages or is
+ * frozen. Throws `std::invalid_argument` if @p data is not a valid snapshot in
+ * which case the current context is left empty.
+ */
+void ecsact_load_runtime_snapshot(const void* data, int32_t size);
+
+#endif // ECSACT_PARSE_RESOLVER_RUNTIME_SNAPSHOT_H
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "parse-resolver-runtime/memory.hh"
+
+namespace ecsact::interpret::details {
+
+/**
+ * Deduplicated storage for names. Every distinct string is stored once, null
+ * terminated, and never moves while it is referenced, so the views returned by
+ * `intern` may be handed out as `const char*` and two interned strings are
+ * equal exactly when their data pointers are.
+ *
+ * Each `intern` takes a reference that is dropped with `release`. Strings are
+ * packed into blocks and a block is freed once none of its strings are
+ * referenced anymore, so the pool stays about as big as its live strings plus
+ * the released ones still sharing a block with a live string. Reloading the
+ * same or renamed declarations over and over doesn't grow it.
+ */
+class string_pool {
+	static constexpr std::size_t block_size = 4096;
+
+	struct block {
+		std::unique_ptr<char[]> data;
+		std::size_t             capacity = 0;
+		std::size_t             size = 0;
+
+		/** Strings in this block that are still referenced */
+		int32_t live = 0;
+	};
+
+	struct entry {
+		int32_t refs = 0;
+		int32_t block = -1;
+	};
+
+	/** Freed blocks have no data and their index is in `_free_blocks` */
+	std::vector<block>                          _blocks;
+	std::vector<int32_t>                        _free_blocks;
+	std::unordered_map<std::string_view, entry> _strings;
+
+	/** Block new strings are appended to or -1 before the first one */
+	int32_t _current = -1;
+
+	auto free_block(int32_t index) -> void {
+		_blocks[index] = {};
+		_free_blocks.push_back(index);
+	}
+
+	auto allocate(std::size_t size) -> int32_t {
+		if(_current != -1) {
+			auto& current = _blocks[_current];
+			if(current.capacity - current.size >= size) {
+				return _current;
+			}
+			if(current.live == 0) {
+				free_block(_current);
+			}
+		}
+
+		if(_free_blocks.empty()) {
+			_current = static_cast<int32_t>(_blocks.size());
+			_blocks.emplace_back();
+		} else {
+			_current = _free_blocks.back();
+			_free_blocks.pop_back();
+		}
+
+		auto capacity = std::max(block_size, size);
+		_blocks[_current] = block{
+			.data = std::make_unique<char[]>(capacity),
+			.capacity = capacity,
+		};
+		return _current;
+	}
+
+public:
+	string_pool() = default;
+	string_pool(const string_pool&) = delete;
+	string_pool(string_pool&&) = default;
+
+	auto intern(std::string_view str) -> std::string_view {
+		if(auto itr = _strings.find(str); itr != _strings.end()) {
+			itr->second.refs += 1;
+			return itr->first;
+		}
+
+		auto  block_index = allocate(str.size() + 1);
+		auto& b = _blocks[block_index];
+		auto  data = b.data.get() + b.size;
+		b.size += str.size() + 1;
+		b.live += 1;
+		std::memcpy(data, str.data(), str.size());
+		data[str.size()] = '\0';
+
+		auto key = std::string_view{data, str.size()};
+		_strings.emplace(key, entry{.refs = 1, .block = block_index});
+		return key;
+	}
+
+	/**
+	 * Drops a reference taken by `intern`. Views of @p str must not be used
+	 * once its last reference is dropped.
+	 */
+	auto release(std::string_view str) -> void {
+		auto itr = _strings.find(str);
+		assert(itr != _strings.end());
+		if(--itr->second.refs > 0) {
+			return;
+		}
+
+		auto block_index = itr->second.block;
+		_strings.erase(itr);
+
+		auto& b = _blocks[block_index];
+		if(--b.live > 0) {
+			return;
+		}
+		if(block_index == _current) {
+			b.size = 0;
+		} else {
+			free_block(block_index);
+		}
+	}
+
+	/**
+	 * @returns the interned copy of @p str or an empty view with a null data
+	 *          pointer if @p str isn't interned. No reference is taken.
+	 */
+	auto find(std::string_view str) const -> std::string_view {
+		if(auto itr = _strings.find(str); itr != _strings.end()) {
+			return itr->first;
+		}
+
+		return {};
+	}
+
+	auto string_count() const -> std::size_t {
+		return _strings.size();
+	}
+
+	/**
+	 * Bytes reserved for string data including unused block space
+	 */
+	auto reserved_bytes() const -> std::size_t {
+		auto bytes = std::size_t{};
+		for(auto& b : _blocks) {
+			bytes += b.capacity;
+		}
+		return bytes;
+	}
+
+	/**
+	 * Estimated bytes of string data and the index used to deduplicate it
+	 */
+	auto storage_bytes() const -> int64_t {
+		return static_cast<int64_t>(reserved_bytes()) + heap_bytes(_blocks) +
+			heap_bytes(_free_blocks) + heap_bytes(_strings);
+	}
+};
+
+} // namespace ecsact::interpret::details
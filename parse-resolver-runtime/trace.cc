@@ -0,0 +1,273 @@
+#include "parse-resolver-runtime/trace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using trace_clock = std::chrono::steady_clock;
+
+struct trace_event {
+	const char*              category;
+	const char*              name;
+	std::string              detail;
+	trace_clock::time_point  start;
+	std::chrono::nanoseconds duration;
+	int32_t                  thread_id;
+};
+
+struct open_span {
+	const char*             category;
+	const char*             name;
+	std::string             detail;
+	trace_clock::time_point start;
+	uint64_t                generation;
+};
+
+struct thread_trace;
+
+struct trace_state {
+	std::atomic_bool     enabled = false;
+	std::atomic_uint64_t generation = 0;
+
+	/**
+	 * Guards everything below as well as which threads are registered
+	 */
+	std::mutex                 mutex;
+	trace_clock::time_point    start;
+	std::vector<thread_trace*> threads;
+	int32_t                    next_thread_id = 1;
+
+	/**
+	 * Events of threads that exited while the trace was recorded
+	 */
+	std::vector<trace_event> exited_events;
+};
+
+static auto state() -> trace_state& {
+	static trace_state state;
+	return state;
+}
+
+/**
+ * Spans of a single thread. Only the owning thread touches `open`. `events`
+ * is guarded by `mutex` so starting or stopping a trace may take them.
+ */
+struct thread_trace {
+	std::mutex               mutex;
+	int32_t                  id;
+	std::vector<trace_event> events;
+	std::vector<open_span>   open;
+
+	thread_trace() {
+		auto& s = state();
+		auto  lock = std::scoped_lock{s.mutex};
+		id = s.next_thread_id++;
+		s.threads.push_back(this);
+	}
+
+	thread_trace(const thread_trace&) = delete;
+
+	~thread_trace() {
+		auto& s = state();
+		auto  lock = std::scoped_lock{s.mutex, mutex};
+		std::erase(s.threads, this);
+		std::move(
+			events.begin(),
+			events.end(),
+			std::back_inserter(s.exited_events)
+		);
+	}
+};
+
+static auto this_thread() -> thread_trace& {
+	// Only constructed once the thread records a span
+	thread_local thread_trace trace;
+	return trace;
+}
+
+static auto write_json_string(std::ostream& out, std::string_view str)
+	-> void {
+	out << '"';
+	for(auto c : str) {
+		switch(c) {
+			case '"':
+				out << "\\\"";
+				break;
+			case '\\':
+				out << "\\\\";
+				break;
+			case '\n':
+				out << "\\n";
+				break;
+			case '\t':
+				out << "\\t";
+				break;
+			default:
+				if(static_cast<unsigned char>(c) < 0x20) {
+					char escaped[8];
+					std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+					out << escaped;
+				} else {
+					out << c;
+				}
+		}
+	}
+	out << '"';
+}
+
+/**
+ * Chrome trace timestamps and durations are in microseconds
+ */
+static auto write_micros(std::ostream& out, std::chrono::nanoseconds time)
+	-> void {
+	auto ns = static_cast<long long>(std::max(time.count(), int64_t{}));
+	char buf[32];
+	std::snprintf(buf, sizeof(buf), "%lld.%03lld", ns / 1000, ns % 1000);
+	out << buf;
+}
+
+static auto write_trace(
+	std::ostream&                   out,
+	trace_clock::time_point         start,
+	const std::vector<trace_event>& events
+) -> void {
+	out << "{\"traceEvents\":[";
+	for(std::size_t i = 0; events.size() > i; ++i) {
+		auto& event = events[i];
+		out << (i == 0 ? "\n" : ",\n") << "{\"name\":";
+		write_json_string(out, event.name);
+		out << ",\"cat\":";
+		write_json_string(out, event.category);
+		out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.thread_id;
+		out << ",\"ts\":";
+		write_micros(out, event.start - start);
+		out << ",\"dur\":";
+		write_micros(out, event.duration);
+		if(!event.detail.empty()) {
+			out << ",\"args\":{\"detail\":";
+			write_json_string(out, event.detail);
+			out << "}";
+		}
+		out << "}";
+	}
+	out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+}
+
+void ecsact_start_trace() {
+	auto& s = state();
+	auto  lock = std::scoped_lock{s.mutex};
+
+	// Spans of the previous trace still being ended see the new generation and
+	// are dropped
+	s.generation.fetch_add(1, std::memory_order_relaxed);
+	s.exited_events.clear();
+	for(auto thread : s.threads) {
+		auto thread_lock = std::scoped_lock{thread->mutex};
+		thread->events.clear();
+	}
+	s.start = trace_clock::now();
+	s.enabled.store(true, std::memory_order_release);
+}
+
+bool ecsact_stop_trace(const char* path) {
+	auto& s = state();
+	auto  events = std::vector<trace_event>{};
+	auto  start = trace_clock::time_point{};
+	{
+		auto lock = std::scoped_lock{s.mutex};
+		if(!s.enabled.load(std::memory_order_relaxed)) {
+			return false;
+		}
+
+		s.enabled.store(false, std::memory_order_release);
+		events = std::move(s.exited_events);
+		s.exited_events.clear();
+		for(auto thread : s.threads) {
+			auto thread_lock = std::scoped_lock{thread->mutex};
+			std::move(
+				thread->events.begin(),
+				thread->events.end(),
+				std::back_inserter(events)
+			);
+			thread->events.clear();
+		}
+		start = s.start;
+	}
+
+	if(path == nullptr) {
+		return true;
+	}
+
+	std::stable_sort(events.begin(), events.end(), [](auto& a, auto& b) {
+		return a.start < b.start;
+	});
+
+	auto out = std::ofstream{path, std::ios::binary};
+	if(!out) {
+		return false;
+	}
+	write_trace(out, start, events);
+	out.flush();
+	return out.good();
+}
+
+bool ecsact_is_tracing() {
+	return state().enabled.load(std::memory_order_acquire);
+}
+
+bool ecsact_trace_begin(
+	const char* category,
+	const char* name,
+	const char* detail,
+	int32_t     detail_len
+) {
+	auto& s = state();
+	if(!s.enabled.load(std::memory_order_relaxed)) {
+		return false;
+	}
+
+	auto& thread = this_thread();
+	thread.open.push_back(open_span{
+		.category = category,
+		.name = name,
+		.detail = detail ? std::string(detail, detail_len) : std::string{},
+		.start = trace_clock::now(),
+		.generation = s.generation.load(std::memory_order_relaxed),
+	});
+	return true;
+}
+
+void ecsact_trace_end() {
+	auto  end = trace_clock::now();
+	auto& thread = this_thread();
+	if(thread.open.empty()) {
+		return;
+	}
+
+	auto span = std::move(thread.open.back());
+	thread.open.pop_back();
+
+	auto& s = state();
+	auto  lock = std::scoped_lock{thread.mutex};
+	if(!s.enabled.load(std::memory_order_acquire) ||
+		 s.generation.load(std::memory_order_relaxed) != span.generation) {
+		return;
+	}
+
+	thread.events.push_back(trace_event{
+		.category = span.category,
+		.name = span.name,
+		.detail = std::move(span.detail),
+		.start = span.start,
+		.duration = end - span.start,
+		.thread_id = thread.id,
+	});
+}
@@ -0,0 +1,53 @@
+#ifndef ECSACT_PARSE_RESOLVER_RUNTIME_TRACE_H
+#define ECSACT_PARSE_RESOLVER_RUNTIME_TRACE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Starts recording trace spans on every thread. Spans of an earlier trace that
+ * was not stopped are dropped. Recording is process wide and not tied to a
+ * runtime context.
+ *
+ * While no trace is being recorded every span function returns right away so
+ * spans may be left in hot code.
+ */
+void ecsact_start_trace();
+
+/**
+ * Stops recording and writes the spans ended since `ecsact_start_trace` to
+ * @p path in the Chrome trace event format, which chrome://tracing and
+ * Perfetto can open. Spans still open are left out. A null @p path only drops
+ * the spans.
+ *
+ * @returns false if no trace was being recorded or @p path could not be
+ *          written
+ */
+bool ecsact_stop_trace(const char* path);
+
+bool ecsact_is_tracing();
+
+/**
+ * Opens a span on the calling thread which lasts until the next
+ * `ecsact_trace_end` on the same thread. Spans opened while another span is
+ * open are nested in it. Does nothing if no trace is being recorded.
+ *
+ * @p category and @p name must stay valid until the trace is stopped, usually
+ * they are string literals. @p detail is copied and shown with the span. It
+ * may be null.
+ *
+ * @returns true if the span was opened and must be ended
+ */
+bool ecsact_trace_begin(
+	const char* category,
+	const char* name,
+	const char* detail,
+	int32_t     detail_len
+);
+
+/**
+ * Ends the span last opened by `ecsact_trace_begin` on the calling thread
+ */
+void ecsact_trace_end();
+
+#endif // ECSACT_PARSE_RESOLVER_RUNTIME_TRACE_H
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "parse-resolver-runtime/trace.h"
+
+namespace ecsact::interpret::details {
+
+/**
+ * Trace span lasting for the lifetime of this object. See trace.h
+ */
+class trace_span {
+	bool _active;
+
+public:
+	trace_span(const char* category, const char* name)
+		: _active(ecsact_trace_begin(category, name, nullptr, 0)) {
+	}
+
+	trace_span(const trace_span&) = delete;
+
+	~trace_span() {
+		if(_active) {
+			ecsact_trace_end();
+		}
+	}
+};
+
+} // namespace ecsact::interpret::details
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <optional>
+#include <span>
+#include <string_view>
+#include <utility>
+#include "ecsact/runtime/common.h"
+
+/**
+ * Read only views straight into the parse resolver runtime's storage of the
+ * calling thread's current context. Unlike their `ecsact_meta_*` counterparts
+ * these never allocate or copy.
+ *
+ * A view is only valid until the next dynamic function call on the same
+ * context. Invalid IDs are handled the same way as the `ecsact_meta_*`
+ * function each view mirrors.
+ */
+namespace ecsact::interpret::views {
+
+/** Live packages in creation order */
+auto package_ids() -> std::span<const ecsact_package_id>;
+auto package_name(ecsact_package_id package_id) -> std::string_view;
+auto dependencies(ecsact_package_id package_id)
+	-> std::span<const ecsact_package_id>;
+
+auto component_ids(ecsact_package_id package_id)
+	-> std::span<const ecsact_component_id>;
+auto transient_ids(ecsact_package_id package_id)
+	-> std::span<const ecsact_transient_id>;
+auto action_ids(ecsact_package_id package_id)
+	-> std::span<const ecsact_action_id>;
+auto enum_ids(ecsact_package_id package_id) -> std::span<const ecsact_enum_id>;
+
+/** Every system owned by @p package_id including nested systems */
+auto system_ids(ecsact_package_id package_id)
+	-> std::span<const ecsact_system_id>;
+
+/** In execution order */
+auto top_level_systems(ecsact_package_id package_id)
+	-> std::span<const ecsact_system_like_id>;
+
+/** In execution order */
+auto child_system_ids(ecsact_system_like_id system_id)
+	-> std::span<const ecsact_system_id>;
+
+/** In the order they were first set */
+auto system_capabilities(ecsact_system_like_id system_id)
+	-> std::span<
+		const std::pair<ecsact_component_like_id, ecsact_system_capability>>;
+
+/**
+ * Capability @p system_id has for @p component_id or nullopt if it has none.
+ * Capabilities of parent systems are not considered.
+ */
+auto system_capability(
+	ecsact_system_like_id    system_id,
+	ecsact_component_like_id component_id
+) -> std::optional<ecsact_system_capability>;
+
+/** In the order they were added */
+auto system_assoc_ids(ecsact_system_like_id system_id)
+	-> std::span<const ecsact_system_assoc_id>;
+
+/**
+ * Associations of @p system_id with @p component_id in the order they were
+ * added
+ */
+auto system_assoc_ids(
+	ecsact_system_like_id    system_id,
+	ecsact_component_like_id component_id
+) -> std::span<const ecsact_system_assoc_id>;
+
+auto system_assoc_fields(
+	ecsact_system_like_id  system_id,
+	ecsact_system_assoc_id assoc_id
+) -> std::span<const ecsact_field_id>;
+
+auto system_assoc_capabilities(
+	ecsact_system_like_id  system_id,
+	ecsact_system_assoc_id assoc_id
+)
+	-> std::span<
+		const std::pair<ecsact_component_like_id, ecsact_system_capability>>;
+
+} // namespace ecsact::interpret::views
@@ -0,0 +1,381 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "gtest/gtest.h"
+#include "magic_enum.hpp"
+#include "ecsact/parse.h"
+#include "ecsact/interpret/eval.h"
+#include "ecsact/interpret/detail/eval_parse.hh"
+#include "ecsact/interpret/detail/read_util.hh"
+#include "ecsact/runtime/dynamic.h"
+#include "ecsact/runtime/meta.hh"
+#include "parse-resolver-runtime/context.h"
+#include "parse-resolver-runtime/lookup.h"
+#include "bazel_sundry/runfiles.hh"
+
+#ifdef _WIN32
+#	include <malloc.h>
+#endif
+
+using ecsact::detail::buffer_input;
+using ecsact::detail::statement_reader;
+
+template<typename ID>
+using decl_list_t = std::vector<std::pair<ecsact_package_id, ID>>;
+
+/**
+ * Allocations made by this thread since counting began. Only counted while
+ * `counting_allocations` is set so gtest and fixture setup are left out.
+ */
+static thread_local int64_t allocation_count = 0;
+static thread_local bool    counting_allocations = false;
+
+static auto counted_malloc(std::size_t size) -> void* {
+	if(counting_allocations) {
+		allocation_count += 1;
+	}
+	if(auto ptr = std::malloc(size == 0 ? 1 : size)) {
+		return ptr;
+	}
+	throw std::bad_alloc{};
+}
+
+static auto counted_aligned_malloc(std::size_t size, std::align_val_t align)
+	-> void* {
+	if(counting_allocations) {
+		allocation_count += 1;
+	}
+	auto alignment = static_cast<std::size_t>(align);
+	auto aligned_size = (size + alignment - 1) / alignment * alignment;
+#ifdef _WIN32
+	// MSVC has no std::aligned_alloc and std::free can't release these blocks
+	auto ptr = _aligned_malloc(aligned_size, alignment);
+#else
+	auto ptr = std::aligned_alloc(alignment, aligned_size);
+#endif
+	if(ptr) {
+		return ptr;
+	}
+	throw std::bad_alloc{};
+}
+
+static auto aligned_free(void* ptr) -> void {
+#ifdef _WIN32
+	_aligned_free(ptr);
+#else
+	std::free(ptr);
+#endif
+}
+
+void* operator new(std::size_t size) {
+	return counted_malloc(size);
+}
+
+void* operator new[](std::size_t size) {
+	return counted_malloc(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+	try {
+		return counted_malloc(size);
+	} catch(...) {
+		return nullptr;
+	}
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+	try {
+		return counted_malloc(size);
+	} catch(...) {
+		return nullptr;
+	}
+}
+
+void* operator new(std::size_t size, std::align_val_t align) {
+	return counted_aligned_malloc(size, align);
+}
+
+void* operator new[](std::size_t size, std::align_val_t align) {
+	return counted_aligned_malloc(size, align);
+}
+
+void operator delete(void* ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+	aligned_free(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept {
+	aligned_free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept {
+	aligned_free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept {
+	aligned_free(ptr);
+}
+
+/**
+ * Counts the allocations made by this thread while in scope
+ */
+class allocation_scope {
+	int64_t _start;
+
+public:
+	allocation_scope() : _start(allocation_count) {
+		counting_allocations = true;
+	}
+
+	~allocation_scope() {
+		counting_allocations = false;
+	}
+
+	auto count() const -> int64_t {
+		return allocation_count - _start;
+	}
+};
+
+/**
+ * Most allocations evaluating a single @p statement may make. Declarations own
+ * their definition and name index entries and associations own their field
+ * lists so those have to allocate. Block ends and anything not listed may not
+ * allocate at all.
+ *
+ * Budgets leave some room for differences between standard libraries. Raise
+ * one only when new runtime storage is added on purpose.
+ */
+static auto eval_allocation_budget(const ecsact_statement& statement)
+	-> int64_t {
+	switch(statement.type) {
+		case ECSACT_STATEMENT_COMPONENT:
+		case ECSACT_STATEMENT_TRANSIENT:
+		case ECSACT_STATEMENT_ENUM:
+			return 8;
+		case ECSACT_STATEMENT_SYSTEM:
+		case ECSACT_STATEMENT_ACTION:
+			return 10;
+		case ECSACT_STATEMENT_ENUM_VALUE:
+			return 3;
+		case ECSACT_STATEMENT_BUILTIN_TYPE_FIELD:
+		case ECSACT_STATEMENT_USER_TYPE_FIELD:
+		case ECSACT_STATEMENT_ENTITY_FIELD:
+			return 6;
+		case ECSACT_STATEMENT_SYSTEM_COMPONENT: {
+			auto& data = statement.data.system_component_statement;
+			return data.with_field_name_list_count > 0 ? 32 : 4;
+		}
+		case ECSACT_STATEMENT_SYSTEM_WITH:
+			return 20;
+		default:
+			return 0;
+	}
+}
+
+static const auto fixtures = std::array{
+	"test.ecsact",
+	"field_indexing.ecsact",
+	"stream_component.ecsact",
+	"assoc_capabilities.ecsact",
+};
+
+class Allocations : public testing::Test {
+protected:
+	ecsact_runtime_context*  context = nullptr;
+	std::vector<std::string> sources;
+
+	void SetUp() override {
+		auto runfiles = bazel_sundry::CreateDefaultRunfiles();
+		ASSERT_TRUE(runfiles);
+
+		for(auto fixture : fixtures) {
+			auto path = std::filesystem::path{
+				runfiles->Rlocation(std::string{"ecsact_interpret_test/"} + fixture)
+			};
+			ASSERT_TRUE(std::filesystem::exists(path)) << path << " does not exist";
+			sources.push_back(ecsact::detail::read_file_contents(path));
+		}
+
+		context = ecsact_create_runtime_context();
+		ecsact_set_thread_runtime_context(context);
+	}
+
+	void TearDown() override {
+		ecsact_set_thread_runtime_context(nullptr);
+		ecsact_destroy_runtime_context(context);
+	}
+
+	/**
+	 * Reads and evaluates every fixture one statement at a time. @p on_statement
+	 * is called with each statement, the allocations evaluating it made and
+	 * where it was read.
+	 */
+	void eval_fixtures(auto&& on_statement) {
+		for(auto i = 0; sources.size() > i; ++i) {
+			auto reader = statement_reader<buffer_input>{};
+			reader.stream.buffer = sources[i];
+			auto package_id = std::optional<ecsact_package_id>{};
+
+			while(reader.can_read_next()) {
+				reader.read_next();
+				ASSERT_FALSE(ecsact_is_error_parse_status_code(reader.status.code))
+					<< fixtures[i] << ":" << reader.current_line << " failed to parse";
+
+				auto& statement = reader.statements.top();
+				if(statement.type == ECSACT_STATEMENT_PACKAGE) {
+					package_id = ecsact_eval_package_statement(
+						&statement.data.package_statement
+					);
+				} else if(statement.type != ECSACT_STATEMENT_IMPORT) {
+					ASSERT_TRUE(package_id) << fixtures[i] << " has no package";
+
+					auto err = ecsact_eval_error{};
+					auto count = int64_t{};
+					{
+						auto scope = allocation_scope{};
+						err = ecsact_eval_statement(
+							*package_id,
+							static_cast<int32_t>(reader.statements.size()),
+							reader.statements.data()
+						);
+						count = scope.count();
+					}
+
+					ASSERT_EQ(err.code, ECSACT_EVAL_OK)
+						<< fixtures[i] << ":" << reader.current_line << " "
+						<< magic_enum::enum_name(err.code);
+					on_statement(statement, count, fixtures[i], reader.current_line);
+				}
+
+				reader.pump_status_code();
+			}
+		}
+	}
+};
+
+TEST_F(Allocations, ReadStatements) {
+	for(auto& source : sources) {
+		auto reader = statement_reader<buffer_input>{};
+		reader.stream.buffer = source;
+
+		auto scope = allocation_scope{};
+		while(reader.can_read_next()) {
+			reader.read_next();
+			if(ecsact_is_error_parse_status_code(reader.status.code)) {
+				break;
+			}
+			reader.pump_status_code();
+		}
+
+		// Buffered readers view the source and keep their stacks inline
+		EXPECT_EQ(scope.count(), 0);
+	}
+}
+
+TEST_F(Allocations, EvalStatements) {
+	auto statement_count = 0;
+	eval_fixtures([&](auto& statement, auto count, auto fixture, auto line) {
+		EXPECT_LE(count, eval_allocation_budget(statement))
+			<< fixture << ":" << line << " "
+			<< magic_enum::enum_name(statement.type);
+		statement_count += 1;
+	});
+	EXPECT_GT(statement_count, 0);
+}
+
+TEST_F(Allocations, Lookups) {
+	eval_fixtures([](auto&&...) {});
+
+	struct field_lookup {
+		ecsact_composite_id composite_id;
+		ecsact_field_id     field_id;
+		std::string_view    name;
+	};
+
+	auto components = decl_list_t<ecsact_component_id>{};
+	auto actions = decl_list_t<ecsact_action_id>{};
+	auto fields = std::vector<field_lookup>{};
+	for(auto package_id : ecsact::meta::get_package_ids()) {
+		for(auto id : ecsact::meta::get_component_ids(package_id)) {
+			components.emplace_back(package_id, id);
+			auto composite_id = ecsact_id_cast<ecsact_composite_id>(id);
+			for(auto field_id : ecsact::meta::get_field_ids(composite_id)) {
+				auto name = ecsact_meta_field_name(composite_id, field_id);
+				fields.push_back({composite_id, field_id, name});
+			}
+		}
+		for(auto id : ecsact::meta::get_action_ids(package_id)) {
+			actions.emplace_back(package_id, id);
+		}
+	}
+	ASSERT_FALSE(components.empty());
+	ASSERT_FALSE(fields.empty());
+
+	auto found_components = std::vector<ecsact_component_id>{};
+	auto found_actions = std::vector<ecsact_action_id>{};
+	auto found_fields = std::vector<ecsact_field_id>{};
+	found_components.reserve(components.size());
+	found_actions.reserve(actions.size());
+	found_fields.reserve(fields.size());
+
+	auto lookup_allocations = int64_t{};
+	{
+		auto scope = allocation_scope{};
+		for(auto [package_id, id] : components) {
+			auto name = std::string_view{ecsact_meta_component_name(id)};
+			found_components.push_back(ecsact_lookup_component(
+				package_id,
+				name.data(),
+				static_cast<int32_t>(name.size())
+			));
+		}
+		for(auto [package_id, id] : actions) {
+			auto name = std::string_view{ecsact_meta_action_name(id)};
+			found_actions.push_back(ecsact_lookup_action(
+				package_id,
+				name.data(),
+				static_cast<int32_t>(name.size())
+			));
+		}
+		for(auto& field : fields) {
+			found_fields.push_back(ecsact_lookup_field(
+				field.composite_id,
+				field.name.data(),
+				static_cast<int32_t>(field.name.size())
+			));
+		}
+		lookup_allocations = scope.count();
+	}
+
+	EXPECT_EQ(lookup_allocations, 0);
+	for(auto i = 0; components.size() > i; ++i) {
+		EXPECT_EQ(found_components[i], components[i].second);
+	}
+	for(auto i = 0; actions.size() > i; ++i) {
+		EXPECT_EQ(found_actions[i], actions[i].second);
+	}
+	for(auto i = 0; fields.size() > i; ++i) {
+		EXPECT_EQ(found_fields[i], fields[i].field_id);
+	}
+}
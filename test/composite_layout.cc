@@ -0,0 +1,169 @@
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include "gtest/gtest.h"
+#include "ecsact/runtime/dynamic.h"
+#include "ecsact/runtime/meta.h"
+#include "parse-resolver-runtime/layout.h"
+
+#include "test_lib.hh"
+
+class CompositeLayout : public RuntimeContextTest {
+protected:
+	CompositeLayout() : RuntimeContextTest("layout.main") {
+	}
+
+	auto add_component(const char* name) -> ecsact_composite_id {
+		auto name_length = static_cast<int32_t>(std::string_view{name}.size());
+		return as_composite(ecsact_create_component(pkg_id, name, name_length));
+	}
+
+	static auto offset(ecsact_composite_id id, ecsact_field_id field_id) {
+		return static_cast<std::size_t>(ecsact_meta_field_offset(id, field_id));
+	}
+
+	static auto size(ecsact_composite_id id) {
+		return static_cast<std::size_t>(ecsact_composite_layout_size(id));
+	}
+
+	static auto alignment(ecsact_composite_id id) {
+		return static_cast<std::size_t>(ecsact_composite_layout_alignment(id));
+	}
+};
+
+TEST_F(CompositeLayout, Empty) {
+	auto comp = add_component("Empty");
+	EXPECT_EQ(size(comp), 0);
+	EXPECT_EQ(alignment(comp), 1);
+}
+
+TEST_F(CompositeLayout, MixedWidths) {
+	struct expected {
+		uint8_t  a;
+		int32_t  b;
+		uint16_t c;
+		uint8_t  d;
+	};
+
+	auto comp = add_component("Mixed");
+	auto a = ecsact_add_field(comp, builtin_field_type(ECSACT_U8), "a", 1);
+	auto b = ecsact_add_field(comp, builtin_field_type(ECSACT_I32), "b", 1);
+	auto c = ecsact_add_field(comp, builtin_field_type(ECSACT_U16), "c", 1);
+	auto d = ecsact_add_field(comp, builtin_field_type(ECSACT_U8), "d", 1);
+
+	EXPECT_EQ(offset(comp, a), offsetof(expected, a));
+	EXPECT_EQ(offset(comp, b), offsetof(expected, b));
+	EXPECT_EQ(offset(comp, c), offsetof(expected, c));
+	EXPECT_EQ(offset(comp, d), offsetof(expected, d));
+	EXPECT_EQ(size(comp), sizeof(expected));
+	EXPECT_EQ(alignment(comp), alignof(expected));
+}
+
+TEST_F(CompositeLayout, Arrays) {
+	struct expected {
+		uint8_t a;
+		int16_t b[3];
+		int32_t c;
+		uint8_t d[5];
+	};
+
+	auto comp = add_component("Arrays");
+	auto a = ecsact_add_field(comp, builtin_field_type(ECSACT_U8), "a", 1);
+	auto b = ecsact_add_field(comp, builtin_field_type(ECSACT_I16, 3), "b", 1);
+	auto c = ecsact_add_field(comp, builtin_field_type(ECSACT_I32), "c", 1);
+	auto d = ecsact_add_field(comp, builtin_field_type(ECSACT_U8, 5), "d", 1);
+
+	EXPECT_EQ(offset(comp, a), offsetof(expected, a));
+	EXPECT_EQ(offset(comp, b), offsetof(expected, b));
+	EXPECT_EQ(offset(comp, c), offsetof(expected, c));
+	EXPECT_EQ(offset(comp, d), offsetof(expected, d));
+	EXPECT_EQ(size(comp), sizeof(expected));
+	EXPECT_EQ(alignment(comp), alignof(expected));
+}
+
+TEST_F(CompositeLayout, EnumStorageChange) {
+	struct expected_u8 {
+		uint8_t a;
+		uint8_t e;
+		uint8_t c;
+	};
+
+	struct expected_u16 {
+		uint8_t  a;
+		uint16_t e;
+		uint8_t  c;
+	};
+
+	auto enum_id = ecsact_create_enum(pkg_id, "Enum", 4);
+	ecsact_add_enum_value(enum_id, 1, "Small", 5);
+	auto enum_type = ecsact_field_type{
+		.kind = ECSACT_TYPE_KIND_ENUM,
+		.type{.enum_id = enum_id},
+		.length = 1,
+	};
+
+	auto comp = add_component("WithEnum");
+	auto a = ecsact_add_field(comp, builtin_field_type(ECSACT_U8), "a", 1);
+	auto e = ecsact_add_field(comp, enum_type, "e", 1);
+	auto c = ecsact_add_field(comp, builtin_field_type(ECSACT_U8), "c", 1);
+
+	ASSERT_EQ(ecsact_meta_enum_storage_type(enum_id), ECSACT_U8);
+	EXPECT_EQ(offset(comp, e), offsetof(expected_u8, e));
+	EXPECT_EQ(offset(comp, c), offsetof(expected_u8, c));
+	EXPECT_EQ(size(comp), sizeof(expected_u8));
+	EXPECT_EQ(alignment(comp), alignof(expected_u8));
+
+	// The cached layout must follow the enum's new storage type
+	ecsact_add_enum_value(enum_id, 300, "Large", 5);
+	ASSERT_EQ(ecsact_meta_enum_storage_type(enum_id), ECSACT_U16);
+	EXPECT_EQ(offset(comp, a), offsetof(expected_u16, a));
+	EXPECT_EQ(offset(comp, e), offsetof(expected_u16, e));
+	EXPECT_EQ(offset(comp, c), offsetof(expected_u16, c));
+	EXPECT_EQ(size(comp), sizeof(expected_u16));
+	EXPECT_EQ(alignment(comp), alignof(expected_u16));
+}
+
+TEST_F(CompositeLayout, FieldIndex) {
+	struct expected {
+		uint8_t a;
+		int32_t index;
+		uint8_t b;
+	};
+
+	auto target = add_component("Target");
+	auto value =
+		ecsact_add_field(target, builtin_field_type(ECSACT_I32), "value", 5);
+
+	auto index_type = ecsact_field_type{
+		.kind = ECSACT_TYPE_KIND_FIELD_INDEX,
+		.type{.field_index{.composite_id = target, .field_id = value}},
+		.length = 1,
+	};
+
+	// A length of 0 is laid out the same as a single element
+	auto unsized_index_type = index_type;
+	unsized_index_type.length = 0;
+
+	auto comp = add_component("Indexed");
+	auto a = ecsact_add_field(comp, builtin_field_type(ECSACT_U8), "a", 1);
+	auto index = ecsact_add_field(comp, index_type, "index", 5);
+	auto b = ecsact_add_field(comp, builtin_field_type(ECSACT_U8), "b", 1);
+
+	auto unsized_comp = add_component("UnsizedIndexed");
+	ecsact_add_field(unsized_comp, builtin_field_type(ECSACT_U8), "a", 1);
+	auto unsized_index =
+		ecsact_add_field(unsized_comp, unsized_index_type, "index", 5);
+	auto unsized_b =
+		ecsact_add_field(unsized_comp, builtin_field_type(ECSACT_U8), "b", 1);
+
+	EXPECT_EQ(offset(comp, a), offsetof(expected, a));
+	EXPECT_EQ(offset(comp, index), offsetof(expected, index));
+	EXPECT_EQ(offset(comp, b), offsetof(expected, b));
+	EXPECT_EQ(size(comp), sizeof(expected));
+	EXPECT_EQ(alignment(comp), alignof(expected));
+
+	EXPECT_EQ(offset(unsized_comp, unsized_index), offsetof(expected, index));
+	EXPECT_EQ(offset(unsized_comp, unsized_b), offsetof(expected, b));
+	EXPECT_EQ(size(unsized_comp), sizeof(expected));
+	EXPECT_EQ(alignment(unsized_comp), alignof(expected));
+}
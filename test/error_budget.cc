@@ -0,0 +1,90 @@
+#include <array>
+#include <string_view>
+#include "gtest/gtest.h"
+#include "ecsact/interpret/eval.hh"
+#include "parse-resolver-runtime/context.h"
+
+using namespace std::string_view_literals;
+
+class ErrorBudget : public testing::Test {
+protected:
+	ecsact_runtime_context* context = nullptr;
+
+	// Every field after the first one reuses its name
+	static constexpr auto broken_source = //
+		"package error.budget;\n"
+		"component Example {\n"
+		"	i32 a;\n"
+		"	i32 a;\n"
+		"	i32 a;\n"
+		"	i32 a;\n"
+		"}\n"sv;
+
+	void SetUp() override {
+		context = ecsact_create_runtime_context();
+	}
+
+	void TearDown() override {
+		ecsact_destroy_runtime_context(context);
+	}
+};
+
+TEST_F(ErrorBudget, Unlimited) {
+	auto sources = std::array{
+		ecsact::eval_source{.file_path = "broken.ecsact", .source = broken_source},
+	};
+
+	auto errs = ecsact::eval_files(sources, {.context = context});
+	ASSERT_EQ(errs.size(), 3);
+	for(auto& err : errs) {
+		EXPECT_FALSE(err.error_message.empty());
+		EXPECT_EQ(
+			broken_source.substr(err.content_offset, err.content_length),
+			"a"
+		);
+	}
+}
+
+TEST_F(ErrorBudget, MaxErrors) {
+	auto sources = std::array{
+		ecsact::eval_source{.file_path = "broken.ecsact", .source = broken_source},
+	};
+
+	auto errs = ecsact::eval_files(
+		sources,
+		{.max_errors = 2, .format_messages = false, .context = context}
+	);
+	ASSERT_EQ(errs.size(), 2);
+	EXPECT_TRUE(errs[0].error_message.empty());
+
+	ecsact::format_error_messages(errs, sources);
+	EXPECT_FALSE(errs[0].error_message.empty());
+	EXPECT_EQ(
+		errs[0].error_message,
+		ecsact::format_error_message(errs[0], broken_source)
+	);
+}
+
+TEST_F(ErrorBudget, FirstFailingFile) {
+	auto sources = std::array{
+		ecsact::eval_source{
+			.file_path = "no_package_a.ecsact",
+			.source = "component A {}\n"sv,
+		},
+		ecsact::eval_source{
+			.file_path = "no_package_b.ecsact",
+			.source = "component B {}\n"sv,
+		},
+	};
+
+	auto all_errs = ecsact::eval_files(sources, {.context = context});
+	EXPECT_EQ(all_errs.size(), 2);
+
+	auto errs = ecsact::eval_files(
+		sources,
+		{.stop_at_first_failing_file = true, .context = context}
+	);
+	ASSERT_EQ(errs.size(), 1);
+	EXPECT_EQ(errs[0].source_index, 0);
+	EXPECT_EQ(errs[0].eval_error, ECSACT_EVAL_ERR_EXPECTED_PACKAGE_STATEMENT);
+}
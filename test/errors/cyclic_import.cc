@@ -0,0 +1,16 @@
+#include "gtest/gtest.h"
+#include "ecsact/interpret/eval.h"
+
+#include "test_lib.hh"
+
+TEST(EvalError, CyclicImport) {
+	auto errs = ecsact_interpret_test_files({
+		"errors/cyclic_import.ecsact",
+		"errors/cyclic_import_b.ecsact",
+	});
+	ASSERT_EQ(errs.size(), 2);
+	ASSERT_EQ(errs[0].eval_error, ECSACT_EVAL_ERR_CYCLIC_IMPORT);
+	ASSERT_EQ(errs[0].source_index, 0);
+	ASSERT_EQ(errs[1].eval_error, ECSACT_EVAL_ERR_CYCLIC_IMPORT);
+	ASSERT_EQ(errs[1].source_index, 1);
+}
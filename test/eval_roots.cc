@@ -0,0 +1,176 @@
+#include <algorithm>
+#include <array>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "gtest/gtest.h"
+#include "ecsact/interpret/eval.hh"
+#include "ecsact/interpret/eval_session.hh"
+#include "ecsact/runtime/meta.hh"
+
+#include "test_lib.hh"
+
+using namespace std::string_view_literals;
+
+static const auto sources = std::array{
+	ecsact::eval_source{
+		.file_path = "roots_main.ecsact",
+		.source = "main package roots.main;\n"
+							"import roots.a;\n"
+							"component Main {\n"
+							"i32 x;\n"
+							"}\n"sv,
+	},
+	ecsact::eval_source{
+		.file_path = "roots_a.ecsact",
+		.source = "package roots.a;\n"
+							"import roots.b;\n"
+							"component A {\n"
+							"i32 x;\n"
+							"}\n"sv,
+	},
+	ecsact::eval_source{
+		.file_path = "roots_b.ecsact",
+		.source = "package roots.b;\n"
+							"component B {\n"
+							"i32 x;\n"
+							"}\n"sv,
+	},
+	ecsact::eval_source{
+		.file_path = "roots_unrelated.ecsact",
+		.source = "package roots.unrelated;\n"
+							"import roots.missing;\n"
+							"component Broken {\n"
+							"NotAType x;\n"
+							"}\n"sv,
+	},
+	ecsact::eval_source{
+		.file_path = "roots_other.ecsact",
+		.source = "package roots.other;\n"
+							"import roots.b;\n"
+							"component Other {\n"
+							"i32 x;\n"
+							"}\n"sv,
+	},
+};
+
+static auto evaluated_package_names() -> std::vector<std::string> {
+	auto names = std::vector<std::string>{};
+	for(auto package_id : ecsact::meta::get_package_ids()) {
+		names.push_back(ecsact::meta::package_name(package_id));
+	}
+	std::ranges::sort(names);
+	return names;
+}
+
+class EvalRoots : public RuntimeContextTest {};
+
+TEST_F(EvalRoots, MainPackageRoot) {
+	auto errs = ecsact::eval_files(sources, {.main_package_root = true});
+	ASSERT_EQ(errs.size(), 0) << errs[0].error_message;
+
+	EXPECT_EQ(
+		evaluated_package_names(),
+		(std::vector<std::string>{"roots.a", "roots.b", "roots.main"})
+	);
+}
+
+TEST_F(EvalRoots, NamedRoots) {
+	auto stats = ecsact::eval_stats{};
+	auto errs = ecsact::eval_files(
+		sources,
+		{.root_packages = {"roots.other"}, .stats = &stats}
+	);
+	ASSERT_EQ(errs.size(), 0) << errs[0].error_message;
+
+	EXPECT_EQ(
+		evaluated_package_names(),
+		(std::vector<std::string>{"roots.b", "roots.other"})
+	);
+	EXPECT_EQ(stats.objects_created.packages, 2);
+	EXPECT_EQ(
+		stats.bytes_read,
+		static_cast<int64_t>(sources[2].source.size() + sources[4].source.size())
+	);
+}
+
+TEST_F(EvalRoots, ErrorsReferToGivenSources) {
+	auto errs = ecsact::eval_files(
+		sources,
+		{.root_packages = {"roots.unrelated"}}
+	);
+	ASSERT_EQ(errs.size(), 1);
+	EXPECT_EQ(errs[0].source_index, 3);
+	EXPECT_EQ(errs[0].eval_error, ECSACT_EVAL_ERR_UNKNOWN_IMPORT);
+	EXPECT_NE(errs[0].error_message.find("roots.missing"), std::string::npos)
+		<< errs[0].error_message;
+}
+
+TEST_F(EvalRoots, UnknownRoot) {
+	auto errs = ecsact::eval_files(
+		sources,
+		{.root_packages = {"roots.a", "roots.nope"}}
+	);
+	ASSERT_EQ(errs.size(), 1);
+	EXPECT_EQ(errs[0].source_index, -1);
+	EXPECT_EQ(errs[0].eval_error, ECSACT_EVAL_ERR_UNKNOWN_ROOT_PACKAGE);
+	EXPECT_EQ(errs[0].error_message, "Unknown root package 'roots.nope'");
+	EXPECT_EQ(ecsact_meta_count_packages(), 0);
+}
+
+TEST_F(EvalRoots, NoMainPackage) {
+	auto no_main_sources = std::span{sources}.subspan(1);
+	auto errs = ecsact::eval_files(no_main_sources, {.main_package_root = true});
+	ASSERT_EQ(errs.size(), 1);
+	EXPECT_EQ(errs[0].source_index, -1);
+	EXPECT_EQ(errs[0].eval_error, ECSACT_EVAL_ERR_NO_MAIN_PACKAGE);
+	EXPECT_EQ(errs[0].error_message, "No main package to use as root");
+}
+
+TEST_F(EvalRoots, UnformattedUnknownRoot) {
+	auto errs = ecsact::eval_files(
+		sources,
+		{.format_messages = false, .root_packages = {"roots.nope"}}
+	);
+	ASSERT_EQ(errs.size(), 1);
+	EXPECT_EQ(errs[0].eval_error, ECSACT_EVAL_ERR_UNKNOWN_ROOT_PACKAGE);
+	EXPECT_TRUE(errs[0].error_message.empty());
+
+	ecsact::format_error_messages(errs, sources);
+	EXPECT_EQ(errs[0].error_message, "Unknown root package");
+}
+
+TEST_F(EvalRoots, HeaderStatementsCountedOnce) {
+	auto stats = ecsact::eval_stats{};
+	auto errs = ecsact::eval_files(
+		sources,
+		{.root_packages = {"roots.other"}, .stats = &stats}
+	);
+	ASSERT_EQ(errs.size(), 0) << errs[0].error_message;
+
+	// Picking the files already read their package and import statements
+	EXPECT_EQ(stats.statements_parsed[ECSACT_STATEMENT_PACKAGE], 2);
+	EXPECT_EQ(stats.statements_parsed[ECSACT_STATEMENT_IMPORT], 1);
+}
+
+TEST_F(EvalRoots, Session) {
+	auto session = ecsact::eval_session{context};
+
+	auto errs = session.eval_files(sources, {.main_package_root = true});
+	ASSERT_EQ(errs.size(), 0) << errs[0].error_message;
+	EXPECT_EQ(session.last_evaluated_count(), 3);
+	EXPECT_TRUE(session.package_id("roots_main.ecsact"));
+	EXPECT_FALSE(session.package_id("roots_other.ecsact"));
+
+	// Files no longer reachable are treated as removed
+	errs = session.eval_files(sources, {.root_packages = {"roots.other"}});
+	ASSERT_EQ(errs.size(), 0) << errs[0].error_message;
+	EXPECT_EQ(session.last_evaluated_count(), 1);
+	EXPECT_FALSE(session.package_id("roots_main.ecsact"));
+	EXPECT_TRUE(session.package_id("roots_other.ecsact"));
+	EXPECT_EQ(
+		evaluated_package_names(),
+		(std::vector<std::string>{"roots.b", "roots.other"})
+	);
+}
@@ -0,0 +1,197 @@
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "ecsact/interpret/eval_session.hh"
+#include "ecsact/runtime/meta.hh"
+
+#include "test_lib.hh"
+
+class EvalSession : public RuntimeContextTest {};
+
+TEST_F(EvalSession, OnlyChangedPackagesAreEvaluated) {
+	auto main_src = std::string{
+		"main package session.main;\n"
+		"import session.a;\n"
+		"import session.b;\n"
+		"component MainComponent { i32 v; }\n"
+	};
+	auto a_src = std::string{"package session.a;\ncomponent A { i32 a; }\n"};
+	auto b_src = std::string{"package session.b;\ncomponent B { i32 b; }\n"};
+
+	auto sources = std::vector<ecsact::eval_source>{
+		{.file_path = "main.ecsact", .source = main_src},
+		{.file_path = "a.ecsact", .source = a_src},
+		{.file_path = "b.ecsact", .source = b_src},
+	};
+
+	auto session = ecsact::eval_session{};
+	auto errs = session.eval_files(sources);
+	ASSERT_EQ(errs.size(), 0) << errs[0].error_message;
+	ASSERT_EQ(session.last_evaluated_count(), 3);
+	ASSERT_EQ(ecsact_meta_count_packages(), 3);
+
+	auto main_pkg = session.package_id("main.ecsact");
+	auto a_pkg = session.package_id("a.ecsact");
+	auto b_pkg = session.package_id("b.ecsact");
+	ASSERT_TRUE(main_pkg && a_pkg && b_pkg);
+
+	errs = session.eval_files(sources);
+	ASSERT_EQ(errs.size(), 0) << errs[0].error_message;
+	EXPECT_EQ(session.last_evaluated_count(), 0);
+	EXPECT_EQ(session.package_id("main.ecsact"), main_pkg);
+
+	b_src = "package session.b;\ncomponent B { i32 b; i32 c; }\n";
+	sources[2].source = b_src;
+
+	errs = session.eval_files(sources);
+	ASSERT_EQ(errs.size(), 0) << errs[0].error_message;
+	EXPECT_EQ(session.last_evaluated_count(), 2);
+	EXPECT_EQ(ecsact_meta_count_packages(), 3);
+	EXPECT_EQ(session.package_id("a.ecsact"), a_pkg);
+	EXPECT_NE(session.package_id("b.ecsact"), b_pkg);
+	EXPECT_NE(session.package_id("main.ecsact"), main_pkg);
+
+	auto new_main_pkg = *session.package_id("main.ecsact");
+	EXPECT_EQ(ecsact_meta_count_dependencies(new_main_pkg), 2);
+
+	session.clear();
+	EXPECT_EQ(ecsact_meta_count_packages(), 0);
+}
+
+TEST_F(EvalSession, RemovedFileDirtiesImporters) {
+	auto main_src = std::string{
+		"main package session.main;\n"
+		"import session.b;\n"
+		"component Main { i32 v; }\n"
+	};
+	auto a_src = std::string{"package session.a;\ncomponent A { i32 a; }\n"};
+	auto b_src = std::string{"package session.b;\ncomponent B { i32 b; }\n"};
+
+	auto sources = std::vector<ecsact::eval_source>{
+		{.file_path = "main.ecsact", .source = main_src},
+		{.file_path = "a.ecsact", .source = a_src},
+		{.file_path = "b.ecsact", .source = b_src},
+	};
+
+	auto session = ecsact::eval_session{};
+	auto errs = session.eval_files(sources);
+	ASSERT_EQ(errs.size(), 0) << errs[0].error_message;
+	auto a_pkg = session.package_id("a.ecsact");
+
+	sources.pop_back();
+	errs = session.eval_files(sources);
+	ASSERT_EQ(errs.size(), 1);
+	EXPECT_EQ(errs[0].eval_error, ECSACT_EVAL_ERR_UNKNOWN_IMPORT);
+	EXPECT_EQ(errs[0].source_index, 0);
+	EXPECT_EQ(session.last_evaluated_count(), 1);
+	EXPECT_FALSE(session.package_id("b.ecsact"));
+	EXPECT_EQ(session.package_id("a.ecsact"), a_pkg);
+	EXPECT_EQ(ecsact_meta_count_packages(), 1);
+}
+
+TEST_F(EvalSession, FixedFileAfterError) {
+	auto a_src = std::string{"package session.a;\ncomponent A { i32 a; }\n"};
+	auto b_src = std::string{"package session.b;\ncomponent B { oops b; }\n"};
+
+	auto sources = std::vector<ecsact::eval_source>{
+		{.file_path = "a.ecsact", .source = a_src},
+		{.file_path = "b.ecsact", .source = b_src},
+	};
+
+	auto session = ecsact::eval_session{};
+	auto errs = session.eval_files(sources);
+	ASSERT_EQ(errs.size(), 1);
+	EXPECT_EQ(errs[0].source_index, 1);
+
+	// Every file of a failed run is evaluated again, not only the broken one
+	b_src = "package session.b;\ncomponent B { i32 b; }\n";
+	sources[1].source = b_src;
+	errs = session.eval_files(sources);
+	ASSERT_EQ(errs.size(), 0) << errs[0].error_message;
+	EXPECT_EQ(session.last_evaluated_count(), 2);
+	EXPECT_EQ(ecsact_meta_count_packages(), 2);
+
+	errs = session.eval_files(sources);
+	ASSERT_EQ(errs.size(), 0) << errs[0].error_message;
+	EXPECT_EQ(session.last_evaluated_count(), 0);
+}
+
+TEST_F(EvalSession, PackageRenameDirtiesImporters) {
+	auto main_src = std::string{
+		"main package session.main;\n"
+		"import session.a;\n"
+		"component Main { i32 v; }\n"
+	};
+	auto a_src = std::string{"package session.a;\ncomponent A { i32 a; }\n"};
+	auto b_src = std::string{"package session.b;\ncomponent B { i32 b; }\n"};
+
+	auto sources = std::vector<ecsact::eval_source>{
+		{.file_path = "main.ecsact", .source = main_src},
+		{.file_path = "a.ecsact", .source = a_src},
+		{.file_path = "b.ecsact", .source = b_src},
+	};
+
+	auto session = ecsact::eval_session{};
+	auto errs = session.eval_files(sources);
+	ASSERT_EQ(errs.size(), 0) << errs[0].error_message;
+	auto b_pkg = session.package_id("b.ecsact");
+
+	// The unchanged importer is evaluated again and no longer finds its import
+	a_src = "package session.renamed;\ncomponent A { i32 a; }\n";
+	sources[1].source = a_src;
+	errs = session.eval_files(sources);
+	ASSERT_EQ(errs.size(), 1);
+	EXPECT_EQ(errs[0].eval_error, ECSACT_EVAL_ERR_UNKNOWN_IMPORT);
+	EXPECT_EQ(errs[0].source_index, 0);
+	EXPECT_EQ(session.last_evaluated_count(), 2);
+	EXPECT_EQ(session.package_id("b.ecsact"), b_pkg);
+
+	main_src =
+		"main package session.main;\n"
+		"import session.renamed;\n"
+		"component Main { i32 v; }\n";
+	sources[0].source = main_src;
+	errs = session.eval_files(sources);
+	ASSERT_EQ(errs.size(), 0) << errs[0].error_message;
+	EXPECT_EQ(ecsact_meta_count_packages(), 3);
+	auto main_pkg = *session.package_id("main.ecsact");
+	EXPECT_EQ(ecsact_meta_count_dependencies(main_pkg), 1);
+}
+
+TEST_F(EvalSession, RootsLimitDirtyFiles) {
+	auto main_src = std::string{
+		"main package session.main;\n"
+		"import session.a;\n"
+		"component Main { i32 v; }\n"
+	};
+	auto a_src = std::string{"package session.a;\ncomponent A { i32 a; }\n"};
+	auto other_src =
+		std::string{"package session.other;\ncomponent O { i32 o; }\n"};
+
+	auto sources = std::vector<ecsact::eval_source>{
+		{.file_path = "main.ecsact", .source = main_src},
+		{.file_path = "a.ecsact", .source = a_src},
+		{.file_path = "other.ecsact", .source = other_src},
+	};
+	auto options = ecsact::eval_files_options{.main_package_root = true};
+
+	auto session = ecsact::eval_session{};
+	auto errs = session.eval_files(sources, options);
+	ASSERT_EQ(errs.size(), 0) << errs[0].error_message;
+	EXPECT_EQ(session.last_evaluated_count(), 2);
+	EXPECT_FALSE(session.package_id("other.ecsact"));
+
+	// Files outside the roots are never evaluated, changed or not
+	other_src = "package session.other;\ncomponent O { i32 o; i32 p; }\n";
+	sources[2].source = other_src;
+	errs = session.eval_files(sources, options);
+	ASSERT_EQ(errs.size(), 0) << errs[0].error_message;
+	EXPECT_EQ(session.last_evaluated_count(), 0);
+
+	a_src = "package session.a;\ncomponent A { i32 a; i32 b; }\n";
+	sources[1].source = a_src;
+	errs = session.eval_files(sources, options);
+	ASSERT_EQ(errs.size(), 0) << errs[0].error_message;
+	EXPECT_EQ(session.last_evaluated_count(), 2);
+	EXPECT_EQ(ecsact_meta_count_packages(), 2);
+}
@@ -0,0 +1,147 @@
+#include <array>
+#include <string_view>
+#include <vector>
+#include "gtest/gtest.h"
+#include "ecsact/interpret/eval.h"
+#include "ecsact/runtime/dynamic.h"
+#include "ecsact/runtime/meta.h"
+
+#include "test_lib.hh"
+
+static auto sv(std::string_view str) -> ecsact_statement_sv {
+	return {str.data(), static_cast<int32_t>(str.size())};
+}
+
+static auto make_component(std::string_view name) -> ecsact_statement {
+	auto statement = ecsact_statement{};
+	statement.type = ECSACT_STATEMENT_COMPONENT;
+	statement.data.component_statement.component_name = sv(name);
+	return statement;
+}
+
+static auto make_system(std::string_view name) -> ecsact_statement {
+	auto statement = ecsact_statement{};
+	statement.type = ECSACT_STATEMENT_SYSTEM;
+	statement.data.system_statement.system_name = sv(name);
+	return statement;
+}
+
+static auto make_i32_field(std::string_view name) -> ecsact_statement {
+	auto statement = ecsact_statement{};
+	statement.type = ECSACT_STATEMENT_BUILTIN_TYPE_FIELD;
+	statement.data.field_statement.field_type = ECSACT_I32;
+	statement.data.field_statement.field_name = sv(name);
+	statement.data.field_statement.length = 1;
+	return statement;
+}
+
+static auto make_readwrite(std::string_view name) -> ecsact_statement {
+	auto statement = ecsact_statement{};
+	statement.type = ECSACT_STATEMENT_SYSTEM_COMPONENT;
+	auto& data = statement.data.system_component_statement;
+	data.capability = ECSACT_SYS_CAP_READWRITE;
+	data.component_name = sv(name);
+	return statement;
+}
+
+class EvalStatements : public RuntimeContextTest {
+protected:
+	std::vector<ecsact_statement>              statements;
+	std::vector<int32_t>                       parent_indices;
+	std::array<ecsact_eval_statement_error, 8> errors = {};
+	int32_t                                    error_count = 0;
+
+	EvalStatements() : RuntimeContextTest("batch.main") {
+	}
+
+	auto add(ecsact_statement statement, int32_t parent = -1) -> int32_t {
+		statements.push_back(statement);
+		parent_indices.push_back(parent);
+		return static_cast<int32_t>(statements.size() - 1);
+	}
+
+	void eval(int32_t max_error_count = 8) {
+		ecsact_eval_statements(
+			pkg_id,
+			static_cast<int32_t>(statements.size()),
+			statements.data(),
+			parent_indices.data(),
+			max_error_count,
+			errors.data(),
+			&error_count
+		);
+	}
+
+	auto component_ids() -> std::vector<ecsact_component_id> {
+		auto ids =
+			std::vector<ecsact_component_id>(ecsact_meta_count_components(pkg_id));
+		ecsact_meta_get_component_ids(
+			pkg_id,
+			static_cast<int32_t>(ids.size()),
+			ids.data(),
+			nullptr
+		);
+		return ids;
+	}
+};
+
+TEST_F(EvalStatements, Tree) {
+	auto comp = add(make_component("Comp"));
+	add(make_i32_field("a"), comp);
+	add(make_i32_field("b"), comp);
+	auto sys = add(make_system("Sys"));
+	add(make_readwrite("Comp"), sys);
+	eval();
+
+	ASSERT_EQ(error_count, 0);
+	auto comp_ids = component_ids();
+	ASSERT_EQ(comp_ids.size(), 1);
+	EXPECT_EQ(
+		ecsact_meta_count_fields(ecsact_id_cast<ecsact_composite_id>(comp_ids[0])),
+		2
+	);
+	EXPECT_EQ(ecsact_meta_count_systems(pkg_id), 1);
+}
+
+TEST_F(EvalStatements, ParentAfterSiblings) {
+	// Children don't have to directly follow their parent
+	auto first = add(make_component("First"));
+	auto second = add(make_component("Second"));
+	add(make_i32_field("a"), first);
+	add(make_i32_field("b"), second);
+	add(make_i32_field("c"), first);
+	eval();
+
+	ASSERT_EQ(error_count, 0);
+	for(auto comp_id : component_ids()) {
+		EXPECT_EQ(
+			ecsact_meta_count_fields(ecsact_id_cast<ecsact_composite_id>(comp_id)),
+			std::string_view{ecsact_meta_component_name(comp_id)} == "First" ? 2 : 1
+		);
+	}
+}
+
+TEST_F(EvalStatements, ErrorsSkipChildren) {
+	add(make_component("Comp"));
+	auto duplicate = add(make_component("Comp"));
+	add(make_i32_field("a"), duplicate);
+	auto orphan = add(make_i32_field("b"));
+	auto bad_parent = add(make_i32_field("c"), 100);
+	eval();
+
+	ASSERT_EQ(error_count, 3);
+	EXPECT_EQ(errors[0].statement_index, duplicate);
+	EXPECT_EQ(errors[0].error.code, ECSACT_EVAL_ERR_DECLARATION_NAME_TAKEN);
+	EXPECT_EQ(errors[1].statement_index, orphan);
+	EXPECT_EQ(errors[1].error.code, ECSACT_EVAL_ERR_INVALID_CONTEXT);
+	EXPECT_EQ(errors[2].statement_index, bad_parent);
+	EXPECT_EQ(errors[2].error.code, ECSACT_EVAL_ERR_INVALID_CONTEXT);
+
+	// Evaluating again fails on every declaration. The total is still reported
+	// when not every error fits.
+	errors = {};
+	eval(1);
+	EXPECT_EQ(error_count, 4);
+	EXPECT_EQ(errors[0].statement_index, 0);
+	EXPECT_EQ(errors[1].error.code, ECSACT_EVAL_OK);
+}
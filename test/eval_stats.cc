@@ -0,0 +1,38 @@
+#include "gtest/gtest.h"
+#include "ecsact/interpret/eval.hh"
+#include "ecsact/runtime/meta.hh"
+
+#include "test_lib.hh"
+
+TEST(EvalStats, MultiPkg) {
+	auto stats = ecsact::eval_stats{};
+	auto errs = ecsact_interpret_test_files(
+		{
+			"multi_pkg_main.ecsact",
+			"multi_pkg_a.ecsact",
+			"multi_pkg_b.ecsact",
+			"multi_pkg_c.ecsact",
+		},
+		{.stats = &stats}
+	);
+	ASSERT_EQ(errs.size(), 0) //
+		<< "Expected no errors. Instead got: " << errs[0].error_message << "\n";
+
+	EXPECT_GT(stats.bytes_read, 0);
+	EXPECT_GT(stats.phase_times.total.count(), 0);
+	EXPECT_GE(stats.phase_times.total, stats.phase_times.eval_declarations);
+
+	EXPECT_EQ(stats.statements_parsed[ECSACT_STATEMENT_PACKAGE], 4);
+	EXPECT_EQ(stats.statements_parsed[ECSACT_STATEMENT_IMPORT], 3);
+	EXPECT_EQ(stats.statements_parsed[ECSACT_STATEMENT_COMPONENT], 4);
+	EXPECT_EQ(stats.statements_parsed[ECSACT_STATEMENT_SYSTEM], 2);
+	EXPECT_EQ(stats.statements_parsed[ECSACT_STATEMENT_BUILTIN_TYPE_FIELD], 2);
+
+	EXPECT_EQ(stats.objects_created.packages, 4);
+	EXPECT_EQ(stats.objects_created.components, 4);
+	EXPECT_EQ(stats.objects_created.systems, 2);
+	EXPECT_EQ(stats.objects_created.fields, 2);
+
+	EXPECT_GT(stats.symbol_lookups, 0);
+	EXPECT_LE(stats.symbol_lookup_misses, stats.symbol_lookups);
+}
@@ -2,6 +2,7 @@
 
 #include "ecsact/runtime/meta.hh"
 #include "ecsact/runtime/dynamic.h"
+#include "parse-resolver-runtime/layout.h"
 #include "test_lib.hh"
 
 using ecsact::meta::get_field_type;
@@ -39,6 +40,11 @@ TEST_F(FieldIndexing, SingleFieldIndex) {
 		field_type.type.field_index.composite_id,
 		ecsact_id_cast<ecsact_composite_id>(*example_comp)
 	);
+	EXPECT_EQ(field_type.length, 1);
+	EXPECT_EQ(
+		ecsact_composite_layout_size(ecsact_id_cast<ecsact_composite_id>(*comp)),
+		4
+	);
 }
 
 TEST_F(FieldIndexing, FieldIndexAction) {
@@ -84,6 +90,13 @@ TEST_F(FieldIndexing, MutltiField) {
 		field_y_type.type.field_index.composite_id,
 		ecsact_id_cast<ecsact_composite_id>(*multi_field_comp)
 	);
+	auto other_field = get_field_by_name(*comp, "other_field");
+	ASSERT_TRUE(other_field);
+	auto composite_id = ecsact_id_cast<ecsact_composite_id>(*comp);
+	EXPECT_EQ(ecsact_meta_field_offset(composite_id, *field_x), 0);
+	EXPECT_EQ(ecsact_meta_field_offset(composite_id, *field_y), 4);
+	EXPECT_EQ(ecsact_meta_field_offset(composite_id, *other_field), 8);
+	EXPECT_EQ(ecsact_composite_layout_size(composite_id), 12);
 }
 
 TEST_F(FieldIndexing, MultiFieldSystem) {
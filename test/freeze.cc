@@ -0,0 +1,57 @@
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "ecsact/interpret/eval.hh"
+#include "ecsact/runtime/dynamic.h"
+#include "ecsact/runtime/meta.hh"
+#include "parse-resolver-runtime/freeze.h"
+
+#include "test_lib.hh"
+
+TEST(Freeze, ConcurrentReads) {
+	auto errs = ecsact_interpret_test_files({
+		"multi_pkg_main.ecsact",
+		"multi_pkg_a.ecsact",
+		"multi_pkg_b.ecsact",
+		"multi_pkg_c.ecsact",
+	});
+	ASSERT_EQ(errs.size(), 0) //
+		<< "Expected no errors. Instead got: " << errs[0].error_message << "\n";
+
+	ecsact_freeze_runtime();
+	ASSERT_TRUE(ecsact_is_runtime_frozen());
+
+	auto component_count = std::atomic_int{0};
+	auto threads = std::vector<std::thread>{};
+	for(int i = 0; 8 > i; ++i) {
+		threads.emplace_back([&] {
+			for(auto pkg_id : ecsact::meta::get_package_ids()) {
+				for(auto comp_id : ecsact::meta::get_component_ids(pkg_id)) {
+					auto compo_id = ecsact_id_cast<ecsact_composite_id>(comp_id);
+					for(auto field_id : ecsact::meta::get_field_ids(compo_id)) {
+						ecsact_meta_field_offset(compo_id, field_id);
+					}
+					component_count += 1;
+				}
+			}
+		});
+	}
+	for(auto& thread : threads) {
+		thread.join();
+	}
+	EXPECT_EQ(component_count, 8 * 4);
+
+	EXPECT_THROW(
+		ecsact_create_package(false, "frozen.pkg", 10),
+		std::logic_error
+	);
+	EXPECT_EQ(ecsact_meta_count_packages(), 4);
+
+	ecsact_unfreeze_runtime();
+	EXPECT_FALSE(ecsact_is_runtime_frozen());
+	auto pkg_id = ecsact_create_package(false, "unfrozen.pkg", 12);
+	EXPECT_EQ(ecsact_meta_count_packages(), 5);
+	ecsact_destroy_package(pkg_id);
+}
@@ -0,0 +1,87 @@
+#include <string>
+#include "gtest/gtest.h"
+#include "ecsact/runtime/dynamic.h"
+#include "ecsact/runtime/meta.h"
+#include "parse-resolver-runtime/freeze.h"
+
+#include "test_lib.hh"
+
+class FullNames : public RuntimeContextTest {
+protected:
+	FullNames() : RuntimeContextTest("names.main") {
+	}
+};
+
+TEST_F(FullNames, Declarations) {
+	auto comp_id = ecsact_create_component(pkg_id, "Comp", 4);
+	auto act_id = ecsact_create_action(pkg_id, "Act", 3);
+	auto enum_id = ecsact_create_enum(pkg_id, "Enum", 4);
+	auto unnamed_sys_id = ecsact_create_system(pkg_id, "", 0);
+
+	EXPECT_EQ(decl_full_name(comp_id), "names.main.Comp");
+	EXPECT_EQ(decl_full_name(act_id), "names.main.Act");
+	EXPECT_EQ(decl_full_name(enum_id), "");
+	EXPECT_EQ(decl_full_name(unnamed_sys_id), "");
+}
+
+TEST_F(FullNames, NestedSystems) {
+	auto parent_id = ecsact_create_system(pkg_id, "Parent", 6);
+	auto child_id = ecsact_create_system(pkg_id, "Child", 5);
+	auto grandchild_id = ecsact_create_system(pkg_id, "Grandchild", 10);
+	ecsact_add_child_system(as_system_like(child_id), grandchild_id);
+	EXPECT_EQ(decl_full_name(grandchild_id), "names.main.Child.Grandchild");
+
+	// Moving a system renames everything nested in it
+	ecsact_add_child_system(as_system_like(parent_id), child_id);
+	EXPECT_EQ(decl_full_name(child_id), "names.main.Parent.Child");
+	EXPECT_EQ(
+		decl_full_name(grandchild_id),
+		"names.main.Parent.Child.Grandchild"
+	);
+
+	ecsact_remove_child_system(as_system_like(parent_id), child_id);
+	EXPECT_EQ(decl_full_name(child_id), "names.main.Child");
+	EXPECT_EQ(decl_full_name(grandchild_id), "names.main.Child.Grandchild");
+
+	// An unnamed parent is skipped over
+	auto unnamed_sys_id = ecsact_create_system(pkg_id, "", 0);
+	ecsact_add_child_system(as_system_like(unnamed_sys_id), child_id);
+	EXPECT_EQ(decl_full_name(child_id), "names.main.Child");
+}
+
+TEST_F(FullNames, NamesAreInterned) {
+	auto other_pkg_id = ecsact_create_package(false, "names.other", 11);
+	auto comp_id = ecsact_create_component(pkg_id, "Comp", 4);
+	auto other_comp_id = ecsact_create_component(other_pkg_id, "Comp", 4);
+	auto act_id = ecsact_create_action(pkg_id, "Comp", 4);
+
+	EXPECT_EQ(
+		ecsact_meta_component_name(comp_id),
+		ecsact_meta_component_name(other_comp_id)
+	);
+	EXPECT_EQ(
+		ecsact_meta_component_name(comp_id),
+		ecsact_meta_action_name(act_id)
+	);
+	EXPECT_NE(
+		ecsact_meta_decl_full_name(ecsact_id_cast<ecsact_decl_id>(comp_id)),
+		ecsact_meta_decl_full_name(ecsact_id_cast<ecsact_decl_id>(other_comp_id))
+	);
+
+	// Full names stay valid while the runtime changes
+	auto comp_full_name =
+		ecsact_meta_decl_full_name(ecsact_id_cast<ecsact_decl_id>(comp_id));
+	ecsact_destroy_package(other_pkg_id);
+	ecsact_create_component(pkg_id, "Another", 7);
+	EXPECT_STREQ(comp_full_name, "names.main.Comp");
+}
+
+TEST_F(FullNames, FrozenRuntime) {
+	auto sys_id = ecsact_create_system(pkg_id, "Sys", 3);
+	auto child_id = ecsact_create_system(pkg_id, "Child", 5);
+	ecsact_add_child_system(as_system_like(sys_id), child_id);
+
+	ecsact_freeze_runtime();
+	EXPECT_EQ(decl_full_name(child_id), "names.main.Sys.Child");
+	ecsact_unfreeze_runtime();
+}
@@ -0,0 +1,78 @@
+#include <array>
+#include <string>
+#include <string_view>
+#include "gtest/gtest.h"
+#include "ecsact/interpret/eval.hh"
+#include "ecsact/runtime/meta.hh"
+#include "parse-resolver-runtime/context.h"
+
+using namespace std::string_view_literals;
+
+TEST(InMemorySource, NoErrors) {
+	auto sources = std::array{
+		ecsact::eval_source{
+			.file_path = "in_memory_main.ecsact",
+			.source = "main package in.memory.main;\n"
+								"import in.memory.dep;\n"
+								"component MainComponent { i32 a; }\n"sv,
+		},
+		ecsact::eval_source{
+			.file_path = "in_memory_dep.ecsact",
+			.source = "package in.memory.dep;\n"
+								"component DepComponent { f32 b; }"sv,
+		},
+	};
+
+	auto errs = ecsact::eval_files(sources);
+	ASSERT_EQ(errs.size(), 0) //
+		<< "Expected no errors. Instead got: " << errs[0].error_message << "\n";
+
+	EXPECT_EQ(ecsact_meta_count_packages(), 2);
+
+	for(auto pkg_id : ecsact::meta::get_package_ids()) {
+		auto pkg_name = ecsact::meta::package_name(pkg_id);
+		EXPECT_EQ(ecsact_meta_count_components(pkg_id), 1) //
+			<< "Expected one component in " << pkg_name;
+
+		if(pkg_name == "in.memory.main") {
+			EXPECT_EQ(ecsact_meta_count_dependencies(pkg_id), 1);
+		}
+	}
+}
+
+TEST(InMemorySource, DeepNesting) {
+	// Deeper than the statement stacks keep inline
+	constexpr auto depth = 40;
+
+	auto source = std::string{
+		"package in.memory.deep;\n"
+		"component DeepComponent {\n"
+		"i32 a;\n"
+		"}\n"
+	};
+	for(auto i = 0; depth > i; ++i) {
+		source += "system Nested" + std::to_string(i) + " {\n";
+		source += "readwrite DeepComponent;\n";
+	}
+	for(auto i = 0; depth > i; ++i) {
+		source += "}\n";
+	}
+
+	auto context = ecsact_create_runtime_context();
+	auto sources = std::array{
+		ecsact::eval_source{
+			.file_path = "in_memory_deep.ecsact",
+			.source = source,
+		},
+	};
+	auto errs = ecsact::eval_files(sources, {.context = context});
+	ASSERT_EQ(errs.size(), 0) //
+		<< "Expected no errors. Instead got: " << errs[0].error_message << "\n";
+
+	ecsact_set_thread_runtime_context(context);
+	auto pkg_id = ecsact::meta::get_package_ids().at(0);
+	EXPECT_EQ(ecsact_meta_count_systems(pkg_id), depth);
+	EXPECT_EQ(ecsact_meta_count_top_level_systems(pkg_id), 1);
+	ecsact_set_thread_runtime_context(nullptr);
+	ecsact_destroy_runtime_context(context);
+}
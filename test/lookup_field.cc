@@ -0,0 +1,35 @@
+#include <string>
+#include "gtest/gtest.h"
+#include "ecsact/runtime/dynamic.h"
+#include "parse-resolver-runtime/context.h"
+#include "parse-resolver-runtime/lookup.h"
+
+TEST(LookupField, ManyFields) {
+	auto context = ecsact_create_runtime_context();
+	ecsact_set_thread_runtime_context(context);
+
+	auto pkg_id = ecsact_create_package(true, "lookup.field", 12);
+	auto comp_id = ecsact_id_cast<ecsact_composite_id>(
+		ecsact_create_component(pkg_id, "Wide", 4)
+	);
+
+	auto field_type = ecsact_field_type{.kind = ECSACT_TYPE_KIND_BUILTIN};
+	field_type.type.builtin = ECSACT_I32;
+	for(int i = 0; 200 > i; ++i) {
+		auto name = "f" + std::to_string(i);
+		ecsact_add_field(comp_id, field_type, name.data(), name.size());
+	}
+
+	EXPECT_EQ(ecsact_lookup_field(comp_id, "f0", 2), ecsact_field_id{0});
+	EXPECT_EQ(ecsact_lookup_field(comp_id, "f199", 4), ecsact_field_id{199});
+	EXPECT_EQ(ecsact_lookup_field(comp_id, "f1999", 4), ecsact_field_id{199});
+	EXPECT_EQ(ecsact_lookup_field(comp_id, "f200", 4), ECSACT_INVALID_ID(field));
+
+	// First field with a name wins
+	auto dup_id = ecsact_add_field(comp_id, field_type, "f7", 2);
+	EXPECT_NE(dup_id, ecsact_field_id{7});
+	EXPECT_EQ(ecsact_lookup_field(comp_id, "f7", 2), ecsact_field_id{7});
+
+	ecsact_set_thread_runtime_context(nullptr);
+	ecsact_destroy_runtime_context(context);
+}
@@ -0,0 +1,62 @@
+#include "gtest/gtest.h"
+#include "ecsact/interpret/eval.h"
+#include "ecsact/runtime/meta.hh"
+
+#include "test_lib.hh"
+
+TEST(MultiPkgParallelTest, NoErrors) {
+	auto errs = ecsact_interpret_test_files(
+		{
+			"multi_pkg_main.ecsact",
+			"multi_pkg_a.ecsact",
+			"multi_pkg_b.ecsact",
+			"multi_pkg_c.ecsact",
+		},
+		{.jobs = 4}
+	);
+	EXPECT_EQ(errs.size(), 0) //
+		<< "Expected no errors. Instead got: " << errs[0].error_message << "\n";
+
+	EXPECT_EQ(ecsact_meta_count_packages(), 4);
+
+	auto pkg_ids = ecsact::meta::get_package_ids();
+	for(auto pkg_id : pkg_ids) {
+		auto pkg_name = ecsact::meta::package_name(pkg_id);
+
+		if(pkg_name == "example.multipkg") {
+			EXPECT_EQ(ecsact_meta_count_dependencies(pkg_id), 3) //
+				<< "Expected main package to have 3 dependencies. One for each import";
+		} else {
+			EXPECT_EQ(ecsact_meta_count_components(pkg_id), 1) //
+				<< "Expected one component in " << pkg_name;
+		}
+	}
+}
+
+TEST(MultiPkgParallelTest, Pipelined) {
+	auto context = ecsact_create_runtime_context();
+	auto errs = ecsact_interpret_test_files(
+		{
+			"multi_pkg_main.ecsact",
+			"multi_pkg_a.ecsact",
+			"multi_pkg_b.ecsact",
+			"multi_pkg_c.ecsact",
+		},
+		{.jobs = 3, .pipeline_depth = 2, .context = context}
+	);
+	EXPECT_EQ(errs.size(), 0) //
+		<< "Expected no errors. Instead got: " << errs[0].error_message << "\n";
+
+	ecsact_set_thread_runtime_context(context);
+	EXPECT_EQ(ecsact_meta_count_packages(), 4);
+	for(auto pkg_id : ecsact::meta::get_package_ids()) {
+		if(ecsact::meta::package_name(pkg_id) == "example.multipkg") {
+			EXPECT_EQ(ecsact_meta_count_dependencies(pkg_id), 3);
+		} else {
+			EXPECT_EQ(ecsact_meta_count_components(pkg_id), 1);
+		}
+	}
+
+	ecsact_set_thread_runtime_context(nullptr);
+	ecsact_destroy_runtime_context(context);
+}
@@ -0,0 +1,257 @@
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+#include "gtest/gtest.h"
+#include "ecsact/interpret/eval.hh"
+#include "ecsact/runtime/dynamic.h"
+#include "ecsact/runtime/meta.hh"
+#include "parse-resolver-runtime/context.h"
+#include "parse-resolver-runtime/fingerprint.h"
+
+using namespace std::string_view_literals;
+
+static const auto dep_source = //
+	"package fingerprint.dep;\n"
+	"component Shared { i32 value; }\n"sv;
+
+static const auto main_source = //
+	"main package fingerprint.main;\n"
+	"import fingerprint.dep;\n"
+	"component Position { i32 x; i32 y; }\n"
+	"action Move { i32 dx; readwrite Position; }\n"
+	"system Tick { readwrite Position; readonly fingerprint.dep.Shared; }\n"sv;
+
+static const auto reformatted_main_source = //
+	"main package fingerprint.main;\n"
+	"\n"
+	"import fingerprint.dep;\n"
+	"\n"
+	"// Where things are\n"
+	"component Position {\n"
+	"\ti32 x;\n"
+	"\ti32 y;\n"
+	"}\n"
+	"\n"
+	"action Move {\n"
+	"\ti32 dx;\n"
+	"\treadwrite Position;\n"
+	"}\n"
+	"\n"
+	"system Tick {\n"
+	"\treadwrite Position;\n"
+	"\treadonly fingerprint.dep.Shared;\n"
+	"}\n"sv;
+
+static const auto changed_main_source = //
+	"main package fingerprint.main;\n"
+	"import fingerprint.dep;\n"
+	"component Position { i32 x; i32 y; i32 z; }\n"
+	"action Move { i32 dx; readwrite Position; }\n"
+	"system Tick { readwrite Position; readonly fingerprint.dep.Shared; }\n"sv;
+
+class PackageFingerprint : public testing::Test {
+protected:
+	std::vector<ecsact_runtime_context*> contexts;
+
+	void TearDown() override {
+		ecsact_set_thread_runtime_context(nullptr);
+		for(auto context : contexts) {
+			ecsact_destroy_runtime_context(context);
+		}
+	}
+
+	/**
+	 * Evaluates @p sources into a new context and returns the fingerprint of
+	 * the package named @p package_name
+	 */
+	auto eval_fingerprint(
+		std::vector<ecsact::eval_source> sources,
+		std::string_view                 package_name
+	) -> uint64_t {
+		auto context = contexts.emplace_back(ecsact_create_runtime_context());
+		auto errs = ecsact::eval_files(sources, {.context = context});
+		EXPECT_EQ(errs.size(), 0) //
+			<< "Expected no errors. Instead got: " << errs[0].error_message;
+
+		ecsact_set_thread_runtime_context(context);
+		for(auto pkg_id : ecsact::meta::get_package_ids()) {
+			if(ecsact::meta::package_name(pkg_id) == package_name) {
+				return ecsact_package_fingerprint(pkg_id);
+			}
+		}
+
+		ADD_FAILURE() << package_name << " was not evaluated";
+		return 0;
+	}
+};
+
+TEST_F(PackageFingerprint, WhitespaceAndComments) {
+	auto fingerprint = eval_fingerprint(
+		{
+			{.file_path = "main.ecsact", .source = main_source},
+			{.file_path = "dep.ecsact", .source = dep_source},
+		},
+		"fingerprint.main"
+	);
+
+	// An unrelated package evaluated first changes every ID
+	auto reformatted_fingerprint = eval_fingerprint(
+		{
+			{
+				.file_path = "other.ecsact",
+				.source = "package fingerprint.other;\n"
+									"component Other { i32 a; }\n",
+			},
+			{.file_path = "dep.ecsact", .source = dep_source},
+			{.file_path = "main.ecsact", .source = reformatted_main_source},
+		},
+		"fingerprint.main"
+	);
+
+	EXPECT_EQ(fingerprint, reformatted_fingerprint);
+}
+
+TEST_F(PackageFingerprint, ChangedDeclarations) {
+	auto sources = std::vector<ecsact::eval_source>{
+		{.file_path = "main.ecsact", .source = main_source},
+		{.file_path = "dep.ecsact", .source = dep_source},
+	};
+	auto fingerprint = eval_fingerprint(sources, "fingerprint.main");
+	auto dep_fingerprint = eval_fingerprint(sources, "fingerprint.dep");
+
+	sources[0].source = changed_main_source;
+	EXPECT_NE(eval_fingerprint(sources, "fingerprint.main"), fingerprint);
+	EXPECT_EQ(eval_fingerprint(sources, "fingerprint.dep"), dep_fingerprint);
+}
+
+TEST_F(PackageFingerprint, UndoneChanges) {
+	auto context = contexts.emplace_back(ecsact_create_runtime_context());
+	ecsact_set_thread_runtime_context(context);
+
+	auto pkg_id = ecsact_create_package(true, "fingerprint.runtime", 19);
+	auto comp_id = ecsact_create_component(pkg_id, "Comp", 4);
+	auto comp_like_id = ecsact_id_cast<ecsact_component_like_id>(comp_id);
+	auto field_type = ecsact_field_type{.kind = ECSACT_TYPE_KIND_BUILTIN};
+	field_type.type.builtin = ECSACT_I32;
+	auto field_id = ecsact_add_field(
+		ecsact_id_cast<ecsact_composite_id>(comp_id),
+		field_type,
+		"a",
+		1
+	);
+	auto sys_id = ecsact_create_system(pkg_id, "Sys", 3);
+	auto sys_like_id = ecsact_id_cast<ecsact_system_like_id>(sys_id);
+	auto child_id = ecsact_create_system(pkg_id, "Child", 5);
+
+	auto fingerprint = ecsact_package_fingerprint(pkg_id);
+	auto expect_changed_then_undone = [&](auto change, auto undo) {
+		change();
+		EXPECT_NE(ecsact_package_fingerprint(pkg_id), fingerprint);
+		undo();
+		EXPECT_EQ(ecsact_package_fingerprint(pkg_id), fingerprint);
+	};
+
+	expect_changed_then_undone(
+		[&] {
+			ecsact_set_system_capability(
+				sys_like_id,
+				comp_like_id,
+				ECSACT_SYS_CAP_READONLY
+			);
+			ecsact_set_system_capability(
+				sys_like_id,
+				comp_like_id,
+				ECSACT_SYS_CAP_READWRITE
+			);
+		},
+		[&] { ecsact_unset_system_capability(sys_like_id, comp_like_id); }
+	);
+
+	expect_changed_then_undone(
+		[&] {
+			ecsact_set_system_notify_component_setting(
+				sys_like_id,
+				comp_like_id,
+				ECSACT_SYS_NOTIFY_ONCHANGE
+			);
+		},
+		[&] {
+			ecsact_set_system_notify_component_setting(
+				sys_like_id,
+				comp_like_id,
+				ECSACT_SYS_NOTIFY_NONE
+			);
+		}
+	);
+
+	expect_changed_then_undone(
+		[&] { ecsact_set_system_lazy_iteration_rate(sys_id, 4); },
+		[&] { ecsact_set_system_lazy_iteration_rate(sys_id, 0); }
+	);
+
+	expect_changed_then_undone(
+		[&] {
+			ecsact_set_system_parallel_execution(
+				sys_like_id,
+				ECSACT_PAR_EXEC_DENY
+			);
+		},
+		[&] {
+			ecsact_set_system_parallel_execution(
+				sys_like_id,
+				ECSACT_PAR_EXEC_AUTO
+			);
+		}
+	);
+
+	expect_changed_then_undone(
+		[&] {
+			ecsact_set_component_type(comp_id, ECSACT_COMPONENT_TYPE_STREAM);
+		},
+		[&] { ecsact_set_component_type(comp_id, ECSACT_COMPONENT_TYPE_NONE); }
+	);
+
+	auto gen_id = ecsact_system_generates_id{};
+	expect_changed_then_undone(
+		[&] {
+			gen_id = ecsact_add_system_generates(sys_like_id);
+			ecsact_system_generates_set_component(
+				sys_like_id,
+				gen_id,
+				comp_id,
+				ECSACT_SYS_GEN_REQUIRED
+			);
+		},
+		[&] { ecsact_remove_system_generates(sys_like_id, gen_id); }
+	);
+
+	auto assoc_id = ecsact_system_assoc_id{};
+	expect_changed_then_undone(
+		[&] {
+			assoc_id = ecsact_add_system_assoc(sys_like_id, comp_like_id);
+			ecsact_add_system_assoc_field(sys_like_id, assoc_id, field_id);
+			ecsact_set_system_assoc_capability(
+				sys_like_id,
+				assoc_id,
+				comp_like_id,
+				ECSACT_SYS_CAP_READWRITE
+			);
+		},
+		[&] { ecsact_remove_system_assoc(sys_like_id, assoc_id); }
+	);
+
+	expect_changed_then_undone(
+		[&] { ecsact_add_child_system(sys_like_id, child_id); },
+		[&] { ecsact_remove_child_system(sys_like_id, child_id); }
+	);
+}
+
+TEST_F(PackageFingerprint, InvalidPackage) {
+	auto context = contexts.emplace_back(ecsact_create_runtime_context());
+	ecsact_set_thread_runtime_context(context);
+
+	EXPECT_THROW(
+		ecsact_package_fingerprint(static_cast<ecsact_package_id>(1234)),
+		std::out_of_range
+	);
+}
@@ -0,0 +1,83 @@
+#include <array>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "ecsact/interpret/eval.hh"
+#include "ecsact/runtime/meta.hh"
+#include "ecsact/runtime/dynamic.h"
+#include "parse-resolver-runtime/context.h"
+
+using namespace std::string_view_literals;
+
+TEST(RuntimeContext, IndependentContexts) {
+	constexpr auto context_count = 4;
+
+	auto contexts = std::array<ecsact_runtime_context*, context_count>{};
+	auto sources = std::array<std::string, context_count>{};
+	for(int i = 0; context_count > i; ++i) {
+		contexts[i] = ecsact_create_runtime_context();
+		sources[i] = "main package ctx.test;\n";
+		for(int c = 0; i >= c; ++c) {
+			sources[i] += "component Comp" + std::to_string(c) + " { i32 v; }\n";
+		}
+	}
+
+	auto error_counts = std::array<std::size_t, context_count>{};
+	auto threads = std::vector<std::thread>{};
+	for(int i = 0; context_count > i; ++i) {
+		threads.emplace_back([&, i] {
+			auto eval_source = ecsact::eval_source{
+				.file_path = "ctx_test.ecsact",
+				.source = sources[i],
+			};
+			auto errs = ecsact::eval_files(
+				std::span{&eval_source, 1},
+				{.context = contexts[i]}
+			);
+			error_counts[i] = errs.size();
+		});
+	}
+	for(auto& thread : threads) {
+		thread.join();
+	}
+
+	// Nothing was evaluated into the default context
+	EXPECT_EQ(ecsact_meta_count_packages(), 0);
+
+	for(int i = 0; context_count > i; ++i) {
+		EXPECT_EQ(error_counts[i], 0);
+
+		ecsact_set_thread_runtime_context(contexts[i]);
+		ASSERT_EQ(ecsact_meta_count_packages(), 1);
+		EXPECT_EQ(ecsact_meta_count_components(ecsact_meta_main_package()), i + 1);
+		ecsact_set_thread_runtime_context(nullptr);
+
+		ecsact_destroy_runtime_context(contexts[i]);
+	}
+}
+
+TEST(RuntimeContext, Reset) {
+	auto context = ecsact_create_runtime_context();
+	ecsact_set_thread_runtime_context(context);
+
+	auto first_pkg_id = ecsact_create_package(true, "reset.test", 10);
+	auto first_comp_id = ecsact_create_component(first_pkg_id, "Comp", 4);
+	ecsact_create_system(first_pkg_id, "Sys", 3);
+
+	for(int i = 0; 3 > i; ++i) {
+		ecsact_reset_runtime();
+		EXPECT_EQ(ecsact_meta_count_packages(), 0);
+
+		// IDs start over so reloading doesn't run out of them
+		auto pkg_id = ecsact_create_package(true, "reset.test", 10);
+		EXPECT_EQ(pkg_id, first_pkg_id);
+		EXPECT_EQ(ecsact_create_component(pkg_id, "Comp", 4), first_comp_id);
+		EXPECT_EQ(ecsact_meta_count_components(pkg_id), 1);
+	}
+
+	ecsact_set_thread_runtime_context(nullptr);
+	ecsact_destroy_runtime_context(context);
+}
@@ -0,0 +1,342 @@
+#include <stdexcept>
+#include <vector>
+#include "gtest/gtest.h"
+#include "ecsact/runtime/dynamic.h"
+#include "ecsact/runtime/meta.hh"
+#include "parse-resolver-runtime/export.h"
+#include "parse-resolver-runtime/layout.h"
+#include "parse-resolver-runtime/views.hh"
+
+#include "test_lib.hh"
+
+namespace views = ecsact::interpret::views;
+
+class RuntimeExport : public RuntimeContextTest {
+protected:
+	ecsact_component_id comp_id = {};
+	ecsact_component_id other_id = {};
+	ecsact_transient_id trans_id = {};
+	ecsact_action_id    act_id = {};
+	ecsact_system_id    sys_id = {};
+	ecsact_system_id    child_id = {};
+
+	RuntimeExport() : RuntimeContextTest("export.main") {
+	}
+
+	void SetUp() override {
+		RuntimeContextTest::SetUp();
+
+		comp_id = ecsact_create_component(pkg_id, "Comp", 4);
+		other_id = ecsact_create_component(pkg_id, "Other", 5);
+		trans_id = ecsact_create_transient(pkg_id, "Trans", 5);
+		act_id = ecsact_create_action(pkg_id, "Act", 3);
+		sys_id = ecsact_create_system(pkg_id, "Sys", 3);
+		child_id = ecsact_create_system(pkg_id, "Child", 5);
+
+		auto comp = as_composite(comp_id);
+		auto i32_type = builtin_field_type(ECSACT_I32);
+		auto entity_type = builtin_field_type(ECSACT_ENTITY_TYPE);
+		ecsact_add_field(comp, builtin_field_type(ECSACT_U8), "a", 1);
+		ecsact_add_field(comp, i32_type, "b", 1);
+		auto target_id = ecsact_add_field(comp, entity_type, "target", 6);
+		auto i16_type = builtin_field_type(ECSACT_I16);
+		ecsact_add_field(as_composite(trans_id), i16_type, "t", 1);
+		ecsact_add_field(as_composite(act_id), i32_type, "x", 1);
+
+		auto sys_like_id = as_system_like(sys_id);
+		auto comp_like_id = as_comp_like(comp_id);
+		auto other_like_id = as_comp_like(other_id);
+		ecsact_add_child_system(sys_like_id, child_id);
+		ecsact_set_system_capability(
+			sys_like_id,
+			comp_like_id,
+			ECSACT_SYS_CAP_READWRITE
+		);
+		ecsact_set_system_capability(
+			as_system_like(child_id),
+			comp_like_id,
+			ECSACT_SYS_CAP_READONLY
+		);
+		ecsact_set_system_capability(
+			as_system_like(act_id),
+			other_like_id,
+			ECSACT_SYS_CAP_ADDS
+		);
+
+		auto gen_id = ecsact_add_system_generates(sys_like_id);
+		ecsact_system_generates_set_component(
+			sys_like_id,
+			gen_id,
+			other_id,
+			ECSACT_SYS_GEN_REQUIRED
+		);
+
+		auto assoc_id = ecsact_add_system_assoc(sys_like_id, comp_like_id);
+		ecsact_add_system_assoc_field(sys_like_id, assoc_id, target_id);
+		ecsact_set_system_assoc_capability(
+			sys_like_id,
+			assoc_id,
+			other_like_id,
+			ECSACT_SYS_CAP_READONLY
+		);
+	}
+};
+
+TEST_F(RuntimeExport, Composites) {
+	auto count = int32_t{};
+	ecsact_export_package_composites(pkg_id, 0, {}, &count);
+	ASSERT_EQ(count, 4);
+
+	auto ids = std::vector<ecsact_composite_id>(count);
+	auto first_field_rows = std::vector<int32_t>(count);
+	auto field_counts = std::vector<int32_t>(count);
+	auto sizes = std::vector<int32_t>(count);
+	auto alignments = std::vector<int32_t>(count);
+	ecsact_export_package_composites(
+		pkg_id,
+		count,
+		{
+			.composite_ids = ids.data(),
+			.first_field_rows = first_field_rows.data(),
+			.field_counts = field_counts.data(),
+			.sizes = sizes.data(),
+			.alignments = alignments.data(),
+		},
+		nullptr
+	);
+
+	EXPECT_EQ(
+		ids,
+		(std::vector{
+			as_composite(comp_id),
+			as_composite(other_id),
+			as_composite(trans_id),
+			as_composite(act_id),
+		})
+	);
+	EXPECT_EQ(first_field_rows, (std::vector{0, 3, 3, 4}));
+	EXPECT_EQ(field_counts, (std::vector{3, 0, 1, 1}));
+	for(auto i = 0; count > i; ++i) {
+		EXPECT_EQ(sizes[i], ecsact_composite_layout_size(ids[i]));
+		EXPECT_EQ(alignments[i], ecsact_composite_layout_alignment(ids[i]));
+	}
+}
+
+TEST_F(RuntimeExport, FieldsMatchMeta) {
+	auto count = int32_t{};
+	ecsact_export_package_fields(pkg_id, 0, {}, &count);
+	ASSERT_EQ(count, 5);
+
+	auto composite_ids = std::vector<ecsact_composite_id>(count);
+	auto field_ids = std::vector<ecsact_field_id>(count);
+	auto names = std::vector<const char*>(count);
+	auto types = std::vector<ecsact_field_type>(count);
+	auto offsets = std::vector<int32_t>(count);
+	ecsact_export_package_fields(
+		pkg_id,
+		count,
+		{
+			.composite_ids = composite_ids.data(),
+			.field_ids = field_ids.data(),
+			.names = names.data(),
+			.types = types.data(),
+			.offsets = offsets.data(),
+		},
+		nullptr
+	);
+
+	auto row = 0;
+	auto composites = std::vector{
+		as_composite(comp_id),
+		as_composite(trans_id),
+		as_composite(act_id),
+	};
+	for(auto composite_id : composites) {
+		for(auto field_id : ecsact::meta::get_field_ids(composite_id)) {
+			ASSERT_GT(count, row);
+			EXPECT_EQ(composite_ids[row], composite_id);
+			EXPECT_EQ(field_ids[row], field_id);
+			EXPECT_STREQ(
+				names[row],
+				ecsact_meta_field_name(composite_id, field_id)
+			);
+			EXPECT_EQ(
+				types[row].type.builtin,
+				ecsact_meta_field_type(composite_id, field_id).type.builtin
+			);
+			EXPECT_EQ(
+				offsets[row],
+				ecsact_meta_field_offset(composite_id, field_id)
+			);
+			row += 1;
+		}
+	}
+	EXPECT_EQ(row, count);
+}
+
+TEST_F(RuntimeExport, SystemLikes) {
+	auto count = int32_t{};
+	ecsact_export_package_system_likes(pkg_id, 0, {}, &count);
+	ASSERT_EQ(count, 3);
+
+	auto ids = std::vector<ecsact_system_like_id>(count);
+	auto first_capability_rows = std::vector<int32_t>(count);
+	auto capability_counts = std::vector<int32_t>(count);
+	auto first_generates_rows = std::vector<int32_t>(count);
+	auto generates_counts = std::vector<int32_t>(count);
+	auto first_assoc_rows = std::vector<int32_t>(count);
+	auto assoc_counts = std::vector<int32_t>(count);
+	ecsact_export_package_system_likes(
+		pkg_id,
+		count,
+		{
+			.system_ids = ids.data(),
+			.first_capability_rows = first_capability_rows.data(),
+			.capability_counts = capability_counts.data(),
+			.first_generates_rows = first_generates_rows.data(),
+			.generates_counts = generates_counts.data(),
+			.first_assoc_rows = first_assoc_rows.data(),
+			.assoc_counts = assoc_counts.data(),
+		},
+		nullptr
+	);
+
+	EXPECT_EQ(
+		ids,
+		(std::vector{
+			as_system_like(sys_id),
+			as_system_like(child_id),
+			as_system_like(act_id),
+		})
+	);
+	EXPECT_EQ(first_capability_rows, (std::vector{0, 1, 2}));
+	EXPECT_EQ(capability_counts, (std::vector{1, 1, 1}));
+	EXPECT_EQ(first_generates_rows, (std::vector{0, 1, 1}));
+	EXPECT_EQ(generates_counts, (std::vector{1, 0, 0}));
+	EXPECT_EQ(first_assoc_rows, (std::vector{0, 1, 1}));
+	EXPECT_EQ(assoc_counts, (std::vector{1, 0, 0}));
+
+	auto system_ids = std::vector<ecsact_system_like_id>(3);
+	auto capabilities = std::vector<ecsact_system_capability>(3);
+	ecsact_export_package_capabilities(
+		pkg_id,
+		3,
+		{.system_ids = system_ids.data(), .capabilities = capabilities.data()},
+		&count
+	);
+	EXPECT_EQ(count, 3);
+	EXPECT_EQ(system_ids, ids);
+	EXPECT_EQ(
+		capabilities,
+		(std::vector{
+			ECSACT_SYS_CAP_READWRITE,
+			ECSACT_SYS_CAP_READONLY,
+			ECSACT_SYS_CAP_ADDS,
+		})
+	);
+
+	auto generates_component_id = ecsact_component_id{};
+	auto generate_flag = ecsact_system_generate{};
+	ecsact_export_package_generates(
+		pkg_id,
+		1,
+		{
+			.component_ids = &generates_component_id,
+			.generate_flags = &generate_flag,
+		},
+		&count
+	);
+	EXPECT_EQ(count, 1);
+	EXPECT_EQ(generates_component_id, other_id);
+	EXPECT_EQ(generate_flag, ECSACT_SYS_GEN_REQUIRED);
+}
+
+TEST_F(RuntimeExport, Assocs) {
+	auto sys_like_id = as_system_like(sys_id);
+	auto assoc_ids = views::system_assoc_ids(sys_like_id);
+	ASSERT_EQ(assoc_ids.size(), 1);
+
+	auto count = int32_t{};
+	auto system_id = ecsact_system_like_id{};
+	auto assoc_id = ecsact_system_assoc_id{};
+	auto component_id = ecsact_component_like_id{};
+	auto field_count = int32_t{};
+	auto capability_count = int32_t{};
+	ecsact_export_package_assocs(
+		pkg_id,
+		1,
+		{
+			.system_ids = &system_id,
+			.assoc_ids = &assoc_id,
+			.component_ids = &component_id,
+			.field_counts = &field_count,
+			.capability_counts = &capability_count,
+		},
+		&count
+	);
+	EXPECT_EQ(count, 1);
+	EXPECT_EQ(system_id, sys_like_id);
+	EXPECT_EQ(assoc_id, assoc_ids[0]);
+	EXPECT_EQ(component_id, as_comp_like(comp_id));
+	EXPECT_EQ(field_count, 1);
+	EXPECT_EQ(capability_count, 1);
+
+	auto field_assoc_id = ecsact_system_assoc_id{};
+	auto field_id = ecsact_field_id{};
+	ecsact_export_package_assoc_fields(
+		pkg_id,
+		1,
+		{.assoc_ids = &field_assoc_id, .field_ids = &field_id},
+		&count
+	);
+	EXPECT_EQ(count, 1);
+	EXPECT_EQ(field_assoc_id, assoc_id);
+	EXPECT_EQ(field_id, views::system_assoc_fields(sys_like_id, assoc_id)[0]);
+
+	auto cap_component_id = ecsact_component_like_id{};
+	auto capability = ecsact_system_capability{};
+	ecsact_export_package_assoc_capabilities(
+		pkg_id,
+		1,
+		{.component_ids = &cap_component_id, .capabilities = &capability},
+		&count
+	);
+	EXPECT_EQ(count, 1);
+	EXPECT_EQ(
+		cap_component_id,
+		as_comp_like(other_id)
+	);
+	EXPECT_EQ(capability, ECSACT_SYS_CAP_READONLY);
+}
+
+TEST_F(RuntimeExport, MaxCount) {
+	// Only the first rows are written but ranges and the count cover every row
+	auto field_counts = std::vector<int32_t>(4, -1);
+	auto first_field_rows = std::vector<int32_t>(4, -1);
+	auto count = int32_t{};
+	ecsact_export_package_composites(
+		pkg_id,
+		3,
+		{
+			.first_field_rows = first_field_rows.data(),
+			.field_counts = field_counts.data(),
+		},
+		&count
+	);
+	EXPECT_EQ(count, 4);
+	EXPECT_EQ(first_field_rows, (std::vector{0, 3, 3, -1}));
+	EXPECT_EQ(field_counts, (std::vector{3, 0, 1, -1}));
+}
+
+TEST_F(RuntimeExport, InvalidPackage) {
+	auto count = int32_t{};
+	EXPECT_THROW(
+		ecsact_export_package_fields(
+			ecsact_id_cast<ecsact_package_id>(comp_id),
+			0,
+			{},
+			&count
+		),
+		std::out_of_range
+	);
+}
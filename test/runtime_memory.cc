@@ -0,0 +1,157 @@
+#include <stdexcept>
+#include <string>
+#include "gtest/gtest.h"
+#include "ecsact/runtime/dynamic.h"
+#include "parse-resolver-runtime/memory.h"
+
+#include "test_lib.hh"
+
+class RuntimeMemory : public RuntimeContextTest {
+protected:
+	RuntimeMemory() : RuntimeContextTest("memory.main") {
+	}
+
+	static auto table(
+		const ecsact_runtime_memory_usage& usage,
+		ecsact_runtime_memory_table        table
+	) -> ecsact_runtime_memory_entry {
+		return usage.tables[table];
+	}
+};
+
+TEST_F(RuntimeMemory, RuntimeAndPackage) {
+	auto other_pkg_id = ecsact_create_package(false, "memory.other", 12);
+	ecsact_create_component(other_pkg_id, "Other", 5);
+
+	auto comp_id = ecsact_create_component(pkg_id, "Comp", 4);
+	auto i32_type = builtin_field_type(ECSACT_I32);
+	ecsact_add_field(as_composite(comp_id), i32_type, "a", 1);
+	ecsact_add_field(as_composite(comp_id), i32_type, "b", 1);
+	auto sys_id = ecsact_create_system(pkg_id, "Sys", 3);
+	ecsact_set_system_capability(
+		as_system_like(sys_id),
+		as_comp_like(comp_id),
+		ECSACT_SYS_CAP_READWRITE
+	);
+
+	auto runtime_usage = ecsact_runtime_memory_usage{};
+	ecsact_get_runtime_memory_usage(&runtime_usage);
+	auto package_usage = ecsact_runtime_memory_usage{};
+	ecsact_get_package_memory_usage(pkg_id, &package_usage);
+
+	EXPECT_EQ(table(runtime_usage, ECSACT_MEMORY_TABLE_PACKAGES).count, 2);
+	EXPECT_EQ(table(runtime_usage, ECSACT_MEMORY_TABLE_COMPONENTS).count, 2);
+	EXPECT_EQ(table(package_usage, ECSACT_MEMORY_TABLE_PACKAGES).count, 1);
+	EXPECT_EQ(table(package_usage, ECSACT_MEMORY_TABLE_COMPONENTS).count, 1);
+
+	for(auto& usage : {runtime_usage, package_usage}) {
+		EXPECT_EQ(table(usage, ECSACT_MEMORY_TABLE_FIELDS).count, 2);
+		EXPECT_EQ(table(usage, ECSACT_MEMORY_TABLE_SYSTEMS).count, 1);
+		EXPECT_EQ(table(usage, ECSACT_MEMORY_TABLE_CAPABILITIES).count, 1);
+		EXPECT_GT(table(usage, ECSACT_MEMORY_TABLE_CAPABILITIES).bytes, 0);
+		EXPECT_GT(usage.total_bytes, 0);
+	}
+
+	EXPECT_LE(package_usage.total_bytes, runtime_usage.total_bytes);
+}
+
+TEST_F(RuntimeMemory, TotalIsSumOfTables) {
+	ecsact_create_enum(pkg_id, "Enum", 4);
+
+	auto usage = ecsact_runtime_memory_usage{};
+	ecsact_get_runtime_memory_usage(&usage);
+
+	auto total = int64_t{};
+	for(auto entry : usage.tables) {
+		EXPECT_GE(entry.count, 0);
+		EXPECT_GE(entry.bytes, 0);
+		total += entry.bytes;
+	}
+	EXPECT_EQ(usage.total_bytes, total);
+	EXPECT_EQ(table(usage, ECSACT_MEMORY_TABLE_ENUMS).count, 1);
+}
+
+TEST_F(RuntimeMemory, InvalidPackage) {
+	auto usage = ecsact_runtime_memory_usage{};
+	EXPECT_THROW(
+		ecsact_get_package_memory_usage(static_cast<ecsact_package_id>(-5), &usage),
+		std::out_of_range
+	);
+
+	auto comp_id = ecsact_create_component(pkg_id, "Comp", 4);
+	EXPECT_THROW(
+		ecsact_get_package_memory_usage(
+			ecsact_id_cast<ecsact_package_id>(comp_id),
+			&usage
+		),
+		std::out_of_range
+	);
+}
+
+/**
+ * Creates a package with a renamed copy of every kind of declaration, reads
+ * their full names and destroys it again, like reloading a renamed file
+ */
+static auto reload_renamed(ecsact_package_id dependency, int revision) -> void {
+	auto suffix = std::to_string(revision);
+	auto create = [&](auto create_fn, auto parent, std::string name) {
+		name += suffix;
+		return create_fn(parent, name.c_str(), static_cast<int32_t>(name.size()));
+	};
+
+	auto pkg_name = "memory.renamed" + suffix;
+	auto pkg_id = ecsact_create_package(
+		false,
+		pkg_name.c_str(),
+		static_cast<int32_t>(pkg_name.size())
+	);
+	ecsact_add_dependency(pkg_id, dependency);
+
+	auto comp_id = create(ecsact_create_component, pkg_id, "Comp");
+	auto field_name = "field" + suffix;
+	ecsact_add_field(
+		as_composite(comp_id),
+		builtin_field_type(ECSACT_I32),
+		field_name.c_str(),
+		static_cast<int32_t>(field_name.size())
+	);
+	auto sys_id = create(ecsact_create_system, pkg_id, "Sys");
+	auto nested_id = create(ecsact_create_system, pkg_id, "Nested");
+	ecsact_add_child_system(as_system_like(sys_id), nested_id);
+	auto enum_id = create(ecsact_create_enum, pkg_id, "Enum");
+	auto value_name = "VALUE" + suffix;
+	ecsact_add_enum_value(
+		enum_id,
+		0,
+		value_name.c_str(),
+		static_cast<int32_t>(value_name.size())
+	);
+
+	EXPECT_EQ(
+		decl_full_name(nested_id),
+		pkg_name + ".Sys" + suffix + ".Nested" + suffix
+	);
+	decl_full_name(comp_id);
+	decl_full_name(enum_id);
+
+	ecsact_destroy_package(pkg_id);
+}
+
+TEST_F(RuntimeMemory, RenamedReloadsDontGrowNames) {
+	constexpr auto reloads = 500;
+
+	auto names_after = [&](int first_revision) {
+		auto last_revision = first_revision + reloads;
+		for(auto revision = first_revision; last_revision > revision; ++revision) {
+			reload_renamed(pkg_id, revision);
+		}
+		auto usage = ecsact_runtime_memory_usage{};
+		ecsact_get_runtime_memory_usage(&usage);
+		return table(usage, ECSACT_MEMORY_TABLE_NAMES);
+	};
+
+	auto warmed_up = names_after(0);
+	auto reloaded = names_after(reloads);
+	EXPECT_EQ(reloaded.count, warmed_up.count);
+	EXPECT_EQ(reloaded.bytes, warmed_up.bytes);
+}
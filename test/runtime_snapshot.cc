@@ -0,0 +1,253 @@
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "ecsact/runtime/dynamic.h"
+#include "ecsact/runtime/meta.hh"
+#include "parse-resolver-runtime/snapshot.h"
+
+#include "test_lib.hh"
+
+static auto save_snapshot(uint64_t source_hash) -> std::vector<char> {
+	auto size = int32_t{};
+	ecsact_save_runtime_snapshot(source_hash, 0, nullptr, &size);
+
+	auto snapshot = std::vector<char>(size);
+	ecsact_save_runtime_snapshot(source_hash, size, snapshot.data(), &size);
+	EXPECT_EQ(size, static_cast<int32_t>(snapshot.size()));
+	return snapshot;
+}
+
+/**
+ * Snapshots are saved from the fixture's context and loaded into
+ * `loaded_context`
+ */
+class RuntimeSnapshot : public RuntimeContextTest {
+protected:
+	ecsact_runtime_context* loaded_context = nullptr;
+
+	ecsact_package_id   dep_pkg_id = {};
+	ecsact_enum_id      enum_id = {};
+	ecsact_component_id comp_id = {};
+	ecsact_component_id stream_comp_id = {};
+	ecsact_component_id assoc_comp_id = {};
+	ecsact_action_id    act_id = {};
+	ecsact_system_id    sys_id = {};
+	ecsact_system_id    nested_sys_id = {};
+
+	void SetUp() override {
+		RuntimeContextTest::SetUp();
+		loaded_context = ecsact_create_runtime_context();
+
+		dep_pkg_id = ecsact_create_package(false, "snap.dep", 8);
+		pkg_id = ecsact_create_package(true, "snap.main", 9);
+		ecsact_set_package_source_file_path(pkg_id, "snap.ecsact", 11);
+		ecsact_add_dependency(pkg_id, dep_pkg_id);
+
+		enum_id = ecsact_create_enum(dep_pkg_id, "Color", 5);
+		ecsact_add_enum_value(enum_id, 1, "Red", 3);
+		ecsact_add_enum_value(enum_id, 300, "Blue", 4);
+
+		comp_id = ecsact_create_component(pkg_id, "Comp", 4);
+		auto color = ecsact_field_type{.kind = ECSACT_TYPE_KIND_ENUM};
+		color.type.enum_id = enum_id;
+		ecsact_add_field(as_composite(comp_id), color, "color", 5);
+		auto num = builtin_field_type(ECSACT_I32, 4);
+		ecsact_add_field(as_composite(comp_id), num, "nums", 4);
+
+		stream_comp_id = ecsact_create_component(pkg_id, "Stream", 6);
+		ecsact_set_component_type(stream_comp_id, ECSACT_COMPONENT_TYPE_STREAM);
+
+		assoc_comp_id = ecsact_create_component(pkg_id, "AssocComp", 9);
+		auto index = ecsact_field_type{.kind = ECSACT_TYPE_KIND_FIELD_INDEX};
+		index.type.field_index.composite_id = as_composite(comp_id);
+		index.type.field_index.field_id = static_cast<ecsact_field_id>(1);
+		auto index_field_id =
+			ecsact_add_field(as_composite(assoc_comp_id), index, "target", 6);
+
+		act_id = ecsact_create_action(pkg_id, "Act", 3);
+		ecsact_add_field(as_composite(act_id), num, "value", 5);
+		ecsact_set_system_capability(
+			as_system_like(act_id),
+			as_comp_like(comp_id),
+			ECSACT_SYS_CAP_READONLY
+		);
+
+		sys_id = ecsact_create_system(pkg_id, "Sys", 3);
+		ecsact_set_system_lazy_iteration_rate(sys_id, 4);
+		ecsact_set_system_capability(
+			as_system_like(sys_id),
+			as_comp_like(assoc_comp_id),
+			ECSACT_SYS_CAP_READWRITE
+		);
+		ecsact_set_system_notify_component_setting(
+			as_system_like(sys_id),
+			as_comp_like(assoc_comp_id),
+			ECSACT_SYS_NOTIFY_ONCHANGE
+		);
+		auto gen_id = ecsact_add_system_generates(as_system_like(sys_id));
+		ecsact_system_generates_set_component(
+			as_system_like(sys_id),
+			gen_id,
+			stream_comp_id,
+			ECSACT_SYS_GEN_OPTIONAL
+		);
+		auto assoc_id = ecsact_add_system_assoc(
+			as_system_like(sys_id),
+			as_comp_like(assoc_comp_id)
+		);
+		ecsact_add_system_assoc_field(
+			as_system_like(sys_id),
+			assoc_id,
+			index_field_id
+		);
+		ecsact_set_system_assoc_capability(
+			as_system_like(sys_id),
+			assoc_id,
+			as_comp_like(comp_id),
+			ECSACT_SYS_CAP_WRITEONLY
+		);
+
+		nested_sys_id = ecsact_create_system(pkg_id, "Nested", 6);
+		ecsact_add_child_system(as_system_like(sys_id), nested_sys_id);
+		ecsact_set_system_parallel_execution(
+			as_system_like(nested_sys_id),
+			ECSACT_PAR_EXEC_PREFERRED
+		);
+	}
+
+	void TearDown() override {
+		RuntimeContextTest::TearDown();
+		ecsact_destroy_runtime_context(loaded_context);
+	}
+};
+
+TEST_F(RuntimeSnapshot, LoadRestoresRuntime) {
+	auto snapshot = save_snapshot(42);
+	ecsact_set_thread_runtime_context(loaded_context);
+	ecsact_load_runtime_snapshot(snapshot.data(), snapshot.size());
+
+	ASSERT_EQ(ecsact_meta_count_packages(), 2);
+	EXPECT_EQ(ecsact_meta_main_package(), pkg_id);
+	EXPECT_STREQ(ecsact_meta_package_name(pkg_id), "snap.main");
+	EXPECT_STREQ(ecsact_meta_package_file_path(pkg_id), "snap.ecsact");
+	EXPECT_EQ(
+		ecsact::meta::get_dependencies(pkg_id),
+		std::vector{dep_pkg_id}
+	);
+
+	EXPECT_STREQ(ecsact_meta_enum_name(enum_id), "Color");
+	EXPECT_EQ(ecsact_meta_count_enum_values(enum_id), 2);
+	EXPECT_EQ(ecsact_meta_enum_storage_type(enum_id), ECSACT_U16);
+
+	EXPECT_EQ(decl_full_name(comp_id), "snap.main.Comp");
+	ASSERT_EQ(ecsact_meta_count_fields(as_composite(comp_id)), 2);
+	auto nums_type = ecsact_meta_field_type(
+		as_composite(comp_id),
+		static_cast<ecsact_field_id>(1)
+	);
+	EXPECT_EQ(nums_type.type.builtin, ECSACT_I32);
+	EXPECT_EQ(nums_type.length, 4);
+	EXPECT_EQ(
+		ecsact_meta_component_type(as_comp_like(stream_comp_id)),
+		ECSACT_COMPONENT_TYPE_STREAM
+	);
+
+	auto index_type = ecsact_meta_field_type(
+		as_composite(assoc_comp_id),
+		static_cast<ecsact_field_id>(0)
+	);
+	EXPECT_EQ(index_type.kind, ECSACT_TYPE_KIND_FIELD_INDEX);
+	EXPECT_EQ(index_type.type.field_index.composite_id, as_composite(comp_id));
+
+	EXPECT_EQ(decl_full_name(act_id), "snap.main.Act");
+	EXPECT_EQ(ecsact_meta_system_capabilities_count(as_system_like(act_id)), 1);
+
+	EXPECT_EQ(ecsact_meta_get_lazy_iteration_rate(sys_id), 4);
+	EXPECT_EQ(
+		ecsact_meta_system_notify_settings_count(as_system_like(sys_id)),
+		1
+	);
+	EXPECT_EQ(ecsact_meta_count_system_generates_ids(as_system_like(sys_id)), 1);
+	ASSERT_EQ(ecsact_meta_system_assoc_count(as_system_like(sys_id)), 1);
+
+	auto assoc_ids = ecsact::meta::system_assoc_ids(as_system_like(sys_id));
+	EXPECT_EQ(
+		ecsact_meta_system_assoc_component_id(
+			as_system_like(sys_id),
+			assoc_ids.at(0)
+		),
+		as_comp_like(assoc_comp_id)
+	);
+	EXPECT_EQ(
+		ecsact_meta_system_assoc_capabilities_count(
+			as_system_like(sys_id),
+			assoc_ids.at(0)
+		),
+		1
+	);
+
+	EXPECT_EQ(decl_full_name(nested_sys_id), "snap.main.Sys.Nested");
+	EXPECT_EQ(
+		ecsact_meta_get_parent_system_id(nested_sys_id),
+		as_system_like(sys_id)
+	);
+	EXPECT_EQ(
+		ecsact_meta_get_system_parallel_execution(as_system_like(nested_sys_id)),
+		ECSACT_PAR_EXEC_PREFERRED
+	);
+	// Sys and Act
+	EXPECT_EQ(ecsact_meta_count_top_level_systems(pkg_id), 2);
+}
+
+TEST_F(RuntimeSnapshot, SnapshotOfLoadedRuntimeIsIdentical) {
+	auto snapshot = save_snapshot(7);
+	ecsact_set_thread_runtime_context(loaded_context);
+	ecsact_load_runtime_snapshot(snapshot.data(), snapshot.size());
+
+	EXPECT_EQ(save_snapshot(7), snapshot);
+
+	// New IDs continue where the saved runtime left off
+	auto new_pkg_id = ecsact_create_package(false, "snap.new", 8);
+	ecsact_set_thread_runtime_context(context);
+	EXPECT_EQ(ecsact_create_package(false, "snap.new", 8), new_pkg_id);
+}
+
+TEST_F(RuntimeSnapshot, SourceHash) {
+	auto snapshot = save_snapshot(0xfeedbeefcafe);
+
+	auto source_hash = uint64_t{};
+	ASSERT_TRUE(ecsact_read_runtime_snapshot_source_hash(
+		snapshot.data(),
+		snapshot.size(),
+		&source_hash
+	));
+	EXPECT_EQ(source_hash, 0xfeedbeefcafe);
+
+	EXPECT_FALSE(ecsact_read_runtime_snapshot_source_hash(
+		snapshot.data(),
+		snapshot.size() - 1,
+		&source_hash
+	));
+}
+
+TEST_F(RuntimeSnapshot, LoadRequiresEmptyRuntime) {
+	auto snapshot = save_snapshot(0);
+	EXPECT_THROW(
+		ecsact_load_runtime_snapshot(snapshot.data(), snapshot.size()),
+		std::logic_error
+	);
+}
+
+TEST_F(RuntimeSnapshot, InvalidSnapshot) {
+	auto snapshot = save_snapshot(0);
+	snapshot[0] = 'X';
+
+	ecsact_set_thread_runtime_context(loaded_context);
+	EXPECT_THROW(
+		ecsact_load_runtime_snapshot(snapshot.data(), snapshot.size()),
+		std::invalid_argument
+	);
+	EXPECT_EQ(ecsact_meta_count_packages(), 0);
+}
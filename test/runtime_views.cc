@@ -0,0 +1,149 @@
+#include <vector>
+#include "gtest/gtest.h"
+#include "ecsact/runtime/dynamic.h"
+#include "ecsact/runtime/meta.hh"
+#include "parse-resolver-runtime/context.h"
+#include "parse-resolver-runtime/views.hh"
+
+namespace views = ecsact::interpret::views;
+
+TEST(RuntimeViews, MatchMeta) {
+	auto context = ecsact_create_runtime_context();
+	ecsact_set_thread_runtime_context(context);
+
+	auto dep_pkg_id = ecsact_create_package(false, "views.dep", 9);
+	auto pkg_id = ecsact_create_package(true, "views.main", 10);
+	ecsact_add_dependency(pkg_id, dep_pkg_id);
+
+	auto comp_id = ecsact_create_component(pkg_id, "Comp", 4);
+	ecsact_create_component(pkg_id, "Other", 5);
+	ecsact_create_transient(pkg_id, "Trans", 5);
+	ecsact_create_enum(pkg_id, "Enum", 4);
+	auto act_id = ecsact_create_action(pkg_id, "Act", 3);
+	auto sys_id = ecsact_create_system(pkg_id, "Sys", 3);
+	auto child_id = ecsact_create_system(pkg_id, "Child", 5);
+	auto sys_like_id = ecsact_id_cast<ecsact_system_like_id>(sys_id);
+	ecsact_add_child_system(sys_like_id, child_id);
+
+	auto field_type = ecsact_field_type{.kind = ECSACT_TYPE_KIND_BUILTIN};
+	field_type.type.builtin = ECSACT_ENTITY_TYPE;
+	auto field_id = ecsact_add_field(
+		ecsact_id_cast<ecsact_composite_id>(comp_id),
+		field_type,
+		"target",
+		6
+	);
+	auto comp_like_id = ecsact_id_cast<ecsact_component_like_id>(comp_id);
+	auto assoc_id = ecsact_add_system_assoc(sys_like_id, comp_like_id);
+	ecsact_add_system_assoc_field(sys_like_id, assoc_id, field_id);
+	ecsact_set_system_assoc_capability(
+		sys_like_id,
+		assoc_id,
+		comp_like_id,
+		ECSACT_SYS_CAP_READONLY
+	);
+
+	auto as_vector = [](auto span) {
+		return std::vector(span.begin(), span.end());
+	};
+
+	EXPECT_EQ(as_vector(views::package_ids()), ecsact::meta::get_package_ids());
+	EXPECT_EQ(views::package_name(pkg_id), "views.main");
+	EXPECT_EQ(
+		as_vector(views::dependencies(pkg_id)),
+		ecsact::meta::get_dependencies(pkg_id)
+	);
+	EXPECT_EQ(
+		as_vector(views::component_ids(pkg_id)),
+		ecsact::meta::get_component_ids(pkg_id)
+	);
+	EXPECT_EQ(views::transient_ids(pkg_id).size(), 1);
+	EXPECT_EQ(views::enum_ids(pkg_id).size(), 1);
+	EXPECT_EQ(views::action_ids(pkg_id).front(), act_id);
+	EXPECT_EQ(views::system_ids(pkg_id).size(), 2);
+	EXPECT_EQ(views::top_level_systems(pkg_id).size(), 2);
+	ASSERT_EQ(views::child_system_ids(sys_like_id).size(), 1);
+	EXPECT_EQ(views::child_system_ids(sys_like_id).front(), child_id);
+
+	ASSERT_EQ(views::system_assoc_ids(sys_like_id).size(), 1);
+	EXPECT_EQ(views::system_assoc_ids(sys_like_id).front(), assoc_id);
+	EXPECT_EQ(
+		views::system_assoc_fields(sys_like_id, assoc_id).front(),
+		field_id
+	);
+	ASSERT_EQ(views::system_assoc_capabilities(sys_like_id, assoc_id).size(), 1);
+	EXPECT_EQ(
+		views::system_assoc_capabilities(sys_like_id, assoc_id).front().second,
+		ECSACT_SYS_CAP_READONLY
+	);
+
+	// Systems without associations have empty views
+	EXPECT_TRUE(
+		views::system_assoc_ids(ecsact_id_cast<ecsact_system_like_id>(child_id))
+			.empty()
+	);
+
+	ecsact_set_thread_runtime_context(nullptr);
+	ecsact_destroy_runtime_context(context);
+}
+
+TEST(RuntimeViews, SystemCapabilities) {
+	auto context = ecsact_create_runtime_context();
+	ecsact_set_thread_runtime_context(context);
+
+	auto pkg_id = ecsact_create_package(true, "views.caps", 10);
+	auto sys_id = ecsact_create_system(pkg_id, "Sys", 3);
+	auto sys_like_id = ecsact_id_cast<ecsact_system_like_id>(sys_id);
+
+	auto comp_like_ids = std::vector<ecsact_component_like_id>{};
+	for(auto name : {"C", "B", "A", "D"}) {
+		comp_like_ids.push_back(ecsact_id_cast<ecsact_component_like_id>(
+			ecsact_create_component(pkg_id, name, 1)
+		));
+		ecsact_set_system_capability(
+			sys_like_id,
+			comp_like_ids.back(),
+			ECSACT_SYS_CAP_READONLY
+		);
+	}
+
+	// Setting a capability again keeps its position
+	ecsact_set_system_capability(
+		sys_like_id,
+		comp_like_ids[1],
+		ECSACT_SYS_CAP_WRITEONLY
+	);
+	ecsact_unset_system_capability(sys_like_id, comp_like_ids[0]);
+
+	auto caps = views::system_capabilities(sys_like_id);
+	ASSERT_EQ(caps.size(), 3);
+	EXPECT_EQ(caps[0].first, comp_like_ids[1]);
+	EXPECT_EQ(caps[0].second, ECSACT_SYS_CAP_WRITEONLY);
+	EXPECT_EQ(caps[1].first, comp_like_ids[2]);
+	EXPECT_EQ(caps[2].first, comp_like_ids[3]);
+
+	EXPECT_FALSE(views::system_capability(sys_like_id, comp_like_ids[0]));
+	EXPECT_EQ(
+		views::system_capability(sys_like_id, comp_like_ids[3]),
+		ECSACT_SYS_CAP_READONLY
+	);
+
+	// Meta functions report capabilities in the same order
+	auto meta_caps = ecsact::meta::system_capabilities(sys_like_id);
+	ASSERT_EQ(meta_caps.size(), caps.size());
+	for(auto i = 0; caps.size() > i; ++i) {
+		EXPECT_EQ(meta_caps[i].first, caps[i].first);
+		EXPECT_EQ(meta_caps[i].second, caps[i].second);
+	}
+
+	auto assoc_id = ecsact_add_system_assoc(sys_like_id, comp_like_ids[2]);
+	ASSERT_EQ(views::system_assoc_ids(sys_like_id, comp_like_ids[2]).size(), 1);
+	EXPECT_EQ(
+		views::system_assoc_ids(sys_like_id, comp_like_ids[2]).front(),
+		assoc_id
+	);
+	EXPECT_TRUE(views::system_assoc_ids(sys_like_id, comp_like_ids[1]).empty());
+
+	ecsact_set_thread_runtime_context(nullptr);
+	ecsact_destroy_runtime_context(context);
+}
@@ -0,0 +1,297 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include "gtest/gtest.h"
+#include "ecsact/interpret/eval.hh"
+#include "ecsact/runtime/dynamic.h"
+#include "ecsact/runtime/meta.hh"
+#include "parse-resolver-runtime/context.h"
+#include "parse-resolver-runtime/memory.h"
+#include "bench/schema_gen.hh"
+
+using ecsact::bench::schema_params;
+
+static constexpr auto default_shape = schema_params{
+	.packages = 4,
+	.imports = 1,
+	.components = 4,
+	.fields = 4,
+	.systems = 4,
+	.nested_systems = 4,
+};
+
+/**
+ * Measurements of a schema. Counts are the same on every run, times are the
+ * fastest of the runs.
+ */
+struct scale_result {
+	int     scale;
+	int64_t entries;
+	int64_t bytes;
+	int64_t statements;
+	int64_t symbol_lookups;
+	int64_t symbol_lookup_misses;
+	double  eval_seconds;
+	double  layout_seconds;
+	double  destroy_seconds;
+};
+
+static constexpr auto scales = std::array{1, 10, 100};
+
+/**
+ * Per entry cost may grow by this much between scales. Quadratic behavior
+ * grows it by about the scale step instead.
+ */
+static constexpr auto count_slack = 1.5;
+static constexpr auto time_slack = 3.0;
+
+/**
+ * Times shorter than this are too noisy to compare and are rounded up
+ */
+static constexpr auto min_seconds = 0.0002;
+
+static auto seconds_since(std::chrono::steady_clock::time_point start)
+	-> double {
+	auto elapsed = std::chrono::steady_clock::now() - start;
+	return std::chrono::duration<double>(elapsed).count();
+}
+
+static auto measure(const schema_params& shape, int scale, int repetitions)
+	-> scale_result {
+	auto schema = ecsact::bench::generate_schema(shape);
+	auto eval_sources = schema.eval_sources();
+
+	auto result = scale_result{.scale = scale};
+	for(auto run = 0; repetitions > run; ++run) {
+		auto context = ecsact_create_runtime_context();
+		ecsact_set_thread_runtime_context(context);
+
+		auto stats = ecsact::eval_stats{};
+		auto start = std::chrono::steady_clock::now();
+		auto errs = ecsact::eval_files(eval_sources, {.stats = &stats});
+		auto eval_seconds = seconds_since(start);
+		EXPECT_EQ(errs.size(), 0) << errs[0].error_message;
+
+		result.statements = 0;
+		for(auto& [_, count] : stats.statements_parsed) {
+			result.statements += count;
+		}
+		result.symbol_lookups = stats.symbol_lookups;
+		result.symbol_lookup_misses = stats.symbol_lookup_misses;
+
+		auto usage = ecsact_runtime_memory_usage{};
+		ecsact_get_runtime_memory_usage(&usage);
+		result.entries = 0;
+		for(auto& table : usage.tables) {
+			result.entries += table.count;
+		}
+		result.bytes = usage.total_bytes;
+
+		auto package_ids = ecsact::meta::get_package_ids();
+		auto offset_sum = int64_t{};
+		start = std::chrono::steady_clock::now();
+		for(auto package_id : package_ids) {
+			for(auto comp_id : ecsact::meta::get_component_ids(package_id)) {
+				auto composite_id = ecsact_id_cast<ecsact_composite_id>(comp_id);
+				for(auto field_id : ecsact::meta::get_field_ids(composite_id)) {
+					offset_sum += ecsact_meta_field_offset(composite_id, field_id);
+				}
+			}
+		}
+		auto layout_seconds = seconds_since(start);
+		EXPECT_GE(offset_sum, 0);
+
+		start = std::chrono::steady_clock::now();
+		for(auto package_id : package_ids) {
+			ecsact_destroy_package(package_id);
+		}
+		auto destroy_seconds = seconds_since(start);
+		EXPECT_EQ(ecsact_meta_count_packages(), 0);
+
+		ecsact_set_thread_runtime_context(nullptr);
+		ecsact_destroy_runtime_context(context);
+
+		if(run == 0 || eval_seconds < result.eval_seconds) {
+			result.eval_seconds = eval_seconds;
+		}
+		if(run == 0 || layout_seconds < result.layout_seconds) {
+			result.layout_seconds = layout_seconds;
+		}
+		if(run == 0 || destroy_seconds < result.destroy_seconds) {
+			result.destroy_seconds = destroy_seconds;
+		}
+	}
+
+	return result;
+}
+
+static auto measure_scales(
+	schema_params        shape,
+	int schema_params::* dimension,
+	int                  repetitions
+) -> std::vector<scale_result> {
+	auto base = shape.*dimension;
+	auto results = std::vector<scale_result>{};
+	for(auto scale : scales) {
+		shape.*dimension = base * scale;
+		results.push_back(measure(shape, scale, repetitions));
+	}
+	return results;
+}
+
+/**
+ * Expects the per entry cost of each scale to be at most a little above that
+ * of the scale before it
+ */
+static auto expect_linear(
+	const std::vector<scale_result>& results,
+	const char*                      what,
+	auto                             cost,
+	double                           slack
+) -> void {
+	for(std::size_t i = 1; results.size() > i; ++i) {
+		auto& prev = results[i - 1];
+		auto& next = results[i];
+		ASSERT_GT(next.entries, prev.entries);
+
+		auto prev_per_entry = cost(prev) / static_cast<double>(prev.entries);
+		auto next_per_entry = cost(next) / static_cast<double>(next.entries);
+		EXPECT_LE(next_per_entry, prev_per_entry * slack)
+			<< what << " per entry grew from " << prev_per_entry << " at "
+			<< prev.scale << "x to " << next_per_entry << " at " << next.scale
+			<< "x";
+	}
+}
+
+/**
+ * Evaluates @p shape with `shape.*dimension` multiplied by each scale and
+ * checks that the work counted by `eval_stats` and the runtime memory grow
+ * about linearly with the runtime entries
+ */
+static auto check_scaling(schema_params shape, int schema_params::*dimension)
+	-> void {
+	auto results = measure_scales(shape, dimension, 1);
+
+	auto count = [](int64_t scale_result::*metric) {
+		return [=](const scale_result& r) {
+			return static_cast<double>(std::max(r.*metric, int64_t{1}));
+		};
+	};
+	expect_linear(
+		results,
+		"statements parsed",
+		count(&scale_result::statements),
+		count_slack
+	);
+	expect_linear(
+		results,
+		"symbol lookups",
+		count(&scale_result::symbol_lookups),
+		count_slack
+	);
+	expect_linear(
+		results,
+		"symbol lookup misses",
+		count(&scale_result::symbol_lookup_misses),
+		count_slack
+	);
+	expect_linear(
+		results,
+		"runtime memory",
+		count(&scale_result::bytes),
+		count_slack
+	);
+}
+
+/**
+ * Same as `check_scaling` for the wall clock time of evaluating, laying out
+ * and destroying the schema. Only run on request, see the `scaling_timing`
+ * target.
+ */
+static auto check_timing(schema_params shape, int schema_params::*dimension)
+	-> void {
+	auto results = measure_scales(shape, dimension, 3);
+
+	auto seconds = [](double scale_result::*metric) {
+		return [=](const scale_result& r) {
+			return std::max(r.*metric, min_seconds);
+		};
+	};
+	expect_linear(
+		results,
+		"eval_files time",
+		seconds(&scale_result::eval_seconds),
+		time_slack
+	);
+	expect_linear(
+		results,
+		"ecsact_meta_field_offset time",
+		seconds(&scale_result::layout_seconds),
+		time_slack
+	);
+	expect_linear(
+		results,
+		"ecsact_destroy_package time",
+		seconds(&scale_result::destroy_seconds),
+		time_slack
+	);
+}
+
+/**
+ * Enough packages for the largest import count
+ */
+static constexpr auto imports_shape = [] {
+	auto shape = default_shape;
+	shape.packages = scales.back() + 1;
+	return shape;
+}();
+
+TEST(Scaling, Packages) {
+	check_scaling(default_shape, &schema_params::packages);
+}
+
+TEST(Scaling, Imports) {
+	check_scaling(imports_shape, &schema_params::imports);
+}
+
+TEST(Scaling, Components) {
+	check_scaling(default_shape, &schema_params::components);
+}
+
+TEST(Scaling, Fields) {
+	check_scaling(default_shape, &schema_params::fields);
+}
+
+TEST(Scaling, Systems) {
+	check_scaling(default_shape, &schema_params::systems);
+}
+
+TEST(Scaling, NestedSystems) {
+	check_scaling(default_shape, &schema_params::nested_systems);
+}
+
+TEST(ScalingTiming, Packages) {
+	check_timing(default_shape, &schema_params::packages);
+}
+
+TEST(ScalingTiming, Imports) {
+	check_timing(imports_shape, &schema_params::imports);
+}
+
+TEST(ScalingTiming, Components) {
+	check_timing(default_shape, &schema_params::components);
+}
+
+TEST(ScalingTiming, Fields) {
+	check_timing(default_shape, &schema_params::fields);
+}
+
+TEST(ScalingTiming, Systems) {
+	check_timing(default_shape, &schema_params::systems);
+}
+
+TEST(ScalingTiming, NestedSystems) {
+	check_timing(default_shape, &schema_params::nested_systems);
+}
@@ -0,0 +1,55 @@
+#include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include "gtest/gtest.h"
+#include "ecsact/interpret/detail/simd_scan.hh"
+#include "ecsact/interpret/detail/read_util.hh"
+
+using ecsact::detail::buffer_input;
+using ecsact::detail::find_first_of;
+
+static constexpr auto ending_chars = std::array{';', '{', '}', '\n'};
+
+TEST(SimdScan, MatchesStringView) {
+	// Long enough to cover several blocks plus a tail of every length
+	for(std::size_t length = 0; 100 > length; ++length) {
+		for(std::size_t match = 0; length >= match; ++match) {
+			auto str = std::string(length, 'a');
+			if(length > match) {
+				str[match] = ending_chars[match % ending_chars.size()];
+			}
+
+			auto delims = std::string_view{ending_chars.data(), ending_chars.size()};
+			for(std::size_t start = 0; length + 1 >= start; ++start) {
+				EXPECT_EQ(
+					find_first_of(str, start, ending_chars),
+					std::string_view{str}.find_first_of(delims, start)
+				) << "length " << length << " match " << match << " start " << start;
+			}
+		}
+	}
+}
+
+TEST(SimdScan, NullCharacter) {
+	// Tails are padded with null characters which must not be reported
+	auto chars = std::array{'\0', ';'};
+	auto str = std::string{"abc"};
+	EXPECT_EQ(find_first_of(str, 0, chars), std::string_view::npos);
+
+	str.push_back('\0');
+	EXPECT_EQ(find_first_of(str, 0, chars), 3);
+}
+
+TEST(SimdScan, BufferInput) {
+	auto input = buffer_input{};
+	input.buffer = "package a;\ncomponent B {}";
+
+	EXPECT_EQ(input.get_until(ending_chars), "package a;");
+	EXPECT_EQ(input.get_until(ending_chars), "\n");
+	EXPECT_EQ(input.get_until(ending_chars), "component B {");
+	EXPECT_EQ(input.get_until(ending_chars), "}");
+	EXPECT_FALSE(input.eof());
+	EXPECT_EQ(input.get_until(ending_chars), "");
+	EXPECT_TRUE(input.eof());
+}
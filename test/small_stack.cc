@@ -0,0 +1,57 @@
+#include <cstddef>
+#include <utility>
+#include "gtest/gtest.h"
+#include "ecsact/interpret/detail/small_stack.hh"
+
+using ecsact::detail::small_stack;
+
+TEST(SmallStack, GrowsOntoHeap) {
+	auto stack = small_stack<int, 4>{};
+	for(auto i = 0; 4 > i; ++i) {
+		stack.push(i);
+	}
+	EXPECT_TRUE(stack.is_inline());
+
+	stack.push(4);
+	EXPECT_FALSE(stack.is_inline());
+	ASSERT_EQ(stack.size(), 5);
+	for(auto i = 4; i >= 0; --i) {
+		EXPECT_EQ(stack.top(), i);
+		stack.pop();
+	}
+	EXPECT_TRUE(stack.empty());
+}
+
+TEST(SmallStack, PushOwnElementWhileFull) {
+	// Pushing an element of the stack itself must read it before the storage
+	// it lives in is released. Covers growing out of the inline storage and
+	// out of a heap buffer.
+	auto stack = small_stack<int, 2>{};
+	for(auto value = 0; 4 > value; ++value) {
+		stack.push(value);
+		while(stack.size() != stack.capacity()) {
+			stack.push(value);
+		}
+		stack.push(stack.top());
+		EXPECT_EQ(stack.top(), value);
+		stack.emplace(stack.data()[0]);
+		EXPECT_EQ(stack.top(), 0);
+	}
+}
+
+TEST(SmallStack, CopyAndMove) {
+	auto stack = small_stack<int, 2>{};
+	for(auto i = 0; 3 > i; ++i) {
+		stack.push(i);
+	}
+
+	auto copy = stack;
+	EXPECT_EQ(copy.size(), 3);
+	EXPECT_EQ(copy.top(), 2);
+
+	auto moved = std::move(stack);
+	EXPECT_EQ(moved.size(), 3);
+	EXPECT_EQ(moved.top(), 2);
+	EXPECT_TRUE(stack.empty());
+	EXPECT_TRUE(stack.is_inline());
+}
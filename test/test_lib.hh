@@ -5,12 +5,76 @@
 #include <filesystem>
 #include <optional>
 #include <string>
+#include <string_view>
 #include "gtest/gtest.h"
 #include "ecsact/interpret/eval.hh"
+#include "ecsact/runtime/dynamic.h"
 #include "ecsact/runtime/meta.hh"
+#include "parse-resolver-runtime/context.h"
 #include "magic_enum.hpp"
 #include "bazel_sundry/runfiles.hh"
 
+/**
+ * Gives each test its own runtime context, set as the thread's context for the
+ * duration of the test. A main package is created in it if a name is given.
+ */
+class RuntimeContextTest : public testing::Test {
+	std::string_view _main_package_name;
+
+protected:
+	ecsact_runtime_context* context = nullptr;
+	ecsact_package_id       pkg_id = {};
+
+	explicit RuntimeContextTest(std::string_view main_package_name = {})
+		: _main_package_name(main_package_name) {
+	}
+
+	void SetUp() override {
+		context = ecsact_create_runtime_context();
+		ecsact_set_thread_runtime_context(context);
+		if(!_main_package_name.empty()) {
+			pkg_id = ecsact_create_package(
+				true,
+				_main_package_name.data(),
+				static_cast<int32_t>(_main_package_name.size())
+			);
+		}
+	}
+
+	void TearDown() override {
+		ecsact_set_thread_runtime_context(nullptr);
+		ecsact_destroy_runtime_context(context);
+	}
+};
+
+inline auto builtin_field_type( //
+	ecsact_builtin_type type,
+	int32_t             length = 1
+) -> ecsact_field_type {
+	auto field_type = ecsact_field_type{
+		.kind = ECSACT_TYPE_KIND_BUILTIN,
+		.length = length,
+	};
+	field_type.type.builtin = type;
+	return field_type;
+}
+
+inline auto as_composite(auto id) -> ecsact_composite_id {
+	return ecsact_id_cast<ecsact_composite_id>(id);
+}
+
+inline auto as_comp_like(auto id) -> ecsact_component_like_id {
+	return ecsact_id_cast<ecsact_component_like_id>(id);
+}
+
+inline auto as_system_like(auto id) -> ecsact_system_like_id {
+	return ecsact_id_cast<ecsact_system_like_id>(id);
+}
+
+inline auto decl_full_name(auto id) -> std::string {
+	return ecsact_meta_decl_full_name(ecsact_id_cast<ecsact_decl_id>(id));
+}
+
 inline auto get_component_by_name( //
 	ecsact_package_id pkg_id,
 	std::string       name
@@ -69,7 +133,8 @@ inline auto get_field_by_name( //
 }
 
 inline auto ecsact_interpret_test_files(
-	std::vector<std::string> relative_file_paths
+	std::vector<std::string>   relative_file_paths,
+	ecsact::eval_files_options options = {}
 ) -> std::vector<ecsact::parse_eval_error> {
 	auto runfiles = bazel_sundry::CreateDefaultRunfiles();
 	[&] { ASSERT_TRUE(runfiles); }();
@@ -89,12 +154,16 @@ inline auto ecsact_interpret_test_files(
 
 	[&] { ASSERT_FALSE(file_paths.empty()) << "cannot interpret 0 files\n"; }();
 
-	auto errs = ecsact::eval_files(file_paths);
+	auto errs = ecsact::eval_files(file_paths, options);
 
 	for(auto& err : errs) {
+		auto file_path = std::filesystem::path{};
+		if(err.source_index >= 0) {
+			file_path = file_paths[err.source_index];
+		}
 		std::cerr //
-			<< "[ERROR] " << file_paths[err.source_index].generic_string() << ":"
-			<< err.line << ":" << err.character << " " << err.error_message << "\n";
+			<< "[ERROR] " << file_path.generic_string() << ":" << err.line << ":"
+			<< err.character << " " << err.error_message << "\n";
 	}
 
 	return errs;
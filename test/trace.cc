@@ -0,0 +1,152 @@
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include "gtest/gtest.h"
+#include "ecsact/interpret/eval.hh"
+#include "ecsact/runtime/dynamic.h"
+#include "parse-resolver-runtime/context.h"
+#include "parse-resolver-runtime/trace.h"
+
+using namespace std::string_view_literals;
+
+static auto read_trace(const std::filesystem::path& path) -> std::string {
+	auto stream = std::ifstream{path, std::ios::binary};
+	auto contents = std::stringstream{};
+	contents << stream.rdbuf();
+	return contents.str();
+}
+
+static auto span_name(std::string_view name) -> std::string {
+	return "{\"name\":\"" + std::string{name} + "\"";
+}
+
+class Trace : public testing::Test {
+protected:
+	ecsact_runtime_context* context = nullptr;
+	std::filesystem::path   trace_path;
+
+	void SetUp() override {
+		auto test_name =
+			testing::UnitTest::GetInstance()->current_test_info()->name();
+		trace_path = std::filesystem::temp_directory_path() /
+			(std::string{"ecsact_interpret_trace_"} + test_name + ".json");
+		std::filesystem::remove(trace_path);
+
+		context = ecsact_create_runtime_context();
+		ecsact_set_thread_runtime_context(context);
+	}
+
+	void TearDown() override {
+		ecsact_set_thread_runtime_context(nullptr);
+		ecsact_destroy_runtime_context(context);
+		std::filesystem::remove(trace_path);
+	}
+};
+
+TEST_F(Trace, EvalFiles) {
+	auto sources = std::array{
+		ecsact::eval_source{
+			.file_path = "trace_main.ecsact",
+			.source = "main package trace.main;\n"
+								"import trace.dep;\n"
+								"component Position {\n"
+								"i32 x;\n"
+								"}\n"
+								"system Move {\n"
+								"readwrite Position;\n"
+								"readonly trace.dep.Speed;\n"
+								"}\n"sv,
+		},
+		ecsact::eval_source{
+			.file_path = "trace_dep.ecsact",
+			.source = "package trace.dep;\n"
+								"component Speed {\n"
+								"i32 value;\n"
+								"}\n"sv,
+		},
+	};
+
+	auto errs = ecsact::eval_files(
+		sources,
+		{.trace_path = trace_path, .context = context}
+	);
+	ASSERT_EQ(errs.size(), 0) << errs[0].error_message;
+	EXPECT_FALSE(ecsact_is_tracing());
+
+	auto trace = read_trace(trace_path);
+	ASSERT_TRUE(trace.starts_with("{\"traceEvents\":[")) << trace;
+
+	for(auto name : {
+				"eval_files"sv,
+				"parse_package_statements"sv,
+				"parse_imports"sv,
+				"check_imports"sv,
+				"eval_package_statements"sv,
+				"eval_declarations"sv,
+				"parse_eval_declarations"sv,
+				"ECSACT_STATEMENT_COMPONENT"sv,
+				"ECSACT_STATEMENT_SYSTEM_COMPONENT"sv,
+				"find_by_name"sv,
+			}) {
+		EXPECT_NE(trace.find(span_name(name)), std::string::npos) << name;
+	}
+	EXPECT_NE(trace.find("\"detail\":\"trace_main.ecsact\""), std::string::npos);
+	EXPECT_NE(trace.find("\"detail\":\"trace_dep.ecsact\""), std::string::npos);
+}
+
+TEST_F(Trace, NotRequested) {
+	auto source = ecsact::eval_source{
+		.file_path = "trace_main.ecsact",
+		.source = "main package trace.main;\n"sv,
+	};
+
+	// Spans without a trace are not kept for the next one
+	auto errs = ecsact::eval_files(std::span{&source, 1}, {.context = context});
+	ASSERT_EQ(errs.size(), 0);
+	EXPECT_FALSE(ecsact_is_tracing());
+	EXPECT_FALSE(ecsact_stop_trace(trace_path.string().c_str()));
+
+	ecsact_start_trace();
+	ASSERT_TRUE(ecsact_stop_trace(trace_path.string().c_str()));
+	auto trace = read_trace(trace_path);
+	EXPECT_EQ(trace.find(span_name("eval_files")), std::string::npos);
+}
+
+TEST_F(Trace, RuntimeSpans) {
+	ecsact_start_trace();
+	ASSERT_TRUE(ecsact_is_tracing());
+
+	auto pkg_id = ecsact_create_package(true, "trace.main", 10);
+	ecsact_create_component(pkg_id, "Comp", 4);
+	ecsact_destroy_package(pkg_id);
+
+	auto worker = std::thread{[] {
+		if(ecsact_trace_begin("test", "worker", "with \"quotes\"", 13)) {
+			ecsact_trace_end();
+		}
+	}};
+	worker.join();
+
+	ASSERT_TRUE(ecsact_stop_trace(trace_path.string().c_str()));
+	EXPECT_FALSE(ecsact_is_tracing());
+
+	auto trace = read_trace(trace_path);
+	EXPECT_NE(
+		trace.find(span_name("ecsact_destroy_package")),
+		std::string::npos
+	);
+	EXPECT_NE(trace.find(span_name("trigger_on_destroy")), std::string::npos);
+
+	// Spans of threads that already exited are kept
+	EXPECT_NE(trace.find(span_name("worker")), std::string::npos);
+	auto quoted_detail = R"("detail":"with \"quotes\"")"sv;
+	EXPECT_NE(trace.find(quoted_detail), std::string::npos);
+
+	// Nothing is recorded once the trace stopped
+	EXPECT_FALSE(ecsact_trace_begin("test", "after", nullptr, 0));
+}